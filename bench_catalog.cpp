@@ -0,0 +1,248 @@
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <iomanip>
+#include <chrono>
+#include <atomic>
+#include <thread>
+#include <mutex>
+#include <shared_mutex>
+#include <unordered_map>
+#include <cstdlib>
+#include <algorithm>
+#include <unistd.h>
+#include "include/schema/schema.hpp"
+#include "include/schema/catalogFile.hpp"
+#include "include/schema/batchValidator.hpp"
+
+Table buildTable(size_t index, size_t columns) {
+    static const char* const types[] = {"INT", "VARCHAR", "DOUBLE", "DATE", "BOOLEAN"};
+    Table table;
+    table.name = "table_" + std::to_string(index);
+    for (size_t c = 0; c < columns; c++) {
+        Column column;
+        column.name = "column_" + std::to_string(c);
+        column.datatype = types[c % 5];
+        column.isPrimaryKey = c == 0;
+        column.isUnique = c == 0;
+        column.isNotNull = c < 2;
+        table.addColumn(column);
+    }
+    if (index > 0) table.foreignKeys.emplace("column_1", "table_" + std::to_string(index - 1) + ".column_0");
+    return table;
+}
+
+// Startup cost: replaying DDL into memory vs mapping a saved catalog
+void benchStartup(size_t tableCount, size_t columns, const std::string& path) {
+    std::vector<Table> definitions;
+    definitions.reserve(tableCount);
+    for (size_t i = 0; i < tableCount; i++) definitions.push_back(buildTable(i, columns));
+
+    std::chrono::duration<double, std::milli> replay{};
+    {
+        auto start = std::chrono::steady_clock::now();
+        DatabaseSchema schema;
+        for (const Table& table : definitions) schema.addTable(table);
+        replay = std::chrono::steady_clock::now() - start;
+
+        ::unlink(path.c_str());
+        schema.openCatalog(path);
+        schema.saveCatalog();
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    DatabaseSchema schema;
+    bool opened = schema.openCatalog(path);
+    std::chrono::duration<double, std::milli> open = std::chrono::steady_clock::now() - start;
+
+    schema.getTable("table_0"); // first heap use after the replay's teardown is slow; keep it out of the timing
+    start = std::chrono::steady_clock::now();
+    const Table* table = schema.getTable("table_" + std::to_string(tableCount / 2));
+    std::chrono::duration<double, std::micro> firstLoad = std::chrono::steady_clock::now() - start;
+
+    std::vector<std::string> names;
+    for (size_t i = 0; i < tableCount; i++) names.push_back("table_" + std::to_string((i * 7919) % tableCount));
+    start = std::chrono::steady_clock::now();
+    size_t found = 0;
+    for (const std::string& name : names) found += schema.tableExists(name);
+    std::chrono::duration<double, std::nano> lookups = std::chrono::steady_clock::now() - start;
+
+    std::cout << "tables: " << tableCount << " x " << columns << " columns" << std::endl;
+    std::cout << "replay DDL        | " << std::fixed << std::setprecision(2) << std::setw(9) << replay.count() << " ms" << std::endl;
+    std::cout << "map catalog       | " << std::setw(9) << open.count() << " ms"
+              << " | opened: " << opened << " | tables: " << schema.tableCount() << std::endl;
+    std::cout << "load one table    | " << std::setw(9) << firstLoad.count() << " us"
+              << " | columns: " << (table ? table->columns.size() : 0) << std::endl;
+    std::cout << "in-place lookup   | " << std::setw(9) << lookups.count() / names.size() << " ns"
+              << " | found: " << found << std::endl;
+}
+
+// Lookup throughput with N readers while a writer keeps running DDL, against
+// the same lookups through a reader-writer lock
+void benchContention(size_t readers, bool withWriter, size_t tableCount) {
+    DatabaseSchema schema;
+    std::unordered_map<std::string, Table> locked;
+    std::shared_mutex lockedMutex;
+    for (size_t i = 0; i < tableCount; i++) {
+        Table table = buildTable(i, 8);
+        locked.emplace(table.name, table);
+        schema.addTable(table);
+    }
+
+    std::vector<std::string> names;
+    for (size_t i = 0; i < 4096; i++) names.push_back("table_" + std::to_string((i * 7919) % tableCount));
+
+    auto run = [&](bool snapshot) {
+        std::atomic<bool> stop{false};
+        std::atomic<uint64_t> lookups{0};
+        std::atomic<uint64_t> writes{0};
+        std::vector<std::thread> threads;
+
+        for (size_t r = 0; r < readers; r++) {
+            threads.emplace_back([&, r] {
+                uint64_t done = 0;
+                size_t found = 0;
+                for (size_t i = r * 131; !stop.load(std::memory_order_relaxed); i++) {
+                    const std::string& name = names[i % names.size()];
+                    if (snapshot) {
+                        found += schema.getTable(name) != nullptr;
+                    } else {
+                        std::shared_lock<std::shared_mutex> lock(lockedMutex);
+                        found += locked.find(name) != locked.end();
+                    }
+                    done++;
+                }
+                lookups += done;
+                if (found == 0) std::cerr << "no tables found" << std::endl;
+            });
+        }
+        if (withWriter) {
+            threads.emplace_back([&] {
+                for (size_t i = 0; !stop.load(std::memory_order_relaxed); i++) {
+                    Table table = buildTable(tableCount + i, 8);
+                    table.name = (snapshot ? "ddl_" : "locked_ddl_") + std::to_string(i);
+                    if (snapshot) {
+                        schema.addTable(table);
+                    } else {
+                        std::unique_lock<std::shared_mutex> lock(lockedMutex);
+                        // Hold the lock as long as a copy-on-write publish takes
+                        std::unordered_map<std::string, Table> copy(locked);
+                        copy.emplace(table.name, table);
+                        locked.swap(copy);
+                    }
+                    writes++;
+                    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+                }
+            });
+        }
+
+        auto start = std::chrono::steady_clock::now();
+        std::this_thread::sleep_for(std::chrono::milliseconds(300));
+        stop = true;
+        for (auto& thread : threads) thread.join();
+        std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+
+        std::cout << (snapshot ? "snapshot     " : "shared_mutex ") << "| readers: " << std::setw(2) << readers
+                  << " | writer: " << (withWriter ? "yes" : "no ")
+                  << " | " << std::fixed << std::setprecision(1) << std::setw(8) << lookups.load() / elapsed.count() / 1e6
+                  << " M lookups/s | DDL: " << writes.load() << std::endl;
+    };
+
+    run(true);
+    run(false);
+}
+
+// Existing primary keys, as an index on the table would hold them
+class keySetLookup : public keyLookup {
+public:
+    explicit keySetLookup(std::vector<int64_t> keys) : keys(std::move(keys)) { std::sort(this->keys.begin(), this->keys.end()); }
+
+    void probe(const Value* values, size_t count, uint64_t* found) const override {
+        for (size_t i = 0; i < count; i++) {
+            if (values[i].type() == ValueType::INT && std::binary_search(keys.begin(), keys.end(), values[i].asInt())) {
+                found[i / 64] |= uint64_t(1) << (i % 64);
+            }
+        }
+    }
+
+private:
+    std::vector<int64_t> keys;
+};
+
+// Bulk-insert validation: one call per row and column vs one batch per column
+void benchBatchValidation(size_t rows) {
+    DatabaseSchema schema;
+    Table table;
+    table.name = "orders";
+    table.addColumn({"id", "INT", true, true, true});
+    table.addColumn({"customer", "VARCHAR(16)", false, false, true});
+    table.addColumn({"amount", "DOUBLE", false, false, false});
+    schema.addTable(table);
+
+    // Every 1000th row breaks one rule
+    std::vector<std::string> names(rows);
+    std::vector<std::vector<Value>> columns(3, std::vector<Value>(rows));
+    for (size_t i = 0; i < rows; i++) {
+        names[i] = "customer_" + std::to_string(i % 5000);
+        columns[0][i] = Value::integer(static_cast<int64_t>(i % 1000 == 7 ? i - 1 : i) + 1000);
+        columns[1][i] = i % 1000 == 3 ? Value::null() : Value::string(names[i]);
+        columns[2][i] = i % 1000 == 5 ? Value::string("lots") : Value::real(static_cast<double>(i) * 0.25);
+    }
+    keySetLookup existing({1000 + static_cast<int64_t>(rows / 2)});
+
+    std::ostringstream sink;
+    std::streambuf* savedErr = std::cerr.rdbuf(sink.rdbuf());
+    auto start = std::chrono::steady_clock::now();
+    size_t rejected = 0;
+    for (size_t i = 0; i < rows; i++) {
+        bool ok = true;
+        for (size_t c = 0; c < 3; c++) {
+            ok &= schema.validateColumnConstraints("orders", table.columns[c].name, columns[c][i]);
+        }
+        rejected += !ok;
+    }
+    std::chrono::duration<double, std::milli> perRow = std::chrono::steady_clock::now() - start;
+    std::cerr.rdbuf(savedErr);
+
+    start = std::chrono::steady_clock::now();
+    const Table* resolved = schema.getTable("orders");
+    batchErrors errors[3];
+    for (size_t c = 0; c < 3; c++) {
+        validateColumnBatch(resolved->columns[c], columns[c].data(), rows, errors[c], c == 0 ? &existing : nullptr);
+    }
+    size_t failed = 0;
+    for (size_t w = 0; w < errors[0].notNull.size(); w++) {
+        uint64_t word = 0;
+        for (const batchErrors& e : errors) word |= e.notNull[w] | e.type[w] | e.range[w] | e.unique[w];
+        failed += static_cast<size_t>(__builtin_popcountll(word));
+    }
+    std::chrono::duration<double, std::milli> batch = std::chrono::steady_clock::now() - start;
+
+    std::cout << "rows: " << rows << " x 3 columns" << std::endl;
+    std::cout << "per-row checks    | " << std::fixed << std::setprecision(2) << std::setw(9) << perRow.count() << " ms"
+              << " | rejected: " << rejected << " (UNIQUE not checked)" << std::endl;
+    std::cout << "batch + UNIQUE    | " << std::setw(9) << batch.count() << " ms"
+              << " | rejected: " << failed << " | duplicate keys: " << errors[0].failedCount() << std::endl;
+}
+
+int main(int argc, char** argv) {
+    size_t tables = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 5000;
+    std::string path = argc > 2 ? argv[2] : "bench_catalog.cat";
+
+    std::cout << "=== CATALOG STARTUP ===" << std::endl;
+    benchStartup(tables, 20, path);
+
+    ::unlink(path.c_str());
+
+    std::cout << "\n=== BATCH VALIDATION ===" << std::endl;
+    benchBatchValidation(100000);
+
+    std::cout << "\n=== CATALOG CONTENTION ===" << std::endl;
+    size_t maxReaders = std::max<size_t>(1, std::thread::hardware_concurrency());
+    for (size_t readers = 1; readers <= maxReaders; readers *= 2) {
+        benchContention(readers, false, 1000);
+        benchContention(readers, true, 1000);
+    }
+    return 0;
+}
@@ -0,0 +1,227 @@
+#include <iostream>
+#include <string>
+#include <vector>
+#include <iomanip>
+#include <chrono>
+#include <cstdlib>
+#include <atomic>
+#include <thread>
+#include <shared_mutex>
+#include <algorithm>
+#include <unordered_map>
+#include <unistd.h>
+#include "include/schema/schema.hpp"
+#include "include/storage/bTreeIndex.hpp"
+#include "include/storage/hashIndex.hpp"
+
+// Keys 0 .. count-1 in a scrambled order: a prime multiplier permutes them
+// for any count below it
+int64_t scrambled(uint64_t i, uint64_t count) {
+    return static_cast<int64_t>((i % count) * 2654435761ull % count);
+}
+
+void benchBuild(bTreeIndex& index, size_t keys) {
+    auto start = std::chrono::steady_clock::now();
+    size_t failed = 0;
+    for (size_t i = 0; i < keys; i++) {
+        int64_t key = scrambled(i, keys);
+        failed += index.insert(Value::integer(key), {static_cast<uint32_t>(key >> 8), static_cast<uint16_t>(key & 0xFF)}) != indexStatus::OK;
+    }
+    index.flush();
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+    std::cout << "insert " << keys << " keys (random order) | " << std::fixed << std::setprecision(2) << std::setw(8)
+              << elapsed.count() << " s | " << std::setprecision(2) << keys / elapsed.count() / 1e6 << " M/s"
+              << " | height: " << index.height() << " | failed: " << failed << std::endl;
+}
+
+// Point lookups from several threads, optionally with a thread inserting
+// new keys into the same tree: lock-free descents vs the same operations
+// under a reader-writer lock
+void benchLookups(bTreeIndex& index, size_t keys, size_t threads, bool withWriter) {
+    static uint64_t nextWrite = 0; // new keys are negative, so lookups keep hitting
+    std::shared_mutex treeMutex;
+    auto run = [&](bool optimistic) {
+        std::atomic<bool> stop{false};
+        std::atomic<uint64_t> lookups{0};
+        std::atomic<uint64_t> misses{0};
+        std::atomic<uint64_t> writes{0};
+        std::vector<std::thread> workers;
+        for (size_t t = 0; t < threads; t++) {
+            workers.emplace_back([&, t] {
+                uint64_t done = 0;
+                uint64_t missed = 0;
+                recordId rid;
+                for (uint64_t i = t * 7919; !stop.load(std::memory_order_relaxed); i++) {
+                    Value key = Value::integer(scrambled(i * 31, keys));
+                    bool found;
+                    if (optimistic) {
+                        found = index.lookup(key, rid);
+                    } else {
+                        std::shared_lock<std::shared_mutex> lock(treeMutex);
+                        found = index.lookup(key, rid);
+                    }
+                    missed += !found;
+                    done++;
+                }
+                lookups += done;
+                misses += missed;
+            });
+        }
+        if (withWriter) {
+            workers.emplace_back([&] {
+                for (uint64_t i = 0; !stop.load(std::memory_order_relaxed); i++) {
+                    Value key = Value::integer(-1 - static_cast<int64_t>(nextWrite++));
+                    if (optimistic) {
+                        index.insert(key, {0, 0});
+                    } else {
+                        std::unique_lock<std::shared_mutex> lock(treeMutex);
+                        index.insert(key, {0, 0});
+                    }
+                    writes++;
+                }
+            });
+        }
+        auto start = std::chrono::steady_clock::now();
+        std::this_thread::sleep_for(std::chrono::milliseconds(500));
+        stop = true;
+        for (auto& worker : workers) worker.join();
+        std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+
+        std::cout << (optimistic ? "optimistic   " : "shared_mutex ") << "| readers: " << std::setw(2) << threads
+                  << " | writer: " << (withWriter ? "yes" : "no ") << " | " << std::fixed << std::setprecision(2)
+                  << std::setw(6) << lookups.load() / elapsed.count() / 1e6 << " M lookups/s"
+                  << " | " << std::setw(6) << writes.load() / elapsed.count() / 1e3 << " K inserts/s"
+                  << " | misses: " << misses.load() << std::endl;
+    };
+    run(true);
+    run(false);
+}
+
+void benchRanges(const bTreeIndex& index, size_t keys, size_t width, size_t scans) {
+    auto start = std::chrono::steady_clock::now();
+    uint64_t rows = 0;
+    recordId rid;
+    for (size_t i = 0; i < scans; i++) {
+        int64_t low = scrambled(i * 131 + 1, keys - width);
+        bTreeScan scan(index, Value::integer(low), true, Value::integer(low + static_cast<int64_t>(width) - 1), true);
+        while (scan.next(rid)) rows++;
+    }
+    std::chrono::duration<double, std::micro> elapsed = std::chrono::steady_clock::now() - start;
+    std::cout << "BETWEEN, " << std::setw(7) << width << " keys | " << std::fixed << std::setprecision(2) << std::setw(9)
+              << elapsed.count() / scans << " us/scan | " << std::setw(7) << rows / elapsed.count() << " M rows/s"
+              << " | rows: " << rows << std::endl;
+}
+
+// Build the hash index, timing every insert: linear hashing splits one
+// bucket per insert, where a rehashing table stops to move every entry
+void benchHashBuild(hashIndex& index, size_t keys) {
+    using clock = std::chrono::steady_clock;
+    auto timeInserts = [keys](const char* name, auto&& insert) {
+        std::chrono::nanoseconds worst{0};
+        size_t slow = 0;
+        auto start = clock::now();
+        for (size_t i = 0; i < keys; i++) {
+            int64_t key = scrambled(i, keys);
+            auto before = clock::now();
+            insert(key);
+            auto took = std::chrono::duration_cast<std::chrono::nanoseconds>(clock::now() - before);
+            worst = std::max(worst, took);
+            slow += took > std::chrono::microseconds(100);
+        }
+        std::chrono::duration<double> elapsed = clock::now() - start;
+        std::cout << name << " | " << std::fixed << std::setprecision(2) << std::setw(6) << elapsed.count() << " s | "
+                  << std::setw(5) << keys / elapsed.count() / 1e6 << " M/s | slowest insert: " << std::setw(9)
+                  << worst.count() / 1e3 << " us | over 100 us: " << slow << std::endl;
+    };
+    timeInserts("hashIndex (linear hashing)   ", [&index](int64_t key) {
+        index.insert(Value::integer(key), {static_cast<uint32_t>(key >> 8), static_cast<uint16_t>(key & 0xFF)});
+    });
+    std::unordered_map<int64_t, recordId> rehashing;
+    timeInserts("std::unordered_map (rehashes)", [&rehashing](int64_t key) {
+        rehashing.emplace(key, recordId{static_cast<uint32_t>(key >> 8), static_cast<uint16_t>(key & 0xFF)});
+    });
+    std::cout << "buckets: " << index.bucketCount() << " for " << index.size() << " keys" << std::endl;
+}
+
+// WHERE key = literal one at a time, then foreign key checks: batches of
+// 1024 probes, a quarter of them for keys past the end (the lookup phase's
+// writers added negative keys to the tree)
+void benchEquality(const bTreeIndex& tree, const hashIndex& hash, size_t keys) {
+    const size_t lookups = 2000000;
+    auto timeLookups = [&](const char* name, auto&& find) {
+        size_t hits = 0;
+        auto start = std::chrono::steady_clock::now();
+        for (size_t i = 0; i < lookups; i++) hits += find(Value::integer(scrambled(i * 31, keys)));
+        std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+        std::cout << "point  " << name << " | " << std::fixed << std::setprecision(2) << std::setw(6)
+                  << lookups / elapsed.count() / 1e6 << " M lookups/s | hits: " << hits << std::endl;
+    };
+    timeLookups("B+tree", [&tree](const Value& key) {
+        recordId rid;
+        return tree.lookup(key, rid);
+    });
+    std::vector<recordId> rids;
+    timeLookups("hash  ", [&hash, &rids](const Value& key) {
+        rids.clear();
+        return hash.find(key, rids) > 0;
+    });
+
+    std::vector<Value> batch(1024);
+    std::vector<uint64_t> found(batch.size() / 64);
+    auto timeProbes = [&](const char* name, const keyLookup& existing) {
+        size_t hits = 0;
+        auto start = std::chrono::steady_clock::now();
+        for (size_t first = 0; first < lookups; first += batch.size()) {
+            for (size_t i = 0; i < batch.size(); i++) {
+                int64_t key = scrambled((first + i) * 17, keys);
+                batch[i] = Value::integer(i % 4 == 0 ? static_cast<int64_t>(keys) + key : key);
+            }
+            std::fill(found.begin(), found.end(), 0);
+            existing.probe(batch.data(), batch.size(), found.data());
+            for (uint64_t word : found) hits += __builtin_popcountll(word);
+        }
+        std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+        std::cout << "FK     " << name << " | " << std::fixed << std::setprecision(2) << std::setw(6)
+                  << lookups / elapsed.count() / 1e6 << " M probes/s  | hits: " << hits << std::endl;
+    };
+    timeProbes("B+tree", tree);
+    timeProbes("hash  ", hash);
+}
+
+int main(int argc, char** argv) {
+    size_t keys = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 10000000;
+    std::string path = argc > 2 ? argv[2] : "bench_index.idx";
+
+    Table table;
+    table.name = "keys";
+    table.addColumn({"id", "INT", true, true, true});
+    ::unlink(path.c_str());
+
+    // Enough frames for the whole tree: lookups measure the tree, not the disk
+    bufferPool pool(65536);
+    bTreeIndex index(path, table.columns[0], pool);
+    if (!index.isOpen()) return 1;
+
+    std::cout << "=== BUILD ===" << std::endl;
+    benchBuild(index, keys);
+
+    std::cout << "\n=== POINT LOOKUPS ===" << std::endl;
+    size_t maxThreads = std::max<size_t>(1, std::thread::hardware_concurrency());
+    for (size_t threads = 1; threads <= maxThreads; threads *= 2) {
+        benchLookups(index, keys, threads, false);
+        benchLookups(index, keys, threads, true);
+    }
+
+    std::cout << "\n=== RANGE SCANS ===" << std::endl;
+    benchRanges(index, keys, 1, 200000);
+    benchRanges(index, keys, 100, 50000);
+    benchRanges(index, keys, 10000, 1000);
+    benchRanges(index, keys, keys / 100, 10);
+
+    std::cout << "\n=== HASH INDEX ===" << std::endl;
+    hashIndex hash(table.columns[0]);
+    benchHashBuild(hash, keys);
+    benchEquality(index, hash, keys);
+
+    return 0;
+}
@@ -0,0 +1,162 @@
+#include <iostream>
+#include <string>
+#include <vector>
+#include <iomanip>
+#include <chrono>
+#include <cstdlib>
+#include <new>
+#include <algorithm>
+#include <unordered_map>
+#include "include/parser/lexer.hpp"
+#include "include/parser/keywordTable.hpp"
+#include "include/parser/simdScan.hpp"
+#include "include/common/token.hpp"
+
+// Global allocation counter so each run can report allocations per token
+static size_t allocationCount = 0;
+
+void* operator new(std::size_t size) {
+    allocationCount++;
+    if (void* p = std::malloc(size ? size : 1)) return p;
+    throw std::bad_alloc();
+}
+
+void operator delete(void* p) noexcept { std::free(p); }
+void operator delete(void* p, std::size_t) noexcept { std::free(p); }
+
+// Build a generated bulk INSERT script similar to our dump files
+std::string buildInsertScript(size_t rows) {
+    std::string script;
+    script.reserve(rows * 160);
+    for (size_t i = 0; i < rows; i++) {
+        script += "INSERT INTO users (id, name, email, age, created, bio) VALUES (";
+        script += std::to_string(i);
+        script += ", 'user_" + std::to_string(i) + "', 'user" + std::to_string(i) + "@example.com', ";
+        script += std::to_string(18 + i % 60);
+        script += ", '2023-12-25', 'Lorem ipsum dolor sit amet, consectetur adipiscing elit');\n";
+    }
+    return script;
+}
+
+struct BenchResult {
+    size_t tokens = 0;
+    size_t allocations = 0;
+    double millis = 0;
+};
+
+template <typename Fn>
+BenchResult runBench(Fn&& fn) {
+    BenchResult result;
+    size_t before = allocationCount;
+    auto start = std::chrono::steady_clock::now();
+    result.tokens = fn();
+    auto end = std::chrono::steady_clock::now();
+    result.allocations = allocationCount - before;
+    result.millis = std::chrono::duration<double, std::milli>(end - start).count();
+    return result;
+}
+
+void printResult(const std::string& name, const BenchResult& r, size_t bytes) {
+    std::cout << std::left << std::setw(22) << name
+              << " | tokens: " << std::setw(9) << r.tokens
+              << " | allocs/token: " << std::setw(8) << std::fixed << std::setprecision(3)
+              << (r.tokens ? double(r.allocations) / r.tokens : 0.0)
+              << " | " << std::setw(9) << std::setprecision(1) << r.millis << " ms"
+              << " | " << std::setprecision(1) << (bytes / 1048576.0) / (r.millis / 1000.0) << " MiB/s"
+              << std::endl;
+}
+
+// Previous classifier: upper-case copy, then probe each map in turn
+struct LegacyClassifier {
+    std::unordered_map<std::string, TokenType> operators, punctuation, constraints, keywords, datatypes;
+
+    LegacyClassifier() {
+        for (const auto& entry : keyword_entries) {
+            std::string name(entry.name);
+            switch (entry.type) {
+                case TokenType::OPERATOR:    operators[name] = entry.type; break;
+                case TokenType::PUNCTUATION: punctuation[name] = entry.type; break;
+                case TokenType::CONSTRAINT:  constraints[name] = entry.type; break;
+                case TokenType::DATATYPE:    datatypes[name] = entry.type; break;
+                default:                     keywords[name] = entry.type; break;
+            }
+        }
+    }
+
+    TokenType classify(const std::string& token) const {
+        std::string upper = token;
+        std::transform(upper.begin(), upper.end(), upper.begin(), ::toupper);
+        if (operators.count(token)) return TokenType::OPERATOR;
+        if (punctuation.count(token)) return TokenType::PUNCTUATION;
+        if (constraints.count(upper)) return TokenType::CONSTRAINT;
+        if (keywords.count(upper)) return TokenType::KEYWORD;
+        if (datatypes.count(upper)) return TokenType::DATATYPE;
+        return TokenType::IDENTIFIER;
+    }
+};
+
+void benchClassification(const std::vector<std::string>& words) {
+    const size_t rounds = 20;
+    LegacyClassifier legacy;
+    size_t matches = 0;
+
+    BenchResult maps = runBench([&] {
+        for (size_t r = 0; r < rounds; r++)
+            for (const auto& word : words) matches += legacy.classify(word) != TokenType::IDENTIFIER;
+        return words.size() * rounds;
+    });
+
+    BenchResult table = runBench([&] {
+        for (size_t r = 0; r < rounds; r++)
+            for (const auto& word : words) matches += lookupKeyword(word) != nullptr;
+        return words.size() * rounds;
+    });
+
+    for (const auto& [name, r] : {std::pair<const char*, BenchResult>{"five unordered_maps", maps},
+                                  std::pair<const char*, BenchResult>{"perfect hash table", table}}) {
+        std::cout << std::left << std::setw(22) << name
+                  << " | lookups: " << std::setw(9) << r.tokens
+                  << " | allocs/lookup: " << std::setw(7) << std::fixed << std::setprecision(3)
+                  << double(r.allocations) / r.tokens
+                  << " | " << std::setprecision(2) << r.millis * 1e6 / r.tokens << " ns/lookup" << std::endl;
+    }
+    std::cout << "(matched " << matches << ")" << std::endl;
+}
+
+int main(int argc, char** argv) {
+    size_t rows = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 50000;
+    std::string script = buildInsertScript(rows);
+
+    std::cout << "=== LEXER BENCHMARK ===" << std::endl;
+    std::cout << "Script: " << rows << " INSERT rows, " << script.size() / 1024 << " KiB" << std::endl;
+    std::cout << std::string(90, '-') << std::endl;
+
+    lexer lex;
+    BenchResult owned = runBench([&] { return lex.tokenize(script).size(); });
+    printResult("tokenize (Token)", owned, script.size());
+
+    BenchResult views = runBench([&] { return lex.tokenizeView(script).size(); });
+    printResult("tokenizeView (view)", views, script.size());
+
+    std::cout << std::string(90, '-') << std::endl;
+
+    std::cout << "\n=== SCAN LEVELS (tokenizeView) ===" << std::endl;
+    ScanLevel bestLevel = activeScanLevel();
+    for (ScanLevel level : {ScanLevel::SCALAR, ScanLevel::SSE2, ScanLevel::AVX2}) {
+        forceScanLevel(level);
+        if (activeScanLevel() != level) continue; // not supported on this CPU
+        BenchResult r = runBench([&] { return lex.tokenizeView(script).size(); });
+        printResult(scanLevelName(level), r, script.size());
+    }
+    forceScanLevel(bestLevel);
+
+    std::cout << "\n=== TOKEN CLASSIFICATION MICROBENCHMARK ===" << std::endl;
+    std::vector<std::string> words;
+    for (const auto& token : lex.tokenizeView(script.substr(0, 1 << 20))) {
+        if (token.type != TokenType::STRING && token.type != TokenType::DATE) {
+            words.emplace_back(token.text);
+        }
+    }
+    benchClassification(words);
+    return 0;
+}
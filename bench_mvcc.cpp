@@ -0,0 +1,196 @@
+#include <iostream>
+#include <string>
+#include <vector>
+#include <iomanip>
+#include <chrono>
+#include <cstdlib>
+#include <atomic>
+#include <random>
+#include <shared_mutex>
+#include <thread>
+#include "include/storage/recoveryManager.hpp"
+#include "include/storage/transactionManager.hpp"
+
+constexpr int64_t ACCOUNTS = 20000;
+constexpr size_t WRITERS = 4;
+
+Table accounts() {
+    Table table;
+    table.name = "accounts";
+    table.addColumn({"id", "INT", true, true, true});
+    table.addColumn({"balance", "INT"});
+    table.addColumn({"note", "VARCHAR(64)"});
+    return table;
+}
+
+struct runResult {
+    uint64_t commits = 0;
+    uint64_t conflicts = 0;
+    uint64_t scans = 0;
+    uint64_t versions = 0;
+    uint64_t collected = 0;
+};
+
+void printResult(const char* mode, size_t readers, const runResult& result, double seconds) {
+    std::cout << std::left << std::setw(6) << mode << std::right << " | readers " << std::setw(2) << readers << " | "
+              << std::fixed << std::setprecision(0) << std::setw(8) << result.commits / seconds << " writer commits/s | "
+              << std::setw(6) << result.conflicts << " conflicts | " << std::setprecision(1) << std::setw(7)
+              << result.scans / seconds << " scans/s | versions " << result.versions << ", collected "
+              << result.collected << std::endl;
+}
+
+// Writers run short transactions (look an account up by id, change its
+// balance, commit) while readers sum every balance in a snapshot
+runResult runMvcc(const std::string& dir, size_t readers, double seconds) {
+    std::system(("rm -rf '" + dir + "' && mkdir -p '" + dir + "'").c_str());
+    Table table = accounts();
+    writeAheadLog log(dir + "/mvcc.log");
+    bufferPool pool(4096);
+    heapFile heap(dir + "/accounts.heap", table, pool);
+    recoveryManager recovery(log, pool);
+    recovery.attach(1, heap);
+    transactionManager manager(log);
+    versionedTable& rows = manager.manage(heap);
+
+    std::string note(40, 'n');
+    {
+        mvccTransaction txn = manager.begin();
+        for (int64_t id = 0; id < ACCOUNTS; id++) {
+            Value row[3] = {Value::integer(id), Value::integer(1000), Value::string(note)};
+            recordId rid;
+            rows.insert(txn, row, rid);
+        }
+        manager.commit(txn);
+    }
+    manager.startCollector(std::chrono::milliseconds(10), 4096);
+
+    std::atomic<bool> stop{false};
+    std::atomic<uint64_t> scans{0};
+    std::vector<std::thread> threads;
+    for (size_t w = 0; w < WRITERS; w++) {
+        threads.emplace_back([&, w] {
+            std::mt19937_64 rng(w);
+            std::vector<recordId> found;
+            std::string tuple;
+            while (!stop.load(std::memory_order_relaxed)) {
+                int64_t id = static_cast<int64_t>(rng() % ACCOUNTS);
+                mvccTransaction txn = manager.begin();
+                found.clear();
+                if (!rows.lookup(txn, 0, Value::integer(id), found) || found.empty() || !rows.get(txn, found[0], tuple)) continue;
+                int64_t balance = heap.codec().decode(tuple.data(), 1).asInt();
+                Value row[3] = {Value::integer(id), Value::integer(balance + 1), Value::string(note)};
+                if (rows.update(txn, found[0], row) == writeStatus::OK) manager.commit(txn);
+            }
+        });
+    }
+    for (size_t r = 0; r < readers; r++) {
+        threads.emplace_back([&] {
+            while (!stop.load(std::memory_order_relaxed)) {
+                mvccTransaction txn = manager.begin();
+                snapshotScan scan(rows, txn);
+                recordId rid;
+                const char* tuple;
+                uint16_t length;
+                int64_t total = 0;
+                while (scan.next(rid, tuple, length)) total += heap.codec().decode(tuple, 1).asInt();
+                if (total < ACCOUNTS * 1000) std::cerr << "Error: Snapshot lost money." << std::endl;
+                scans++;
+            }
+        });
+    }
+    std::this_thread::sleep_for(std::chrono::duration<double>(seconds));
+    stop = true;
+    for (auto& thread : threads) thread.join();
+    manager.stopCollector();
+
+    mvccStats stats = manager.stats();
+    runResult result;
+    result.commits = stats.commits - 1;
+    result.conflicts = stats.conflicts;
+    result.scans = scans;
+    result.versions = stats.versions;
+    result.collected = stats.collected;
+    return result;
+}
+
+// The same load with one reader-writer lock per table: a scan holds it
+// shared throughout, a writer holds it exclusively while changing the heap
+runResult runLocked(const std::string& dir, size_t readers, double seconds) {
+    std::system(("rm -rf '" + dir + "' && mkdir -p '" + dir + "'").c_str());
+    Table table = accounts();
+    writeAheadLog log(dir + "/locked.log");
+    bufferPool pool(4096);
+    heapFile heap(dir + "/accounts.heap", table, pool);
+    std::shared_mutex tableLock;
+
+    std::string note(40, 'n');
+    {
+        walTransaction txn = log.begin();
+        for (int64_t id = 0; id < ACCOUNTS; id++) {
+            Value row[3] = {Value::integer(id), Value::integer(1000), Value::string(note)};
+            recordId rid;
+            heap.insert(row, rid, &txn);
+        }
+        log.commit(txn);
+    }
+
+    std::atomic<bool> stop{false};
+    std::atomic<uint64_t> commits{0};
+    std::atomic<uint64_t> scans{0};
+    std::vector<std::thread> threads;
+    for (size_t w = 0; w < WRITERS; w++) {
+        threads.emplace_back([&, w] {
+            std::mt19937_64 rng(w);
+            std::string tuple;
+            while (!stop.load(std::memory_order_relaxed)) {
+                int64_t id = static_cast<int64_t>(rng() % ACCOUNTS);
+                walTransaction txn = log.begin();
+                {
+                    std::unique_lock<std::shared_mutex> lock(tableLock);
+                    recordId rid;
+                    if (!heap.index(0)->lookup(Value::integer(id), rid) || !heap.get(rid, tuple)) continue;
+                    int64_t balance = heap.codec().decode(tuple.data(), 1).asInt();
+                    Value row[3] = {Value::integer(id), Value::integer(balance + 1), Value::string(note)};
+                    heap.update(rid, row, &txn);
+                }
+                if (log.commit(txn)) commits++;
+            }
+        });
+    }
+    for (size_t r = 0; r < readers; r++) {
+        threads.emplace_back([&] {
+            while (!stop.load(std::memory_order_relaxed)) {
+                std::shared_lock<std::shared_mutex> lock(tableLock);
+                heapScan scan(heap);
+                recordId rid;
+                const char* tuple;
+                uint16_t length;
+                int64_t total = 0;
+                while (scan.next(rid, tuple, length)) total += heap.codec().decode(tuple, 1).asInt();
+                if (total < ACCOUNTS * 1000) std::cerr << "Error: Scan lost money." << std::endl;
+                scans++;
+            }
+        });
+    }
+    std::this_thread::sleep_for(std::chrono::duration<double>(seconds));
+    stop = true;
+    for (auto& thread : threads) thread.join();
+
+    runResult result;
+    result.commits = commits;
+    result.scans = scans;
+    return result;
+}
+
+int main(int argc, char** argv) {
+    double seconds = argc > 1 ? std::strtod(argv[1], nullptr) : 3.0;
+    std::string dir = argc > 2 ? argv[2] : "bench_mvcc_data";
+
+    std::cout << "=== " << WRITERS << " WRITERS, " << ACCOUNTS << " ACCOUNTS ===" << std::endl;
+    for (size_t readers : {0, 1, 2, 4, 8, 16}) {
+        printResult("mvcc", readers, runMvcc(dir, readers, seconds), seconds);
+        printResult("locked", readers, runLocked(dir, readers, seconds), seconds);
+    }
+    std::system(("rm -rf '" + dir + "'").c_str());
+    return 0;
+}
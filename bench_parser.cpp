@@ -0,0 +1,268 @@
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <iomanip>
+#include <chrono>
+#include <cstdlib>
+#include <thread>
+#include <new>
+#include <atomic>
+#include "include/parser/batchParser.hpp"
+#include "include/parser/lexer.hpp"
+#include "include/parser/parser.hpp"
+#include "include/parser/preparedStatement.hpp"
+#include "include/parser/templateCache.hpp"
+#include "include/parser/parserStats.hpp"
+#include "include/common/arena.hpp"
+
+// Global allocation counter so each run can report allocations per statement
+static std::atomic<size_t> allocationCount{0};
+
+void* operator new(std::size_t size) {
+    allocationCount.fetch_add(1, std::memory_order_relaxed);
+    if (void* p = std::malloc(size ? size : 1)) return p;
+    throw std::bad_alloc();
+}
+
+void operator delete(void* p) noexcept { std::free(p); }
+void operator delete(void* p, std::size_t) noexcept { std::free(p); }
+
+// Mixed SELECT workload shaped like our dump-replay scripts
+std::string buildSelectScript(size_t statements) {
+    std::string script;
+    for (size_t i = 0; i < statements; i++) {
+        switch (i % 3) {
+            case 0:
+                script += "SELECT id, name FROM users WHERE age > " + std::to_string(i % 90) + ";\n";
+                break;
+            case 1:
+                script += "SELECT users.name, orders.amount FROM users INNER JOIN orders ON users.id = orders.user_id "
+                          "WHERE orders.amount >= " + std::to_string(i) + " AND users.name LIKE 'A%' ORDER BY users.name DESC LIMIT 10;\n";
+                break;
+            default:
+                script += "SELECT COUNT(*) FROM orders GROUP BY user_id HAVING COUNT(*) > 1;\n";
+                break;
+        }
+    }
+    return script;
+}
+
+// Silence parser progress output while timing
+struct QuietStdout {
+    std::ostringstream sink;
+    std::streambuf* saved;
+    QuietStdout() : saved(std::cout.rdbuf(sink.rdbuf())) {}
+    ~QuietStdout() { std::cout.rdbuf(saved); }
+};
+
+void benchBatchParse(const std::string& script) {
+    std::vector<std::string_view> statements = splitStatements(script);
+    std::cout << "Statements: " << statements.size() << std::endl;
+
+    double baseline = 0;
+    size_t maxThreads = std::max<size_t>(4, std::thread::hardware_concurrency());
+    for (size_t threads = 1; threads <= maxThreads; threads *= 2) {
+        batchParser pool(threads);
+        std::chrono::duration<double, std::milli> elapsed;
+        size_t okCount = 0;
+        {
+            QuietStdout quiet;
+            auto start = std::chrono::steady_clock::now();
+            std::vector<parsedStatement> results = pool.parseStatements(statements);
+            elapsed = std::chrono::steady_clock::now() - start;
+            for (const auto& r : results) okCount += r.ok;
+        }
+        if (threads == 1) baseline = elapsed.count();
+        std::cout << "threads: " << std::setw(3) << threads
+                  << " | " << std::fixed << std::setprecision(1) << std::setw(8) << elapsed.count() << " ms"
+                  << " | " << std::setw(10) << std::setprecision(0) << statements.size() / (elapsed.count() / 1000.0) << " stmt/s"
+                  << " | speedup " << std::setprecision(2) << baseline / elapsed.count()
+                  << " | parsed ok: " << okCount << std::endl;
+    }
+}
+
+// Parse pre-lexed statements repeatedly, with heap nodes vs a reused arena
+void benchArenaParse(const std::string& script) {
+    lexer lex;
+    std::vector<std::vector<Token>> tokenized;
+    for (std::string_view statement : splitStatements(script)) {
+        tokenized.push_back(lex.tokenize(statement));
+    }
+
+    for (bool useArena : {false, true}) {
+        arena mem;
+        parser pars;
+        pars.nodeArena = useArena ? &mem : nullptr;
+
+        size_t allocations = 0;
+        std::chrono::duration<double, std::milli> elapsed{};
+        {
+            QuietStdout quiet;
+            size_t before = allocationCount.load();
+            auto start = std::chrono::steady_clock::now();
+            for (const auto& tokens : tokenized) {
+                astNode* root = astNode::create("ROOT", "ROOT", pars.nodeArena);
+                pars.itr = Iterator();
+                pars.parse(tokens, root);
+                if (useArena) {
+                    mem.reset();
+                } else {
+                    astNode::destroy(root);
+                }
+            }
+            elapsed = std::chrono::steady_clock::now() - start;
+            allocations = allocationCount.load() - before;
+        }
+
+        std::cout << std::left << std::setw(14) << (useArena ? "arena AST" : "heap AST")
+                  << " | " << std::fixed << std::setprecision(1) << std::setw(8) << elapsed.count() << " ms"
+                  << " | allocs/stmt: " << std::setprecision(2) << double(allocations) / tokenized.size()
+                  << " | arena blocks: " << mem.blockCount() << std::endl;
+    }
+}
+
+// Same few statement shapes executed over and over: re-lex and re-parse on
+// every call vs prepare once and bind per call
+void benchPrepared(size_t executions) {
+    std::vector<std::string> shapes;
+    for (size_t i = 0; i < 300; i++) {
+        shapes.push_back("SELECT id, name FROM users_" + std::to_string(i) + " WHERE age > ? AND name LIKE ? LIMIT 10");
+    }
+
+    std::chrono::duration<double, std::milli> reparse{};
+    {
+        QuietStdout quiet;
+        lexer lex;
+        arena mem;
+        parser pars;
+        pars.nodeArena = &mem;
+        auto start = std::chrono::steady_clock::now();
+        for (size_t i = 0; i < executions; i++) {
+            std::vector<Token> tokens = lex.tokenize(shapes[i % shapes.size()]);
+            astNode* root = astNode::create("ROOT", "ROOT", &mem);
+            pars.itr = Iterator();
+            pars.parse(tokens, root);
+            mem.reset();
+        }
+        reparse = std::chrono::steady_clock::now() - start;
+    }
+
+    preparedStatementCache cache(512);
+    std::chrono::duration<double, std::milli> prepared{};
+    size_t boundCount = 0;
+    {
+        QuietStdout quiet;
+        auto start = std::chrono::steady_clock::now();
+        for (size_t i = 0; i < executions; i++) {
+            boundStatement bound;
+            std::vector<Value> values;
+            values.reserve(2);
+            values.push_back(Value::integer(static_cast<int64_t>(i % 90)));
+            values.push_back(Value::string("A%"));
+            boundCount += cache.execute(shapes[i % shapes.size()], std::move(values), bound);
+        }
+        prepared = std::chrono::steady_clock::now() - start;
+    }
+
+    std::cout << "reparse each call | " << std::fixed << std::setprecision(1) << std::setw(8) << reparse.count() << " ms" << std::endl;
+    std::cout << "prepare + bind    | " << std::setw(8) << prepared.count() << " ms"
+              << " | bound: " << boundCount << " | hits: " << cache.hits() << " misses: " << cache.misses()
+              << " evictions: " << cache.evictions() << std::endl;
+}
+
+// Literal-inlined ad-hoc SQL: parse every statement vs fingerprint + bind
+void benchTemplateCache(const std::string& script) {
+    lexer lex;
+    std::vector<std::vector<Token>> tokenized;
+    for (std::string_view statement : splitStatements(script)) {
+        tokenized.push_back(lex.tokenize(statement));
+    }
+
+    std::chrono::duration<double, std::milli> reparse{};
+    {
+        QuietStdout quiet;
+        arena mem;
+        parser pars;
+        pars.nodeArena = &mem;
+        auto start = std::chrono::steady_clock::now();
+        for (const auto& tokens : tokenized) {
+            astNode* root = astNode::create("ROOT", "ROOT", &mem);
+            pars.itr = Iterator();
+            pars.parse(tokens, root);
+            mem.reset();
+        }
+        reparse = std::chrono::steady_clock::now() - start;
+    }
+
+    templateCache cache;
+    std::chrono::duration<double, std::milli> cached{};
+    {
+        QuietStdout quiet;
+        boundStatement bound;
+        auto start = std::chrono::steady_clock::now();
+        for (const auto& tokens : tokenized) {
+            cache.execute(tokens, bound);
+        }
+        cached = std::chrono::steady_clock::now() - start;
+    }
+
+    std::cout << "parse every statement | " << std::fixed << std::setprecision(1) << std::setw(8) << reparse.count() << " ms" << std::endl;
+    std::cout << "fingerprint + bind    | " << std::setw(8) << cached.count() << " ms"
+              << " | templates: " << cache.size() << " | hits: " << cache.hits()
+              << " misses: " << cache.misses() << " bypassed: " << cache.bypassed() << std::endl;
+    for (const templateStats& entry : cache.stats()) {
+        std::cout << "  " << std::setw(7) << entry.executions << " x "
+                  << std::setprecision(0) << std::setw(6) << double(entry.totalNanos) / entry.executions << " ns | "
+                  << entry.text.substr(0, 70) << std::endl;
+    }
+}
+
+// Parse the script once with clause timing on and dump the counters
+void benchParserCounters(const std::string& script) {
+    lexer lex;
+    std::vector<std::vector<Token>> tokenized;
+    for (std::string_view statement : splitStatements(script)) {
+        tokenized.push_back(lex.tokenize(statement));
+    }
+
+    for (bool timing : {false, true}) {
+        parserStats::setTimingEnabled(timing);
+        arena mem;
+        parser pars;
+        pars.nodeArena = &mem;
+        auto start = std::chrono::steady_clock::now();
+        for (const auto& tokens : tokenized) {
+            astNode* root = astNode::create("ROOT", "ROOT", &mem);
+            pars.itr = Iterator();
+            pars.parse(tokens, root);
+            mem.reset();
+        }
+        std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - start;
+        std::cout << "clause timing " << (timing ? "on " : "off") << " | " << std::fixed << std::setprecision(1)
+                  << std::setw(8) << elapsed.count() << " ms" << std::endl;
+    }
+    parserStats::setTimingEnabled(false);
+    parserStats::dump();
+}
+
+int main(int argc, char** argv) {
+    size_t statements = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 30000;
+    std::string script = buildSelectScript(statements);
+
+    std::cout << "=== PARALLEL BATCH PARSE ===" << std::endl;
+    benchBatchParse(script);
+
+    std::cout << "\n=== AST ALLOCATION (heap vs arena) ===" << std::endl;
+    benchArenaParse(script);
+
+    std::cout << "\n=== PREPARED STATEMENTS (reparse vs prepare once) ===" << std::endl;
+    benchPrepared(statements * 10);
+
+    std::cout << "\n=== TEMPLATE CACHE (literal-inlined SQL) ===" << std::endl;
+    benchTemplateCache(script);
+
+    std::cout << "\n=== PARSER COUNTERS ===" << std::endl;
+    benchParserCounters(script);
+    return 0;
+}
@@ -0,0 +1,403 @@
+#include <iostream>
+#include <string>
+#include <vector>
+#include <iomanip>
+#include <chrono>
+#include <cstdlib>
+#include <atomic>
+#include <thread>
+#include <algorithm>
+#include <unistd.h>
+#include "include/schema/schema.hpp"
+#include "include/storage/heapFile.hpp"
+#include "include/storage/paxFile.hpp"
+
+Table ordersTable() {
+    Table table;
+    table.name = "orders";
+    table.addColumn({"id", "INT", true, true, true});
+    table.addColumn({"customer", "VARCHAR(16)", false, false, true});
+    table.addColumn({"amount", "DOUBLE", false, false, false});
+    table.addColumn({"placed", "DATE", false, false, false});
+    table.addColumn({"flag", "BOOLEAN", false, false, false});
+    return table;
+}
+
+// Bulk load rows into a fresh heap file, then scan it back
+void benchLoadAndScan(size_t rows, const std::string& path) {
+    Table table = ordersTable();
+    bufferPool pool(1024);
+    ::unlink(path.c_str());
+    ::unlink((path + ".fsm").c_str());
+    ::unlink((path + ".id.idx").c_str()); // the PRIMARY KEY's index
+
+    std::vector<std::string> customers;
+    for (size_t i = 0; i < 5000; i++) customers.push_back("customer_" + std::to_string(i));
+
+    double expected = 0;
+    std::chrono::duration<double> load{};
+    std::chrono::duration<double, std::milli> flush{};
+    uint32_t pages = 0;
+    {
+        heapFile file(path, table, pool);
+        if (!file.isOpen()) return;
+
+        auto start = std::chrono::steady_clock::now();
+        Value row[5];
+        recordId rid;
+        for (size_t i = 0; i < rows; i++) {
+            double amount = static_cast<double>(i % 10000) * 0.25;
+            row[0] = Value::integer(static_cast<int64_t>(i));
+            row[1] = Value::string(customers[i % customers.size()]);
+            row[2] = i % 100 == 0 ? Value::null() : Value::real(amount);
+            row[3] = Value::date(static_cast<int32_t>(18000 + i % 3650));
+            row[4] = Value::boolean(i % 3 == 0);
+            if (!file.insert(row, rid)) return;
+            if (i % 100 != 0) expected += amount;
+        }
+        load = std::chrono::steady_clock::now() - start;
+
+        start = std::chrono::steady_clock::now();
+        file.flush();
+        flush = std::chrono::steady_clock::now() - start;
+        pages = file.pageCount();
+    }
+
+    // Reopen, so the scan reads from the file and the map comes from its sidecar
+    auto start = std::chrono::steady_clock::now();
+    heapFile file(path, table, pool);
+    std::chrono::duration<double, std::milli> open = std::chrono::steady_clock::now() - start;
+
+    start = std::chrono::steady_clock::now();
+    heapScan scan(file);
+    recordId rid;
+    const char* tuple;
+    uint16_t length;
+    size_t scanned = 0;
+    double sum = 0;
+    const tupleCodec& codec = file.codec();
+    while (scan.next(rid, tuple, length)) {
+        Value amount = codec.decode(tuple, 2);
+        if (!amount.isNull()) sum += amount.asDouble();
+        scanned++;
+    }
+    std::chrono::duration<double> scanTime = std::chrono::steady_clock::now() - start;
+
+    double megabytes = static_cast<double>(pages) * PAGE_SIZE / (1024.0 * 1024.0);
+    std::cout << "rows: " << rows << " | pages: " << pages << " (" << std::fixed << std::setprecision(1)
+              << megabytes << " MiB, " << static_cast<double>(rows) / pages << " rows/page)" << std::endl;
+    std::cout << "insert            | " << std::setw(9) << rows / load.count() / 1e6 << " M rows/s" << std::endl;
+    std::cout << "flush + fsync     | " << std::setw(9) << flush.count() << " ms" << std::endl;
+    std::cout << "reopen            | " << std::setw(9) << open.count() << " ms" << std::endl;
+    std::cout << "scan + decode     | " << std::setw(9) << scanned / scanTime.count() / 1e6 << " M rows/s"
+              << " | " << megabytes / scanTime.count() << " MiB/s"
+              << " | rows: " << scanned << " | sum ok: " << (sum == expected) << std::endl;
+
+    ::unlink(path.c_str());
+    ::unlink((path + ".fsm").c_str());
+    ::unlink((path + ".id.idx").c_str());
+}
+
+// Point lookups on a hot set of pages with a full table scan after every
+// batch; the scan touches several times the pool's capacity
+void benchBufferPool(size_t rows, const std::string& path, evictionPolicy policy) {
+    Table table = ordersTable();
+    ::unlink(path.c_str());
+    ::unlink((path + ".fsm").c_str());
+    ::unlink((path + ".id.idx").c_str());
+
+    bufferPool pool(4096, policy);
+    heapFile file(path, table, pool);
+    if (!file.isOpen()) return;
+
+    std::vector<recordId> hot;
+    Value row[5];
+    recordId rid;
+    for (size_t i = 0; i < rows; i++) {
+        row[0] = Value::integer(static_cast<int64_t>(i));
+        row[1] = Value::string("customer");
+        row[2] = Value::real(static_cast<double>(i));
+        row[3] = Value::date(18000);
+        row[4] = Value::boolean(true);
+        if (!file.insert(row, rid)) return;
+        if (rid.page < 2048) hot.push_back(rid);
+    }
+    file.flush();
+    pool.resetStats();
+
+    const size_t rounds = 10;
+    const size_t lookupsPerRound = 10000;
+    uint64_t lookupHits = 0;
+    uint64_t lookupMisses = 0;
+    std::chrono::duration<double, std::milli> lookupTime{};
+    std::chrono::duration<double, std::milli> scanTime{};
+    uint64_t seed = 42;
+    std::string tuple;
+    size_t found = 0;
+    for (size_t round = 0; round < rounds; round++) {
+        bufferPoolStats before = pool.stats();
+        auto start = std::chrono::steady_clock::now();
+        for (size_t i = 0; i < lookupsPerRound; i++) {
+            seed = seed * 6364136223846793005ull + 1442695040888963407ull;
+            found += file.get(hot[(seed >> 33) % hot.size()], tuple);
+        }
+        lookupTime += std::chrono::steady_clock::now() - start;
+        bufferPoolStats after = pool.stats();
+        if (round > 0) { // the first round only warms the pool
+            lookupHits += after.hits - before.hits;
+            lookupMisses += after.misses - before.misses;
+        }
+
+        start = std::chrono::steady_clock::now();
+        heapScan scan(file);
+        const char* data;
+        uint16_t length;
+        while (scan.next(rid, data, length)) found++;
+        scanTime += std::chrono::steady_clock::now() - start;
+    }
+    bufferPoolStats total = pool.stats();
+
+    // Same mix with lookups and scans on separate threads
+    size_t lookupThreads = std::max<size_t>(1, std::thread::hardware_concurrency());
+    std::atomic<bool> stop{false};
+    std::atomic<uint64_t> concurrentLookups{0};
+    std::vector<std::thread> threads;
+    for (size_t t = 0; t < lookupThreads; t++) {
+        threads.emplace_back([&, t] {
+            uint64_t state = t + 1;
+            uint64_t done = 0;
+            std::string copy;
+            while (!stop.load(std::memory_order_relaxed)) {
+                state = state * 6364136223846793005ull + 1442695040888963407ull;
+                file.get(hot[(state >> 33) % hot.size()], copy);
+                done++;
+            }
+            concurrentLookups += done;
+        });
+    }
+    threads.emplace_back([&] {
+        while (!stop.load(std::memory_order_relaxed)) {
+            heapScan scan(file);
+            recordId scanned;
+            const char* data;
+            uint16_t length;
+            while (!stop.load(std::memory_order_relaxed) && scan.next(scanned, data, length)) {}
+        }
+    });
+    std::this_thread::sleep_for(std::chrono::milliseconds(500));
+    stop = true;
+    for (auto& thread : threads) thread.join();
+
+    std::cout << (policy == evictionPolicy::LRU ? "LRU " : "2Q  ") << "| pages: " << file.pageCount()
+              << " | frames: " << pool.frameCount() << " | hot pages: 2048" << std::endl;
+    std::cout << "  lookups         | " << std::fixed << std::setprecision(2) << std::setw(9)
+              << lookupTime.count() / (rounds * lookupsPerRound) * 1000.0 << " us"
+              << " | hit ratio after warm-up: " << std::setprecision(3)
+              << double(lookupHits) / double(lookupHits + lookupMisses) << std::endl;
+    std::cout << "  scans           | " << std::setprecision(2) << std::setw(9) << scanTime.count() / rounds << " ms"
+              << " | evictions: " << total.evictions << " | write-backs: " << total.writeBacks
+              << " | overall hit ratio: " << std::setprecision(3) << total.hitRatio() << std::endl;
+    std::cout << "  with scan thread| " << std::setprecision(2) << std::setw(9) << concurrentLookups.load() / 0.5 / 1e6
+              << " M lookups/s on " << lookupThreads << " thread(s)" << (found == 0 ? " (nothing found)" : "") << std::endl;
+
+    ::unlink(path.c_str());
+    ::unlink((path + ".fsm").c_str());
+    ::unlink((path + ".id.idx").c_str());
+}
+
+// Reporting query over 3 of 40 columns, SUM(c2) GROUP BY c1 WHERE c3 in a
+// date range, as a row scan, a PAX scan, and a PAX scan with a zone map range
+void benchPaxScan(size_t rows, const std::string& path) {
+    static const char* const types[] = {"INT", "DOUBLE", "VARCHAR(12)", "DATE"};
+    Table table;
+    table.name = "facts";
+    for (size_t c = 0; c < 40; c++) {
+        Column column;
+        column.name = "c" + std::to_string(c);
+        column.datatype = c < 2 ? "INT" : c == 2 ? "DOUBLE" : c == 3 ? "DATE" : types[c % 4];
+        table.addColumn(column);
+    }
+    std::string heapPath = path + ".rows";
+    std::string paxPath = path + ".pax";
+    ::unlink(heapPath.c_str());
+    ::unlink((heapPath + ".fsm").c_str());
+    ::unlink(paxPath.c_str());
+
+    bufferPool pool(4096);
+    std::vector<std::string> labels;
+    for (size_t i = 0; i < 1000; i++) labels.push_back("label_" + std::to_string(i));
+
+    heapFile heap(heapPath, table, pool);
+    paxFile pax(paxPath, table, pool);
+    std::vector<Value> row(table.columns.size());
+    recordId rid;
+    for (size_t i = 0; i < rows; i++) {
+        for (size_t c = 0; c < row.size(); c++) {
+            switch (table.columns[c].type) {
+                case ColumnType::INT:     row[c] = Value::integer(static_cast<int64_t>(c == 1 ? i % 16 : i + c)); break;
+                case ColumnType::DOUBLE:  row[c] = Value::real(static_cast<double>(i % 1000) * 0.5); break;
+                case ColumnType::DATE:    row[c] = Value::date(static_cast<int32_t>(18000 + (i * 7) % 3650)); break;
+                default:                  row[c] = Value::string(labels[(i + c) % labels.size()]); break;
+            }
+        }
+        row[0] = Value::integer(static_cast<int64_t>(i));
+        if (!heap.insert(row.data(), rid) || !pax.append(row.data())) return;
+    }
+    heap.flush();
+    pax.flush();
+
+    const int32_t from = 18000 + 365;
+    const int32_t to = 18000 + 730;
+    auto report = [&pool](const char* name, std::chrono::duration<double, std::milli> elapsed, const double* sums, size_t skipped) {
+        bufferPoolStats stats = pool.stats();
+        double total = 0;
+        for (size_t g = 0; g < 16; g++) total += sums[g];
+        std::cout << name << std::fixed << std::setprecision(2) << std::setw(9) << elapsed.count() << " ms"
+                  << " | pages: " << std::setw(6) << stats.hits + stats.misses
+                  << " | sum: " << std::setprecision(1) << total;
+        if (skipped) std::cout << " | blocks skipped: " << skipped;
+        std::cout << std::endl;
+    };
+
+    // Row store: every page holds every column
+    pool.resetStats();
+    double sums[16] = {};
+    auto start = std::chrono::steady_clock::now();
+    {
+        heapScan scan(heap);
+        const tupleCodec& codec = heap.codec();
+        const char* tuple;
+        uint16_t length;
+        while (scan.next(rid, tuple, length)) {
+            int32_t day = codec.decode(tuple, 3).asDate();
+            if (day < from || day > to) continue;
+            sums[codec.decode(tuple, 1).asInt()] += codec.decode(tuple, 2).asDouble();
+        }
+    }
+    report("row scan          | ", std::chrono::steady_clock::now() - start, sums, 0);
+
+    // PAX: only the three chunks
+    auto paxQuery = [&](bool zoneMap) {
+        pool.resetStats();
+        double paxSums[16] = {};
+        auto begin = std::chrono::steady_clock::now();
+        paxScan scan(pax, {1, 2, 3});
+        if (zoneMap) scan.addRange(0, Value::integer(static_cast<int64_t>(rows / 2)), Value::integer(static_cast<int64_t>(rows / 2 + rows / 100)));
+        while (scan.next()) {
+            const int64_t* group = scan.column(0).data<int64_t>();
+            const double* amount = scan.column(1).data<double>();
+            const int32_t* day = scan.column(2).data<int32_t>();
+            for (uint32_t r = 0; r < scan.rows(); r++) {
+                if (day[r] >= from && day[r] <= to) paxSums[group[r]] += amount[r];
+            }
+        }
+        report(zoneMap ? "PAX + id range    | " : "PAX 3 of 40       | ", std::chrono::steady_clock::now() - begin, paxSums, scan.blocksSkipped());
+    };
+    paxQuery(false);
+    paxQuery(true);
+
+    std::cout << "rows: " << rows << " x 40 columns | row pages: " << heap.pageCount()
+              << " | PAX blocks: " << pax.blockCount() << std::endl;
+
+    ::unlink(heapPath.c_str());
+    ::unlink((heapPath + ".fsm").c_str());
+    ::unlink(paxPath.c_str());
+}
+
+// Encoded vs plain PAX blocks: size, and a filter evaluated on the chunks
+// (dictionary codes, packed integers) instead of decoded values
+void benchCompression(size_t rows, const std::string& path) {
+    static const char* const statuses[] = {"pending", "paid", "shipped", "delivered", "returned"};
+    Table table;
+    table.name = "orders";
+    table.addColumn({"id", "INT"});
+    table.addColumn({"status", "VARCHAR(12)"});
+    table.addColumn({"country", "VARCHAR(16)"});
+    table.addColumn({"ordered", "DATE"});
+    table.addColumn({"quantity", "INT"});
+    table.addColumn({"amount", "DOUBLE"});
+
+    std::vector<std::string> countries;
+    for (size_t i = 0; i < 20; i++) countries.push_back("country_" + std::to_string(i));
+    std::vector<Value> inList = {Value::string("country_3"), Value::string("country_7"), Value::string("country_11")};
+
+    bufferPool pool(8192);
+    for (bool compress : {false, true}) {
+        std::string paxPath = path + (compress ? ".encoded" : ".plain");
+        ::unlink(paxPath.c_str());
+        paxFile pax(paxPath, table, pool);
+        pax.setCompression(compress);
+
+        uint64_t seed = 42;
+        for (size_t i = 0; i < rows; i++) {
+            seed = seed * 6364136223846793005ULL + 1442695040888963407ULL;
+            uint32_t r = static_cast<uint32_t>(seed >> 33);
+            Value row[6] = {Value::integer(static_cast<int64_t>(i)),
+                            Value::string(statuses[r % 5]),
+                            Value::string(countries[(r >> 3) % countries.size()]),
+                            Value::date(static_cast<int32_t>(18000 + i / 2000)),
+                            Value::integer(1 + (r >> 8) % 20),
+                            Value::real(static_cast<double>((r >> 12) % 100000) / 100)};
+            if (!pax.append(row)) return;
+        }
+        pax.flush();
+        size_t pages = 0;
+        for (size_t b = 0; b < pax.blockCount(); b++) pages += pax.block(b).pageCount;
+
+        // SUM(amount * quantity) WHERE status = 'shipped' AND country IN (...)
+        pool.resetStats();
+        auto start = std::chrono::steady_clock::now();
+        double total = 0;
+        size_t matched = 0;
+        paxScan scan(pax, {1, 2, 4, 5});
+        std::vector<uint64_t> matches;
+        std::vector<uint64_t> inCountry;
+        while (scan.next()) {
+            uint32_t count = scan.rows();
+            matches.resize((count + 63) / 64);
+            inCountry.resize(matches.size());
+            scan.column(0).select(compareOp::EQ, Value::string("shipped"), matches.data());
+            scan.column(1).selectIn(inList, inCountry.data());
+            const int64_t* quantity = scan.column(2).data<int64_t>();
+            const double* amount = scan.column(3).data<double>();
+            for (size_t w = 0; w < matches.size(); w++) {
+                uint64_t bits = matches[w] & inCountry[w];
+                while (bits) {
+                    size_t r = w * 64 + static_cast<size_t>(__builtin_ctzll(bits));
+                    total += amount[r] * static_cast<double>(quantity[r]);
+                    matched++;
+                    bits &= bits - 1;
+                }
+            }
+        }
+        std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - start;
+
+        std::cout << (compress ? "encoded | " : "plain   | ") << "pages: " << std::setw(6) << pages;
+        for (uint32_t c = 0; c < table.columns.size() && pax.blockCount() > 0; c++) {
+            std::cout << " " << table.columns[c].name << "=" << chunkEncodingToString(pax.block(0).chunks[c].encoding);
+        }
+        std::cout << std::endl;
+        std::cout << "        | filter + sum " << std::fixed << std::setprecision(2) << std::setw(8) << elapsed.count() << " ms"
+                  << " | rows: " << matched << " | sum: " << std::setprecision(1) << total << std::endl;
+        ::unlink(paxPath.c_str());
+    }
+}
+
+int main(int argc, char** argv) {
+    size_t rows = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 10000000;
+    std::string path = argc > 2 ? argv[2] : "bench_storage.heap";
+
+    std::cout << "=== HEAP LOAD AND SCAN ===" << std::endl;
+    benchLoadAndScan(rows, path);
+
+    std::cout << "\n=== BUFFER POOL: LOOKUPS + SCANS ===" << std::endl;
+    benchBufferPool(3000000, path, evictionPolicy::LRU);
+    benchBufferPool(3000000, path, evictionPolicy::TWO_QUEUE);
+
+    std::cout << "\n=== ROW VS PAX SCAN ===" << std::endl;
+    benchPaxScan(std::max<size_t>(rows / 10, 1), path);
+
+    std::cout << "\n=== PAX COMPRESSION ===" << std::endl;
+    benchCompression(std::max<size_t>(rows / 2, 1), path);
+    return 0;
+}
@@ -0,0 +1,60 @@
+#include <iostream>
+#include <string>
+#include <vector>
+#include <iomanip>
+#include <chrono>
+#include <cstdlib>
+#include <atomic>
+#include <thread>
+#include <unistd.h>
+#include "include/storage/writeAheadLog.hpp"
+
+// Writers each run small transactions (one 100-byte INSERT record, then
+// COMMIT) back to back for a fixed time; group commit should let many
+// commits share one fsync as the writer count grows
+void benchCommits(const std::string& path, size_t writers, std::chrono::microseconds delay, double seconds) {
+    ::unlink(path.c_str());
+    writeAheadLog log(path, writeAheadLog::DEFAULT_BUFFER, delay);
+    if (!log.isOpen()) return;
+
+    std::atomic<bool> stop{false};
+    std::atomic<size_t> failed{0};
+    std::string row(100, 'r');
+    std::vector<std::thread> threads;
+    auto start = std::chrono::steady_clock::now();
+    for (size_t w = 0; w < writers; w++) {
+        threads.emplace_back([&, w] {
+            for (uint32_t i = 0; !stop.load(std::memory_order_relaxed); i++) {
+                walTransaction txn = log.begin();
+                log.append(txn, logType::INSERT, 1, {i, static_cast<uint16_t>(w)}, {}, row);
+                if (!log.commit(txn)) failed++;
+            }
+        });
+    }
+    std::this_thread::sleep_for(std::chrono::duration<double>(seconds));
+    stop = true;
+    for (auto& thread : threads) thread.join();
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+
+    uint64_t commits = log.commitCount();
+    uint64_t syncs = log.syncCount();
+    std::cout << "writers " << std::setw(2) << writers << " | delay " << std::setw(4) << delay.count() << " us | "
+              << std::fixed << std::setprecision(0) << std::setw(8) << commits / elapsed.count() << " commits/s | "
+              << std::setw(6) << syncs << " fsyncs | " << std::setprecision(3) << static_cast<double>(syncs) / commits
+              << " fsyncs/commit | failed: " << failed << std::endl;
+}
+
+int main(int argc, char** argv) {
+    double seconds = argc > 1 ? std::strtod(argv[1], nullptr) : 3.0;
+    std::string path = argc > 2 ? argv[2] : "bench_wal.log";
+
+    for (long delay : {0L, 100L, 1000L}) {
+        std::cout << "=== COMMIT DELAY " << delay << " us ===" << std::endl;
+        for (size_t writers = 1; writers <= 32; writers *= 2) {
+            benchCommits(path, writers, std::chrono::microseconds(delay), seconds);
+        }
+        std::cout << std::endl;
+    }
+    ::unlink(path.c_str());
+    return 0;
+}
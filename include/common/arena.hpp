@@ -0,0 +1,48 @@
+#pragma once
+#include <cstddef>
+#include <memory_resource>
+
+// Bump allocator for per-statement data such as AST nodes and their strings.
+// Allocation is a pointer bump; individual deallocation is a no-op and
+// everything is released at once by reset(). After a reset the blocks are
+// kept (merged into one block if the arena had to grow), so reusing an arena
+// for similar statements reaches a steady state with no heap traffic.
+class arena : public std::pmr::memory_resource {
+public:
+    static constexpr size_t DEFAULT_BLOCK_SIZE = 8192;
+
+    explicit arena(size_t initialBlockSize = DEFAULT_BLOCK_SIZE);
+    ~arena() override;
+
+    arena(const arena&) = delete;
+    arena& operator=(const arena&) = delete;
+
+    // Forget every allocation; objects in the arena are not destroyed
+    void reset();
+
+    size_t bytesUsed() const { return used; }
+    size_t capacity() const { return totalCapacity; }
+    size_t blockCount() const { return blocks; }
+
+protected:
+    void* do_allocate(size_t bytes, size_t alignment) override;
+    void do_deallocate(void*, size_t, size_t) override {}
+    bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override { return this == &other; }
+
+private:
+    struct blockHeader {
+        blockHeader* next;
+        size_t size; // usable bytes after the header
+    };
+
+    void addBlock(size_t minSize);
+    void freeBlocks();
+
+    blockHeader* head = nullptr; // most recent block first
+    char* cursor = nullptr;
+    char* limit = nullptr;
+    size_t used = 0;
+    size_t totalCapacity = 0;
+    size_t blocks = 0;
+    size_t nextBlockSize;
+};
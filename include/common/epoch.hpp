@@ -0,0 +1,35 @@
+#pragma once
+#include <cstdint>
+#include <functional>
+
+// Epoch-based reclamation for read-mostly shared structures.
+//
+// Readers wrap each access in an epochGuard; that is one store to a
+// thread-local slot, no lock and no shared write. A writer that unpublishes
+// an object hands it to retire(); it is destroyed once every thread that
+// might still be reading it has left its guard.
+class epochReclaimer {
+public:
+    // Enter / leave a read-side critical section (nestable per thread)
+    static void enter();
+    static void exit();
+
+    // Destroy an unpublished object after all current readers are done.
+    // The object must already be unreachable for new readers.
+    static void retire(std::function<void()> destroy);
+
+    // Destroy whatever retired objects are no longer visible to any reader
+    static void reclaim();
+
+    // Objects retired but not yet destroyed
+    static size_t pending();
+};
+
+class epochGuard {
+public:
+    epochGuard() { epochReclaimer::enter(); }
+    ~epochGuard() { epochReclaimer::exit(); }
+
+    epochGuard(const epochGuard&) = delete;
+    epochGuard& operator=(const epochGuard&) = delete;
+};
@@ -1,5 +1,7 @@
 #pragma once
 #include <string>
+#include <string_view>
+#include "value.hpp"
 
 // Enum for token types - covers all possible token classifications
 enum class TokenType {
@@ -15,6 +17,7 @@ enum class TokenType {
     DOUBLE,         // Floating point: 3.14, -2.5
     STRING,         // String literals: 'hello', 'world'
     DATE,           // Date literals: '2023-12-25'
+    PARAMETER,      // Bind placeholders: ?, $1
     
     // Structure
     PUNCTUATION,    // ,;().
@@ -38,6 +41,7 @@ inline std::string tokenTypeToString(TokenType type) {
         case TokenType::DOUBLE:      return "double";
         case TokenType::STRING:      return "string";
         case TokenType::DATE:        return "date";
+        case TokenType::PARAMETER:   return "parameter";
         case TokenType::PUNCTUATION: return "punctuation";
         case TokenType::WHITESPACE:  return "whitespace";
         case TokenType::ERROR:       return "error";
@@ -58,6 +62,7 @@ inline TokenType stringToTokenType(const std::string& typeStr) {
     if (typeStr == "double") return TokenType::DOUBLE;
     if (typeStr == "string") return TokenType::STRING;
     if (typeStr == "date") return TokenType::DATE;
+    if (typeStr == "parameter") return TokenType::PARAMETER;
     if (typeStr == "punctuation") return TokenType::PUNCTUATION;
     if (typeStr == "whitespace") return TokenType::WHITESPACE;
     if (typeStr == "error") return TokenType::ERROR;
@@ -73,6 +78,7 @@ struct Token {
     size_t position;       // position in input string
     size_t line;           // line number (for error reporting)
     size_t column;         // column number (for error reporting)
+    Value literal;         // NUMBER, DOUBLE and DATE value, parsed once by the lexer
     
     Token() : type(TokenType::UNKNOWN), value(""), original(""), position(0), line(1), column(1) {}
     
@@ -92,4 +98,60 @@ struct Token {
     }
     bool isError() const { return type == TokenType::ERROR; }
     bool isEOF() const { return type == TokenType::EOF_TOKEN; }
-};
\ No newline at end of file
+
+    // Typed value of a literal token; a STRING's text is viewed (unquoted)
+    // in value, so the result must not outlive this token
+    Value literalValue() const {
+        if (type != TokenType::STRING) return literal;
+        return Value::string(std::string_view(value).substr(1, value.size() - 2));
+    }
+};
+
+// Zero-copy token that points back into the lexed input buffer.
+// Only keywords, datatypes and constraints whose spelling differs from their
+// upper-case form (and synthesized error values) own a normalized copy; every
+// other token is just an offset+length into the caller's buffer, which must
+// outlive the view.
+struct TokenView {
+    TokenType type;
+    std::string_view text;   // original slice of the input
+    std::string normalized;  // owned upper-case value, empty when text is already normalized
+    size_t position;         // offset of text in input string
+    size_t line;             // line number (for error reporting)
+    size_t column;           // column number (for error reporting)
+    Value literal;           // NUMBER, DOUBLE and DATE value, parsed once by the lexer
+
+    TokenView() : type(TokenType::UNKNOWN), position(0), line(1), column(1) {}
+
+    TokenView(TokenType t, std::string_view txt, size_t pos = 0, size_t ln = 1, size_t col = 1)
+        : type(t), text(txt), position(pos), line(ln), column(col) {}
+
+    TokenView(TokenType t, std::string_view txt, std::string norm, size_t pos = 0, size_t ln = 1, size_t col = 1)
+        : type(t), text(txt), normalized(std::move(norm)), position(pos), line(ln), column(col) {}
+
+    // Value as the parser sees it (normalized when available)
+    std::string_view value() const { return normalized.empty() ? text : std::string_view(normalized); }
+
+    // Materialize an owning Token for the existing parser interfaces
+    Token toToken() const {
+        if (normalized.empty()) {
+            Token token(type, std::string(text), position, line, column);
+            token.literal = literal;
+            return token;
+        }
+        if (type == TokenType::ERROR) {
+            return Token(type, normalized, position, line, column);
+        }
+        return Token(type, normalized, std::string(text), position, line, column);
+    }
+
+    bool isKeyword() const { return type == TokenType::KEYWORD; }
+    bool isIdentifier() const { return type == TokenType::IDENTIFIER; }
+    bool isOperator() const { return type == TokenType::OPERATOR; }
+    bool isLiteral() const {
+        return type == TokenType::NUMBER || type == TokenType::DOUBLE ||
+               type == TokenType::STRING || type == TokenType::DATE;
+    }
+    bool isError() const { return type == TokenType::ERROR; }
+    bool isEOF() const { return type == TokenType::EOF_TOKEN; }
+};
@@ -0,0 +1,41 @@
+#pragma once
+#include <sstream>
+#include <string>
+
+// Diagnostic tracing. Build with -DMINISQL_ENABLE_TRACE to compile trace
+// points in; without it every TRACE_* statement expands to nothing and its
+// arguments are never evaluated, so trace points cost nothing on hot paths.
+enum class TraceLevel {
+    OFF,
+    ERROR,  // failures, e.g. parse errors
+    INFO,   // one line per statement
+    DEBUG   // every step of the parser
+};
+
+#ifdef MINISQL_ENABLE_TRACE
+
+// Runtime threshold; defaults to DEBUG, i.e. the parser's full step-by-step output
+TraceLevel traceLevel();
+void setTraceLevel(TraceLevel level);
+
+// Write one line to std::cout; lines from different threads never interleave
+void traceWrite(const std::string& message);
+
+#define TRACE(level, message)                                              \
+    do {                                                                   \
+        if (static_cast<int>(level) <= static_cast<int>(traceLevel())) {   \
+            std::ostringstream trace_stream_;                              \
+            trace_stream_ << message;                                      \
+            traceWrite(trace_stream_.str());                               \
+        }                                                                  \
+    } while (0)
+
+#else
+
+#define TRACE(level, message) do { } while (0)
+
+#endif
+
+#define TRACE_ERROR(message) TRACE(TraceLevel::ERROR, message)
+#define TRACE_INFO(message)  TRACE(TraceLevel::INFO, message)
+#define TRACE_DEBUG(message) TRACE(TraceLevel::DEBUG, message)
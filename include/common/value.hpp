@@ -0,0 +1,106 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <iosfwd>
+#include <memory>
+#include <memory_resource>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// Runtime type of a Value; CHAR, VARCHAR and TEXT columns all hold STRING
+enum class ValueType : uint8_t {
+    NULL_VALUE,
+    INT,      // 64-bit signed
+    DOUBLE,
+    BOOLEAN,
+    DATE,     // days since 1970-01-01
+    STRING
+};
+
+const char* valueTypeToString(ValueType type);
+
+// Days since 1970-01-01 for a proleptic Gregorian date, and back
+int32_t daysFromCivil(int year, unsigned month, unsigned day);
+void civilFromDays(int32_t days, int& year, unsigned& month, unsigned& day);
+
+// One typed SQL value in 16 bytes, trivially copyable.
+//
+// Strings of up to INLINE_CAPACITY bytes are stored in the value itself.
+// Longer ones point at text owned elsewhere (the source buffer, an arena, or
+// a buffer from internStrings), which must outlive the value. Nothing here
+// allocates except the explicit arena / internStrings copies and toString().
+class Value {
+public:
+    static constexpr size_t INLINE_CAPACITY = 8;
+
+    Value() : tag(ValueType::NULL_VALUE), length(0), intValue(0) {}
+
+    static Value null() { return Value(); }
+    static Value integer(int64_t value);
+    static Value real(double value);
+    static Value boolean(bool value);
+    static Value date(int32_t days);
+    static Value date(int year, unsigned month, unsigned day) { return date(daysFromCivil(year, month, day)); }
+
+    // Inline when short, otherwise a view of text
+    static Value string(std::string_view text);
+    // Inline when short, otherwise copied into memory
+    static Value string(std::string_view text, std::pmr::memory_resource* memory);
+
+    // Parse text as a value of type, e.g. "-12", "2.5", "TRUE" or
+    // "2024-02-29" (quotes around strings and dates are stripped); false
+    // when text is not a valid literal of that type
+    static bool parse(std::string_view text, ValueType type, Value& out);
+
+    // Parse a SQL literal as the lexer spells it: 123, 1.5, 'text', '2024-01-31', TRUE, NULL
+    static bool parseLiteral(std::string_view text, Value& out);
+
+    // Copy every out-of-line string in values into one new buffer and point
+    // them at it; the buffer owns the text from then on (nullptr if none)
+    static std::unique_ptr<char[]> internStrings(std::vector<Value>& values);
+
+    ValueType type() const { return tag; }
+    bool isNull() const { return tag == ValueType::NULL_VALUE; }
+    bool isNumeric() const { return tag == ValueType::INT || tag == ValueType::DOUBLE; }
+
+    int64_t asInt() const { return intValue; }
+    double asDouble() const { return tag == ValueType::INT ? static_cast<double>(intValue) : doubleValue; }
+    bool asBool() const { return boolValue; }
+    int32_t asDate() const { return dateDays; }
+    std::string_view asString() const {
+        return std::string_view(length <= INLINE_CAPACITY ? inlineText : pointer, length);
+    }
+
+    // Total order for sorting and grouping: NULL first, INT and DOUBLE by
+    // exact numeric value with NaN above every number, strings bytewise,
+    // otherwise by type. SQL's NULL semantics are left to the caller.
+    // Returns <0, 0 or >0.
+    static int compare(const Value& left, const Value& right);
+    bool operator==(const Value& other) const { return compare(*this, other) == 0; }
+    bool operator!=(const Value& other) const { return compare(*this, other) != 0; }
+    bool operator<(const Value& other) const { return compare(*this, other) < 0; }
+
+    // Equal values hash equally, including INT 2 and DOUBLE 2.0
+    uint64_t hash() const;
+
+    // SQL spelling, e.g. 42, 'text', '2024-02-29', NULL
+    std::string toString() const;
+
+private:
+    ValueType tag;
+    uint32_t length; // STRING only
+    union {
+        int64_t intValue;
+        double doubleValue;
+        bool boolValue;
+        int32_t dateDays;
+        const char* pointer;                 // STRING longer than INLINE_CAPACITY
+        char inlineText[INLINE_CAPACITY];    // STRING up to INLINE_CAPACITY
+    };
+};
+
+static_assert(sizeof(Value) == 16, "Value should stay two words");
+
+std::ostream& operator<<(std::ostream& out, const Value& value);
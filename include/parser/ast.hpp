@@ -1,26 +1,46 @@
 #pragma once
 #include <string>
+#include <string_view>
 #include <vector>
+#include <memory_resource>
 #include <unordered_map>
 #include "../schema/schema.hpp"
+#include "../common/arena.hpp"
 
 class astNode {
 public:
-    std::string nodeType; // e.g., "SELECT", "INSERT", "TABLE", "COLUMN"
-    std::string value;    // e.g., table name, column name, etc.
-    std::string tokenType; // e.g., "keyword", "identifier", "operator"
-    std::vector<astNode*> children; // Child nodes
+    std::pmr::string nodeType; // e.g., "SELECT", "INSERT", "TABLE", "COLUMN"
+    std::pmr::string value;    // e.g., table name, column name, etc.
+    std::pmr::string tokenType; // e.g., "keyword", "identifier", "operator"
+    std::pmr::vector<astNode*> children; // Child nodes
     astNode* parent = nullptr; // Pointer to parent node
+    bool arenaOwned = false;   // Node (and its subtree) lives in an arena
 
-    astNode(const std::string& type, const std::string& val) : nodeType(type), value(val) {}
+    // Binding, filled in by validateAST
+    const Table* boundTable = nullptr;          // TABLE and COLUMN nodes
+    int32_t tableRef = -1;                      // statement-wide table id (see binder::tables())
+    int32_t columnOrdinal = -1;                 // COLUMN: ordinal in boundTable, or select-list position of an alias
+    ColumnType valueType = ColumnType::UNKNOWN; // type of the value the node produces
+    bool constant = false;                      // subtree depends on no row
 
-    void addChild(astNode* child, std::string tokenType, bool setParent = true);
+    astNode(std::string_view type, std::string_view val,
+            std::pmr::memory_resource* resource = std::pmr::new_delete_resource())
+        : nodeType(type, resource), value(val, resource), tokenType(resource), children(resource) {}
 
-    void validateAST(astNode* node, const DatabaseSchema& schema);
+    // Allocate a node on the heap, or inside mem when given; arena nodes are
+    // released in bulk by arena::reset() and must not be deleted
+    static astNode* create(std::string_view type, std::string_view val, arena* mem = nullptr);
+
+    // Release a tree from create(): deletes heap trees, no-op for arena trees
+    static void destroy(astNode* node);
+
+    void addChild(astNode* child, std::string_view tokenType = "", bool setParent = true);
+
+    // Bind node's tree against schema (see binder); false, with the reason
+    // on std::cerr, on an unknown name or a type mismatch
+    bool validateAST(astNode* node, const DatabaseSchema& schema);
 
     void print(astNode* node, int depth = 0);
 
     ~astNode();
 };
-
-
@@ -0,0 +1,63 @@
+#pragma once
+#include <atomic>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+#include "ast.hpp"
+
+// Result for one statement of a script, in script order
+struct parsedStatement {
+    std::string_view text;          // view into the script
+    std::unique_ptr<astNode> root;  // "ROOT" node holding the statement tree
+    bool ok = false;
+    std::string error;              // first parse error when !ok (see parser::error())
+};
+
+// Split a script on ';' outside string literals (quotes are matched the same
+// way lexer::tokenize matches them); whitespace-only pieces are dropped
+std::vector<std::string_view> splitStatements(std::string_view script);
+
+// Lexes and parses independent statements on a fixed pool of worker threads.
+// Each worker owns its own lexer and parser, since a parser keeps its cursor
+// (parser::itr) as mutable state. The calling thread takes part in every
+// batch, so a pool of size 1 runs everything inline.
+class batchParser {
+public:
+    explicit batchParser(size_t threadCount = std::thread::hardware_concurrency());
+    ~batchParser();
+
+    batchParser(const batchParser&) = delete;
+    batchParser& operator=(const batchParser&) = delete;
+
+    // Split and parse a whole script; the script must outlive the result views
+    std::vector<parsedStatement> parseScript(std::string_view script);
+
+    // Parse already split statements; results keep the input order
+    std::vector<parsedStatement> parseStatements(const std::vector<std::string_view>& statements);
+
+    size_t threadCount() const { return workers.size() + 1; }
+
+private:
+    // Statements claimed per fetch_add, to keep the shared counter cold
+    static constexpr size_t CLAIM_SIZE = 16;
+
+    void workerLoop();
+    void runBatch();
+
+    std::vector<std::thread> workers;
+    std::mutex mtx;
+    std::condition_variable wakeCv;
+    std::condition_variable doneCv;
+    uint64_t generation = 0;
+    size_t busyWorkers = 0;
+    bool stopping = false;
+
+    // Current batch, published under mtx
+    const std::vector<std::string_view>* batchStatements = nullptr;
+    std::vector<parsedStatement>* batchResults = nullptr;
+    std::atomic<size_t> nextIndex{0};
+};
@@ -0,0 +1,98 @@
+#pragma once
+#include <string>
+#include <string_view>
+#include <vector>
+#include "ast.hpp"
+
+class heapFile;
+struct recordId;
+
+// A table reference in a bound statement: every TABLE node, subqueries
+// included, numbered in the order the binder meets them. The number is the
+// node's tableRef.
+struct boundTableRef {
+    const Table* table;
+    std::string_view name; // alias when one is given, else the table name
+    astNode* node;         // the TABLE node
+};
+
+// What a bind parameter's value has to be for the statement to bind, noted
+// while binding a statement with placeholders. Each operand is a fixed type
+// or, when its parameter number is not 0, the type of that parameter's value.
+enum class parameterCheck : uint8_t {
+    COMPARABLE, // the operands can be compared (or stored one in the other)
+    TEXT,       // both are text, as LIKE needs
+    NUMERIC     // the first is a number, as SUM and AVG need
+};
+
+struct parameterRule {
+    parameterCheck check;
+    ColumnType types[2];
+    uint32_t parameters[2];
+};
+
+// Resolves the names in a parsed statement against the schema, once.
+//
+// Afterwards every TABLE node carries its Table and table id, and every
+// COLUMN node its table id, column ordinal and type, so nothing downstream
+// looks a name up again. A column naming a select-list alias (GROUP BY,
+// HAVING, ORDER BY) gets tableRef -1 and the item's position as ordinal.
+// Each node's valueType is set, comparisons are type checked and every node
+// is marked constant when its value depends on no row.
+class binder {
+public:
+    explicit binder(const DatabaseSchema& schema) : schema(schema) {}
+
+    // Bind every SELECT, INSERT, UPDATE and DELETE under node; false on the
+    // first error. INSERT values and SET values are type checked against
+    // their columns, and each ASSIGNMENT is bound like a COLUMN.
+    bool bind(astNode* node);
+
+    // Match column = literal (either way round) in a bound COMPARISON, the
+    // shape a hash index answers: column gets the COLUMN node and key the
+    // literal in the column's type. A long string key views the node's text.
+    // A literal the column's type cannot hold (2.5 for an INT column) is no
+    // key: the comparison is left to the evaluator, which matches no row.
+    static bool equalityKey(const astNode* comparison, const astNode*& column, Value& key);
+
+    // Answer the WHERE of a bound SELECT, UPDATE or DELETE from an index of
+    // rows, the heap file of table reference tableRef: the first column =
+    // literal ANDed into the condition that rows can look up gives the rids
+    // of the candidate rows, which the rest of the condition must still be
+    // checked on. False when no such comparison is indexed, so the caller
+    // has to scan.
+    static bool lookupWhere(const astNode* statement, int32_t tableRef, const heapFile& rows,
+                            std::vector<recordId>& rids);
+
+    // Whether the statement would still bind with parameters' values put
+    // in place of its placeholders ($n is parameters[n - 1])
+    static bool satisfied(const parameterRule& rule, const std::vector<Value>& parameters);
+
+    const std::vector<boundTableRef>& tables() const { return tableRefs; }
+    // Rules the placeholders of the last bound statement are under
+    const std::vector<parameterRule>& parameterRules() const { return rules; }
+    const std::string& error() const { return message; }
+
+private:
+    // Tables visible in one SELECT: tableRefs[first, first + count)
+    struct scope {
+        size_t first;
+        size_t count;
+        const scope* outer;
+        const astNode* selectList;
+    };
+
+    bool bindSelect(astNode* select, const scope* outer);
+    bool bindModification(astNode* statement);
+    bool addTable(astNode* table, size_t scopeFirst);
+    bool bindExpression(astNode* node, const scope& current, bool allowAlias);
+    bool bindColumn(astNode* column, const scope& current, bool allowAlias);
+    bool checkComparison(const astNode* comparison);
+    bool fail(std::string text);
+    void noteParameters(parameterCheck check, ColumnType leftType, const astNode* left, const astNode* right);
+
+    const DatabaseSchema& schema;
+    std::vector<boundTableRef> tableRefs;
+    std::vector<parameterRule> rules;
+    std::string message;
+};
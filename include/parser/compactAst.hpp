@@ -0,0 +1,105 @@
+#pragma once
+#include <cstdint>
+#include <iostream>
+#include <string>
+#include <string_view>
+#include <vector>
+#include "ast.hpp"
+#include "../common/value.hpp"
+
+// Node kinds produced by the parser; names match astNode::nodeType
+enum class NodeKind : uint8_t {
+    ROOT,
+    SELECT, DISTINCT, SELECT_LIST, COLUMN_EXPR, ALIAS, WILDCARD,
+    FUNCTION, ARGS, COLUMN,
+    FROM, TABLE, JOIN, JOIN_TYPE, ON,
+    WHERE, GROUP_BY, HAVING, ORDER_BY, ORDER_EXPR, DIRECTION, LIMIT, VALUE,
+    CONDITION, LOGICAL_OP, GROUP, COMPARISON, OPERATOR,
+    LIKE, IN, VALUE_LIST, BETWEEN, IS, NOT, EXISTS, SUBQUERY,
+    NUMBER, STRING, DATE, NULL_VALUE, BOOLEAN, PARAMETER,
+    INSERT, UPDATE, DELETE, COLUMNS, VALUES, ROW, SET, ASSIGNMENT,
+    CREATE_TABLE, COLUMN_DEF, DATATYPE, CONSTRAINT, TABLE_CONSTRAINT, FOREIGN_KEY, REFERENCES, STORAGE,
+    CREATE_INDEX, USING,
+    UNKNOWN
+};
+
+const char* nodeKindToString(NodeKind kind);
+NodeKind stringToNodeKind(std::string_view type);
+
+// Typed payload carried by literal nodes
+enum class LiteralKind : uint8_t {
+    NONE,
+    INTEGER,
+    DOUBLE,
+    STRING,
+    DATE,
+    BOOLEAN,
+    NULL_VALUE,
+    PARAMETER      // bind placeholder; intValue holds its 1-based number
+};
+
+// One node of a compactAst. Children of a node are stored next to each other,
+// so they are the index range [firstChild, firstChild + childCount).
+struct compactNode {
+    static constexpr uint32_t NO_NODE = UINT32_MAX;
+
+    NodeKind kind = NodeKind::UNKNOWN;
+    LiteralKind literal = LiteralKind::NONE;
+    uint32_t parent = NO_NODE;
+    uint32_t firstChild = 0;
+    uint32_t childCount = 0;
+    uint32_t textOffset = 0;   // node value text in the string pool
+    uint32_t textLength = 0;
+    uint32_t typeOffset = 0;   // original node type, kept only for UNKNOWN kinds
+    uint32_t typeLength = 0;
+    union {
+        int64_t intValue;
+        double doubleValue;
+        int32_t dateDays;      // days since 1970-01-01
+        bool boolValue;
+        struct {
+            uint32_t offset;   // unquoted string content in the string pool
+            uint32_t length;
+        } stringValue;
+    };
+
+    compactNode() : intValue(0) {}
+
+    bool isLiteral() const { return literal != LiteralKind::NONE; }
+};
+
+// Flat, pointer-free copy of a parsed tree: nodes in breadth-first order in one
+// array, all text in one string pool and literals already typed. Cheap to
+// walk, compare and hash, which is what plan caching needs.
+class compactAst {
+public:
+    std::vector<compactNode> nodes;
+    std::string strings;
+
+    static compactAst fromTree(const astNode* root);
+
+    bool empty() const { return nodes.empty(); }
+    const compactNode& root() const { return nodes.front(); }
+    const compactNode& child(const compactNode& node, uint32_t i) const { return nodes[node.firstChild + i]; }
+
+    std::string_view text(const compactNode& node) const;
+    std::string_view typeName(const compactNode& node) const;
+    std::string_view stringLiteral(const compactNode& node) const;
+
+    // Literal payload as a Value (strings view this tree's pool); NULL for
+    // non-literals and parameters
+    Value literalValue(const compactNode& node) const;
+
+    // Same output as astNode::print on the source tree
+    void print(std::ostream& out = std::cout) const;
+
+    // Hash/compare of the tree shape: kinds, structure and non-literal text
+    // (identifiers, operators); literal values are ignored
+    uint64_t shapeHash() const;
+    bool sameShape(const compactAst& other) const;
+
+private:
+    uint32_t addString(std::string_view str);
+    void setLiteral(compactNode& node, std::string_view value);
+    void printNode(std::ostream& out, uint32_t index, int depth) const;
+};
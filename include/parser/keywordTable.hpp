@@ -0,0 +1,147 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+#include "../common/token.hpp"
+
+// Reserved words, datatypes, constraints, operators and punctuation in one table.
+// Names are stored upper-case; lookups compare case-insensitively in place.
+struct keywordEntry {
+    std::string_view name;
+    TokenType type;
+};
+
+inline constexpr keywordEntry keyword_entries[] = {
+    // Keywords
+    {"SELECT", TokenType::KEYWORD}, {"FROM", TokenType::KEYWORD}, {"WHERE", TokenType::KEYWORD},
+    {"INSERT", TokenType::KEYWORD}, {"INTO", TokenType::KEYWORD}, {"VALUES", TokenType::KEYWORD},
+    {"UPDATE", TokenType::KEYWORD}, {"SET", TokenType::KEYWORD}, {"DELETE", TokenType::KEYWORD},
+    {"CREATE", TokenType::KEYWORD}, {"TABLE", TokenType::KEYWORD}, {"DROP", TokenType::KEYWORD},
+    {"ALTER", TokenType::KEYWORD}, {"ADD", TokenType::KEYWORD}, {"NULL", TokenType::KEYWORD},
+    {"ON", TokenType::KEYWORD}, {"IS", TokenType::KEYWORD}, {"JOIN", TokenType::KEYWORD},
+    {"INNER", TokenType::KEYWORD}, {"LEFT", TokenType::KEYWORD}, {"RIGHT", TokenType::KEYWORD},
+    {"FULL", TokenType::KEYWORD}, {"OUTER", TokenType::KEYWORD}, {"AS", TokenType::KEYWORD},
+    {"BY", TokenType::KEYWORD}, {"GROUP", TokenType::KEYWORD}, {"ORDER", TokenType::KEYWORD},
+    {"HAVING", TokenType::KEYWORD}, {"DISTINCT", TokenType::KEYWORD}, {"LIMIT", TokenType::KEYWORD},
+    {"OFFSET", TokenType::KEYWORD}, {"REFERENCES", TokenType::KEYWORD}, {"EXISTS", TokenType::KEYWORD},
+    {"AND", TokenType::KEYWORD}, {"OR", TokenType::KEYWORD}, {"NOT", TokenType::KEYWORD},
+    {"IN", TokenType::KEYWORD}, {"LIKE", TokenType::KEYWORD}, {"BETWEEN", TokenType::KEYWORD},
+    {"ALL", TokenType::KEYWORD}, {"ANY", TokenType::KEYWORD},
+
+    // Operators
+    {"+", TokenType::OPERATOR}, {"-", TokenType::OPERATOR}, {"*", TokenType::OPERATOR},
+    {"/", TokenType::OPERATOR}, {"=", TokenType::OPERATOR}, {"<", TokenType::OPERATOR},
+    {">", TokenType::OPERATOR}, {"<=", TokenType::OPERATOR}, {">=", TokenType::OPERATOR},
+    {"<>", TokenType::OPERATOR}, {"!=", TokenType::OPERATOR}, {"&&", TokenType::OPERATOR},
+    {"||", TokenType::OPERATOR}, {"!", TokenType::OPERATOR},
+
+    // Punctuation
+    {",", TokenType::PUNCTUATION}, {";", TokenType::PUNCTUATION}, {"(", TokenType::PUNCTUATION},
+    {")", TokenType::PUNCTUATION}, {".", TokenType::PUNCTUATION},
+
+    // Datatypes
+    {"NUMBER", TokenType::DATATYPE}, {"INT", TokenType::DATATYPE}, {"VARCHAR", TokenType::DATATYPE},
+    {"CHAR", TokenType::DATATYPE}, {"TEXT", TokenType::DATATYPE}, {"FLOAT", TokenType::DATATYPE},
+    {"DOUBLE", TokenType::DATATYPE}, {"DATE", TokenType::DATATYPE}, {"BOOLEAN", TokenType::DATATYPE},
+    {"STRING", TokenType::DATATYPE},
+
+    // Constraints (multi-word ones are looked up with a single space between words)
+    {"PRIMARY KEY", TokenType::CONSTRAINT}, {"NOT NULL", TokenType::CONSTRAINT},
+    {"FOREIGN KEY", TokenType::CONSTRAINT}, {"UNIQUE", TokenType::CONSTRAINT},
+    {"CHECK", TokenType::CONSTRAINT}, {"DEFAULT", TokenType::CONSTRAINT}
+};
+
+inline constexpr size_t keyword_count = sizeof(keyword_entries) / sizeof(keyword_entries[0]);
+inline constexpr size_t keyword_table_size = 1024; // power of two
+inline constexpr uint16_t keyword_empty_slot = 0xFFFF;
+
+constexpr char asciiUpper(char c) {
+    return (c >= 'a' && c <= 'z') ? static_cast<char>(c - 'a' + 'A') : c;
+}
+
+// Case-insensitive FNV-1a variant; seed is chosen at compile time so that every
+// entry lands in its own slot
+constexpr uint32_t keywordHash(std::string_view str, uint32_t seed) {
+    uint32_t hash = 2166136261u ^ seed;
+    for (char c : str) {
+        hash ^= static_cast<unsigned char>(asciiUpper(c));
+        hash *= 16777619u;
+    }
+    hash ^= hash >> 15;
+    return hash;
+}
+
+constexpr size_t maxKeywordLength() {
+    size_t maxLen = 0;
+    for (const auto& entry : keyword_entries) {
+        if (entry.name.size() > maxLen) maxLen = entry.name.size();
+    }
+    return maxLen;
+}
+
+inline constexpr size_t keyword_max_length = maxKeywordLength();
+
+struct keywordHashTable {
+    uint32_t seed = 0;
+    bool valid = false;
+    uint16_t slots[keyword_table_size] = {};
+};
+
+// Search for a seed giving a collision-free mapping of all entries
+constexpr keywordHashTable buildKeywordHashTable() {
+    keywordHashTable table;
+    for (uint32_t seed = 0; seed < 100000; seed++) {
+        for (size_t i = 0; i < keyword_table_size; i++) table.slots[i] = keyword_empty_slot;
+
+        bool collision = false;
+        for (size_t i = 0; i < keyword_count && !collision; i++) {
+            size_t slot = keywordHash(keyword_entries[i].name, seed) & (keyword_table_size - 1);
+            if (table.slots[slot] != keyword_empty_slot) {
+                collision = true;
+            } else {
+                table.slots[slot] = static_cast<uint16_t>(i);
+            }
+        }
+
+        if (!collision) {
+            table.seed = seed;
+            table.valid = true;
+            return table;
+        }
+    }
+    return table;
+}
+
+inline constexpr keywordHashTable keyword_hash_table = buildKeywordHashTable();
+static_assert(keyword_hash_table.valid, "no perfect hash seed found for keyword table");
+
+// One probe: index of the matching entry or -1; never allocates
+constexpr int lookupKeywordIndex(std::string_view str) {
+    if (str.empty() || str.size() > keyword_max_length) return -1;
+
+    uint16_t index = keyword_hash_table.slots[keywordHash(str, keyword_hash_table.seed) & (keyword_table_size - 1)];
+    if (index == keyword_empty_slot) return -1;
+
+    const keywordEntry& entry = keyword_entries[index];
+    if (entry.name.size() != str.size()) return -1;
+    for (size_t i = 0; i < str.size(); i++) {
+        if (asciiUpper(str[i]) != entry.name[i]) return -1;
+    }
+    return index;
+}
+
+// Matching entry or nullptr
+constexpr const keywordEntry* lookupKeyword(std::string_view str) {
+    int index = lookupKeywordIndex(str);
+    return index < 0 ? nullptr : &keyword_entries[index];
+}
+
+// Token type of a table entry, or UNKNOWN when str is not in the table
+constexpr TokenType keywordType(std::string_view str) {
+    int index = lookupKeywordIndex(str);
+    return index < 0 ? TokenType::UNKNOWN : keyword_entries[index].type;
+}
+
+static_assert(keywordType("select") == TokenType::KEYWORD, "keyword table self-check");
+static_assert(keywordType("Not Null") == TokenType::CONSTRAINT, "keyword table self-check");
+static_assert(keywordType("users") == TokenType::UNKNOWN, "keyword table self-check");
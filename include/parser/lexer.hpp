@@ -1,25 +1,30 @@
 #pragma once
 #include <string>
+#include <string_view>
 #include <vector>
 #include "../common/token.hpp"
 
 class lexer {
 public:
     // Modern interface using Token struct
-    std::vector<Token> tokenize(const std::string& input);
+    std::vector<Token> tokenize(std::string_view input);
+
+    // Zero-copy interface: tokens are views into input, which must outlive them
+    std::vector<TokenView> tokenizeView(std::string_view input);
     
     // Legacy interface for backward compatibility
     std::vector<std::pair<std::string, std::string>> getlexer(const std::string& cmd);
 
 private:
     // Helper methods for better organization
-    Token classifyToken(const std::string& tokenStr, size_t position = 0, size_t line = 1, size_t column = 1);
-    bool isValidIdentifier(const std::string& str);
-    bool isNumeric(const std::string& str);
-    bool isFloatingPoint(const std::string& str);
-    bool isDateFormat(const std::string& str);
-    bool isStringLiteral(const std::string& str);
+    TokenView classifyToken(std::string_view tokenStr, size_t position = 0, size_t line = 1, size_t column = 1);
+    bool isValidIdentifier(std::string_view str, bool checkReserved = true);
+    bool isNumeric(std::string_view str);
+    bool isFloatingPoint(std::string_view str);
+    bool isDateFormat(std::string_view str);
+    bool isStringLiteral(std::string_view str);
+    bool isParameter(std::string_view str);
     
     // Multi-word constraint handling
-    std::pair<bool, std::string> checkMultiWordConstraint(const std::string& currentToken, const std::string& input, size_t currentPos);
-};
\ No newline at end of file
+    std::pair<bool, std::string> checkMultiWordConstraint(std::string_view currentToken, std::string_view input, size_t currentPos);
+};
@@ -1,8 +1,10 @@
 #pragma once
 #include <string>
+#include <string_view>
 #include <vector>
 #include <utility>
 #include "ast.hpp"
+#include "parserStats.hpp"
 #include "../common/token.hpp"
 #include "../../utils/Iterator.hpp"
 
@@ -12,6 +14,31 @@ class parser{
         ~parser() = default;
         Iterator itr;
         
+        // When set, AST nodes for the statement are allocated from this arena;
+        // the caller releases the whole tree with nodeArena->reset()
+        arena* nodeArena = nullptr;
+        
+        // Bind placeholders seen in the current statement; '?' is numbered by
+        // position, '$n' explicitly from 1 to MAX_PARAMETERS, and the two
+        // styles cannot be mixed
+        static constexpr size_t MAX_PARAMETERS = 65535;
+        size_t parameterCount = 0;
+        bool positionalParameters = false;
+        bool numberedParameters = false;
+        
+        // First error hit by the last parse() call, NONE when it succeeded,
+        // with its message and the index of the token it was hit at
+        ParseError firstError = ParseError::NONE;
+        std::string firstErrorMessage;
+        size_t firstErrorToken = 0;
+        const std::string& error() const { return firstErrorMessage; }
+        
+        // Node allocation helpers
+        astNode* makeNode(std::string_view type, std::string_view value);
+        astNode* makeQualifiedNode(std::string_view type, std::string_view qualifier, std::string_view name);
+        
+        void noteError(ParseError kind, std::string message);
+        
         // Basic parsing methods
         bool isToken(const Token& token, TokenType type, const std::string& value = "");
         bool handleSubquery(const std::vector<Token>& tokens, astNode* parentNode = nullptr);
@@ -34,6 +61,16 @@ class parser{
         bool parseOrderBy(const std::vector<Token>& tokens, astNode* parentNode = nullptr);
         bool parseLimit(const std::vector<Token>& tokens, astNode* parentNode = nullptr);
         
+        // INSERT / UPDATE / DELETE helpers
+        bool parseOptionalWhere(const std::vector<Token>& tokens, astNode* parentNode);
+        bool finishStatement(const std::vector<Token>& tokens, const char* statement);
+
+        // CREATE TABLE / CREATE INDEX parsing methods
+        bool parseCreateIndex(const std::vector<Token>& tokens, astNode* parentNode = nullptr);
+        bool parseColumnDefinition(const std::vector<Token>& tokens, astNode* parentNode = nullptr);
+        bool parseTableConstraint(const std::vector<Token>& tokens, astNode* parentNode = nullptr);
+        bool parseReferences(const std::vector<Token>& tokens, astNode* parentNode = nullptr);
+        
         // Enhanced condition parsing methods
         bool parseCondition(const  std::vector<Token>& tokens, astNode* parentNode = nullptr);
         bool parseLogicalExpression(const  std::vector<Token>& tokens, astNode* parentNode = nullptr);
@@ -47,6 +84,7 @@ class parser{
         bool parseIsExpression(const  std::vector<Token>& tokens, astNode* parentNode = nullptr);
         bool parseExistsExpression(const  std::vector<Token>& tokens, astNode* parentNode = nullptr);
         bool parseValue(const  std::vector<Token>& tokens, astNode* parentNode = nullptr);
+        bool parseParameter(const  std::vector<Token>& tokens, astNode* parentNode = nullptr);
 };
 
 
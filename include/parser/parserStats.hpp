@@ -0,0 +1,101 @@
+#pragma once
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <iostream>
+
+enum class StatementKind {
+    SELECT,
+    INSERT,
+    UPDATE,
+    DELETE,
+    CREATE,
+    OTHER,
+    COUNT
+};
+
+// Kind of the first error hit while parsing a statement
+enum class ParseError {
+    NONE,
+    EMPTY_INPUT,
+    UNSUPPORTED_STATEMENT,
+    EXPECTED_KEYWORD,
+    EXPECTED_IDENTIFIER,
+    EXPECTED_VALUE,
+    EXPECTED_PUNCTUATION,
+    UNEXPECTED_TOKEN,
+    MIXED_PARAMETERS,
+    INVALID_PARAMETER,
+    COUNT
+};
+
+// Clause parsers whose time is measured (inclusive of nested subqueries)
+enum class ParseClause {
+    SELECT_LIST,
+    FROM,
+    JOIN,
+    WHERE,
+    GROUP_BY,
+    HAVING,
+    ORDER_BY,
+    LIMIT,
+    SUBQUERY,
+    COUNT
+};
+
+const char* statementKindToString(StatementKind kind);
+const char* parseErrorToString(ParseError error);
+const char* parseClauseToString(ParseClause clause);
+
+// Totals over every thread, as returned by parserStats::snapshot()
+struct parserCounters {
+    uint64_t statements[static_cast<size_t>(StatementKind::COUNT)] = {};
+    uint64_t failedStatements[static_cast<size_t>(StatementKind::COUNT)] = {};
+    uint64_t errors[static_cast<size_t>(ParseError::COUNT)] = {};
+    uint64_t clauseCalls[static_cast<size_t>(ParseClause::COUNT)] = {};
+    uint64_t clauseNanos[static_cast<size_t>(ParseClause::COUNT)] = {};
+};
+
+// Parser counters. Each thread bumps its own slot with plain relaxed
+// load/store pairs (a slot has a single writer), so counting takes no locks
+// and no atomic read-modify-write. Reading sums all slots on demand.
+class parserStats {
+public:
+    static void countStatement(StatementKind kind, bool ok);
+    static void countError(ParseError error);
+    static void addClauseTime(ParseClause clause, uint64_t nanos);
+
+    // Clause timing costs two clock reads per clause, so it is off by default
+    static bool timingEnabled() { return timing.load(std::memory_order_relaxed); }
+    static void setTimingEnabled(bool enabled) { timing.store(enabled, std::memory_order_relaxed); }
+
+    static parserCounters snapshot();
+    static void dump(std::ostream& out = std::cout);
+
+private:
+    static std::atomic<bool> timing;
+};
+
+// Adds the lifetime of the scope to a clause's time when timing is enabled
+class clauseTimer {
+public:
+    explicit clauseTimer(ParseClause c) : clause(c), active(parserStats::timingEnabled()) {
+        if (active) start = std::chrono::steady_clock::now();
+    }
+
+    ~clauseTimer() {
+        if (active) {
+            auto elapsed = std::chrono::steady_clock::now() - start;
+            parserStats::addClauseTime(clause, static_cast<uint64_t>(
+                std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count()));
+        }
+    }
+
+    clauseTimer(const clauseTimer&) = delete;
+    clauseTimer& operator=(const clauseTimer&) = delete;
+
+private:
+    ParseClause clause;
+    bool active;
+    std::chrono::steady_clock::time_point start;
+};
@@ -0,0 +1,94 @@
+#pragma once
+#include <cstdint>
+#include <list>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+#include "compactAst.hpp"
+#include "lexer.hpp"
+#include "parser.hpp"
+#include "../common/arena.hpp"
+#include "../common/value.hpp"
+
+// A statement parsed once and kept in compact form; executing it only binds
+// parameter values. Immutable after construction, so it can be shared.
+class preparedStatement {
+public:
+    preparedStatement(std::string sqlText, compactAst parsedTree, size_t parameters);
+
+    const std::string& sql() const { return text; }
+    const compactAst& tree() const { return ast; }
+    size_t parameterCount() const { return parameters; }
+
+    // Indexes into tree().nodes of every PARAMETER node, in tree order
+    const std::vector<uint32_t>& parameterNodes() const { return placeholders; }
+
+private:
+    std::string text;
+    compactAst ast;
+    size_t parameters;
+    std::vector<uint32_t> placeholders;
+};
+
+// A prepared statement together with the values for its placeholders
+struct boundStatement {
+    std::shared_ptr<const preparedStatement> statement;
+    std::vector<Value> parameters;
+    std::unique_ptr<char[]> text; // long string parameters point here
+
+    // Value of placeholder $number (1-based)
+    const Value& parameter(size_t number) const { return parameters[number - 1]; }
+};
+
+// PREPARE/EXECUTE front end for one session: a bounded LRU of prepared
+// statements keyed by SQL text. Not thread-safe; each session owns its own.
+class preparedStatementCache {
+public:
+    static constexpr size_t DEFAULT_CAPACITY = 256;
+
+    explicit preparedStatementCache(size_t capacity = DEFAULT_CAPACITY);
+
+    preparedStatementCache(const preparedStatementCache&) = delete;
+    preparedStatementCache& operator=(const preparedStatementCache&) = delete;
+
+    // Cached statement for sql, parsing it on a miss; nullptr when sql does
+    // not parse, with the parser's error on std::cerr (failures are not cached)
+    std::shared_ptr<const preparedStatement> prepare(std::string_view sql);
+
+    // Bind values to a prepared statement; false when the count does not
+    // match. String values are copied into bound, so they only need to live
+    // for the call.
+    bool execute(const std::shared_ptr<const preparedStatement>& statement,
+                 std::vector<Value> values, boundStatement& bound);
+
+    // prepare() + execute() in one call
+    bool execute(std::string_view sql, std::vector<Value> values, boundStatement& bound);
+
+    void clear();
+
+    size_t size() const { return entries.size(); }
+    size_t capacity() const { return maxEntries; }
+    uint64_t hits() const { return hitCount; }
+    uint64_t misses() const { return missCount; }
+    uint64_t evictions() const { return evictionCount; }
+
+private:
+    using entryList = std::list<std::shared_ptr<const preparedStatement>>;
+
+    std::shared_ptr<const preparedStatement> parseStatement(std::string_view sql);
+
+    size_t maxEntries;
+    entryList entries; // most recently used first
+    // Keys view the SQL text owned by the cached statement
+    std::unordered_map<std::string_view, entryList::iterator> index;
+
+    lexer lex;
+    parser pars;
+    arena parseArena;
+
+    uint64_t hitCount = 0;
+    uint64_t missCount = 0;
+    uint64_t evictionCount = 0;
+};
@@ -0,0 +1,38 @@
+#pragma once
+#include <cstddef>
+
+// Vectorized byte scanning used by the lexer hot loops.
+// The implementation (AVX2, SSE2 or scalar) is picked once at startup from
+// the CPU features; all levels return identical results.
+
+enum class ScanLevel {
+    SCALAR,
+    SSE2,
+    AVX2
+};
+
+// Newline statistics for a span of input (for line/column tracking)
+struct NewlineInfo {
+    size_t count = 0;        // number of '\n' bytes
+    size_t lastOffset = 0;   // offset of the last '\n' (valid when count > 0)
+};
+
+// Offset of the first byte that can end or start a token (whitespace,
+// punctuation, operator characters or a quote), or len if there is none
+size_t scanTokenBoundary(const char* data, size_t len);
+
+// Offset of the first single quote, or len if there is none
+size_t scanQuote(const char* data, size_t len);
+
+// Offset of the first single quote or semicolon, or len if there is none
+// (used to split scripts into statements outside string literals)
+size_t scanQuoteOrSemicolon(const char* data, size_t len);
+
+// Count newlines and locate the last one
+NewlineInfo scanNewlines(const char* data, size_t len);
+
+// Active implementation; forceScanLevel() is meant for benchmarks and tests and
+// falls back to the best supported level when the CPU lacks the requested one
+ScanLevel activeScanLevel();
+void forceScanLevel(ScanLevel level);
+const char* scanLevelName(ScanLevel level);
@@ -0,0 +1,134 @@
+#pragma once
+#include <string>
+#include <string_view>
+#include <vector>
+#include <cstddef>
+#include "lexer.hpp"
+#include "../common/token.hpp"
+
+// Finds statement ends (';' outside string literals) in input that arrives in
+// pieces. Quotes are matched the same way lexer::tokenize matches them, so a
+// literal may span any number of chunks.
+class statementSplitter {
+public:
+    static constexpr size_t npos = static_cast<size_t>(-1);
+
+    // Offset just past the terminating ';' in data[0, len), or npos if the
+    // statement continues beyond this piece
+    size_t findEnd(const char* data, size_t len);
+
+    bool inLiteral() const { return insideLiteral; }
+    void reset() { insideLiteral = false; }
+
+private:
+    bool insideLiteral = false;
+};
+
+// Pull-based byte source for the streaming lexer
+class sqlSource {
+public:
+    virtual ~sqlSource() = default;
+
+    // Read up to capacity bytes into buffer; returns 0 at end of input
+    virtual size_t read(char* buffer, size_t capacity) = 0;
+};
+
+// Reads from a file descriptor (a path it opens itself, or e.g. stdin)
+class fileSource : public sqlSource {
+public:
+    explicit fileSource(int fd);
+    explicit fileSource(const std::string& path);
+    ~fileSource() override;
+
+    fileSource(const fileSource&) = delete;
+    fileSource& operator=(const fileSource&) = delete;
+
+    bool isOpen() const { return fd >= 0; }
+    size_t read(char* buffer, size_t capacity) override;
+
+private:
+    int fd = -1;
+    bool ownsFd = false;
+};
+
+// Read-only memory mapping of a whole dump file
+class mappedFile {
+public:
+    explicit mappedFile(const std::string& path);
+    ~mappedFile();
+
+    mappedFile(const mappedFile&) = delete;
+    mappedFile& operator=(const mappedFile&) = delete;
+
+    bool isOpen() const { return opened; }
+    const char* data() const { return base; }
+    size_t size() const { return length; }
+
+    // Drop resident pages below offset once they have been consumed
+    void release(size_t offset);
+
+private:
+    char* base = nullptr;
+    size_t length = 0;
+    size_t releasedUpTo = 0;
+    bool opened = false;
+};
+
+// Streaming lexer: splits input into statements on ';' and tokenizes them one
+// at a time. In buffered mode memory is bounded by the chunk size plus the
+// longest statement, independent of the total input size; in mapped mode
+// statements are views straight into the mapping and consumed pages are
+// released as the stream advances.
+//
+// Views returned by nextStatement/nextStatementTokens/nextToken stay valid
+// until the next statement is pulled from the stream.
+class streamLexer {
+public:
+    static constexpr size_t DEFAULT_CHUNK_SIZE = 1 << 20;
+
+    explicit streamLexer(sqlSource& source, size_t chunkSize = DEFAULT_CHUNK_SIZE);
+    explicit streamLexer(mappedFile& file);
+
+    // Next statement text including its terminating ';' (the last statement
+    // of the input may have none); whitespace-only trailing input is skipped
+    bool nextStatement(std::string_view& statement);
+
+    // Tokens of the next statement; positions and lines are relative to the
+    // whole stream
+    bool nextStatementTokens(std::vector<TokenView>& tokens);
+
+    // Next token across statement boundaries
+    bool nextToken(TokenView& token);
+
+    size_t statementsRead() const { return statementCount; }
+    size_t peakBufferBytes() const { return peakBuffer; }
+
+private:
+    bool refill();
+    void advancePosition(std::string_view statement);
+
+    sqlSource* source = nullptr;
+    mappedFile* mapping = nullptr;
+    std::vector<char> buffer;
+
+    const char* window = nullptr; // buffer.data() or the mapping
+    size_t dataBegin = 0;         // start of the unconsumed statement
+    size_t dataEnd = 0;           // end of valid bytes in window
+    size_t scanPos = 0;           // how far the splitter has looked
+    bool endOfInput = false;
+
+    statementSplitter splitter;
+    lexer lex;
+
+    size_t streamOffset = 0;      // absolute offset of window[dataBegin]
+    size_t lineBase = 1;          // line of the next statement's first byte
+    size_t columnBase = 1;        // column of the next statement's first byte
+    size_t statementOffset = 0;   // position of the statement last returned
+    size_t statementLine = 1;
+    size_t statementColumn = 1;
+    size_t statementCount = 0;
+    size_t peakBuffer = 0;
+
+    std::vector<TokenView> pending;
+    size_t pendingIndex = 0;
+};
@@ -0,0 +1,108 @@
+#pragma once
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <shared_mutex>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+#include "binder.hpp"
+#include "preparedStatement.hpp"
+#include "../common/token.hpp"
+
+// Literal-free form of one statement. Every NUMBER/DOUBLE/STRING/DATE token is
+// replaced with a "$n" slot (numbered left to right) and its value moved to
+// literals. Reuse one instance per thread to keep the buffers warm.
+struct normalizedStatement {
+    uint64_t fingerprint = 0;          // hash of text
+    std::string text;                  // token values joined by spaces, literals as $n
+    std::vector<Value> literals;       // long strings view the tokens' text
+};
+
+// Normalize a tokenized statement; false when it cannot be templated (it
+// already uses ? / $n placeholders or contains an ERROR token)
+bool normalizeTokens(const std::vector<Token>& tokens, normalizedStatement& out);
+
+// Per-fingerprint counters, as reported by templateCache::stats()
+struct templateStats {
+    uint64_t fingerprint;
+    std::string text;
+    uint64_t executions;   // first execution (the parse) included
+    uint64_t hits;
+    uint64_t totalNanos;   // normalize + lookup/parse + bind, summed
+};
+
+// Shared cache of parsed statement templates keyed by fingerprint, for
+// clients that inline literals instead of using prepared statements.
+// Repeated shapes skip parser::parse and only bind the extracted literals.
+// Given a schema, each template is also bound once when it is cached (see
+// binder), keeping the rules its slots are under; a hit then only checks
+// the literals against those rules. A shape that does not bind is not
+// cached, so it binds once the tables it names exist; one that binds stays
+// valid, since tables are never dropped or altered.
+// Lookups take a shard's lock in shared mode, so concurrent readers do not
+// block each other; only inserting a new shape takes it exclusively.
+class templateCache {
+public:
+    static constexpr size_t DEFAULT_CAPACITY = 4096;
+
+    explicit templateCache(size_t capacity = DEFAULT_CAPACITY, const DatabaseSchema* schema = nullptr);
+
+    templateCache(const templateCache&) = delete;
+    templateCache& operator=(const templateCache&) = delete;
+
+    // Lex, normalize and bind sql. Statements with placeholders, shapes whose
+    // template does not parse, literals that break a slot's rules, and new
+    // shapes once the cache is full are parsed (and bound) directly with
+    // their literals. False when the statement does not parse or bind.
+    bool execute(std::string_view sql, boundStatement& bound);
+    bool execute(const std::vector<Token>& tokens, boundStatement& bound);
+
+    // Snapshot of every cached template, most executed first
+    std::vector<templateStats> stats() const;
+
+    void clear();
+
+    size_t size() const;
+    size_t capacity() const { return maxEntries; }
+    uint64_t hits() const { return hitCount.load(std::memory_order_relaxed); }
+    uint64_t misses() const { return missCount.load(std::memory_order_relaxed); }
+    // Statements parsed directly instead of through a template
+    uint64_t bypassed() const { return bypassCount.load(std::memory_order_relaxed); }
+
+private:
+    static constexpr size_t SHARD_COUNT = 16;
+
+    struct entry {
+        std::string text;                                   // normalized text
+        std::shared_ptr<const preparedStatement> statement; // null: shape only parses with its literals
+        std::vector<parameterRule> rules;                   // the literals must satisfy these
+        std::atomic<uint64_t> executions{0};
+        std::atomic<uint64_t> hits{0};
+        std::atomic<uint64_t> totalNanos{0};
+    };
+
+    struct shard {
+        mutable std::shared_mutex mtx;
+        std::unordered_map<uint64_t, std::shared_ptr<entry>> entries;
+    };
+
+    shard& shardFor(uint64_t fingerprint) { return shards[fingerprint % SHARD_COUNT]; }
+    std::shared_ptr<entry> find(const normalizedStatement& normalized);
+    // Parse tokens and, with a schema, bind them; nullptr if either fails,
+    // with unbound set when binding did. A template (rules given) keeps its
+    // slots' rules and reports no error
+    std::shared_ptr<const preparedStatement> parseTokens(const std::vector<Token>& tokens, std::string text,
+                                                         std::vector<parameterRule>* rules, bool& unbound);
+    std::shared_ptr<const preparedStatement> parseDirect(const std::vector<Token>& tokens);
+
+    size_t maxEntries;
+    const DatabaseSchema* schema;
+    std::atomic<size_t> entryCount{0};
+    shard shards[SHARD_COUNT];
+
+    std::atomic<uint64_t> hitCount{0};
+    std::atomic<uint64_t> missCount{0};
+    std::atomic<uint64_t> bypassCount{0};
+};
@@ -0,0 +1,40 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "schema.hpp"
+
+// Per-row outcome of a batch validation: one bitmap per kind of violation,
+// bit i set when row i fails it. Nothing is logged.
+struct batchErrors {
+    size_t rows = 0;
+    std::vector<uint64_t> notNull; // NULL in a NOT NULL column
+    std::vector<uint64_t> type;    // value of the wrong type
+    // Too long for CHAR(n)/VARCHAR(n), or a NaN or infinite DOUBLE: no
+    // column stores those, so validateColumnConstraints rejects them too
+    std::vector<uint64_t> range;
+    std::vector<uint64_t> unique;  // duplicate key, within the batch or against existing keys
+
+    // Size every bitmap for rows and clear it
+    void reset(size_t rowCount);
+
+    bool failed(size_t row) const;
+    size_t failedCount() const;
+    bool ok() const { return failedCount() == 0; }
+};
+
+// Keys already stored for a UNIQUE / PRIMARY KEY column, e.g. an index on
+// it. probe() looks up a whole batch in one call and sets bit i of found
+// for every keys[i] that exists.
+class keyLookup {
+public:
+    virtual ~keyLookup() = default;
+    virtual void probe(const Value* keys, size_t count, uint64_t* found) const = 0;
+};
+
+// Check count values for one resolved column: NOT NULL, type and range in
+// branch-free passes of 64 rows per bitmap word, then UNIQUE / PRIMARY KEY
+// (duplicates inside the batch, plus existing keys when given). Returns
+// errors.ok().
+bool validateColumnBatch(const Column& column, const Value* values, size_t count,
+                         batchErrors& errors, const keyLookup* existing = nullptr);
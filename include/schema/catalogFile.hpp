@@ -0,0 +1,122 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+#include "schema.hpp"
+
+// On-disk catalog, read in place through a read-only mapping.
+//
+// Layout (host byte order, every section 8-byte aligned):
+//   catalogHeader
+//   catalogTableRecord[tableCount]        sorted by name, for binary search
+//   catalogColumnRecord[columnCount]      each table's columns are a contiguous run, in ordinal order
+//   catalogForeignKeyRecord[foreignKeyCount]
+//   catalogIndexRecord[indexCount]
+//   string pool                           names and types, referenced by offset/length
+//
+// The file is only ever replaced whole (write to a temp file, fsync, rename),
+// so a reader sees either the old or the new catalog, never a torn one.
+
+struct catalogString {
+    uint32_t offset; // into the string pool
+    uint32_t length;
+};
+
+struct catalogHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t tableCount;
+    uint32_t columnCount;
+    uint32_t foreignKeyCount;
+    uint32_t indexCount;
+    uint32_t reserved;
+    uint64_t generation;        // bumped by every rewrite
+    uint64_t tablesOffset;
+    uint64_t columnsOffset;
+    uint64_t foreignKeysOffset;
+    uint64_t indexesOffset;
+    uint64_t stringsOffset;
+    uint64_t stringsSize;
+};
+
+struct catalogTableRecord {
+    catalogString name;
+    uint32_t firstColumn;
+    uint32_t columnCount;
+    uint32_t firstForeignKey;
+    uint32_t foreignKeyCount;
+    uint32_t storage;           // TableStorage
+    uint32_t reserved;
+};
+
+// catalogColumnRecord::flags
+constexpr uint32_t COLUMN_PRIMARY_KEY = 1u << 0;
+constexpr uint32_t COLUMN_UNIQUE = 1u << 1;
+constexpr uint32_t COLUMN_NOT_NULL = 1u << 2;
+
+struct catalogColumnRecord {
+    catalogString name;
+    catalogString datatype;
+    uint32_t flags;
+    uint32_t reserved;
+};
+
+struct catalogForeignKeyRecord {
+    catalogString column;
+    catalogString reference; // "table.column"
+};
+
+struct catalogIndexRecord {
+    catalogString name;
+    catalogString table;
+    catalogString column;
+    uint32_t method;            // IndexMethod
+    uint32_t reserved;
+};
+
+class catalogFile {
+public:
+    static constexpr char MAGIC[8] = {'M', 'S', 'Q', 'L', 'C', 'A', 'T', '\0'};
+    static constexpr uint32_t VERSION = 4; // 2: columns stored in ordinal order, 3: table storage format, 4: indexes
+
+    // Map path and check its header and section bounds; isOpen() is false
+    // when the file is missing, truncated, of another version or holds an
+    // index method this build does not know
+    explicit catalogFile(const std::string& path);
+    ~catalogFile();
+
+    catalogFile(const catalogFile&) = delete;
+    catalogFile& operator=(const catalogFile&) = delete;
+
+    bool isOpen() const { return header != nullptr; }
+    uint64_t generation() const { return header ? header->generation : 0; }
+    size_t tableCount() const { return header ? header->tableCount : 0; }
+    size_t indexCount() const { return header ? header->indexCount : 0; }
+
+    // In-place access; nothing is copied
+    std::string_view tableName(size_t table) const;
+    long findTable(std::string_view name) const; // index, or -1
+
+    // Build the in-memory Table for one record
+    Table loadTable(size_t table) const;
+    IndexDefinition loadIndex(size_t index) const;
+
+    // Write tables and indexes to path atomically: temp file, fsync, rename,
+    // fsync of the directory
+    static bool write(const std::string& path, const std::vector<const Table*>& tables,
+                      const std::vector<IndexDefinition>& indexes, uint64_t generation);
+
+private:
+    std::string_view text(catalogString str) const;
+
+    char* base = nullptr;
+    size_t length = 0;
+    const catalogHeader* header = nullptr;
+    const catalogTableRecord* tables = nullptr;
+    const catalogColumnRecord* columns = nullptr;
+    const catalogForeignKeyRecord* foreignKeys = nullptr;
+    const catalogIndexRecord* indexes = nullptr;
+    const char* strings = nullptr;
+};
@@ -2,9 +2,47 @@
 #ifndef SCHEMA_HPP  
 #define SCHEMA_HPP
 
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
 #include <string>
+#include <string_view>
 #include <unordered_map>
 #include <unordered_set>
+#include <vector>
+#include "../common/value.hpp"
+
+// Storage type of a column, derived from its declared datatype
+enum class ColumnType : uint8_t {
+    INT,      // INT, NUMBER: 8-byte signed integer
+    DOUBLE,   // DOUBLE, FLOAT
+    BOOLEAN,
+    DATE,     // 4-byte days since 1970-01-01
+    CHAR,     // CHAR(n): n bytes inline
+    VARCHAR,  // VARCHAR(n), STRING: 8-byte (offset, length) slot into the row's variable part
+    TEXT,     // same slot as VARCHAR, no length limit
+    UNKNOWN
+};
+
+// Parse a declared datatype such as "INT" or "VARCHAR(64)"; length gets the
+// declared size (0 when none was given)
+ColumnType columnTypeFromString(std::string_view datatype, uint32_t& length);
+const char* columnTypeToString(ColumnType type);
+
+// Bytes a column takes in the fixed part of a row
+uint32_t columnTypeWidth(ColumnType type, uint32_t length);
+
+// Type of the Values a column holds (NULL_VALUE for UNKNOWN)
+ValueType columnValueType(ColumnType type);
+
+// How a table's rows are laid out on disk
+enum class TableStorage : uint8_t {
+    ROW,   // heapFile: whole rows in slotted pages
+    PAX    // paxFile: blocks of rows, each column's values contiguous
+};
+
+const char* tableStorageToString(TableStorage storage);
 
 // Column metadata
 struct Column {
@@ -13,23 +51,104 @@ struct Column {
     bool isPrimaryKey = false;
     bool isUnique = false;
     bool isNotNull = false;
+
+    // Physical layout, filled in by Table::addColumn
+    uint32_t ordinal = 0;      // position in Table::columns
+    ColumnType type = ColumnType::UNKNOWN;
+    uint32_t length = 0;       // declared CHAR/VARCHAR size, 0 if none
+    uint32_t width = 0;        // bytes in the fixed part of the row
+    uint32_t offset = 0;       // byte offset of the value from the start of the row
+    uint32_t nullBit = 0;      // bit in the row's leading null bitmap
 };
 
 // Table metadata
+//
+// Row layout: a null bitmap with one bit per column (by ordinal), then every
+// column's fixed-width slot at a precomputed offset. Slots are ordered by
+// width so each one is naturally aligned; VARCHAR/TEXT slots point into a
+// variable-length part that follows fixedRowSize.
 struct Table {
     std::string name;
-    std::unordered_map<std::string, Column> columns; // Column name -> Column metadata
+    std::vector<Column> columns; // declaration order; columns[i].ordinal == i
+    std::unordered_map<std::string, uint32_t> columnIndex; // Column name -> ordinal
     std::unordered_map<std::string, std::string> foreignKeys; // Column name -> Referenced table.column
+    uint32_t nullBitmapBytes = 0;
+    uint32_t fixedRowSize = 0;
+    TableStorage storage = TableStorage::ROW;
+
+    // Append a column and recompute the row layout; false if the name is taken
+    bool addColumn(Column column);
+
+    // Column by name, or nullptr
+    const Column* findColumn(const std::string& columnName) const;
+
+private:
+    void computeLayout();
+};
+
+// How a secondary index is organized
+enum class IndexMethod : uint8_t {
+    HASH   // hashIndex: equality probes only
 };
 
+const char* indexMethodToString(IndexMethod method);
+
+// An index from CREATE INDEX name ON table (column) USING method. PRIMARY KEY
+// and UNIQUE columns are indexed implicitly and have no definition.
+struct IndexDefinition {
+    std::string name;
+    std::string table;
+    std::string column;
+    IndexMethod method = IndexMethod::HASH;
+};
+
+class catalogFile;
+class keyLookup;
+struct schemaSnapshot;
+
 // Database schema
+//
+// Reads never lock: every lookup pins the current immutable snapshot with
+// one atomic load inside an epoch guard. DDL is serialized, builds a new
+// snapshot copy-on-write (tables are shared, not copied) and publishes it
+// with one atomic store; the old snapshot is reclaimed once no reader can
+// still see it. Table pointers stay valid for the schema's lifetime, since
+// tables are never dropped and every later snapshot shares them.
 class DatabaseSchema {
 private:
-    std::unordered_map<std::string, Table> tables; // Table name -> Table metadata
+    std::atomic<const schemaSnapshot*> current;
+    std::mutex writerMutex;
+    std::string catalogPath;
+
+    void publish(schemaSnapshot* next);
+    // Write contents, a snapshot not published yet, to the catalog and
+    // publish it over the new file; nothing is published if writing fails
+    bool saveCatalogLocked(const schemaSnapshot& contents);
 
 public:
-    // Add a table to the schema
-    void addTable(const Table& table);
+    DatabaseSchema();
+    ~DatabaseSchema();
+
+    DatabaseSchema(const DatabaseSchema&) = delete;
+    DatabaseSchema& operator=(const DatabaseSchema&) = delete;
+
+    // Attach the catalog file at path (missing file = empty catalog). Tables
+    // are looked up in the mapping and only materialized when requested;
+    // every later addTable or addIndex rewrites the file atomically.
+    bool openCatalog(const std::string& path);
+
+    // Atomically rewrite the attached catalog with every table and index
+    bool saveCatalog();
+
+    // Number of tables, in memory and in the catalog
+    size_t tableCount() const;
+
+    // Bumped by every published change
+    uint64_t version() const;
+
+    // Add a table to the schema; false if its name is taken or the
+    // attached catalog cannot be written, and the table is not added then
+    bool addTable(const Table& table);
 
     // Check if a table exists
     bool tableExists(const std::string& tableName) const;
@@ -37,8 +156,21 @@ public:
     // Get table metadata
     const Table* getTable(const std::string& tableName) const;
 
-    // Validate a column's constraints
-    bool validateColumnConstraints(const std::string& tableName, const std::string& columnName, const std::string& value) const;
+    // Add an index definition; false if its name is taken, its table or
+    // column does not exist or the attached catalog cannot be written.
+    // Building the index is up to the table's storage.
+    bool addIndex(const IndexDefinition& index);
+
+    // Index definitions on one table
+    std::vector<IndexDefinition> getIndexes(const std::string& tableName) const;
+
+    // Validate a column's constraints; the text form is parsed into the
+    // column's type first (empty = NULL). UNIQUE / PRIMARY KEY is checked
+    // against existing when given, e.g. the column's bTreeIndex.
+    bool validateColumnConstraints(const std::string& tableName, const std::string& columnName, const std::string& value,
+                                   const keyLookup* existing = nullptr) const;
+    bool validateColumnConstraints(const std::string& tableName, const std::string& columnName, const Value& value,
+                                   const keyLookup* existing = nullptr) const;
 
     // Print the schema (for debugging)
     void printSchema() const;
@@ -0,0 +1,146 @@
+#pragma once
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+#include "../schema/batchValidator.hpp"
+#include "bufferPool.hpp"
+#include "page.hpp"
+
+enum class indexStatus : uint8_t {
+    OK,
+    DUPLICATE,   // the key is already present
+    ERROR        // I/O error, or a value that cannot be a key (logged)
+};
+
+// Disk-backed B+tree mapping the values of one column to recordIds, with no
+// duplicate keys: it backs PRIMARY KEY and UNIQUE constraints. NULL is never
+// stored, so any number of rows may have a NULL key.
+//
+// Keys are normalized into keyWidth bytes that compare with memcmp in the
+// column's order (INT/DATE/DOUBLE big-endian with the sign flipped,
+// CHAR(n)/VARCHAR(n) zero-padded to n bytes), so only fixed-width types and
+// VARCHARs with a declared length of at most MAX_KEY can be indexed.
+//
+// Page 0 holds the root and page counts; every other page is a node:
+//
+//   nodeHeader | key 0, value 0 | key 1, value 1 | ...
+//
+// A leaf's values are recordIds and its header links the right sibling. An
+// inner node's header holds the child left of key 0, and value i is the child
+// holding keys >= key i. Nodes split when full and never merge.
+//
+// Concurrency is optimistic lock coupling: each node has a version counter
+// outside the buffer pool. Readers never write shared state; they descend
+// reading versions, and restart when a node changed under them. Writers lock
+// only the nodes they change by bumping the version, and split full inner
+// nodes on the way down so a split never climbs back up.
+class bTreeIndex : public pagedFile, public keyLookup {
+public:
+    static constexpr uint32_t MAX_KEY = 128;
+
+    // Whether a column's values can be keys
+    static bool supports(const Column& column);
+
+    bTreeIndex(const std::string& path, const Column& column, bufferPool& pool);
+    ~bTreeIndex() override;
+
+    bTreeIndex(const bTreeIndex&) = delete;
+    bTreeIndex& operator=(const bTreeIndex&) = delete;
+
+    bool isOpen() const { return fd >= 0; }
+    // Whether the file had to be created (so it may lack existing rows)
+    bool isNew() const { return created; }
+    // Whether the file was left not clean, by a crash; it is not opened then
+    bool wasUnclean() const { return unclean; }
+    const Column& keyColumn() const { return column; }
+    uint64_t size() const { return keyCount.load(std::memory_order_relaxed); }
+    uint32_t height() const;
+
+    // Add key -> rid in one descent. A NULL key is not stored and is OK.
+    indexStatus insert(const Value& key, recordId rid);
+
+    // Find the row with this key
+    bool lookup(const Value& key, recordId& rid) const;
+
+    // Remove key; false if it was not present
+    bool erase(const Value& key);
+
+    // Write back the index's dirty pages and its header page, then fsync.
+    // Not concurrent with writers.
+    bool flush();
+
+    // keyLookup
+    void probe(const Value* keys, size_t count, uint64_t* found) const override;
+
+    // pagedFile
+    bool readPage(uint32_t page, char* data) const override;
+    bool writePage(uint32_t page, const char* data) const override;
+
+private:
+    friend class bTreeScan;
+
+    static constexpr uint32_t LATCH_CHUNK = 4096;     // version counters per chunk
+    static constexpr uint32_t LATCH_CHUNKS = 65536;   // so at most 2^28 pages
+
+    bool encodeKey(const Value& key, char* out) const;
+    std::atomic<uint64_t>* latch(uint32_t page) const;
+    bool allocate(pageHandle& handle);
+    int findLeaf(const char* key, pageHandle& leaf, uint64_t& version) const;
+    bool boundKey(const Value& bound, bool isLow, bool& inclusive, std::string& out) const;
+    int insertOnce(const char* key, recordId rid, indexStatus& status);
+    int eraseOnce(const char* key, bool& erased);
+    void splitNode(char* node, char* right, uint32_t rightPage, char* separator);
+    void insertIntoInner(char* node, const char* key, uint32_t child) const;
+    bool markChanged();
+    bool writeHeader(bool clean) const;
+
+    std::string path;
+    const Column& column;
+    bufferPool& pool;
+    int fd = -1;
+    bool created = false;
+    bool unclean = false;
+    uint32_t keyWidth = 0;
+    uint32_t entryBytes = 0;
+    uint32_t capacity = 0;         // entries per node
+
+    std::atomic<uint32_t> root{0};
+    std::atomic<uint32_t> pages{0};
+    std::atomic<uint64_t> keyCount{0};
+    std::atomic<bool> changed{false};  // header on disk says "not clean"
+    std::mutex allocateMutex;
+    std::unique_ptr<std::atomic<std::atomic<uint64_t>*>[]> latches;
+};
+
+// Keys in [low, high] in order; a NULL bound is open and an exclusive bound
+// leaves out keys equal to it. Leaves are copied one at a time, so the scan
+// holds no pins or locks between calls; keys inserted behind it may be missed.
+class bTreeScan {
+public:
+    bTreeScan(const bTreeIndex& index, const Value& low, bool lowInclusive, const Value& high, bool highInclusive);
+
+    bool next(recordId& rid);
+
+private:
+    bool fill();
+
+    const bTreeIndex& index;
+    bool hasLow = false;
+    bool hasHigh = false;
+    bool empty = false;            // the bounds admit no key
+    bool started = false;
+    bool done = false;
+    bool lowInclusive;
+    bool highInclusive;
+    std::string low;
+    std::string high;
+    std::string last;              // last key of the copied leaf
+    bool hasLast = false;
+    uint32_t nextLeaf = 0;
+    std::vector<recordId> rids;    // the copied leaf's rows in range
+    size_t position = 0;
+};
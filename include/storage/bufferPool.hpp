@@ -0,0 +1,133 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+#include "page.hpp"
+
+// A file of PAGE_SIZE pages the pool can read from and write back to
+class pagedFile {
+public:
+    virtual ~pagedFile() = default;
+    virtual bool readPage(uint32_t page, char* data) const = 0;
+    virtual bool writePage(uint32_t page, const char* data) const = 0;
+};
+
+struct pageKey {
+    const pagedFile* file;
+    uint32_t page;
+
+    bool operator==(const pageKey& other) const { return file == other.file && page == other.page; }
+};
+
+struct pageKeyHash {
+    size_t operator()(const pageKey& key) const {
+        uint64_t h = reinterpret_cast<uintptr_t>(key.file) ^ (uint64_t(key.page) * 0x9E3779B97F4A7C15ull);
+        h ^= h >> 29;
+        h *= 0xBF58476D1CE4E5B9ull;
+        return static_cast<size_t>(h ^ (h >> 32));
+    }
+};
+
+enum class evictionPolicy : uint8_t {
+    LRU,        // plain least recently used, for comparison
+    TWO_QUEUE   // 2Q: first touches go through a FIFO, only re-references reach the LRU
+};
+
+struct bufferPoolStats {
+    uint64_t hits = 0;
+    uint64_t misses = 0;
+    uint64_t evictions = 0;
+    uint64_t writeBacks = 0;
+
+    double hitRatio() const { return hits + misses == 0 ? 0.0 : double(hits) / double(hits + misses); }
+};
+
+class bufferPool;
+
+// A pinned page; unpins when destroyed. Call markDirty() after changing data().
+class pageHandle {
+public:
+    pageHandle() = default;
+    ~pageHandle() { release(); }
+
+    pageHandle(pageHandle&& other) noexcept { *this = std::move(other); }
+    pageHandle& operator=(pageHandle&& other) noexcept;
+    pageHandle(const pageHandle&) = delete;
+    pageHandle& operator=(const pageHandle&) = delete;
+
+    explicit operator bool() const { return frameData != nullptr; }
+    char* data() const { return frameData; }
+    uint32_t page() const { return pageNo; }
+    void markDirty() { dirty = true; }
+
+    void release();
+
+private:
+    friend class bufferPool;
+
+    bufferPool* pool = nullptr;
+    char* frameData = nullptr;
+    uint32_t shard = 0;
+    uint32_t frame = 0;
+    uint32_t pageNo = 0;
+    bool dirty = false;
+};
+
+// Fixed set of page frames shared by every table and index file.
+//
+// Frames are split into shards by page hash; each shard has its own latch,
+// page table and replacement queues, so threads touching different pages
+// rarely meet. A miss reads the page while holding its shard's latch.
+//
+// Under TWO_QUEUE a page read for the first time goes to a FIFO of about a
+// quarter of the shard's frames and is evicted from there unless pinned
+// again, which moves it to the main LRU. A ghost list remembers keys evicted
+// from the FIFO, so a page that comes back soon after also goes to the LRU.
+// A large scan therefore only cycles the FIFO and leaves the working set alone.
+//
+// The pool only manages frames: concurrent access to one page's bytes is the
+// caller's to synchronize.
+class bufferPool {
+public:
+    explicit bufferPool(size_t frameCount, evictionPolicy policy = evictionPolicy::TWO_QUEUE, size_t shardCount = 16);
+    ~bufferPool();
+
+    bufferPool(const bufferPool&) = delete;
+    bufferPool& operator=(const bufferPool&) = delete;
+
+    // Pin an existing page, reading it on a miss; empty handle on I/O error
+    // or when every frame of the page's shard is pinned
+    pageHandle pin(const pagedFile* file, uint32_t page);
+
+    // Pin a frame for a page that is not in the file yet (zero-filled, dirty)
+    pageHandle create(const pagedFile* file, uint32_t page);
+
+    // Write back every dirty page of file (pinned ones included)
+    bool flush(const pagedFile* file);
+
+    // Write back one page if it is cached, dirty and not pinned, so nobody
+    // can be changing it; for background writers
+    bool flushPage(const pagedFile* file, uint32_t page);
+
+    // Flush and forget every page of file; none may be pinned
+    bool drop(const pagedFile* file);
+
+    size_t frameCount() const;
+    bufferPoolStats stats() const;
+    void resetStats();
+
+private:
+    friend class pageHandle;
+    struct shard;
+
+    pageHandle fetch(const pagedFile* file, uint32_t page, bool read);
+    void unpin(uint32_t shardIndex, uint32_t frame, bool dirty);
+
+    evictionPolicy policy;
+    std::unique_ptr<char[]> memory;
+    std::vector<std::unique_ptr<shard>> shards;
+};
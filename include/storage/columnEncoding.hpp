@@ -0,0 +1,59 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include "../schema/schema.hpp"
+
+// How the values of one column chunk are stored after its null bitmap
+enum class chunkEncoding : uint8_t {
+    PLAIN,              // fixed-width values, or offsets + text
+    DICTIONARY,         // strings: sorted distinct values + bit-packed codes
+    RUN_LENGTH,         // fixed-width: run end rows + one value per run
+    FRAME_OF_REFERENCE  // INT, DATE: minimum + bit-packed differences
+};
+
+const char* chunkEncodingToString(chunkEncoding encoding);
+
+enum class compareOp : uint8_t { EQ, NE, LT, LE, GT, GE };
+
+// ---- Bit packing: values of width bits, back to back in 64-bit words ----
+
+// Words for count values, plus one spare so unpackBits can always read two
+inline size_t packedWords(size_t count, uint32_t width) {
+    return (count * width + 63) / 64 + 1;
+}
+
+// Bits needed for values up to maxValue (0 for 0)
+uint32_t bitWidth(uint64_t maxValue);
+
+void packBits(const uint64_t* values, size_t count, uint32_t width, uint64_t* out);
+
+inline uint64_t unpackBits(const uint64_t* words, size_t index, uint32_t width) {
+    if (width == 0) return 0;
+    size_t bit = index * width;
+    size_t word = bit / 64;
+    uint32_t shift = static_cast<uint32_t>(bit % 64);
+    uint64_t value = words[word] >> shift;
+    if (shift + width > 64) value |= words[word + 1] << (64 - shift);
+    return width == 64 ? value : value & ((uint64_t(1) << width) - 1);
+}
+
+// ---- Writing ----
+
+// One column's values in plain chunk layout, as collected before a block is written
+struct chunkValues {
+    const Column* column;
+    uint32_t rows;
+    const uint64_t* nulls;     // bit set = NULL
+    const char* fixed;         // fixed-width values (zero for NULL rows)
+    const uint32_t* offsets;   // VARCHAR/TEXT: rows + 1 entries
+    const char* text;
+
+    std::string_view string(uint32_t row) const;
+};
+
+// Append the cheapest encoding of values (everything after the null bitmap)
+// to out. Only PLAIN is considered when compress is false. width gets the
+// bit width of packed values.
+chunkEncoding encodeChunk(const chunkValues& values, bool compress, std::string& out, uint8_t& width);
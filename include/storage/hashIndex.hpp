@@ -0,0 +1,86 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <memory_resource>
+#include <vector>
+#include "../schema/batchValidator.hpp"
+#include "page.hpp"
+
+// In-memory hash index mapping the values of one column to recordIds, for
+// equality probes (WHERE column = literal) and foreign key checks. Duplicate
+// keys are allowed; NULL is never stored.
+//
+// Linear hashing: buckets of BUCKET_ENTRIES entries with overflow chains,
+// held in fixed segments of SEGMENT_BUCKETS so growing never moves a bucket.
+// Once the load passes MAX_LOAD an insert splits exactly one bucket, the one
+// under the split pointer, into itself and a new bucket at the end; after a
+// full round the table has doubled. Resizing is therefore spread over the
+// inserts and no insert ever rehashes more than one chain.
+//
+// Entries keep the key's full hash, so a split never rehashes a key and a
+// probe compares values only when the hashes match. Strings too long to be
+// inline in a Value are copied into the index.
+//
+// One thread modifies an index at a time; probes may run alongside each
+// other but not alongside modifications.
+class hashIndex : public keyLookup {
+public:
+    static constexpr size_t BUCKET_ENTRIES = 4;
+    static constexpr size_t SEGMENT_BUCKETS = 256;
+    static constexpr size_t INITIAL_BUCKETS = 16;  // power of two
+    static constexpr double MAX_LOAD = 0.75;        // entries per bucket slot
+
+    explicit hashIndex(const Column& column);
+    ~hashIndex() override;
+
+    hashIndex(const hashIndex&) = delete;
+    hashIndex& operator=(const hashIndex&) = delete;
+
+    const Column& keyColumn() const { return column; }
+    size_t size() const { return entryCount; }
+    size_t bucketCount() const { return buckets; }
+
+    // Add key -> rid; a NULL key is not stored
+    void insert(const Value& key, recordId rid);
+
+    // Remove the entry key -> rid; false if there is none
+    bool erase(const Value& key, recordId rid);
+
+    // Append the rows holding key to rids; returns how many were found
+    size_t find(const Value& key, std::vector<recordId>& rids) const;
+
+    bool contains(const Value& key) const;
+
+    // keyLookup
+    void probe(const Value* keys, size_t count, uint64_t* found) const override;
+
+private:
+    struct entry {
+        uint64_t hash;
+        Value key;
+        recordId rid;
+    };
+
+    struct bucket {
+        uint32_t count = 0;
+        bucket* overflow = nullptr;
+        entry entries[BUCKET_ENTRIES];
+    };
+
+    bucket& at(size_t index) const;
+    size_t address(uint64_t hash) const;
+    void append(bucket& head, const entry& item);
+    void split();
+    bool contains(const bucket& head, const Value& key, uint64_t hash) const;
+    void release(Value& key);
+
+    const Column& column;
+    std::vector<std::unique_ptr<bucket[]>> segments;
+    size_t buckets = 0;       // in use: roundSize + next
+    size_t roundSize = 0;     // buckets at the start of this round
+    size_t next = 0;          // the bucket the next split divides
+    size_t entryCount = 0;
+    std::vector<entry> moving; // a chain's entries during a split
+    std::pmr::unsynchronized_pool_resource strings;
+};
@@ -0,0 +1,235 @@
+#pragma once
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+#include "bTreeIndex.hpp"
+#include "bufferPool.hpp"
+#include "hashIndex.hpp"
+#include "page.hpp"
+#include "tupleCodec.hpp"
+#include "writeAheadLog.hpp"
+
+// Told about every change heapFile makes to a row, while the changed page's
+// latch is still held, so a reader that copies the page under its latch sees
+// the change and whatever the history recorded for it together (see
+// versionedTable)
+class rowHistory {
+public:
+    virtual ~rowHistory() = default;
+    // rid has just changed from before to after, either empty for a free
+    // slot; lsn is the change's log record, 0 if it was not logged
+    virtual void changed(recordId rid, std::string_view before, std::string_view after, uint64_t lsn) = 0;
+};
+
+// Unordered row storage for one table: a file of PAGE_SIZE slotted pages,
+// accessed through a shared bufferPool.
+//
+// Inserts are placed with a free-space map, one byte per page holding its
+// free bytes / FSM_GRANULE (so a page with category c has at least
+// c * FSM_GRANULE bytes free). The map is saved next to the data file as
+// "<path>.fsm" on flush and rebuilt from the page headers when it is missing
+// or stale. The page inserts go to stays pinned until another page is needed.
+//
+// Every PRIMARY KEY / UNIQUE column gets a bTreeIndex in
+// "<path>.<column>.idx", which insert and erase keep in step with the rows;
+// an insert that would duplicate a key stores nothing. An index that is
+// missing or was not flushed after its last change is rebuilt from the rows.
+//
+// Hash indexes from CREATE INDEX ... USING HASH live in memory only: addIndex
+// builds one from the rows, so the owner adds them again on every open. A
+// foreign key registered with addReference makes an insert fail when the
+// referenced table has no row with the new value.
+//
+// With a writeAheadLog attached (setLog), every insert, update and erase
+// made on behalf of a transaction is logged with its before and after
+// images, and the page remembers the LSN of its latest change; a page is
+// written back only once the log is durable up to that LSN. Changes made
+// without a transaction are not logged. Indexes are never logged: they are
+// rebuilt from the rows after a crash. The file also keeps its dirty page
+// table, the pages changed under the log since they were last written, for
+// checkpoints (see recoveryManager). A row erased for a transaction leaves a
+// tombstone holding its slot and bytes until the transaction ends, so undo
+// can always put it back; inserts purge the tombstones of ended
+// transactions on the page they go to.
+//
+// Every page has a version latch (shared by the pages PAGE_LATCHES apart)
+// that modifications hold while they change the page. A reader copies a page
+// between beginRead and endRead and keeps the copy only if endRead says no
+// modification overlapped; such copies may be taken alongside
+// modifications, and nothing a reader does delays a writer.
+//
+// One thread modifies a heap file at a time; scans may run alongside each
+// other but not alongside modifications.
+class heapFile : public pagedFile {
+public:
+    static constexpr size_t FSM_GRANULE = 32;
+    static constexpr size_t FSM_BLOCK = 1024; // pages per summary entry
+    static constexpr uint32_t PAGE_LATCHES = 1024;
+
+    heapFile(const std::string& path, const Table& table, bufferPool& pool);
+    ~heapFile() override;
+
+    heapFile(const heapFile&) = delete;
+    heapFile& operator=(const heapFile&) = delete;
+
+    bool isOpen() const { return fd >= 0; }
+    uint32_t pageCount() const { return pages.load(std::memory_order_acquire); }
+    const tupleCodec& codec() const { return rowCodec; }
+    bufferPool& buffers() const { return pool; }
+
+    // Log changes made for a transaction to log as file fileId; nullptr
+    // stops logging
+    void setLog(writeAheadLog* log, uint32_t fileId);
+
+    // Report changes made from now on to history; nullptr stops reporting.
+    // Recovery's redo is not reported.
+    void setHistory(rowHistory* history) { this->history = history; }
+
+    // Optimistic read of a page that may be changing: a copy taken after
+    // beginRead returned true is consistent if endRead, given the same
+    // version, returns true too; otherwise read again
+    bool beginRead(uint32_t page, uint64_t& version) const;
+    bool endRead(uint32_t page, uint64_t version) const;
+
+    // Encode row (one Value per column) and store it; false on a duplicate
+    // key or a foreign key value with no match
+    bool insert(const Value* row, recordId& rid, walTransaction* txn = nullptr);
+    // Store an already encoded tuple
+    bool insertTuple(const char* tuple, size_t length, recordId& rid, walTransaction* txn = nullptr);
+
+    // Copy the tuple at rid into tuple; false if there is none
+    bool get(recordId rid, std::string& tuple);
+
+    // Replace the row at rid, in place when its page has room, else by
+    // moving it, in which case rid is set to the new location; false on a
+    // duplicate key or a foreign key value with no match
+    bool update(recordId& rid, const Value* row, walTransaction* txn = nullptr);
+    bool updateTuple(recordId& rid, const char* tuple, size_t length, walTransaction* txn = nullptr);
+
+    bool erase(recordId rid, walTransaction* txn = nullptr);
+
+    // Write back this file's dirty pages, the free-space map and the
+    // indexes, then fsync
+    bool flush();
+
+    // The index on a PRIMARY KEY / UNIQUE column, or nullptr
+    const bTreeIndex* index(uint32_t ordinal) const;
+
+    // Build a hash index over the definition's column from the rows; false
+    // if the column does not exist or is already hash indexed
+    bool addIndex(const IndexDefinition& definition);
+
+    // The hash index on a column, or nullptr
+    const hashIndex* hashIndexOn(uint32_t ordinal) const;
+
+    // The stored keys of a column for existence probes: its hash index,
+    // else its B+tree index, else nullptr
+    const keyLookup* keys(uint32_t ordinal) const;
+
+    // Append the rows whose column equals key to rids; false when no index
+    // on the column can answer, so the caller has to scan
+    bool lookup(uint32_t ordinal, const Value& key, std::vector<recordId>& rids) const;
+
+    // Check the foreign key on columnName against parent, the heap file of
+    // the table it references; false if the column has no foreign key to
+    // parent's table or parent has no index on the referenced column
+    bool addReference(const std::string& columnName, const heapFile& parent);
+
+    // Pages changed under the log and not written since, each with an LSN
+    // no later than its first such change
+    void dirtyPages(std::vector<std::pair<uint32_t, uint64_t>>& pages) const;
+
+    // Recovery. redo applies a logged change unless the page already has
+    // it (applied tells which), and may run on several threads for
+    // different pages; undo reverses
+    // a change of txn, logging a compensation record. extendTo grows the
+    // file to cover pages that were created but never written, and
+    // rebuildIndexes rebuilds every index and the free-space map from the
+    // rows once recovery has changed them; hash indexes are replaced, so
+    // call it before other files add references to this one.
+    bool redo(const logRecordHeader* record, bool& applied);
+    bool undo(const logRecordHeader* record, walTransaction& txn);
+    // Same for a change whose record is not at hand: type, rid and the
+    // images as logged at lsn, and the record txn logged before it
+    bool undo(logType type, recordId rid, std::string_view before, std::string_view after, uint64_t lsn,
+              uint64_t prevLsn, walTransaction& txn);
+    bool extendTo(uint32_t count);
+    bool rebuildIndexes();
+
+    // pagedFile: raw page I/O for the pool
+    bool readPage(uint32_t page, char* data) const override;
+    bool writePage(uint32_t page, const char* data) const override;
+
+private:
+    size_t encodeRow(const Value* row);
+    bool logChange(walTransaction* txn, logType type, recordId rid, std::string_view before,
+                   std::string_view after, slottedPage& view);
+    void noteDirty(uint32_t page, uint64_t lsn) const;
+    std::atomic<uint64_t>& latchFor(uint32_t page) const { return pageLatches[page % PAGE_LATCHES]; }
+    bool pinForInsert(uint32_t page);
+    void purgeTombstones(uint32_t page, slottedPage& view);
+    void setFree(uint32_t page, size_t freeBytes);
+    long findPage(size_t needed);
+    bool loadFreeSpaceMap();
+    bool rebuildFreeSpaceMap();
+    bool saveFreeSpaceMap() const;
+    bool openIndexes();
+    bool indexTuple(const char* tuple, recordId rid);
+    void unindexTuple(const char* tuple, size_t indexCount);
+    void unindexAll(const char* tuple, recordId rid);
+    bool keysAvailable(const char* before, const char* after) const;
+    void rekey(const char* before, const char* after, recordId rid);
+    bool checkReferences(const char* tuple) const;
+
+    // A foreign key column and the keys of the column it references
+    struct reference {
+        uint32_t ordinal;
+        const keyLookup* keys;
+        std::string target;      // "table.column"
+    };
+
+    std::string path;
+    tupleCodec rowCodec;
+    bufferPool& pool;
+    int fd = -1;
+    std::atomic<uint32_t> pages{0};        // written by the modifying thread only
+    std::unique_ptr<std::atomic<uint64_t>[]> pageLatches;
+
+    pageHandle insertPage;               // pinned while inserts go to it
+    std::vector<uint8_t> freeSpace;      // category per page
+    std::vector<uint8_t> blockMax;       // upper bound of freeSpace per FSM_BLOCK pages
+    std::string encodeBuffer;
+    std::vector<std::unique_ptr<bTreeIndex>> indexes;
+    std::vector<std::unique_ptr<hashIndex>> hashIndexes;
+    std::vector<reference> references;
+    writeAheadLog* log = nullptr;
+    uint32_t logFileId = 0;
+    rowHistory* history = nullptr;
+    // Tombstones by packed recordId, with the transaction that erased the row;
+    // one missing here (left by a crash) belongs to nobody
+    std::unordered_map<uint64_t, walTransaction> tombstones;
+    mutable std::mutex dirtyMutex;       // changedPages is also used by writePage and checkpoints
+    mutable std::unordered_map<uint32_t, uint64_t> changedPages;
+};
+
+// Sequential scan over every live tuple of a heap file. Each page stays
+// pinned while its tuples are returned, so a tuple stays valid until the
+// next call to next().
+class heapScan {
+public:
+    explicit heapScan(const heapFile& file);
+
+    bool next(recordId& rid, const char*& tuple, uint16_t& length);
+
+private:
+    const heapFile& file;
+    pageHandle current;
+    uint32_t page = 0;         // page after current
+    uint16_t slot = 0;
+};
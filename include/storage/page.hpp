@@ -0,0 +1,103 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+
+constexpr size_t PAGE_SIZE = 8192;
+
+// Location of a record: page number in its table's file and slot in that page
+struct recordId {
+    uint32_t page = 0;
+    uint16_t slot = 0;
+
+    bool operator==(const recordId& other) const { return page == other.page && slot == other.slot; }
+    bool operator!=(const recordId& other) const { return !(*this == other); }
+};
+
+// Slotted page layout, all offsets in bytes from the page start:
+//
+//   pageHeader | slot[0] slot[1] ... ->      free      <- ... tuple 1 | tuple 0
+//              ^ sizeof(pageHeader)          ^ freeStart  ^ freeEnd          ^ PAGE_SIZE
+//
+// The slot array grows up from the header and tuple data grows down from the
+// end. A slot keeps its number for the record's lifetime, so a recordId stays
+// valid when the page is compacted; a deleted slot has length 0 and is reused.
+// A tombstone (TOMBSTONE set in length) is a deleted tuple whose slot and
+// bytes stay reserved until purge(), so the delete can still be undone.
+struct pageHeader {
+    uint32_t pageId;
+    uint16_t slotCount;
+    uint16_t freeStart;   // end of the slot array
+    uint16_t freeEnd;     // start of tuple data
+    uint16_t fragmented;  // bytes of deleted tuples below freeEnd, reclaimed by compact()
+    uint32_t reserved;
+    uint64_t pageLsn;     // log record of the latest change, 0 if none (see writeAheadLog)
+};
+
+struct pageSlot {
+    uint16_t offset;
+    uint16_t length;      // 0: free slot
+};
+
+constexpr uint16_t TOMBSTONE = 0x8000;    // pageSlot::length flag; no tuple is that long
+
+// View over one PAGE_SIZE buffer; it owns nothing
+class slottedPage {
+public:
+    // Largest tuple a page can take (one slot, empty page)
+    static constexpr size_t MAX_TUPLE = PAGE_SIZE - sizeof(pageHeader) - sizeof(pageSlot);
+
+    explicit slottedPage(char* data) : data(data) {}
+
+    // Format data as an empty page
+    void init(uint32_t pageId);
+
+    // Whether data is all zeros: a page the file was extended by but that
+    // was never written
+    bool isBlank() const { return header()->freeStart == 0; }
+
+    uint32_t pageId() const { return header()->pageId; }
+    uint16_t slotCount() const { return header()->slotCount; }
+    uint64_t pageLsn() const { return header()->pageLsn; }
+    void setPageLsn(uint64_t lsn) { header()->pageLsn = lsn; }
+
+    // Bytes an insert of any size up to this (slot included) is sure to find
+    size_t freeSpace() const;
+    // Same, once every tombstone is purged
+    size_t reclaimableSpace() const;
+
+    // Copy a tuple in; the slot number, or -1 when it does not fit
+    int insert(const char* tuple, size_t length);
+
+    // Tuple bytes in slot, or nullptr for a free / tombstone / out-of-range slot
+    const char* get(uint16_t slot, uint16_t& length) const;
+
+    bool erase(uint16_t slot);
+
+    // Turn the tuple in slot into a tombstone
+    bool markDeleted(uint16_t slot);
+    bool isTombstone(uint16_t slot) const;
+    // Free a tombstone's slot and bytes
+    bool purge(uint16_t slot);
+
+    // Copy a tuple into a given free or tombstone slot, growing the slot
+    // array up to it; recovery uses this to put a record back where it was
+    bool insertAt(uint16_t slot, const char* tuple, size_t length);
+
+    // Replace the tuple in slot, keeping its slot number; false when the
+    // slot is free or the page has no room for the new length
+    bool update(uint16_t slot, const char* tuple, size_t length);
+
+    // Move tuples together so all free space is contiguous
+    void compact();
+
+    char* raw() { return data; }
+    const char* raw() const { return data; }
+
+private:
+    pageHeader* header() { return reinterpret_cast<pageHeader*>(data); }
+    const pageHeader* header() const { return reinterpret_cast<const pageHeader*>(data); }
+    pageSlot* slots() { return reinterpret_cast<pageSlot*>(data + sizeof(pageHeader)); }
+    const pageSlot* slots() const { return reinterpret_cast<const pageSlot*>(data + sizeof(pageHeader)); }
+
+    char* data;
+};
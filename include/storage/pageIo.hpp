@@ -0,0 +1,8 @@
+#pragma once
+#include <cstddef>
+#include <sys/types.h>
+
+// Positioned I/O of a whole buffer, retrying short reads and writes; a read
+// past the end of the file fails
+bool preadAll(int fd, char* data, size_t size, off_t offset);
+bool pwriteAll(int fd, const char* data, size_t size, off_t offset);
@@ -0,0 +1,192 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+#include "bufferPool.hpp"
+#include "columnEncoding.hpp"
+#include "tupleCodec.hpp"
+
+// Zone map of one column in one block
+struct paxColumnStats {
+    uint32_t nullCount = 0;
+    Value min;                  // NULL when every value is NULL
+    Value max;
+    bool maxTruncated = false;  // max is a prefix of the largest string
+};
+
+// Where a block's column chunk lies, relative to the block's first page
+struct paxChunk {
+    uint32_t firstPage;
+    uint32_t pageCount;
+    uint32_t bytes;
+    chunkEncoding encoding;
+    uint8_t width;              // bit width of packed codes / differences
+};
+
+struct paxBlock {
+    uint32_t firstPage;         // the block header page
+    uint32_t pageCount;         // header included
+    uint32_t rowCount;
+    std::vector<paxChunk> chunks;        // by ordinal
+    std::vector<paxColumnStats> stats;   // by ordinal
+    std::unique_ptr<char[]> boundText;   // long min/max strings
+};
+
+// Append-only PAX storage for one table, read through a shared bufferPool.
+//
+// Rows are collected in memory and written as blocks of up to BLOCK_ROWS
+// rows: a header page with every column's chunk location, encoding and zone
+// map, then one chunk per column. A chunk starts on a page boundary and holds
+// the column's null bitmap (one bit per row, in 64-bit words) followed by
+// its values in the cheapest chunkEncoding for that block. A scan pins only
+// the pages of the columns it asks for.
+//
+// Blocks are immutable once written; the file has no updates or deletes.
+class paxFile : public pagedFile {
+public:
+    static constexpr uint32_t BLOCK_ROWS = 65536;
+    static constexpr size_t BLOCK_BYTES = 16 << 20; // a block is also closed once its chunks reach this
+    static const size_t MAX_COLUMNS;
+
+    paxFile(const std::string& path, const Table& table, bufferPool& pool);
+    ~paxFile() override;
+
+    paxFile(const paxFile&) = delete;
+    paxFile& operator=(const paxFile&) = delete;
+
+    bool isOpen() const { return fd >= 0; }
+    const Table& schema() const { return table; }
+    bufferPool& buffers() const { return pool; }
+
+    // Add one row (one Value per column); written with its block
+    bool append(const Value* row);
+
+    // Whether blocks written from now on may use encodings other than PLAIN
+    void setCompression(bool enabled) { compress = enabled; }
+
+    // Write the rows collected so far as a block, then fsync
+    bool flush();
+
+    size_t blockCount() const { return blocks.size(); }
+    const paxBlock& block(size_t index) const { return blocks[index]; }
+    uint64_t rowCount() const { return storedRows + pendingRows; }
+
+    // False when the block's zone map shows no row of the column within
+    // [low, high]; a NULL bound is open
+    bool mayContain(size_t blockIndex, uint32_t ordinal, const Value& low, const Value& high) const;
+
+    // pagedFile
+    bool readPage(uint32_t page, char* data) const override;
+    bool writePage(uint32_t page, const char* data) const override;
+
+private:
+    struct columnBuilder;
+
+    bool loadBlocks();
+    bool writeBlock();
+
+    std::string path;
+    const Table& table;
+    bufferPool& pool;
+    int fd = -1;
+    uint32_t pages = 0;
+    uint64_t storedRows = 0;
+    std::vector<paxBlock> blocks;
+
+    std::vector<columnBuilder> builders;
+    uint32_t pendingRows = 0;
+    size_t pendingBytes = 0;
+    bool compress = true;
+};
+
+// One column of the current block in a paxScan, still encoded
+class paxColumnView {
+public:
+    const Column* column = nullptr;
+    uint32_t rows = 0;
+    chunkEncoding encoding = chunkEncoding::PLAIN;
+    const uint64_t* nulls = nullptr;   // bit set = NULL
+
+    // Point the view at a loaded chunk
+    void attach(const Column* column, uint32_t rows, const paxChunk& chunk, const char* data);
+
+    bool isNull(uint32_t row) const { return (nulls[row / 64] >> (row % 64)) & 1; }
+
+    // Fixed-width values in plain layout (INT: int64_t, DOUBLE: double,
+    // DATE: int32_t, BOOLEAN: char, CHAR: width bytes each); an encoded
+    // chunk is decoded on first use. Not for VARCHAR/TEXT.
+    template <typename T>
+    const T* data() const { return reinterpret_cast<const T*>(plainValues()); }
+
+    // The value at row; strings view the scan's buffer
+    Value get(uint32_t row) const;
+
+    // Set bit r of matches ((rows + 63) / 64 words, overwritten) when row r
+    // is not NULL and its value op constant holds. Dictionary codes and
+    // frame-of-reference differences are compared without decoding, and a
+    // run is compared once.
+    void select(compareOp op, const Value& constant, uint64_t* matches) const;
+    // Same for value IN (list)
+    void selectIn(const std::vector<Value>& list, uint64_t* matches) const;
+
+private:
+    const char* plainValues() const;
+    Value fixedValue(const char* slot) const;
+    void selectRows(compareOp op, const Value& constant, uint64_t* matches) const;
+    uint32_t runOf(uint32_t row) const;
+
+    uint8_t width = 0;
+    const char* values = nullptr;            // PLAIN: fixed values, or VARCHAR/TEXT offsets
+    const char* text = nullptr;              // PLAIN VARCHAR/TEXT bytes
+    uint32_t dictionarySize = 0;             // DICTIONARY
+    const uint32_t* dictionaryOffsets = nullptr;
+    const char* dictionaryText = nullptr;
+    const uint64_t* packed = nullptr;        // DICTIONARY codes, FRAME_OF_REFERENCE differences
+    uint32_t runCount = 0;                   // RUN_LENGTH
+    const uint32_t* runEnds = nullptr;
+    const char* runValues = nullptr;
+    int64_t base = 0;                        // FRAME_OF_REFERENCE
+    mutable uint32_t lastRun = 0;
+    mutable std::vector<char> decoded;
+    mutable bool isDecoded = false;
+};
+
+// Block-at-a-time scan over some columns of a paxFile
+class paxScan {
+public:
+    paxScan(const paxFile& file, std::vector<uint32_t> ordinals);
+
+    // Only visit blocks whose zone map admits a value in [low, high]; a NULL
+    // bound is open, and string bounds must outlive the scan
+    void addRange(uint32_t ordinal, Value low, Value high);
+
+    // Load the next block's columns; false at the end or on a read error
+    bool next();
+
+    uint32_t rows() const { return current ? current->rowCount : 0; }
+    // Column i of the ordinals given to the constructor
+    const paxColumnView& column(size_t i) const { return views[i]; }
+
+    size_t blocksSkipped() const { return skipped; }
+
+private:
+    struct range {
+        uint32_t ordinal;
+        Value low;
+        Value high;
+    };
+
+    bool loadChunk(size_t i);
+
+    const paxFile& file;
+    std::vector<uint32_t> ordinals;
+    std::vector<range> ranges;
+    std::vector<std::unique_ptr<char[]>> buffers;
+    std::vector<size_t> capacities;
+    std::vector<paxColumnView> views;
+    const paxBlock* current = nullptr;
+    size_t nextBlock = 0;
+    size_t skipped = 0;
+};
@@ -0,0 +1,89 @@
+#pragma once
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <mutex>
+#include <thread>
+#include "bufferPool.hpp"
+#include "heapFile.hpp"
+#include "writeAheadLog.hpp"
+
+struct recoveryStats {
+    double analysisSeconds = 0;
+    double redoSeconds = 0;
+    double undoSeconds = 0;
+    uint64_t analyzedBytes = 0;   // log read by analysis, from the checkpoint on
+    uint64_t redoBytes = 0;       // log read by redo, from the oldest dirty page on
+    uint64_t redone = 0;          // changes applied to pages
+    uint64_t undone = 0;
+    uint64_t losers = 0;          // transactions rolled back
+};
+
+// ARIES-style restart recovery and fuzzy checkpoints for the heap files
+// that share one writeAheadLog.
+//
+// A checkpoint does not stop writers: it notes the log's end as its start,
+// waits until the log is durable up to there, and appends the active
+// transactions (with their latest LSNs) and every file's dirty page table
+// as CHECKPOINT records, then points the log's master file at them. A
+// background thread takes one every interval, first writing back the
+// dirty pages that have been dirty longest, so the redo start keeps moving
+// forward.
+//
+// recover() runs three passes. Analysis reads from the checkpoint's start
+// to the end of the log, rebuilding the transaction and dirty page tables.
+// Redo reads from the oldest LSN in the dirty page table and repeats every
+// change a page does not have yet (its page LSN is older), with the pages
+// split into partitions by hash and each partition replayed on its own
+// thread. Undo rolls the transactions that never ended back, newest record
+// first across all of them, logging a compensation record per change so a
+// crash during undo never undoes anything twice. Restart work therefore
+// depends on what happened since the last checkpoint, not on the size of
+// the log.
+//
+// Rollback of a live transaction works the same way. Neither takes locks:
+// keeping transactions off each other's rows is the caller's job.
+class recoveryManager {
+public:
+    recoveryManager(writeAheadLog& log, bufferPool& pool);
+    ~recoveryManager();
+
+    recoveryManager(const recoveryManager&) = delete;
+    recoveryManager& operator=(const recoveryManager&) = delete;
+
+    // Log file's changes as fileId; attach every file before recover()
+    bool attach(uint32_t fileId, heapFile& file);
+
+    // Bring the attached files to the state the log's ended transactions
+    // left, using redoThreads threads for redo (0: one per CPU), then
+    // rebuild their indexes, flush them and checkpoint
+    bool recover(size_t redoThreads = 0, recoveryStats* stats = nullptr);
+
+    // Undo txn's changes and end it with ABORT
+    bool rollback(walTransaction& txn);
+
+    // Take a fuzzy checkpoint now
+    bool checkpoint();
+
+    // Checkpoint every interval, each time first writing back up to
+    // pagesPerRound of the longest-dirty pages
+    void startCheckpoints(std::chrono::milliseconds interval, size_t pagesPerRound);
+    void stopCheckpoints();
+
+private:
+    heapFile* fileFor(const logRecordHeader* record) const;
+    bool undoFrom(walReader& reader, std::vector<walTransaction>& transactions, recoveryStats& stats);
+    void writeOldestPages(size_t count);
+
+    writeAheadLog& log;
+    bufferPool& pool;
+    std::map<uint32_t, heapFile*> files;
+    std::mutex checkpointMutex;          // one checkpoint at a time
+
+    std::mutex backgroundMutex;
+    std::condition_variable backgroundWake;
+    bool stopping = false;
+    std::thread background;
+};
@@ -0,0 +1,324 @@
+#pragma once
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <set>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+#include "heapFile.hpp"
+#include "writeAheadLog.hpp"
+
+class transactionManager;
+class versionedTable;
+
+enum class writeStatus : uint8_t {
+    OK,
+    CONFLICT,   // another transaction changed the row after the snapshot, or is changing it
+    MISSING,    // the snapshot has no such row
+    ERROR       // the row does not match the table (logged), or the transaction has ended
+};
+
+struct mvccStats {
+    uint64_t commits = 0;
+    uint64_t failedCommits = 0;   // rolled back while committing (duplicate key, I/O)
+    uint64_t conflicts = 0;
+    uint64_t versions = 0;        // old row images kept now
+    uint64_t versionBytes = 0;
+    uint64_t collected = 0;       // old row images freed so far
+};
+
+// One transaction of a transactionManager. It reads the snapshot taken when
+// it began plus its own writes, which stay in it until commit. Ending it
+// without commit aborts it; so does destroying it while it is active.
+class mvccTransaction {
+public:
+    mvccTransaction() = default;
+    ~mvccTransaction();
+
+    mvccTransaction(mvccTransaction&& other) noexcept { *this = std::move(other); }
+    mvccTransaction& operator=(mvccTransaction&& other) noexcept;
+    mvccTransaction(const mvccTransaction&) = delete;
+    mvccTransaction& operator=(const mvccTransaction&) = delete;
+
+    bool isActive() const { return active; }
+    // Commit time of the newest transaction it sees
+    uint64_t snapshot() const { return start; }
+    // A write conflict happened; commit will abort it
+    bool isDoomed() const { return conflicted; }
+
+private:
+    friend class transactionManager;
+    friend class versionedTable;
+    friend class snapshotScan;
+
+    struct pendingWrite {
+        versionedTable* table;
+        recordId rid;          // for an INSERT, its provisional id
+        logType type;          // INSERT, UPDATE or DELETE
+        std::string tuple;     // empty for DELETE
+    };
+
+    transactionManager* manager = nullptr;
+    uint64_t id = 0;
+    uint64_t start = 0;
+    bool active = false;
+    bool conflicted = false;
+    std::vector<pendingWrite> writes;
+    // Existing rows it has written (and holds the right to write), by
+    // table and packed recordId
+    std::map<std::pair<const versionedTable*, uint64_t>, size_t> written;
+};
+
+// A heap file's rows under snapshot isolation (see transactionManager).
+//
+// The heap holds the newest committed version of every row. Each row slot
+// that commits have changed has a version chain, newest first: every entry
+// is the image the slot held before one committed change (empty if the slot
+// was free) and that change's commit time. A snapshot at time t reads the
+// slot from the heap and walks the chain undoing every change committed
+// after t. Chains are keyed by slot rather than by row, so a row moved or
+// removed by the heap and a slot reused by a later insert need nothing
+// special. The heap reports each change under its page latch (rowHistory),
+// so a reader's page copy and the chains it looks up always agree.
+//
+// Rows a transaction inserts get provisional ids from PENDING_PAGE on,
+// which no heap file reaches, and their real ids only when it commits.
+class versionedTable : private rowHistory {
+public:
+    static constexpr uint32_t PENDING_PAGE = 0xFFFF0000u;
+
+    versionedTable(transactionManager& manager, heapFile& file);
+    ~versionedTable() override;
+
+    versionedTable(const versionedTable&) = delete;
+    versionedTable& operator=(const versionedTable&) = delete;
+
+    heapFile& file() const { return heap; }
+
+    // The row at rid as txn sees it; false if there is none
+    bool get(const mvccTransaction& txn, recordId rid, std::string& tuple) const;
+
+    // Append the rows txn sees whose column (PRIMARY KEY / UNIQUE) equals
+    // key. The index holds the newest keys, so once commits have changed
+    // the table since txn's snapshot the rows they changed are checked too,
+    // through their chains. false when the column has no B+tree index.
+    bool lookup(const mvccTransaction& txn, uint32_t ordinal, const Value& key, std::vector<recordId>& rids) const;
+
+    // Add a row for txn; rid is its provisional id. Keys and foreign keys
+    // are checked when txn commits.
+    bool insert(mvccTransaction& txn, const Value* row, recordId& rid);
+
+    // Replace or remove a row for txn. The first write to a row claims it:
+    // CONFLICT if a transaction committed a change to it after txn's
+    // snapshot or has claimed it, in which case txn can only abort.
+    writeStatus update(mvccTransaction& txn, recordId rid, const Value* row);
+    writeStatus erase(mvccTransaction& txn, recordId rid);
+
+private:
+    friend class transactionManager;
+    friend class snapshotScan;
+
+    struct rowVersion {
+        std::atomic<uint64_t> timestamp;      // commit time of the change that replaced image
+        std::atomic<rowVersion*> older{nullptr};
+        std::string image;                    // empty: the slot was free
+    };
+
+    struct slotChain {
+        uint16_t slot;
+        rowVersion* newest;
+    };
+
+    // Chains of a share of the pages, by page
+    struct chainStripe {
+        std::mutex mtx;
+        std::unordered_map<uint32_t, std::vector<slotChain>> pages;
+    };
+
+    // A page's rows as a snapshot sees them
+    struct visibleRow {
+        uint16_t slot;
+        uint32_t offset;       // into pageRows::data
+        uint16_t length;
+    };
+    struct pageRows {
+        std::unique_ptr<char[]> copy;
+        std::vector<slotChain> chains;
+        std::string data;
+        std::vector<visibleRow> rows;
+    };
+
+    static constexpr size_t CHAIN_STRIPES = 64;
+
+    // rowHistory: record the image a slot held before an applied change
+    void changed(recordId rid, std::string_view before, std::string_view after, uint64_t lsn) override;
+
+    bool readPage(uint32_t page, uint64_t at, int onlySlot, pageRows& out) const;
+    bool readVisible(const mvccTransaction& txn, recordId rid, std::string& tuple) const;
+    bool encode(const Value* row, std::string& tuple) const;
+    mvccTransaction::pendingWrite* ownWrite(mvccTransaction& txn, recordId rid) const;
+    const mvccTransaction::pendingWrite* ownWrite(const mvccTransaction& txn, recordId rid) const;
+    writeStatus claim(mvccTransaction& txn, recordId rid);
+    void unclaim(recordId rid);
+    uint64_t newestChange(recordId rid) const;
+    void changedSince(uint64_t at, std::vector<recordId>& rids) const;
+
+    bool apply(mvccTransaction::pendingWrite& write, walTransaction& wal);
+    void unlinkNewest(recordId rid, rowVersion* version, std::vector<rowVersion*>& garbage);
+    size_t prune(uint64_t oldest, size_t budget, std::vector<rowVersion*>& garbage);
+
+    chainStripe& stripeFor(uint32_t page) const { return stripes[page % CHAIN_STRIPES]; }
+
+    transactionManager& manager;
+    heapFile& heap;
+    mutable std::unique_ptr<chainStripe[]> stripes;
+    // Commit time of the newest change applied, UINT64_MAX from before the
+    // index changes until the commit is stamped (or for good, if it failed)
+    std::atomic<uint64_t> lastChange{0};
+
+    std::mutex claimMutex;
+    std::unordered_map<uint64_t, uint64_t> claims;        // packed recordId -> transaction id
+
+    std::mutex collectMutex;
+    std::deque<std::pair<uint64_t, recordId>> changes;    // commit time and slot, oldest first
+};
+
+// Rows of a versionedTable as a transaction sees them: the committed rows
+// of its snapshot with its own writes applied, then the rows it inserted.
+// A tuple stays valid until the next call to next(). The scan never holds
+// a latch between calls, so it can run for as long as it likes.
+class snapshotScan {
+public:
+    snapshotScan(const versionedTable& table, const mvccTransaction& txn);
+
+    bool next(recordId& rid, const char*& tuple, uint16_t& length);
+
+private:
+    const versionedTable& table;
+    const mvccTransaction& txn;
+    uint32_t pages;            // the file's size when the scan began
+    uint32_t page = 0;         // next page to read
+    versionedTable::pageRows current;
+    size_t row = 0;
+    size_t pending = 0;        // next of txn's writes to look at, once the pages are done
+};
+
+// Multi-version concurrency control for heap files sharing one log: every
+// transaction reads a snapshot, so readers never wait for writers and
+// writers never wait for readers.
+//
+// Time is a counter bumped by every commit. A transaction's snapshot is the
+// time it began and it sees exactly the commits up to then. Writes are
+// buffered in the transaction; commit applies them to the heap files (one
+// committer at a time, each change logged), stamps the old images with a
+// new commit time, appends COMMIT, and lets the next committer in while it
+// waits for the log, so group commit still works. A commit becomes visible
+// to new snapshots only once it is durable and every earlier one is
+// visible. If applying fails (a duplicate key, say) the changes are rolled
+// back from the images kept in memory, each undo logged, and commit returns
+// false.
+//
+// Write-write conflicts are detected at the first UPDATE/DELETE of a row:
+// the writer claims the row, and fails if another transaction holds the
+// claim or committed a change to it after the writer's snapshot (first
+// updater wins). Inserts claim nothing; duplicate keys show at commit.
+//
+// Old images are freed once every active snapshot is newer than the change
+// that replaced them, by collect() or a background collector, at most a
+// budget of them per round so it never holds things up. Readers pin the
+// images they walk with an epochGuard.
+class transactionManager {
+public:
+    explicit transactionManager(writeAheadLog& log);
+    ~transactionManager();
+
+    transactionManager(const transactionManager&) = delete;
+    transactionManager& operator=(const transactionManager&) = delete;
+
+    // Put file, already logging to log (see recoveryManager::attach), under
+    // the manager before any transaction starts. From then on it may only be changed through the
+    // returned table.
+    versionedTable& manage(heapFile& file);
+
+    mvccTransaction begin();
+
+    // Apply txn's writes and make them durable; false if it was doomed by a
+    // conflict or applying failed, and in both cases nothing it wrote
+    // remains. False is also returned when the log cannot be flushed once
+    // the writes are applied: then the outcome is unknown. The writes stay
+    // in place and visible, since the log can no longer record their undo,
+    // and may or may not survive a crash; the log has failed, so every
+    // later commit fails too. txn has ended either way.
+    bool commit(mvccTransaction& txn);
+    void abort(mvccTransaction& txn);
+
+    // Latest commit time new snapshots see
+    uint64_t now() const { return published.load(std::memory_order_acquire); }
+    // No snapshot in use is older than this
+    uint64_t oldestSnapshot() const;
+
+    // Free up to about budget old images no snapshot can see; how many
+    size_t collect(size_t budget);
+    void startCollector(std::chrono::milliseconds interval, size_t budget);
+    void stopCollector();
+
+    mvccStats stats() const;
+
+private:
+    friend class versionedTable;
+    friend class mvccTransaction;
+
+    // An image pushed by the commit being applied, with what undoing the
+    // change needs: version holds the before image
+    struct appliedChange {
+        versionedTable* table;
+        recordId rid;
+        versionedTable::rowVersion* version;
+        logType type;
+        std::string after;
+        uint64_t lsn;
+    };
+
+    void release(mvccTransaction& txn);
+    void finish(mvccTransaction& txn);
+    void publish(uint64_t timestamp);
+    static void discard(std::vector<versionedTable::rowVersion*>& garbage);
+
+    writeAheadLog& log;
+    std::vector<std::unique_ptr<versionedTable>> tables;
+    std::atomic<uint64_t> nextId{1};
+
+    mutable std::mutex activeMutex;
+    std::multiset<uint64_t> snapshots;              // of active transactions
+
+    std::mutex commitMutex;                         // one commit applies at a time
+    uint64_t lastCommit = 1;                        // guarded by commitMutex
+    std::vector<appliedChange>* applying = nullptr; // guarded by commitMutex
+
+    std::mutex publishMutex;
+    std::condition_variable publishTurn;
+    std::atomic<uint64_t> published{1};
+
+    std::atomic<uint64_t> commits{0};
+    std::atomic<uint64_t> failedCommits{0};
+    std::atomic<uint64_t> conflicts{0};
+    std::atomic<uint64_t> versions{0};
+    std::atomic<uint64_t> versionBytes{0};
+    std::atomic<uint64_t> collected{0};
+
+    std::mutex collectMutex;                        // one collection at a time
+    size_t nextTable = 0;                           // guarded by collectMutex
+    std::mutex backgroundMutex;
+    std::condition_variable backgroundWake;
+    bool stopping = false;
+    std::thread background;
+};
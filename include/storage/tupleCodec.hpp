@@ -0,0 +1,41 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include "../common/value.hpp"
+#include "../schema/schema.hpp"
+
+// Encodes rows of one table to and from the byte form stored in pages.
+//
+// A tuple is the table's fixed row (Table::fixedRowSize bytes: the null
+// bitmap, then every column's slot at Column::offset) followed by the
+// variable part. A VARCHAR/TEXT slot holds a uint32 offset from the tuple
+// start and a uint32 length; CHAR(n) is stored inline, zero padded.
+// A set null bit means NULL and leaves the slot zeroed.
+class tupleCodec {
+public:
+    explicit tupleCodec(const Table& table) : table(table) {}
+
+    // Whether value can be stored in column; variable gets the bytes it
+    // needs outside the fixed row (VARCHAR/TEXT text)
+    static bool fits(const Column& column, const Value& value, size_t& variable);
+
+    // Bytes encode() writes for row (one Value per column, by ordinal);
+    // 0 when a value does not fit its column
+    size_t size(const Value* row) const;
+
+    // Write row into out, which has size(row) bytes. INT values widen into
+    // DOUBLE columns; any other type mismatch or an over-long string fails.
+    bool encode(const Value* row, char* out) const;
+
+    // One column of an encoded tuple. Strings view the tuple's bytes, so they
+    // are only valid while those bytes are.
+    Value decode(const char* tuple, uint32_t ordinal) const;
+
+    // Every column, into row[0 .. columns.size())
+    void decodeAll(const char* tuple, Value* row) const;
+
+    const Table& schema() const { return table; }
+
+private:
+    const Table& table;
+};
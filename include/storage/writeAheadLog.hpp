@@ -0,0 +1,233 @@
+#pragma once
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+#include "page.hpp"
+
+enum class logType : uint8_t {
+    INSERT = 1,   // after image of a new tuple
+    DELETE,       // before image of a removed tuple
+    UPDATE,       // both images of a tuple changed in place
+    COMMIT,
+    ABORT,        // the transaction's changes have been undone
+    CHECKPOINT    // one part of a fuzzy checkpoint (see recoveryManager)
+};
+
+// logRecordHeader::flags
+constexpr uint8_t LOG_COMPENSATION = 1;  // redo-only record written while undoing
+
+const char* logTypeToString(logType type);
+
+// Fixed part of every log record; the before image and then the after image
+// follow it, and the whole record is padded to a multiple of 8 bytes.
+//
+// A compensation record describes the change that undid an earlier record,
+// as an ordinary INSERT, DELETE or UPDATE; undoNextLsn is the record to
+// undo after it. A CHECKPOINT part keeps the checkpoint's start LSN in
+// undoNextLsn and the first transaction id not handed out by then in txn.
+struct logRecordHeader {
+    uint32_t length;        // whole record including padding; stored last
+    uint32_t checksum;      // CRC-32C of the record from lsn on, images included
+    uint64_t lsn;           // the record's own position in the log
+    uint64_t txn;
+    uint64_t prevLsn;       // the transaction's previous record, 0 for its first
+    uint64_t undoNextLsn;
+    uint32_t fileId;        // which heap file (see heapFile::setLog)
+    uint32_t page;
+    uint16_t slot;
+    uint16_t beforeLength;
+    uint16_t afterLength;
+    uint8_t type;           // logType
+    uint8_t flags;
+};
+
+static_assert(sizeof(logRecordHeader) == 56, "log records start with a 56-byte header");
+
+// One transaction's position in the log
+struct walTransaction {
+    uint64_t id = 0;
+    uint64_t lastLsn = 0;   // its latest record, chained through prevLsn
+    uint32_t slot = 0;      // its entry in the log's active transaction table
+};
+
+// Append-only redo/undo log with group commit.
+//
+// An LSN is the byte offset of a record in the log file, so LSN order is
+// log order. Appending is lock-free: a writer reserves its bytes with one
+// fetch_add on the next LSN, copies the record into a ring buffer at that
+// position, and publishes it by storing the length word last. Any number of
+// sessions append at once.
+//
+// A flusher thread writes the ring out in order, stopping at the first
+// record that is not published yet, and fsyncs once for everything it
+// wrote. A commit appends its COMMIT record and sleeps until the flusher
+// has synced past it, so commits arriving while one fsync is in flight all
+// share the next one. A commit delay makes the flusher wait that long
+// after being woken, to gather more commits per fsync at the cost of
+// latency. Flushed ring space is zeroed and handed back to writers, who
+// wait for it when the ring is full.
+//
+// The log also keeps the table of active transactions and their latest
+// LSNs for checkpoints, and "<path>.master" names the latest complete
+// checkpoint, so opening scans only the log written since that checkpoint
+// began.
+//
+// The file starts with a 16-byte header, so the first record has LSN 16
+// and LSN 0 means "none".
+class writeAheadLog {
+public:
+    static constexpr size_t DEFAULT_BUFFER = 16u << 20;
+    static constexpr uint64_t FIRST_LSN = 16;
+    static constexpr uint32_t MAX_ACTIVE = 4096;   // transactions at once
+
+    // Open or create the log at path; records after the first torn or
+    // corrupt one are cut off. bufferBytes is rounded up to a power of two.
+    writeAheadLog(const std::string& path, size_t bufferBytes = DEFAULT_BUFFER,
+                  std::chrono::microseconds commitDelay = std::chrono::microseconds(0));
+    ~writeAheadLog();
+
+    writeAheadLog(const writeAheadLog&) = delete;
+    writeAheadLog& operator=(const writeAheadLog&) = delete;
+
+    bool isOpen() const { return fd >= 0; }
+
+    const std::string& filePath() const { return path; }
+
+    // Start a transaction with a new id; ids keep growing across reopenings.
+    // Waits while MAX_ACTIVE transactions are running.
+    walTransaction begin();
+
+    // Take over a transaction found in the log by recovery, to undo it
+    walTransaction resume(uint64_t id, uint64_t lastLsn);
+
+    // Append a change to rid of file fileId; returns the record's LSN, or 0
+    // if the log has failed. Does not wait for the disk.
+    uint64_t append(walTransaction& txn, logType type, uint32_t fileId, recordId rid,
+                    std::string_view before, std::string_view after);
+
+    // Append a compensation record; undoNext is the next record of txn to undo
+    uint64_t compensate(walTransaction& txn, logType type, uint32_t fileId, recordId rid,
+                        std::string_view before, std::string_view after, uint64_t undoNext);
+
+    // Append COMMIT, wait until it is durable and end the transaction
+    bool commit(walTransaction& txn);
+
+    // Append COMMIT and end the transaction without waiting; it is durable
+    // once flushTo(lsn + 1) returns for the LSN returned, 0 if the log failed
+    uint64_t appendCommit(walTransaction& txn);
+
+    // Append ABORT without waiting and end the transaction; its changes must
+    // already be undone
+    bool abort(walTransaction& txn);
+
+    // Whether txn has not ended yet
+    bool isActive(const walTransaction& txn) const;
+
+    // Active transactions with a record in the log, for a checkpoint started
+    // at an LSN the log is durable up to
+    std::vector<walTransaction> activeTransactions() const;
+
+    // Append one part of a checkpoint that started at beginLsn, when
+    // firstTxn was the next transaction id; parts chain through prevLsn
+    uint64_t appendCheckpoint(uint64_t beginLsn, uint64_t firstTxn, uint64_t prevPart, std::string_view data);
+
+    // Record the durable checkpoint whose last part is at lsn in the master file
+    bool setCheckpoint(uint64_t lsn);
+    uint64_t checkpointLsn() const { return masterLsn.load(std::memory_order_acquire); }
+    uint64_t nextTransaction() const { return nextTxn.load(); }
+
+    // Wait until every record before lsn is durable
+    bool flushTo(uint64_t lsn);
+
+    void setCommitDelay(std::chrono::microseconds delay) { commitDelayMicros.store(delay.count(), std::memory_order_relaxed); }
+
+    uint64_t endLsn() const { return reserved.load(std::memory_order_relaxed); }
+    uint64_t durableLsn() const { return durable.load(std::memory_order_acquire); }
+    uint64_t syncCount() const { return syncs.load(std::memory_order_relaxed); }
+    uint64_t commitCount() const { return commits.load(std::memory_order_relaxed); }
+
+private:
+    struct activeEntry {
+        uint64_t id = 0;                      // 0: free; guarded by activeMutex
+        std::atomic<uint64_t> lastLsn{0};
+    };
+
+    bool readMaster(uint64_t& lsn) const;
+    uint64_t write(logRecordHeader& header, walTransaction* txn, std::string_view before, std::string_view after);
+    void end(walTransaction& txn);
+    uint64_t reserve(size_t length);
+    void copyIn(uint64_t lsn, const char* data, size_t length);
+    void flusherLoop();
+    bool writeOut(uint64_t from, uint64_t to);
+
+    std::string path;
+    int fd = -1;
+    std::unique_ptr<char[]> ring;
+    size_t capacity = 0;                      // power of two
+    std::atomic<uint64_t> reserved{0};        // next LSN to hand out
+    std::atomic<uint64_t> recycled{0};        // ring space below this LSN + capacity is free
+    std::atomic<uint64_t> durable{0};         // everything below is on disk
+    std::atomic<uint64_t> nextTxn{1};
+    std::atomic<int64_t> commitDelayMicros{0};
+    std::atomic<uint64_t> syncs{0};
+    std::atomic<uint64_t> commits{0};
+    std::atomic<uint64_t> masterLsn{0};        // latest checkpoint, 0 if none
+
+    mutable std::mutex activeMutex;
+    std::condition_variable slotFreed;
+    std::unique_ptr<activeEntry[]> active;
+    std::vector<uint32_t> freeSlots;
+
+    std::mutex flushMutex;
+    std::condition_variable flushWanted;      // wakes the flusher
+    std::condition_variable flushDone;        // wakes committers and writers waiting for space
+    uint64_t requested = 0;                   // highest LSN someone waits for
+    bool failed = false;
+    bool stopping = false;
+    std::thread flusher;
+};
+
+// Forward scan over a log file, for opening and recovery. The file is
+// mapped read-only; records are returned in place.
+class walReader {
+public:
+    explicit walReader(const std::string& path);
+    ~walReader();
+
+    walReader(const walReader&) = delete;
+    walReader& operator=(const walReader&) = delete;
+
+    bool isOpen() const { return base != nullptr; }
+
+    // Next intact record; false at the end of the log or at the first torn
+    // or corrupt record
+    bool next(const logRecordHeader*& header, std::string_view& before, std::string_view& after);
+
+    // Continue the scan at lsn, which must start a record
+    void seek(uint64_t lsn) { offset = lsn; }
+
+    // The intact record at lsn, or nullptr
+    const logRecordHeader* at(uint64_t lsn) const;
+
+    // LSN after the last record returned: the end of the intact log
+    uint64_t position() const { return offset; }
+
+private:
+    const logRecordHeader* validate(uint64_t lsn) const;
+
+    char* base = nullptr;
+    size_t length = 0;
+    uint64_t offset = writeAheadLog::FIRST_LSN;
+};
+
+// Images of a record returned by walReader
+std::string_view logBefore(const logRecordHeader* header);
+std::string_view logAfter(const logRecordHeader* header);
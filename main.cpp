@@ -2,39 +2,53 @@
 #include <string>
 #include <sstream>  // for std::ostringstream
 #include "include/parser/lexer.hpp"
+#include "include/parser/streamLexer.hpp"
 #include "include/parser/parser.hpp"
 #include "include/parser/structQuery.hpp"
 #include "include/schema/schema.hpp" // Include the schema header
 
-int main() {
+int main(int argc, char** argv) {
     std::cout << "welcome to your database center" << std::endl;
     std::cout << "This is a simple database program." << std::endl;
     std::cout << "You can use this program to manage your data." << std::endl;
 
+    // Replay a SQL dump file statement by statement without loading it whole
+    if (argc > 1) {
+        mappedFile dump(argv[1]);
+        if (!dump.isOpen()) {
+            std::cerr << "Error: cannot open '" << argv[1] << "'" << std::endl;
+            return 1;
+        }
+
+        streamLexer stream(dump);
+        std::vector<TokenView> tokens;
+        size_t tokenCount = 0;
+        while (stream.nextStatementTokens(tokens)) {
+            tokenCount += tokens.size();
+        }
+
+        std::cout << "Replayed " << stream.statementsRead() << " statements ("
+                  << tokenCount << " tokens) from " << argv[1] << std::endl;
+        return 0;
+    }
+
     // Create the database schema
     // DatabaseSchema schema;
 
     // // Add tables and columns to the schema
-    // Table users = {
-    //     "users",
-    //     {
-    //         {"id", {"id", "INT", true, true, true}}, // Primary key, unique, not null
-    //         {"name", {"name", "VARCHAR", false, false, false}},
-    //         {"age", {"age", "INT", false, false, false}}
-    //     },
-    //     {} // No foreign keys
-    // };
+    // Table users;
+    // users.name = "users";
+    // users.addColumn({"id", "INT", true, true, true}); // Primary key, unique, not null
+    // users.addColumn({"name", "VARCHAR", false, false, false});
+    // users.addColumn({"age", "INT", false, false, false});
     // schema.addTable(users);
 
-    // Table orders = {
-    //     "orders",
-    //     {
-    //         {"order_id", {"order_id", "INT", true, true, true}}, // Primary key, unique, not null
-    //         {"user_id", {"user_id", "INT", false, false, true}}, // Foreign key
-    //         {"amount", {"amount", "DOUBLE", false, false, false}}
-    //     },
-    //     {{"user_id", "users.id"}} // Foreign key: user_id -> users.id
-    // };
+    // Table orders;
+    // orders.name = "orders";
+    // orders.addColumn({"order_id", "INT", true, true, true}); // Primary key, unique, not null
+    // orders.addColumn({"user_id", "INT", false, false, true}); // Foreign key
+    // orders.addColumn({"amount", "DOUBLE", false, false, false});
+    // orders.foreignKeys = {{"user_id", "users.id"}}; // Foreign key: user_id -> users.id
     // schema.addTable(orders);
 
     // // Print the schema for debugging
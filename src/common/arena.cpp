@@ -0,0 +1,72 @@
+#include <cstdint>
+#include <cstdlib>
+#include <new>
+#include "../../include/common/arena.hpp"
+
+arena::arena(size_t initialBlockSize) : nextBlockSize(initialBlockSize ? initialBlockSize : DEFAULT_BLOCK_SIZE) {}
+
+arena::~arena() {
+    freeBlocks();
+}
+
+void arena::freeBlocks() {
+    while (head) {
+        blockHeader* next = head->next;
+        std::free(head);
+        head = next;
+    }
+    cursor = limit = nullptr;
+    totalCapacity = 0;
+    blocks = 0;
+}
+
+void arena::addBlock(size_t minSize) {
+    size_t size = nextBlockSize;
+    while (size < minSize) size *= 2;
+
+    void* memory = std::malloc(sizeof(blockHeader) + size);
+    if (!memory) throw std::bad_alloc();
+
+    blockHeader* block = static_cast<blockHeader*>(memory);
+    block->next = head;
+    block->size = size;
+    head = block;
+
+    cursor = reinterpret_cast<char*>(block + 1);
+    limit = cursor + size;
+    totalCapacity += size;
+    blocks++;
+    nextBlockSize = size * 2;
+}
+
+void* arena::do_allocate(size_t bytes, size_t alignment) {
+    uintptr_t current = reinterpret_cast<uintptr_t>(cursor);
+    uintptr_t aligned = (current + alignment - 1) & ~(uintptr_t(alignment) - 1);
+
+    if (!cursor || aligned + bytes > reinterpret_cast<uintptr_t>(limit)) {
+        addBlock(bytes + alignment);
+        current = reinterpret_cast<uintptr_t>(cursor);
+        aligned = (current + alignment - 1) & ~(uintptr_t(alignment) - 1);
+    }
+
+    cursor = reinterpret_cast<char*>(aligned + bytes);
+    used += bytes;
+    return reinterpret_cast<void*>(aligned);
+}
+
+void arena::reset() {
+    used = 0;
+    if (!head) return;
+
+    // Merge into a single block big enough for the last statement's peak
+    if (head->next) {
+        size_t total = totalCapacity;
+        freeBlocks();
+        nextBlockSize = total;
+        addBlock(total);
+        return;
+    }
+
+    cursor = reinterpret_cast<char*>(head + 1);
+    limit = cursor + head->size;
+}
@@ -0,0 +1,123 @@
+#include <atomic>
+#include <mutex>
+#include <vector>
+#include "../../include/common/epoch.hpp"
+
+namespace {
+
+constexpr uint64_t QUIESCENT = 0;
+
+struct readerSlot {
+    std::atomic<uint64_t> epoch{QUIESCENT}; // epoch seen on entry, or QUIESCENT
+    std::atomic<bool> inUse{true};
+    unsigned depth = 0;                     // owner thread only
+};
+
+struct retiredObject {
+    uint64_t epoch;
+    std::function<void()> destroy;
+};
+
+// Reader slots are never freed, only handed to the next thread, so a writer
+// can scan them without holding the lock against exiting threads
+struct epochState {
+    std::atomic<uint64_t> global{1};
+    std::mutex mtx;
+    std::vector<readerSlot*> slots;
+    std::vector<retiredObject> retired;
+};
+
+epochState& state() {
+    static epochState* instance = new epochState(); // never destroyed: threads may exit late
+    return *instance;
+}
+
+struct slotOwner {
+    readerSlot* slot = nullptr;
+
+    slotOwner() {
+        epochState& st = state();
+        std::lock_guard<std::mutex> lock(st.mtx);
+        for (readerSlot* candidate : st.slots) {
+            bool expected = false;
+            if (candidate->inUse.compare_exchange_strong(expected, true)) {
+                slot = candidate;
+                return;
+            }
+        }
+        slot = new readerSlot();
+        st.slots.push_back(slot);
+    }
+
+    ~slotOwner() {
+        slot->epoch.store(QUIESCENT, std::memory_order_release);
+        slot->inUse.store(false, std::memory_order_release);
+    }
+};
+
+readerSlot& localSlot() {
+    static thread_local slotOwner owner;
+    return *owner.slot;
+}
+
+// Oldest epoch any reader may still be in; callers hold st.mtx
+uint64_t oldestActive(epochState& st) {
+    uint64_t oldest = st.global.load(std::memory_order_seq_cst);
+    for (readerSlot* slot : st.slots) {
+        uint64_t epoch = slot->epoch.load(std::memory_order_seq_cst);
+        if (epoch != QUIESCENT && epoch < oldest) oldest = epoch;
+    }
+    return oldest;
+}
+
+} // namespace
+
+void epochReclaimer::enter() {
+    readerSlot& slot = localSlot();
+    if (slot.depth++ == 0) {
+        // seq_cst store: a writer's later scan sees this, or our next load of
+        // the shared pointer sees its new value
+        slot.epoch.store(state().global.load(std::memory_order_seq_cst), std::memory_order_seq_cst);
+    }
+}
+
+void epochReclaimer::exit() {
+    readerSlot& slot = localSlot();
+    if (--slot.depth == 0) slot.epoch.store(QUIESCENT, std::memory_order_release);
+}
+
+void epochReclaimer::retire(std::function<void()> destroy) {
+    epochState& st = state();
+    {
+        std::lock_guard<std::mutex> lock(st.mtx);
+        // Readers entering from now on are in a later epoch and cannot reach it
+        st.retired.push_back({st.global.fetch_add(1, std::memory_order_seq_cst), std::move(destroy)});
+    }
+    reclaim();
+}
+
+void epochReclaimer::reclaim() {
+    epochState& st = state();
+    std::vector<retiredObject> ready;
+    {
+        std::lock_guard<std::mutex> lock(st.mtx);
+        uint64_t oldest = oldestActive(st);
+        size_t kept = 0;
+        for (retiredObject& object : st.retired) {
+            if (object.epoch < oldest) {
+                ready.push_back(std::move(object));
+            } else {
+                st.retired[kept++] = std::move(object);
+            }
+        }
+        st.retired.resize(kept);
+    }
+    // Destructors run outside the lock; they may retire more objects
+    for (retiredObject& object : ready) object.destroy();
+}
+
+size_t epochReclaimer::pending() {
+    epochState& st = state();
+    std::lock_guard<std::mutex> lock(st.mtx);
+    return st.retired.size();
+}
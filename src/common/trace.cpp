@@ -0,0 +1,25 @@
+#include "../../include/common/trace.hpp"
+
+#ifdef MINISQL_ENABLE_TRACE
+
+#include <atomic>
+#include <iostream>
+#include <mutex>
+
+static std::atomic<int> trace_level{static_cast<int>(TraceLevel::DEBUG)};
+static std::mutex trace_mutex;
+
+TraceLevel traceLevel() {
+    return static_cast<TraceLevel>(trace_level.load(std::memory_order_relaxed));
+}
+
+void setTraceLevel(TraceLevel level) {
+    trace_level.store(static_cast<int>(level), std::memory_order_relaxed);
+}
+
+void traceWrite(const std::string& message) {
+    std::lock_guard<std::mutex> lock(trace_mutex);
+    std::cout << message << '\n';
+}
+
+#endif
@@ -0,0 +1,338 @@
+#include <charconv>
+#include <cmath>
+#include <cstdio>
+#include <ostream>
+#include "../../include/common/value.hpp"
+
+const char* valueTypeToString(ValueType type) {
+    switch (type) {
+        case ValueType::NULL_VALUE: return "NULL";
+        case ValueType::INT:        return "INT";
+        case ValueType::DOUBLE:     return "DOUBLE";
+        case ValueType::BOOLEAN:    return "BOOLEAN";
+        case ValueType::DATE:       return "DATE";
+        case ValueType::STRING:     return "STRING";
+        default:                    return "invalid";
+    }
+}
+
+int32_t daysFromCivil(int year, unsigned month, unsigned day) {
+    year -= month <= 2;
+    const int era = (year >= 0 ? year : year - 399) / 400;
+    const unsigned yoe = static_cast<unsigned>(year - era * 400);
+    const unsigned doy = (153 * (month + (month > 2 ? -3 : 9)) + 2) / 5 + day - 1;
+    const unsigned doe = yoe * 365 + yoe / 4 - yoe / 100 + doy;
+    return era * 146097 + static_cast<int32_t>(doe) - 719468;
+}
+
+void civilFromDays(int32_t days, int& year, unsigned& month, unsigned& day) {
+    days += 719468;
+    const int era = (days >= 0 ? days : days - 146096) / 146097;
+    const unsigned doe = static_cast<unsigned>(days - era * 146097);
+    const unsigned yoe = (doe - doe / 1460 + doe / 36524 - doe / 146096) / 365;
+    const unsigned doy = doe - (365 * yoe + yoe / 4 - yoe / 100);
+    const unsigned mp = (5 * doy + 2) / 153;
+    day = doy - (153 * mp + 2) / 5 + 1;
+    month = mp < 10 ? mp + 3 : mp - 9;
+    year = static_cast<int>(yoe) + era * 400 + (month <= 2);
+}
+
+Value Value::integer(int64_t value) {
+    Value result;
+    result.tag = ValueType::INT;
+    result.intValue = value;
+    return result;
+}
+
+Value Value::real(double value) {
+    Value result;
+    result.tag = ValueType::DOUBLE;
+    result.doubleValue = value;
+    return result;
+}
+
+Value Value::boolean(bool value) {
+    Value result;
+    result.tag = ValueType::BOOLEAN;
+    result.boolValue = value;
+    return result;
+}
+
+Value Value::date(int32_t days) {
+    Value result;
+    result.tag = ValueType::DATE;
+    result.dateDays = days;
+    return result;
+}
+
+Value Value::string(std::string_view text) {
+    Value result;
+    result.tag = ValueType::STRING;
+    result.length = static_cast<uint32_t>(text.size());
+    if (text.size() <= INLINE_CAPACITY) {
+        if (!text.empty()) std::memcpy(result.inlineText, text.data(), text.size());
+    } else {
+        result.pointer = text.data();
+    }
+    return result;
+}
+
+Value Value::string(std::string_view text, std::pmr::memory_resource* memory) {
+    if (text.size() <= INLINE_CAPACITY) return string(text);
+    char* copy = static_cast<char*>(memory->allocate(text.size(), 1));
+    std::memcpy(copy, text.data(), text.size());
+    return string(std::string_view(copy, text.size()));
+}
+
+namespace {
+
+bool equalsIgnoreCase(std::string_view text, std::string_view upper) {
+    if (text.size() != upper.size()) return false;
+    for (size_t i = 0; i < text.size(); i++) {
+        char c = text[i];
+        if (c >= 'a' && c <= 'z') c = static_cast<char>(c - 'a' + 'A');
+        if (c != upper[i]) return false;
+    }
+    return true;
+}
+
+std::string_view unquote(std::string_view text) {
+    if (text.size() >= 2 && text.front() == '\'' && text.back() == '\'') return text.substr(1, text.size() - 2);
+    return text;
+}
+
+bool isDigit(char c) {
+    return c >= '0' && c <= '9';
+}
+
+// 'YYYY-MM-DD' with a day that exists in that month
+bool parseDate(std::string_view text, int32_t& days) {
+    if (text.size() != 10 || text[4] != '-' || text[7] != '-') return false;
+    for (size_t i : {0, 1, 2, 3, 5, 6, 8, 9}) {
+        if (!isDigit(text[i])) return false;
+    }
+    int year = (text[0] - '0') * 1000 + (text[1] - '0') * 100 + (text[2] - '0') * 10 + (text[3] - '0');
+    unsigned month = static_cast<unsigned>((text[5] - '0') * 10 + (text[6] - '0'));
+    unsigned day = static_cast<unsigned>((text[8] - '0') * 10 + (text[9] - '0'));
+    if (month < 1 || month > 12 || day < 1) return false;
+
+    static const unsigned monthDays[] = {31, 28, 31, 30, 31, 30, 31, 31, 30, 31, 30, 31};
+    bool leap = (year % 4 == 0 && year % 100 != 0) || year % 400 == 0;
+    if (day > monthDays[month - 1] + (month == 2 && leap)) return false;
+
+    days = daysFromCivil(year, month, day);
+    return true;
+}
+
+// Whole of text must be consumed; a leading '+' is allowed
+template <typename T>
+bool parseNumber(std::string_view text, T& value) {
+    if (!text.empty() && text.front() == '+') text.remove_prefix(1);
+    if (text.empty()) return false;
+    auto [end, error] = std::from_chars(text.data(), text.data() + text.size(), value);
+    return error == std::errc() && end == text.data() + text.size();
+}
+
+uint64_t mix(uint64_t x) {
+    // splitmix64 finalizer
+    x ^= x >> 30;
+    x *= 0xbf58476d1ce4e5b9ull;
+    x ^= x >> 27;
+    x *= 0x94d049bb133111ebull;
+    x ^= x >> 31;
+    return x;
+}
+
+constexpr double TWO_POW_63 = 9223372036854775808.0;
+
+// NaN sorts above every other number and equals itself
+int compareDoubles(double a, double b) {
+    if (std::isnan(a) || std::isnan(b)) return std::isnan(a) - std::isnan(b);
+    return (a > b) - (a < b);
+}
+
+// Exact, with no rounding of integer to double: above 2^53 not every
+// integer is a double
+int compareIntDouble(int64_t integer, double d) {
+    if (std::isnan(d) || d >= TWO_POW_63) return -1;
+    if (d < -TWO_POW_63) return 1;
+    double whole = std::trunc(d);
+    int64_t wholeInt = static_cast<int64_t>(whole); // in range: -2^63 <= whole < 2^63
+    if (integer != wholeInt) return integer < wholeInt ? -1 : 1;
+    return (whole > d) - (whole < d);
+}
+
+} // namespace
+
+bool Value::parse(std::string_view text, ValueType type, Value& out) {
+    if (type != ValueType::STRING && equalsIgnoreCase(text, "NULL")) {
+        out = null();
+        return true;
+    }
+
+    switch (type) {
+        case ValueType::NULL_VALUE:
+            return false;
+        case ValueType::INT: {
+            int64_t value;
+            if (!parseNumber(text, value)) return false;
+            out = integer(value);
+            return true;
+        }
+        case ValueType::DOUBLE: {
+            double value;
+            if (!parseNumber(text, value)) return false;
+            out = real(value);
+            return true;
+        }
+        case ValueType::BOOLEAN:
+            if (equalsIgnoreCase(text, "TRUE")) {
+                out = boolean(true);
+            } else if (equalsIgnoreCase(text, "FALSE")) {
+                out = boolean(false);
+            } else {
+                return false;
+            }
+            return true;
+        case ValueType::DATE: {
+            int32_t days;
+            if (!parseDate(unquote(text), days)) return false;
+            out = date(days);
+            return true;
+        }
+        case ValueType::STRING:
+            out = string(unquote(text));
+            return true;
+    }
+    return false;
+}
+
+bool Value::parseLiteral(std::string_view text, Value& out) {
+    if (text.size() >= 2 && text.front() == '\'' && text.back() == '\'') {
+        int32_t days;
+        if (parseDate(unquote(text), days)) {
+            out = date(days);
+        } else {
+            out = string(unquote(text));
+        }
+        return true;
+    }
+    if (equalsIgnoreCase(text, "NULL")) {
+        out = null();
+        return true;
+    }
+    if (equalsIgnoreCase(text, "TRUE") || equalsIgnoreCase(text, "FALSE")) return parse(text, ValueType::BOOLEAN, out);
+    if (text.find_first_of(".eE") != std::string_view::npos) return parse(text, ValueType::DOUBLE, out);
+    return parse(text, ValueType::INT, out);
+}
+
+std::unique_ptr<char[]> Value::internStrings(std::vector<Value>& values) {
+    size_t total = 0;
+    for (const Value& value : values) {
+        if (value.tag == ValueType::STRING && value.length > INLINE_CAPACITY) total += value.length;
+    }
+    if (total == 0) return nullptr;
+
+    std::unique_ptr<char[]> buffer(new char[total]);
+    char* cursor = buffer.get();
+    for (Value& value : values) {
+        if (value.tag != ValueType::STRING || value.length <= INLINE_CAPACITY) continue;
+        std::memcpy(cursor, value.pointer, value.length);
+        value.pointer = cursor;
+        cursor += value.length;
+    }
+    return buffer;
+}
+
+int Value::compare(const Value& left, const Value& right) {
+    if (left.isNumeric() && right.isNumeric()) {
+        if (left.tag == ValueType::INT && right.tag == ValueType::INT) {
+            return (left.intValue > right.intValue) - (left.intValue < right.intValue);
+        }
+        if (left.tag == ValueType::DOUBLE && right.tag == ValueType::DOUBLE) {
+            return compareDoubles(left.doubleValue, right.doubleValue);
+        }
+        if (left.tag == ValueType::INT) return compareIntDouble(left.intValue, right.doubleValue);
+        return -compareIntDouble(right.intValue, left.doubleValue);
+    }
+    if (left.tag != right.tag) {
+        return static_cast<int>(left.tag) - static_cast<int>(right.tag);
+    }
+
+    switch (left.tag) {
+        case ValueType::BOOLEAN:
+            return static_cast<int>(left.boolValue) - static_cast<int>(right.boolValue);
+        case ValueType::DATE:
+            return (left.dateDays > right.dateDays) - (left.dateDays < right.dateDays);
+        case ValueType::STRING: {
+            std::string_view a = left.asString();
+            std::string_view b = right.asString();
+            return a.compare(b);
+        }
+        default:
+            return 0; // both NULL
+    }
+}
+
+uint64_t Value::hash() const {
+    switch (tag) {
+        case ValueType::INT:
+            return mix(static_cast<uint64_t>(intValue));
+        case ValueType::DOUBLE: {
+            // Whole numbers hash like the equal INT; this also folds -0.0 into 0.
+            // Every NaN is equal, whatever its bits
+            if (doubleValue >= -TWO_POW_63 && doubleValue < TWO_POW_63 && std::trunc(doubleValue) == doubleValue) {
+                return mix(static_cast<uint64_t>(static_cast<int64_t>(doubleValue)));
+            }
+            if (std::isnan(doubleValue)) return mix(0x7ff8000000000000ull);
+            uint64_t bits;
+            std::memcpy(&bits, &doubleValue, sizeof(bits));
+            return mix(bits);
+        }
+        case ValueType::BOOLEAN:
+            return mix(0x100000000ull | boolValue);
+        case ValueType::DATE:
+            return mix(0x200000000ull ^ static_cast<uint32_t>(dateDays));
+        case ValueType::STRING: {
+            uint64_t hash = 1469598103934665603ull;
+            for (char c : asString()) {
+                hash ^= static_cast<unsigned char>(c);
+                hash *= 1099511628211ull;
+            }
+            return mix(hash);
+        }
+        default:
+            return 0;
+    }
+}
+
+std::string Value::toString() const {
+    switch (tag) {
+        case ValueType::INT:
+            return std::to_string(intValue);
+        case ValueType::DOUBLE: {
+            char buffer[32];
+            auto result = std::to_chars(buffer, buffer + sizeof(buffer), doubleValue);
+            return std::string(buffer, result.ptr);
+        }
+        case ValueType::BOOLEAN:
+            return boolValue ? "TRUE" : "FALSE";
+        case ValueType::DATE: {
+            int year;
+            unsigned month, day;
+            civilFromDays(dateDays, year, month, day);
+            char buffer[16];
+            std::snprintf(buffer, sizeof(buffer), "'%04d-%02u-%02u'", year, month, day);
+            return buffer;
+        }
+        case ValueType::STRING:
+            // Text is kept as the lexer saw it, so quotes are not escaped again
+            return "'" + std::string(asString()) + "'";
+        default:
+            return "NULL";
+    }
+}
+
+std::ostream& operator<<(std::ostream& out, const Value& value) {
+    return out << value.toString();
+}
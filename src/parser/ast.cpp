@@ -3,8 +3,24 @@
 #include <vector>
 #include <unordered_map>
 #include "../../include/parser/ast.hpp"
+#include "../../include/parser/binder.hpp"
 
-void astNode::addChild(astNode* child, std::string tokenType, bool setParent) {
+astNode* astNode::create(std::string_view type, std::string_view val, arena* mem) {
+    if (!mem) {
+        return new astNode(type, val);
+    }
+    astNode* node = new (mem->allocate(sizeof(astNode), alignof(astNode))) astNode(type, val, mem);
+    node->arenaOwned = true;
+    return node;
+}
+
+void astNode::destroy(astNode* node) {
+    if (node && !node->arenaOwned) {
+        delete node;
+    }
+}
+
+void astNode::addChild(astNode* child, std::string_view tokenType, bool setParent) {
     if (setParent) {
         child->parent = this; // Automatically set the parent node
     }
@@ -13,12 +29,19 @@ void astNode::addChild(astNode* child, std::string tokenType, bool setParent) {
 }
 
 astNode::~astNode() {
+    // Arena subtrees are reclaimed by arena::reset(), never node by node
+    if (arenaOwned) return;
     for (auto child : children) {
         delete child;
     }
 }
 
-void astNode::validateAST(astNode* node, const DatabaseSchema& schema) {}
+bool astNode::validateAST(astNode* node, const DatabaseSchema& schema) {
+    binder resolver(schema);
+    if (resolver.bind(node)) return true;
+    std::cerr << "Error: " << resolver.error() << std::endl;
+    return false;
+}
 
 
 void astNode::print(astNode* node, int depth){
@@ -0,0 +1,115 @@
+#include <algorithm>
+#include <cctype>
+#include "../../include/parser/batchParser.hpp"
+#include "../../include/parser/lexer.hpp"
+#include "../../include/parser/parser.hpp"
+#include "../../include/parser/streamLexer.hpp"
+
+std::vector<std::string_view> splitStatements(std::string_view script) {
+    std::vector<std::string_view> statements;
+    statementSplitter splitter;
+
+    size_t begin = 0;
+    while (begin < script.size()) {
+        size_t end = splitter.findEnd(script.data() + begin, script.size() - begin);
+        size_t stop = (end == statementSplitter::npos) ? script.size() : begin + end;
+
+        std::string_view text = script.substr(begin, stop - begin);
+        bool blank = std::all_of(text.begin(), text.end(), [](char c) { return std::isspace(static_cast<unsigned char>(c)); });
+        if (!blank) statements.push_back(text);
+
+        begin = stop;
+    }
+    return statements;
+}
+
+batchParser::batchParser(size_t threadCount) {
+    size_t extraThreads = threadCount > 1 ? threadCount - 1 : 0;
+    workers.reserve(extraThreads);
+    for (size_t i = 0; i < extraThreads; i++) {
+        workers.emplace_back(&batchParser::workerLoop, this);
+    }
+}
+
+batchParser::~batchParser() {
+    {
+        std::lock_guard<std::mutex> lock(mtx);
+        stopping = true;
+    }
+    wakeCv.notify_all();
+    for (auto& worker : workers) worker.join();
+}
+
+std::vector<parsedStatement> batchParser::parseScript(std::string_view script) {
+    return parseStatements(splitStatements(script));
+}
+
+std::vector<parsedStatement> batchParser::parseStatements(const std::vector<std::string_view>& statements) {
+    std::vector<parsedStatement> results(statements.size());
+    if (statements.empty()) return results;
+
+    {
+        std::lock_guard<std::mutex> lock(mtx);
+        batchStatements = &statements;
+        batchResults = &results;
+        nextIndex.store(0, std::memory_order_relaxed);
+        busyWorkers = workers.size();
+        generation++;
+    }
+    wakeCv.notify_all();
+
+    runBatch();
+
+    std::unique_lock<std::mutex> lock(mtx);
+    doneCv.wait(lock, [this] { return busyWorkers == 0; });
+    batchStatements = nullptr;
+    batchResults = nullptr;
+    return results;
+}
+
+void batchParser::workerLoop() {
+    uint64_t seenGeneration = 0;
+    while (true) {
+        {
+            std::unique_lock<std::mutex> lock(mtx);
+            wakeCv.wait(lock, [&] { return stopping || generation != seenGeneration; });
+            if (stopping) return;
+            seenGeneration = generation;
+        }
+
+        runBatch();
+
+        {
+            std::lock_guard<std::mutex> lock(mtx);
+            busyWorkers--;
+        }
+        doneCv.notify_one();
+    }
+}
+
+// Claim statements in small ranges and parse them with this thread's own
+// lexer/parser pair; every result lands in its statement's slot
+void batchParser::runBatch() {
+    const std::vector<std::string_view>& statements = *batchStatements;
+    std::vector<parsedStatement>& results = *batchResults;
+
+    lexer lex;
+    parser pars;
+
+    while (true) {
+        size_t begin = nextIndex.fetch_add(CLAIM_SIZE, std::memory_order_relaxed);
+        if (begin >= statements.size()) break;
+        size_t end = std::min(begin + CLAIM_SIZE, statements.size());
+
+        for (size_t i = begin; i < end; i++) {
+            parsedStatement& result = results[i];
+            result.text = statements[i];
+            result.root.reset(new astNode("ROOT", "ROOT"));
+
+            std::vector<Token> tokens = lex.tokenize(statements[i]);
+            pars.itr = Iterator();
+            result.ok = pars.parse(tokens, result.root.get());
+            if (!result.ok) result.error = pars.error();
+        }
+    }
+}
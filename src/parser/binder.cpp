@@ -0,0 +1,483 @@
+#include <algorithm>
+#include <cstdlib>
+#include "../../include/parser/binder.hpp"
+#include "../../include/storage/heapFile.hpp"
+
+namespace {
+
+bool isNumeric(ColumnType type) {
+    return type == ColumnType::INT || type == ColumnType::DOUBLE;
+}
+
+bool isText(ColumnType type) {
+    return type == ColumnType::CHAR || type == ColumnType::VARCHAR || type == ColumnType::TEXT;
+}
+
+// Whether values of the two types can be compared; UNKNOWN (NULL, bind
+// parameters) matches anything and a string literal may stand for a date
+bool comparable(ColumnType left, ColumnType right) {
+    if (left == ColumnType::UNKNOWN || right == ColumnType::UNKNOWN) return true;
+    if (left == right) return true;
+    if (isNumeric(left) && isNumeric(right)) return true;
+    if (isText(left) && isText(right)) return true;
+    if (left == ColumnType::DATE && isText(right)) return true;
+    if (isText(left) && right == ColumnType::DATE) return true;
+    return false;
+}
+
+ColumnType numberType(std::string_view text) {
+    return text.find_first_of(".eE") == std::string_view::npos ? ColumnType::INT : ColumnType::DOUBLE;
+}
+
+const astNode* childOfType(const astNode* node, std::string_view type) {
+    for (const astNode* child : node->children) {
+        if (child->nodeType == type) return child;
+    }
+    return nullptr;
+}
+
+// $n's number, 0 for any other node
+uint32_t parameterNumber(const astNode* node) {
+    if (!node || node->nodeType != "PARAMETER" || node->value.size() < 2) return 0;
+    return static_cast<uint32_t>(std::strtoul(node->value.c_str() + 1, nullptr, 10));
+}
+
+// Type a literal of value's kind binds with
+ColumnType literalType(const Value& value) {
+    switch (value.type()) {
+        case ValueType::INT:     return ColumnType::INT;
+        case ValueType::DOUBLE:  return ColumnType::DOUBLE;
+        case ValueType::BOOLEAN: return ColumnType::BOOLEAN;
+        case ValueType::DATE:    return ColumnType::DATE;
+        case ValueType::STRING:  return ColumnType::VARCHAR;
+        default:                 return ColumnType::UNKNOWN;
+    }
+}
+
+std::string describe(const astNode* node) {
+    return std::string(node->value) + " (" + columnTypeToString(node->valueType) + ")";
+}
+
+// The comparisons ANDed together at the top of a CONDITION or GROUP; none
+// when an OR joins its terms
+void conjuncts(const astNode* node, std::vector<const astNode*>& out) {
+    for (const astNode* child : node->children) {
+        if (child->nodeType == "LOGICAL_OP" && child->value == "OR") return;
+    }
+    for (const astNode* child : node->children) {
+        const astNode* term = child;
+        if (child->nodeType == "LOGICAL_OP") {
+            if (child->value != "AND" || child->children.size() != 1) continue;
+            term = child->children[0];
+        }
+        if (term->nodeType == "COMPARISON") {
+            out.push_back(term);
+        } else if (term->nodeType == "GROUP") {
+            std::vector<const astNode*> inner;
+            conjuncts(term, inner);
+            out.insert(out.end(), inner.begin(), inner.end());
+        }
+    }
+}
+
+} // namespace
+
+bool binder::fail(std::string text) {
+    message = std::move(text);
+    return false;
+}
+
+// Note what left and right must be when either is a placeholder; leftType
+// stands for left when it is not one (a column a value is stored in, say)
+void binder::noteParameters(parameterCheck check, ColumnType leftType, const astNode* left, const astNode* right) {
+    uint32_t leftNumber = parameterNumber(left);
+    uint32_t rightNumber = parameterNumber(right);
+    if (leftNumber == 0 && rightNumber == 0) return;
+    ColumnType rightType = right ? right->valueType : ColumnType::UNKNOWN;
+    rules.push_back({check, {leftType, rightType}, {leftNumber, rightNumber}});
+}
+
+bool binder::satisfied(const parameterRule& rule, const std::vector<Value>& parameters) {
+    ColumnType types[2];
+    for (int i = 0; i < 2; i++) {
+        uint32_t number = rule.parameters[i];
+        types[i] = number == 0 ? rule.types[i] : number <= parameters.size() ? literalType(parameters[number - 1]) : ColumnType::UNKNOWN;
+    }
+    auto textual = [](ColumnType type) { return isText(type) || type == ColumnType::UNKNOWN; };
+    switch (rule.check) {
+        case parameterCheck::COMPARABLE: return comparable(types[0], types[1]);
+        case parameterCheck::TEXT:       return textual(types[0]) && textual(types[1]);
+        case parameterCheck::NUMERIC:    return isNumeric(types[0]) || types[0] == ColumnType::UNKNOWN;
+    }
+    return false;
+}
+
+bool binder::bind(astNode* node) {
+    tableRefs.clear();
+    rules.clear();
+    message.clear();
+    if (!node) return true;
+
+    if (node->nodeType == "SELECT") return bindSelect(node, nullptr);
+    if (node->nodeType == "INSERT" || node->nodeType == "UPDATE" || node->nodeType == "DELETE") return bindModification(node);
+    for (astNode* child : node->children) {
+        if (!bind(child)) return false;
+    }
+    return true;
+}
+
+bool binder::addTable(astNode* table, size_t scopeFirst) {
+    const Table* metadata = schema.getTable(std::string(table->value));
+    if (!metadata) return fail("Table '" + std::string(table->value) + "' does not exist.");
+
+    const astNode* alias = childOfType(table, "ALIAS");
+    std::string_view name = alias ? std::string_view(alias->value) : std::string_view(table->value);
+    for (size_t i = scopeFirst; i < tableRefs.size(); i++) {
+        if (tableRefs[i].name == name) return fail("Table name or alias '" + std::string(name) + "' is used twice.");
+    }
+
+    table->boundTable = metadata;
+    table->tableRef = static_cast<int32_t>(tableRefs.size());
+    table->constant = false;
+    tableRefs.push_back({metadata, name, table});
+    return true;
+}
+
+bool binder::bindSelect(astNode* select, const scope* outer) {
+    // Register every FROM / JOIN table before any expression refers to one
+    size_t first = tableRefs.size();
+    astNode* from = nullptr;
+    astNode* selectList = nullptr;
+    for (astNode* child : select->children) {
+        if (child->nodeType == "FROM") from = child;
+        if (child->nodeType == "SELECT_LIST") selectList = child;
+    }
+    if (from) {
+        for (astNode* item : from->children) {
+            if (item->nodeType == "TABLE" && !addTable(item, first)) return false;
+            if (item->nodeType == "JOIN") {
+                for (astNode* part : item->children) {
+                    if (part->nodeType == "TABLE" && !addTable(part, first)) return false;
+                }
+            }
+        }
+    }
+    // Subqueries append their own tables after this range
+    scope current{first, tableRefs.size() - first, outer, selectList};
+
+    // The select list first: GROUP BY, HAVING and ORDER BY may name its aliases
+    if (selectList && !bindExpression(selectList, current, false)) return false;
+    for (astNode* child : select->children) {
+        if (child == selectList) continue;
+        if (child == from) {
+            for (astNode* item : from->children) {
+                if (item->nodeType != "JOIN") continue;
+                for (astNode* part : item->children) {
+                    if (part->nodeType == "ON" && !bindExpression(part, current, false)) return false;
+                }
+            }
+            continue;
+        }
+        bool allowAlias = child->nodeType == "GROUP_BY" || child->nodeType == "HAVING" || child->nodeType == "ORDER_BY";
+        if (!bindExpression(child, current, allowAlias)) return false;
+    }
+    select->constant = false;
+    return true;
+}
+
+bool binder::bindModification(astNode* statement) {
+    astNode* target = nullptr;
+    for (astNode* child : statement->children) {
+        if (child->nodeType == "TABLE") target = child;
+    }
+    if (!target) return fail(std::string(statement->nodeType) + " has no table.");
+    if (!addTable(target, 0)) return false;
+    const Table& table = *target->boundTable;
+    scope current{0, 1, nullptr, nullptr};
+
+    auto checkValue = [this](const Column& column, const astNode* value) {
+        noteParameters(parameterCheck::COMPARABLE, column.type, nullptr, value);
+        if (comparable(column.type, value->valueType)) return true;
+        return fail("Cannot store " + describe(value) + " in column '" + column.name + "' of type " + column.datatype + ".");
+    };
+
+    // INSERT: the named columns, or every column in order
+    std::vector<const Column*> targets;
+    if (const astNode* columns = childOfType(statement, "COLUMNS")) {
+        for (astNode* column : columns->children) {
+            if (!bindColumn(column, current, false)) return false;
+            const Column* metadata = &table.columns[column->columnOrdinal];
+            if (std::find(targets.begin(), targets.end(), metadata) != targets.end()) {
+                return fail("Column '" + metadata->name + "' is listed twice.");
+            }
+            targets.push_back(metadata);
+        }
+    } else {
+        for (const Column& column : table.columns) targets.push_back(&column);
+    }
+
+    for (astNode* child : statement->children) {
+        if (child->nodeType == "VALUES") {
+            for (astNode* row : child->children) {
+                if (row->children.size() != targets.size()) {
+                    return fail("INSERT row has " + std::to_string(row->children.size()) + " values for " +
+                                std::to_string(targets.size()) + " columns.");
+                }
+                for (size_t i = 0; i < targets.size(); i++) {
+                    astNode* value = row->children[i];
+                    if (!bindExpression(value, current, false)) return false;
+                    if (!value->constant) return fail("INSERT values cannot refer to columns.");
+                    if (!checkValue(*targets[i], value)) return false;
+                }
+            }
+        } else if (child->nodeType == "SET") {
+            for (astNode* assignment : child->children) {
+                const Column* metadata = table.findColumn(std::string(assignment->value));
+                if (!metadata) return fail("Column '" + std::string(assignment->value) + "' does not exist.");
+                assignment->boundTable = &table;
+                assignment->tableRef = 0;
+                assignment->columnOrdinal = static_cast<int32_t>(metadata->ordinal);
+                assignment->valueType = metadata->type;
+                for (astNode* value : assignment->children) {
+                    if (!bindExpression(value, current, false) || !checkValue(*metadata, value)) return false;
+                }
+            }
+        } else if (child->nodeType == "WHERE") {
+            if (!bindExpression(child, current, false)) return false;
+        }
+    }
+    statement->constant = false;
+    return true;
+}
+
+bool binder::bindColumn(astNode* column, const scope& current, bool allowAlias) {
+    std::string_view value = column->value;
+    size_t dot = value.find('.');
+
+    if (dot != std::string_view::npos) {
+        std::string_view qualifier = value.substr(0, dot);
+        std::string columnName(value.substr(dot + 1));
+        for (const scope* s = &current; s; s = s->outer) {
+            for (size_t i = s->first; i < s->first + s->count; i++) {
+                if (tableRefs[i].name != qualifier) continue;
+                const Column* metadata = tableRefs[i].table->findColumn(columnName);
+                if (!metadata) {
+                    return fail("Column '" + columnName + "' does not exist in table '" + std::string(qualifier) + "'.");
+                }
+                column->boundTable = tableRefs[i].table;
+                column->tableRef = static_cast<int32_t>(i);
+                column->columnOrdinal = static_cast<int32_t>(metadata->ordinal);
+                column->valueType = metadata->type;
+                return true;
+            }
+        }
+        return fail("Unknown table or alias '" + std::string(qualifier) + "'.");
+    }
+
+    // Unqualified: the innermost SELECT with a match wins; two matches there are ambiguous
+    std::string columnName(value);
+    for (const scope* s = &current; s; s = s->outer) {
+        long found = -1;
+        const Column* metadata = nullptr;
+        for (size_t i = s->first; i < s->first + s->count; i++) {
+            const Column* candidate = tableRefs[i].table->findColumn(columnName);
+            if (!candidate) continue;
+            if (found >= 0) return fail("Column '" + columnName + "' is ambiguous.");
+            found = static_cast<long>(i);
+            metadata = candidate;
+        }
+        if (found >= 0) {
+            column->boundTable = tableRefs[found].table;
+            column->tableRef = static_cast<int32_t>(found);
+            column->columnOrdinal = static_cast<int32_t>(metadata->ordinal);
+            column->valueType = metadata->type;
+            return true;
+        }
+    }
+
+    if (allowAlias && current.selectList) {
+        const auto& items = current.selectList->children;
+        for (size_t i = 0; i < items.size(); i++) {
+            const astNode* alias = childOfType(items[i], "ALIAS");
+            if (!alias || alias->value != value) continue;
+            column->boundTable = nullptr;
+            column->tableRef = -1;
+            column->columnOrdinal = static_cast<int32_t>(i);
+            column->valueType = items[i]->valueType;
+            return true;
+        }
+    }
+    return fail("Column '" + columnName + "' does not exist.");
+}
+
+bool binder::bindExpression(astNode* node, const scope& current, bool allowAlias) {
+    const std::pmr::string& type = node->nodeType;
+
+    if (type == "COLUMN") {
+        node->constant = false;
+        return bindColumn(node, current, allowAlias);
+    }
+    if (type == "NUMBER") {
+        node->valueType = numberType(node->value);
+        node->constant = true;
+        return true;
+    }
+    if (type == "VALUE") { // LIMIT count
+        node->valueType = ColumnType::INT;
+        node->constant = true;
+        return true;
+    }
+    if (type == "STRING" || type == "DATE" || type == "BOOLEAN" || type == "NULL" || type == "PARAMETER") {
+        node->valueType = type == "STRING"  ? ColumnType::VARCHAR
+                        : type == "DATE"    ? ColumnType::DATE
+                        : type == "BOOLEAN" ? ColumnType::BOOLEAN
+                                            : ColumnType::UNKNOWN;
+        // A parameter is fixed for a whole execution
+        node->constant = true;
+        return true;
+    }
+    if (type == "WILDCARD") {
+        node->constant = false;
+        return true;
+    }
+    if (type == "SUBQUERY") {
+        // Correlation is not tracked, so a subquery is never treated as constant
+        node->constant = false;
+        for (astNode* child : node->children) {
+            if (child->nodeType == "SELECT" && !bindSelect(child, &current)) return false;
+        }
+        const astNode* select = node->children.empty() ? nullptr : node->children.front();
+        const astNode* list = select ? childOfType(select, "SELECT_LIST") : nullptr;
+        if (list && list->children.size() == 1) node->valueType = list->children.front()->valueType;
+        return true;
+    }
+
+    // Everything else combines its children
+    bool constant = true;
+    for (astNode* child : node->children) {
+        if (!bindExpression(child, current, allowAlias)) return false;
+        constant = constant && child->constant;
+    }
+
+    if (type == "FUNCTION") {
+        // Aggregates read every row of their group
+        node->constant = false;
+        const astNode* args = childOfType(node, "ARGS");
+        ColumnType argument = args && !args->children.empty() ? args->children.front()->valueType : ColumnType::UNKNOWN;
+        if (node->value == "COUNT") {
+            node->valueType = ColumnType::INT;
+        } else if (node->value == "AVG") {
+            node->valueType = ColumnType::DOUBLE;
+        } else {
+            node->valueType = argument;
+        }
+        if ((node->value == "SUM" || node->value == "AVG") && args && !args->children.empty()) {
+            noteParameters(parameterCheck::NUMERIC, argument, args->children.front(), nullptr);
+        }
+        if ((node->value == "SUM" || node->value == "AVG") && !isNumeric(argument) && argument != ColumnType::UNKNOWN) {
+            return fail(std::string(node->value) + " needs a numeric argument, got " + columnTypeToString(argument) + ".");
+        }
+        return true;
+    }
+
+    node->constant = constant;
+    if (type == "COMPARISON") {
+        if (!checkComparison(node)) return false;
+        // A bare value used as a condition keeps its own type
+        node->valueType = node->children.size() == 1 ? node->children.front()->valueType : ColumnType::BOOLEAN;
+    } else if (type == "CONDITION" || type == "LOGICAL_OP" || type == "GROUP") {
+        node->valueType = ColumnType::BOOLEAN;
+    } else if ((type == "COLUMN_EXPR" || type == "ORDER_EXPR") && !node->children.empty()) {
+        node->valueType = node->children.front()->valueType;
+    }
+    return true;
+}
+
+bool binder::checkComparison(const astNode* comparison) {
+    const auto& parts = comparison->children;
+    if (parts.size() < 2) return true;
+    const astNode* left = parts[0];
+
+    auto check = [&](const astNode* right) {
+        noteParameters(parameterCheck::COMPARABLE, left->valueType, left, right);
+        if (comparable(left->valueType, right->valueType)) return true;
+        return fail("Cannot compare " + describe(left) + " with " + describe(right) + ".");
+    };
+
+    const astNode* op = parts[1];
+    if (op->nodeType == "OPERATOR") {
+        return parts.size() < 3 || check(parts[2]);
+    }
+    if (op->nodeType == "LIKE") {
+        for (const astNode* pattern : op->children) {
+            noteParameters(parameterCheck::TEXT, left->valueType, left, pattern);
+            bool textual = (isText(left->valueType) || left->valueType == ColumnType::UNKNOWN) &&
+                           (isText(pattern->valueType) || pattern->valueType == ColumnType::UNKNOWN);
+            if (!textual) return fail("LIKE needs text operands, got " + describe(left) + " and " + describe(pattern) + ".");
+        }
+        return true;
+    }
+    if (op->nodeType == "BETWEEN") {
+        for (const astNode* bound : op->children) {
+            if (!check(bound)) return false;
+        }
+        return true;
+    }
+    if (op->nodeType == "IN") {
+        for (const astNode* list : op->children) {
+            if (list->nodeType == "SUBQUERY") {
+                if (!check(list)) return false;
+                continue;
+            }
+            for (const astNode* item : list->children) {
+                if (!check(item)) return false;
+            }
+        }
+    }
+    // IS [NOT] NULL and EXISTS take any operand
+    return true;
+}
+
+bool binder::equalityKey(const astNode* comparison, const astNode*& column, Value& key) {
+    const auto& parts = comparison->children;
+    if (comparison->nodeType != "COMPARISON" || parts.size() != 3 ||
+        parts[1]->nodeType != "OPERATOR" || parts[1]->value != "=") {
+        return false;
+    }
+
+    auto isLiteral = [](const astNode* node) {
+        return node->nodeType == "NUMBER" || node->nodeType == "STRING" ||
+               node->nodeType == "DATE" || node->nodeType == "BOOLEAN";
+    };
+    const astNode* literal;
+    if (parts[0]->nodeType == "COLUMN" && isLiteral(parts[2])) {
+        column = parts[0];
+        literal = parts[2];
+    } else if (parts[2]->nodeType == "COLUMN" && isLiteral(parts[0])) {
+        column = parts[2];
+        literal = parts[0];
+    } else {
+        return false;
+    }
+    if (column->tableRef < 0 || column->columnOrdinal < 0) return false;
+
+    // column = NULL matches nothing, so it is left to the evaluator
+    return Value::parse(literal->value, columnValueType(column->valueType), key) && !key.isNull();
+}
+
+bool binder::lookupWhere(const astNode* statement, int32_t tableRef, const heapFile& rows,
+                         std::vector<recordId>& rids) {
+    const astNode* where = childOfType(statement, "WHERE");
+    const astNode* condition = where ? childOfType(where, "CONDITION") : nullptr;
+    if (!condition) return false;
+
+    std::vector<const astNode*> terms;
+    conjuncts(condition, terms);
+    for (const astNode* term : terms) {
+        const astNode* column;
+        Value key;
+        if (!equalityKey(term, column, key) || column->tableRef != tableRef) continue;
+        if (rows.lookup(static_cast<uint32_t>(column->columnOrdinal), key, rids)) return true;
+    }
+    return false;
+}
@@ -0,0 +1,190 @@
+#include <cstdlib>
+#include <deque>
+#include "../../include/parser/compactAst.hpp"
+
+static const char* const node_kind_names[] = {
+    "ROOT",
+    "SELECT", "DISTINCT", "SELECT_LIST", "COLUMN_EXPR", "ALIAS", "WILDCARD",
+    "FUNCTION", "ARGS", "COLUMN",
+    "FROM", "TABLE", "JOIN", "JOIN_TYPE", "ON",
+    "WHERE", "GROUP_BY", "HAVING", "ORDER_BY", "ORDER_EXPR", "DIRECTION", "LIMIT", "VALUE",
+    "CONDITION", "LOGICAL_OP", "GROUP", "COMPARISON", "OPERATOR",
+    "LIKE", "IN", "VALUE_LIST", "BETWEEN", "IS", "NOT", "EXISTS", "SUBQUERY",
+    "NUMBER", "STRING", "DATE", "NULL", "BOOLEAN", "PARAMETER",
+    "INSERT", "UPDATE", "DELETE", "COLUMNS", "VALUES", "ROW", "SET", "ASSIGNMENT",
+    "CREATE_TABLE", "COLUMN_DEF", "DATATYPE", "CONSTRAINT", "TABLE_CONSTRAINT", "FOREIGN_KEY", "REFERENCES", "STORAGE",
+    "CREATE_INDEX", "USING",
+    "UNKNOWN"
+};
+
+static_assert(sizeof(node_kind_names) / sizeof(node_kind_names[0]) == static_cast<size_t>(NodeKind::UNKNOWN) + 1,
+              "node_kind_names must list every NodeKind");
+
+const char* nodeKindToString(NodeKind kind) {
+    return node_kind_names[static_cast<size_t>(kind)];
+}
+
+NodeKind stringToNodeKind(std::string_view type) {
+    for (size_t i = 0; i < static_cast<size_t>(NodeKind::UNKNOWN); i++) {
+        if (type == node_kind_names[i]) return static_cast<NodeKind>(i);
+    }
+    return NodeKind::UNKNOWN;
+}
+
+uint32_t compactAst::addString(std::string_view str) {
+    uint32_t offset = static_cast<uint32_t>(strings.size());
+    strings.append(str);
+    return offset;
+}
+
+std::string_view compactAst::text(const compactNode& node) const {
+    return std::string_view(strings).substr(node.textOffset, node.textLength);
+}
+
+std::string_view compactAst::typeName(const compactNode& node) const {
+    if (node.kind != NodeKind::UNKNOWN) return nodeKindToString(node.kind);
+    return std::string_view(strings).substr(node.typeOffset, node.typeLength);
+}
+
+std::string_view compactAst::stringLiteral(const compactNode& node) const {
+    if (node.literal != LiteralKind::STRING) return {};
+    return std::string_view(strings).substr(node.stringValue.offset, node.stringValue.length);
+}
+
+Value compactAst::literalValue(const compactNode& node) const {
+    switch (node.literal) {
+        case LiteralKind::INTEGER: return Value::integer(node.intValue);
+        case LiteralKind::DOUBLE:  return Value::real(node.doubleValue);
+        case LiteralKind::STRING:  return Value::string(stringLiteral(node));
+        case LiteralKind::DATE:    return Value::date(node.dateDays);
+        case LiteralKind::BOOLEAN: return Value::boolean(node.boolValue);
+        default:                   return Value::null();
+    }
+}
+
+// Decode the literal payload once, while flattening
+void compactAst::setLiteral(compactNode& node, std::string_view value) {
+    switch (node.kind) {
+        case NodeKind::NUMBER: {
+            Value number;
+            if (Value::parseLiteral(value, number) && number.type() == ValueType::INT) {
+                node.literal = LiteralKind::INTEGER;
+                node.intValue = number.asInt();
+            } else if (number.isNumeric()) {
+                node.literal = LiteralKind::DOUBLE;
+                node.doubleValue = number.asDouble();
+            }
+            break;
+        }
+        case NodeKind::STRING:
+            node.literal = LiteralKind::STRING;
+            if (value.size() >= 2 && value.front() == '\'' && value.back() == '\'') {
+                node.stringValue.offset = node.textOffset + 1;
+                node.stringValue.length = node.textLength - 2;
+            } else {
+                node.stringValue.offset = node.textOffset;
+                node.stringValue.length = node.textLength;
+            }
+            break;
+        case NodeKind::DATE: {
+            Value date;
+            if (Value::parse(value, ValueType::DATE, date) && date.type() == ValueType::DATE) {
+                node.literal = LiteralKind::DATE;
+                node.dateDays = date.asDate();
+            }
+            break;
+        }
+        case NodeKind::BOOLEAN:
+            node.literal = LiteralKind::BOOLEAN;
+            node.boolValue = value == "TRUE";
+            break;
+        case NodeKind::NULL_VALUE:
+            node.literal = LiteralKind::NULL_VALUE;
+            break;
+        case NodeKind::PARAMETER:
+            // Parser always spells parameters as "$n"
+            node.literal = LiteralKind::PARAMETER;
+            node.intValue = value.size() > 1 ? std::strtoll(std::string(value.substr(1)).c_str(), nullptr, 10) : 0;
+            break;
+        default:
+            break;
+    }
+}
+
+compactAst compactAst::fromTree(const astNode* root) {
+    compactAst ast;
+    if (!root) return ast;
+
+    // Breadth-first, so each node's children get consecutive indexes
+    std::deque<std::pair<const astNode*, uint32_t>> queue;
+    ast.nodes.emplace_back();
+    queue.emplace_back(root, 0);
+
+    while (!queue.empty()) {
+        auto [source, index] = queue.front();
+        queue.pop_front();
+
+        compactNode& node = ast.nodes[index];
+        node.kind = stringToNodeKind(source->nodeType);
+        node.textOffset = ast.addString(source->value);
+        node.textLength = static_cast<uint32_t>(source->value.size());
+        if (node.kind == NodeKind::UNKNOWN) {
+            node.typeOffset = ast.addString(source->nodeType);
+            node.typeLength = static_cast<uint32_t>(source->nodeType.size());
+        }
+        ast.setLiteral(node, source->value);
+
+        node.firstChild = static_cast<uint32_t>(ast.nodes.size());
+        node.childCount = static_cast<uint32_t>(source->children.size());
+        for (const astNode* child : source->children) {
+            uint32_t childIndex = static_cast<uint32_t>(ast.nodes.size());
+            ast.nodes.emplace_back();
+            ast.nodes[childIndex].parent = index;
+            queue.emplace_back(child, childIndex);
+        }
+    }
+
+    return ast;
+}
+
+void compactAst::printNode(std::ostream& out, uint32_t index, int depth) const {
+    const compactNode& node = nodes[index];
+    std::string indent(depth * 2, ' ');
+    out << indent << typeName(node) << ": " << text(node) << std::endl;
+    for (uint32_t i = 0; i < node.childCount; i++) {
+        printNode(out, node.firstChild + i, depth + 1);
+    }
+}
+
+void compactAst::print(std::ostream& out) const {
+    if (!nodes.empty()) printNode(out, 0, 0);
+}
+
+uint64_t compactAst::shapeHash() const {
+    uint64_t hash = 1469598103934665603ull;
+    auto mix = [&hash](uint64_t value) {
+        hash ^= value;
+        hash *= 1099511628211ull;
+    };
+
+    for (const compactNode& node : nodes) {
+        mix(static_cast<uint64_t>(node.kind));
+        mix(node.childCount);
+        if (!node.isLiteral()) {
+            for (char c : text(node)) mix(static_cast<unsigned char>(c));
+        }
+    }
+    return hash;
+}
+
+bool compactAst::sameShape(const compactAst& other) const {
+    if (nodes.size() != other.nodes.size()) return false;
+    for (size_t i = 0; i < nodes.size(); i++) {
+        const compactNode& a = nodes[i];
+        const compactNode& b = other.nodes[i];
+        if (a.kind != b.kind || a.childCount != b.childCount || a.isLiteral() != b.isLiteral()) return false;
+        if (!a.isLiteral() && text(a) != other.text(b)) return false;
+        if (a.kind == NodeKind::UNKNOWN && typeName(a) != other.typeName(b)) return false;
+    }
+    return true;
+}
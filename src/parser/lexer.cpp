@@ -1,63 +1,35 @@
 #include <string>
+#include <string_view>
 #include <algorithm>
-#include <unordered_map>
 #include <cctype>
 #include "../../include/parser/lexer.hpp"
+#include "../../include/parser/keywordTable.hpp"
+#include "../../include/parser/simdScan.hpp"
 #include "../../include/common/token.hpp"
 
-const std::unordered_map<std::string, TokenType> keyword_map = {
-    {"SELECT", TokenType::KEYWORD}, {"FROM", TokenType::KEYWORD}, {"WHERE", TokenType::KEYWORD}, 
-    {"INSERT", TokenType::KEYWORD}, {"INTO", TokenType::KEYWORD}, {"VALUES", TokenType::KEYWORD}, 
-    {"UPDATE", TokenType::KEYWORD}, {"SET", TokenType::KEYWORD}, {"DELETE", TokenType::KEYWORD}, 
-    {"CREATE", TokenType::KEYWORD}, {"TABLE", TokenType::KEYWORD}, {"DROP", TokenType::KEYWORD}, 
-    {"ALTER", TokenType::KEYWORD}, {"ADD", TokenType::KEYWORD}, {"NULL", TokenType::KEYWORD}, 
-    {"ON", TokenType::KEYWORD}, {"IS", TokenType::KEYWORD}, {"JOIN", TokenType::KEYWORD}, 
-    {"INNER", TokenType::KEYWORD}, {"LEFT", TokenType::KEYWORD}, {"RIGHT", TokenType::KEYWORD}, 
-    {"FULL", TokenType::KEYWORD}, {"OUTER", TokenType::KEYWORD}, {"AS", TokenType::KEYWORD}, 
-    {"BY", TokenType::KEYWORD}, {"GROUP", TokenType::KEYWORD}, {"ORDER", TokenType::KEYWORD}, 
-    {"HAVING", TokenType::KEYWORD}, {"DISTINCT", TokenType::KEYWORD}, {"LIMIT", TokenType::KEYWORD}, 
-    {"OFFSET", TokenType::KEYWORD}, {"REFERENCES", TokenType::KEYWORD}, {"EXISTS", TokenType::KEYWORD}, 
-    {"AND", TokenType::KEYWORD}, {"OR", TokenType::KEYWORD}, {"NOT", TokenType::KEYWORD}, 
-    {"IN", TokenType::KEYWORD}, {"LIKE", TokenType::KEYWORD}, {"BETWEEN", TokenType::KEYWORD}, 
-    {"ALL", TokenType::KEYWORD}, {"ANY", TokenType::KEYWORD}
-};
-
-const std::unordered_map<std::string, TokenType> operator_map = {
-    {"+", TokenType::OPERATOR}, {"-", TokenType::OPERATOR}, {"*", TokenType::OPERATOR}, 
-    {"/", TokenType::OPERATOR}, {"=", TokenType::OPERATOR}, {"<", TokenType::OPERATOR}, 
-    {">", TokenType::OPERATOR}, {"<=", TokenType::OPERATOR}, {">=", TokenType::OPERATOR}, 
-    {"<>", TokenType::OPERATOR}, {"!=", TokenType::OPERATOR}, {"&&", TokenType::OPERATOR}, 
-    {"||", TokenType::OPERATOR}, {"!", TokenType::OPERATOR}
-};
-
-const std::unordered_map<std::string, TokenType> punctuation_map = {
-    {",", TokenType::PUNCTUATION}, {";", TokenType::PUNCTUATION}, {"(", TokenType::PUNCTUATION}, 
-    {")", TokenType::PUNCTUATION}, {".", TokenType::PUNCTUATION}
-};
-
-const std::unordered_map<std::string, TokenType> datatype_map = {
-    {"NUMBER", TokenType::DATATYPE}, {"INT", TokenType::DATATYPE}, {"VARCHAR", TokenType::DATATYPE}, 
-    {"CHAR", TokenType::DATATYPE}, {"TEXT", TokenType::DATATYPE}, {"FLOAT", TokenType::DATATYPE}, 
-    {"DOUBLE", TokenType::DATATYPE}, {"DATE", TokenType::DATATYPE}, {"BOOLEAN", TokenType::DATATYPE}, 
-    {"STRING", TokenType::DATATYPE}
-};
+inline bool isPunctuationChar(char ch) {
+    return ch == ',' || ch == ';' || ch == '(' || ch == ')' || ch == '.';
+}
 
-const std::unordered_map<std::string, TokenType> constraint_map = {
-    {"PRIMARY KEY", TokenType::CONSTRAINT}, {"NOT NULL", TokenType::CONSTRAINT}, 
-    {"FOREIGN KEY", TokenType::CONSTRAINT}, {"UNIQUE", TokenType::CONSTRAINT}, 
-    {"CHECK", TokenType::CONSTRAINT}, {"DEFAULT", TokenType::CONSTRAINT}
-};
+inline bool isAllDigits(std::string_view str) {
+    return std::all_of(str.begin(), str.end(), ::isdigit);
+}
 
-inline std::string toUpper(const std::string& str) {
-    std::string result = str;
-    std::transform(result.begin(), result.end(), result.begin(), ::toupper);
-    return result;
+inline bool equalsIgnoreCase(std::string_view str, std::string_view upper) {
+    if (str.size() != upper.size()) return false;
+    for (size_t i = 0; i < str.size(); i++) {
+        if (asciiUpper(str[i]) != upper[i]) return false;
+    }
+    return true;
 }
 
-bool lexer::isValidIdentifier(const std::string& str) {
+bool lexer::isValidIdentifier(std::string_view str, bool checkReserved) {
     if (str.empty()) return false;
     
-    if (keyword_map.find(toUpper(str)) != keyword_map.end()) return false;
+    if (checkReserved) {
+        const keywordEntry* entry = lookupKeyword(str);
+        if (entry && entry->type == TokenType::KEYWORD) return false;
+    }
     
     if (!std::isalpha(str[0]) && str[0] != '_') return false;
     
@@ -65,14 +37,14 @@ bool lexer::isValidIdentifier(const std::string& str) {
                       [](char c) { return std::isalnum(c) || c == '_'; });
 }
 
-bool lexer::isNumeric(const std::string& str) {
+bool lexer::isNumeric(std::string_view str) {
     if (str.empty()) return false;
     size_t start = (str[0] == '-' || str[0] == '+') ? 1 : 0;
     if (start >= str.size()) return false;
     return std::all_of(str.begin() + start, str.end(), ::isdigit);
 }
 
-bool lexer::isFloatingPoint(const std::string& str) {
+bool lexer::isFloatingPoint(std::string_view str) {
     if (str.empty()) return false;
     bool hasDecimal = false;
     size_t start = (str[0] == '-' || str[0] == '+') ? 1 : 0;
@@ -89,21 +61,19 @@ bool lexer::isFloatingPoint(const std::string& str) {
     return hasDecimal; 
 }
 
-bool lexer::isDateFormat(const std::string& str) {
+bool lexer::isDateFormat(std::string_view str) {
     if (str.size() != 10 || str[4] != '-' || str[7] != '-') return false;
 
-    std::string year = str.substr(0, 4);
-    std::string month = str.substr(5, 2);
-    std::string day = str.substr(8, 2);
+    std::string_view year = str.substr(0, 4);
+    std::string_view month = str.substr(5, 2);
+    std::string_view day = str.substr(8, 2);
 
-    if (!std::all_of(year.begin(), year.end(), ::isdigit) ||
-        !std::all_of(month.begin(), month.end(), ::isdigit) ||
-        !std::all_of(day.begin(), day.end(), ::isdigit)) {
+    if (!isAllDigits(year) || !isAllDigits(month) || !isAllDigits(day)) {
         return false;
     }
 
-    int monthInt = std::stoi(month);
-    int dayInt = std::stoi(day);
+    int monthInt = (month[0] - '0') * 10 + (month[1] - '0');
+    int dayInt = (day[0] - '0') * 10 + (day[1] - '0');
 
     if (monthInt < 1 || monthInt > 12) return false;
     if (dayInt < 1 || dayInt > 31) return false; 
@@ -111,34 +81,44 @@ bool lexer::isDateFormat(const std::string& str) {
     return true;
 }
 
-bool lexer::isStringLiteral(const std::string& str) {
+bool lexer::isStringLiteral(std::string_view str) {
     if (str.size() < 2) return false;
     if (str.front() != '\'' || str.back() != '\'') return false;
     
-    std::string content = str.substr(1, str.size() - 2);
-    return !isDateFormat(content); 
+    return !isDateFormat(str.substr(1, str.size() - 2)); 
 }
 
+// Bind placeholders: a bare '?' or '$' followed by a 1-based index
+bool lexer::isParameter(std::string_view str) {
+    if (str == "?") return true;
+    if (str.size() < 2 || str[0] != '$' || str[1] == '0') return false;
+    return isAllDigits(str.substr(1));
+}
 
-std::pair<bool, std::string> lexer::checkMultiWordConstraint(const std::string& currentToken, const std::string& input, size_t currentPos) {
-    std::string upperCurrent = toUpper(currentToken);
-    
-    if (upperCurrent == "PRIMARY" || upperCurrent == "NOT" || upperCurrent == "FOREIGN") {
+std::pair<bool, std::string> lexer::checkMultiWordConstraint(std::string_view currentToken, std::string_view input, size_t currentPos) {
+    if (equalsIgnoreCase(currentToken, "PRIMARY") || equalsIgnoreCase(currentToken, "NOT") ||
+        equalsIgnoreCase(currentToken, "FOREIGN")) {
         
         size_t i = currentPos;
         while (i < input.size() && std::isspace(input[i])) i++;
         
-        std::string nextToken;
-        while (i < input.size() && !std::isspace(input[i]) && 
-               punctuation_map.find(std::string(1, input[i])) == punctuation_map.end()) {
-            nextToken += input[i];
+        size_t nextStart = i;
+        while (i < input.size() && !std::isspace(input[i]) && !isPunctuationChar(input[i])) {
             i++;
         }
         
-        if (!nextToken.empty()) {
-            std::string multiWord = upperCurrent + " " + toUpper(nextToken);
-            if (constraint_map.find(multiWord) != constraint_map.end()) {
-                return {true, multiWord};
+        // Join both words with a single space in a stack buffer for one table probe
+        size_t nextLen = i - nextStart;
+        char joined[keyword_max_length];
+        if (nextLen != 0 && currentToken.size() + 1 + nextLen <= keyword_max_length) {
+            size_t len = 0;
+            for (char c : currentToken) joined[len++] = c;
+            joined[len++] = ' ';
+            for (size_t k = nextStart; k < i; k++) joined[len++] = input[k];
+            
+            const keywordEntry* entry = lookupKeyword(std::string_view(joined, len));
+            if (entry && entry->type == TokenType::CONSTRAINT) {
+                return {true, std::string(entry->name)};
             }
         }
     }
@@ -146,77 +126,100 @@ std::pair<bool, std::string> lexer::checkMultiWordConstraint(const std::string&
     return {false, ""};
 }
 
-Token lexer::classifyToken(const std::string& tokenStr, size_t position, size_t line, size_t column) {
+// Owned copy of the upper-case form, or empty when the source is already upper-case
+inline std::string normalizedCopy(std::string_view tokenStr, std::string_view upperToken) {
+    return tokenStr == upperToken ? std::string() : std::string(upperToken);
+}
+
+TokenView lexer::classifyToken(std::string_view tokenStr, size_t position, size_t line, size_t column) {
     if (tokenStr.empty()) {
-        return Token(TokenType::UNKNOWN, "", position, line, column);
-    }
-    
-    std::string upperToken = toUpper(tokenStr);
-    
-    
-    auto operatorIt = operator_map.find(tokenStr);
-    if (operatorIt != operator_map.end()) {
-        return Token(TokenType::OPERATOR, tokenStr, position, line, column);
-    }
-     
-    auto punctIt = punctuation_map.find(tokenStr);
-    if (punctIt != punctuation_map.end()) {
-        return Token(TokenType::PUNCTUATION, tokenStr, position, line, column);
-    }
-    
-    auto constraintIt = constraint_map.find(upperToken);
-    if (constraintIt != constraint_map.end()) {
-        return Token(TokenType::CONSTRAINT, upperToken, tokenStr, position, line, column);
-    }
-    
-    auto keywordIt = keyword_map.find(upperToken);
-    if (keywordIt != keyword_map.end()) {
-        return Token(TokenType::KEYWORD, upperToken, tokenStr, position, line, column);
+        return TokenView(TokenType::UNKNOWN, tokenStr, position, line, column);
     }
     
-    auto datatypeIt = datatype_map.find(upperToken);
-    if (datatypeIt != datatype_map.end()) {
-        return Token(TokenType::DATATYPE, upperToken, tokenStr, position, line, column);
+    // Operators, punctuation, constraints, keywords and datatypes in one probe
+    if (const keywordEntry* entry = lookupKeyword(tokenStr)) {
+        if (entry->type == TokenType::OPERATOR || entry->type == TokenType::PUNCTUATION) {
+            return TokenView(entry->type, tokenStr, position, line, column);
+        }
+        return TokenView(entry->type, tokenStr, normalizedCopy(tokenStr, entry->name), position, line, column);
     }
     
+    // Literals are parsed here, once; later stages read TokenView::literal
     if (isFloatingPoint(tokenStr)) {
-        return Token(TokenType::DOUBLE, tokenStr, position, line, column);
+        TokenView token(TokenType::DOUBLE, tokenStr, position, line, column);
+        Value::parse(tokenStr, ValueType::DOUBLE, token.literal);
+        return token;
     }
     
     if (isNumeric(tokenStr)) {
-        return Token(TokenType::NUMBER, tokenStr, position, line, column);
+        TokenView token(TokenType::NUMBER, tokenStr, position, line, column);
+        // Too large for 64 bits: keep the approximate value rather than none
+        if (!Value::parse(tokenStr, ValueType::INT, token.literal)) {
+            Value::parse(tokenStr, ValueType::DOUBLE, token.literal);
+        }
+        return token;
+    }
+    
+    if (isParameter(tokenStr)) {
+        return TokenView(TokenType::PARAMETER, tokenStr, position, line, column);
     }
     
     if (isStringLiteral(tokenStr)) {
-        return Token(TokenType::STRING, tokenStr, position, line, column);
+        return TokenView(TokenType::STRING, tokenStr, position, line, column);
     }
     
     if (tokenStr.size() >= 2 && tokenStr.front() == '\'' && tokenStr.back() == '\'') {
-        std::string content = tokenStr.substr(1, tokenStr.size() - 2);
-        if (isDateFormat(content)) {
-            return Token(TokenType::DATE, tokenStr, position, line, column);
+        if (isDateFormat(tokenStr.substr(1, tokenStr.size() - 2))) {
+            // Shaped like a date but not a real one (e.g. '2023-02-30'): plain string
+            TokenView token(TokenType::DATE, tokenStr, position, line, column);
+            if (!Value::parse(tokenStr, ValueType::DATE, token.literal)) token.type = TokenType::STRING;
+            return token;
         }
     }
     
-    if (isValidIdentifier(tokenStr)) {
-        return Token(TokenType::IDENTIFIER, tokenStr, position, line, column);
+    // Reserved words were already ruled out by the table probe above
+    if (isValidIdentifier(tokenStr, false)) {
+        return TokenView(TokenType::IDENTIFIER, tokenStr, position, line, column);
     }
     
-    return Token(TokenType::UNKNOWN, tokenStr, position, line, column);
+    return TokenView(TokenType::UNKNOWN, tokenStr, position, line, column);
 }
     
-std::vector<Token> lexer::tokenize(const std::string& input) {
-    std::vector<Token> tokens;
+std::vector<TokenView> lexer::tokenizeView(std::string_view input) {
+    std::vector<TokenView> tokens;
     tokens.reserve(input.size() / 4);
     
-    std::string currentToken;
-    size_t position = 0;
+    // The token being accumulated is always the contiguous slice [tokenStart, i)
+    size_t tokenStart = 0;
+    size_t tokenLen = 0;
     size_t line = 1;
     size_t column = 1;
+
+    auto flushToken = [&]() {
+        if (tokenLen != 0) {
+            tokens.push_back(classifyToken(input.substr(tokenStart, tokenLen), tokenStart, line, column - tokenLen));
+            tokenLen = 0;
+        }
+    };
+    auto appendChar = [&](size_t at) {
+        if (tokenLen == 0) tokenStart = at;
+        tokenLen++;
+    };
     
     for (size_t i = 0; i < input.size(); ++i) {
         char ch = input[i];
         
+        // Identifier/number bodies never contain boundary bytes, so consume the
+        // whole run at once; it cannot contain a newline either
+        size_t run = scanTokenBoundary(input.data() + i, input.size() - i);
+        if (run != 0) {
+            appendChar(i);
+            tokenLen += run - 1;
+            column += run;
+            i += run - 1;
+            continue;
+        }
+        
         if (ch == '\n') {
             line++;
             column = 1;
@@ -225,44 +228,39 @@ std::vector<Token> lexer::tokenize(const std::string& input) {
         }
         
         if (std::isspace(ch)) {
-            if (!currentToken.empty()) {
+            if (tokenLen != 0) {
                 // Check for multi-word constraints before classifying
-                auto [isMultiWord, constraintStr] = checkMultiWordConstraint(currentToken, input, i);
+                auto [isMultiWord, constraintStr] = checkMultiWordConstraint(input.substr(tokenStart, tokenLen), input, i);
                 if (isMultiWord) {
                     size_t nextTokenStart = i;
                     while (nextTokenStart < input.size() && std::isspace(input[nextTokenStart])) nextTokenStart++;
                     
-                    std::string nextToken;
                     size_t nextTokenEnd = nextTokenStart;
                     while (nextTokenEnd < input.size() && !std::isspace(input[nextTokenEnd]) && 
-                           punctuation_map.find(std::string(1, input[nextTokenEnd])) == punctuation_map.end()) {
-                        nextToken += input[nextTokenEnd];
+                           !isPunctuationChar(input[nextTokenEnd])) {
                         nextTokenEnd++;
                     }
                     
-                    if (!nextToken.empty()) {
-                        tokens.push_back(Token(TokenType::CONSTRAINT, constraintStr, position, line, column - currentToken.size()));
-                        currentToken.clear();
+                    if (nextTokenEnd > nextTokenStart) {
+                        std::string_view span = input.substr(tokenStart, nextTokenEnd - tokenStart);
+                        tokens.push_back(TokenView(TokenType::CONSTRAINT, span, std::move(constraintStr), tokenStart, line, column - tokenLen));
+                        tokenLen = 0;
                         i = nextTokenEnd - 1;
                         continue;
                     }
                 }
                 
-                tokens.push_back(classifyToken(currentToken, position, line, column - currentToken.size()));
-                currentToken.clear();
+                flushToken();
             }
             continue;
         }
         
         // Handle multi-character operators
         if (i + 1 < input.size()) {
-            std::string twoChar = std::string(1, ch) + input[i + 1];
-            if (operator_map.find(twoChar) != operator_map.end()) {
-                if (!currentToken.empty()) {
-                    tokens.push_back(classifyToken(currentToken, position, line, column - currentToken.size()));
-                    currentToken.clear();
-                }
-                tokens.push_back(Token(TokenType::OPERATOR, twoChar, position, line, column));
+            const keywordEntry* twoChar = lookupKeyword(input.substr(i, 2));
+            if (twoChar && twoChar->type == TokenType::OPERATOR) {
+                flushToken();
+                tokens.push_back(TokenView(TokenType::OPERATOR, input.substr(i, 2), i, line, column));
                 i++; 
                 column++;
                 continue;
@@ -271,86 +269,86 @@ std::vector<Token> lexer::tokenize(const std::string& input) {
         
         // Handle string literals
         if (ch == '\'') {
-            if (!currentToken.empty()) {
-                tokens.push_back(classifyToken(currentToken, position, line, column - currentToken.size()));
-                currentToken.clear();
-            }
+            flushToken();
             
-            std::string stringLiteral(1, ch);
+            size_t literalStart = i;
             i++;
             column++;
             
-            while (i < input.size() && input[i] != '\'') {
-                stringLiteral += input[i];
-                if (input[i] == '\n') {
-                    line++;
-                    column = 1;
-                } else {
-                    column++;
-                }
-                i++;
+            size_t bodyLen = scanQuote(input.data() + i, input.size() - i);
+            NewlineInfo newlines = scanNewlines(input.data() + i, bodyLen);
+            if (newlines.count != 0) {
+                line += newlines.count;
+                column = bodyLen - newlines.lastOffset;
+            } else {
+                column += bodyLen;
             }
+            i += bodyLen;
             
             if (i < input.size()) {
-                stringLiteral += input[i]; 
                 column++;
             } else {
-                tokens.push_back(Token(TokenType::ERROR, "unclosed_string_literal", position, line, column));
+                tokens.push_back(TokenView(TokenType::ERROR, input.substr(literalStart), "unclosed_string_literal", literalStart, line, column));
                 continue;
             }
             
-            tokens.push_back(classifyToken(stringLiteral, position, line, column - stringLiteral.size()));
+            size_t literalLen = i - literalStart + 1;
+            tokens.push_back(classifyToken(input.substr(literalStart, literalLen), literalStart, line, column - literalLen));
             continue;
         }
         
         // Handle numbers (including decimals and negative numbers)
         if (std::isdigit(ch) || 
-            (ch == '-' && i + 1 < input.size() && std::isdigit(input[i + 1]) && currentToken.empty()) ||
-            (ch == '+' && i + 1 < input.size() && std::isdigit(input[i + 1]) && currentToken.empty()) ||
-            (ch == '.' && !currentToken.empty() && std::all_of(currentToken.begin(), currentToken.end(), ::isdigit))) {
-            currentToken += ch;
+            (ch == '-' && i + 1 < input.size() && std::isdigit(input[i + 1]) && tokenLen == 0) ||
+            (ch == '+' && i + 1 < input.size() && std::isdigit(input[i + 1]) && tokenLen == 0) ||
+            (ch == '.' && tokenLen != 0 && isAllDigits(input.substr(tokenStart, tokenLen)))) {
+            appendChar(i);
             continue;
         }
         
         // Handle punctuation
-        std::string singleChar(1, ch);
-        if (punctuation_map.find(singleChar) != punctuation_map.end()) {
-            if (!currentToken.empty()) {
-                tokens.push_back(classifyToken(currentToken, position, line, column - currentToken.size()));
-                currentToken.clear();
-            }
-            tokens.push_back(Token(TokenType::PUNCTUATION, singleChar, position, line, column));
+        if (isPunctuationChar(ch)) {
+            flushToken();
+            tokens.push_back(TokenView(TokenType::PUNCTUATION, input.substr(i, 1), i, line, column));
             continue;
         }
         
         // Handle single-character operators
-        if (operator_map.find(singleChar) != operator_map.end()) {
-            if (!currentToken.empty()) {
-                tokens.push_back(classifyToken(currentToken, position, line, column - currentToken.size()));
-                currentToken.clear();
-            }
-            tokens.push_back(Token(TokenType::OPERATOR, singleChar, position, line, column));
+        const keywordEntry* singleChar = lookupKeyword(input.substr(i, 1));
+        if (singleChar && singleChar->type == TokenType::OPERATOR) {
+            flushToken();
+            tokens.push_back(TokenView(TokenType::OPERATOR, input.substr(i, 1), i, line, column));
             continue;
         }
         
         // Default: accumulate character
-        currentToken += ch;
+        appendChar(i);
     }
     
-    if (!currentToken.empty()) {
-        tokens.push_back(classifyToken(currentToken, position, line, column - currentToken.size()));
+    flushToken();
+    
+    return tokens;
+}
+
+std::vector<Token> lexer::tokenize(std::string_view input) {
+    std::vector<TokenView> views = tokenizeView(input);
+    std::vector<Token> tokens;
+    tokens.reserve(views.size());
+    
+    for (const auto& view : views) {
+        tokens.push_back(view.toToken());
     }
     
     return tokens;
 }
 
 std::vector<std::pair<std::string, std::string>> lexer::getlexer(const std::string& input) {
-    std::vector<Token> modernTokens = tokenize(input);
+    std::vector<TokenView> views = tokenizeView(input);
     std::vector<std::pair<std::string, std::string>> legacyTokens;
-    legacyTokens.reserve(modernTokens.size());
+    legacyTokens.reserve(views.size());
     
-    for (const auto& token : modernTokens) {
-        legacyTokens.emplace_back(tokenTypeToString(token.type), token.value);
+    for (const auto& token : views) {
+        legacyTokens.emplace_back(tokenTypeToString(token.type), std::string(token.value()));
     }
     
     return legacyTokens;
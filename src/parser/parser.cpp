@@ -3,7 +3,26 @@
 #include <vector>
 #include <unordered_map>
 #include <functional>
+#include <algorithm>
+#include <cstdlib>
+#include <cctype>
+#include <cerrno>
+#include <sstream>
 #include "../../include/parser/parser.hpp"
+#include "../../include/parser/parserStats.hpp"
+#include "../../include/common/trace.hpp"
+
+// Remember the first error of the statement, its message and the token it
+// was hit at (see parser::error()); tracing adds every later one
+#define PARSE_ERROR(kind, message)                  \
+    do {                                            \
+        if (firstError == ParseError::NONE) {       \
+            std::ostringstream text_;               \
+            text_ << message;                       \
+            noteError(kind, text_.str());           \
+        }                                           \
+        TRACE_ERROR("Error: " << message);          \
+    } while (0)
 
 bool isTableColumn(const std::vector<Token>& tokens, int index) {
     if (index + 2 < tokens.size() &&
@@ -16,19 +35,56 @@ bool isTableColumn(const std::vector<Token>& tokens, int index) {
     
 }
 
+// Allocate an AST node from the statement arena when one is attached
+astNode* parser::makeNode(std::string_view type, std::string_view value) {
+    return astNode::create(type, value, nodeArena);
+}
+
+// Node whose value is "qualifier.name", built in place without a temporary
+astNode* parser::makeQualifiedNode(std::string_view type, std::string_view qualifier, std::string_view name) {
+    astNode* node = astNode::create(type, "", nodeArena);
+    node->value.reserve(qualifier.size() + 1 + name.size());
+    node->value.append(qualifier).append(".").append(name);
+    return node;
+}
+
+void parser::noteError(ParseError kind, std::string message) {
+    if (firstError != ParseError::NONE) return;
+    firstError = kind;
+    firstErrorMessage = std::move(message);
+    firstErrorToken = itr.getVal();
+}
+
 // Helper function to check if a token matches a specific type and value
-bool parser::isToken(const Token& token, TokenType type, const std::string& value = "") {}
+bool parser::isToken(const Token& token, TokenType type, const std::string& value) {
+    return token.type == type && (value.empty() || token.value == value);
+}
 
 // Recursive subquery handler
 bool parser::handleSubquery(const std::vector<Token>& tokens, astNode* parentNode) {
-
+    clauseTimer timer(ParseClause::SUBQUERY);
+    TRACE_DEBUG("Parsing subquery...");
+    
+    astNode* subqueryNode = makeNode("SUBQUERY", "");
+    parentNode->addChild(subqueryNode);
+    
+    if (!parseSelect(tokens, subqueryNode)) {
+        return false;
+    }
+    
+    // Consume the closing parenthesis of a parenthesized subquery
+    if (itr.getVal() < tokens.size() && isToken(tokens[itr.getVal()], TokenType::PUNCTUATION, ")")) {
+        itr += 1;
+    }
+    
+    return true;
 }
 
 // ---------------- SELECT ----------------
 bool parser::parseSelect(const std::vector<Token>& tokens, astNode* parentNode) {
-    std::cout << "Parsing SELECT statement..." << std::endl;
+    TRACE_INFO("Parsing SELECT statement...");
     
-    astNode* selectNode = new astNode("SELECT", "");
+    astNode* selectNode = makeNode("SELECT", "");
     parentNode->addChild(selectNode);
     
     itr += 1; // Skip SELECT keyword
@@ -37,17 +93,17 @@ bool parser::parseSelect(const std::vector<Token>& tokens, astNode* parentNode)
     if (itr.getVal() < tokens.size() && 
         tokens[itr.getVal()].type == TokenType::KEYWORD && 
         tokens[itr.getVal()].value == "DISTINCT") {
-        std::cout << "DISTINCT found" << std::endl;
-        selectNode->addChild(new astNode("DISTINCT", "DISTINCT"));
+        TRACE_DEBUG("DISTINCT found");
+        selectNode->addChild(makeNode("DISTINCT", "DISTINCT"));
         itr += 1;
     }
     
     // Parse SELECT list
-    astNode* selectListNode = new astNode("SELECT_LIST", "");
+    astNode* selectListNode = makeNode("SELECT_LIST", "");
     selectNode->addChild(selectListNode);
     
     if (!parseSelectList(tokens, selectListNode)) {
-        std::cout << "Error: Failed to parse SELECT list" << std::endl;
+        TRACE_ERROR("Error: Failed to parse SELECT list");
         return false;
     }
     
@@ -55,18 +111,18 @@ bool parser::parseSelect(const std::vector<Token>& tokens, astNode* parentNode)
     if (itr.getVal() >= tokens.size() || 
         tokens[itr.getVal()].type != TokenType::KEYWORD || 
         tokens[itr.getVal()].value != "FROM") {
-        std::cout << "Error: Expected FROM keyword" << std::endl;
+        PARSE_ERROR(ParseError::EXPECTED_KEYWORD, "Expected FROM keyword");
         return false;
     }
     
     itr += 1; // Skip FROM
     
     // Parse FROM clause
-    astNode* fromNode = new astNode("FROM", "");
+    astNode* fromNode = makeNode("FROM", "");
     selectNode->addChild(fromNode);
     
     if (!parseFromClause(tokens, fromNode)) {
-        std::cout << "Error: Failed to parse FROM clause" << std::endl;
+        TRACE_ERROR("Error: Failed to parse FROM clause");
         return false;
     }
     
@@ -76,8 +132,9 @@ bool parser::parseSelect(const std::vector<Token>& tokens, astNode* parentNode)
         
         if (currentToken.type == TokenType::KEYWORD) {
             if (currentToken.value == "WHERE") {
-                std::cout << "Parsing WHERE clause..." << std::endl;
-                astNode* whereNode = new astNode("WHERE", "");
+                clauseTimer timer(ParseClause::WHERE);
+                TRACE_DEBUG("Parsing WHERE clause...");
+                astNode* whereNode = makeNode("WHERE", "");
                 selectNode->addChild(whereNode);
                 itr += 1;
                 
@@ -113,12 +170,14 @@ bool parser::parseSelect(const std::vector<Token>& tokens, astNode* parentNode)
 
 // Parse SELECT list (columns, expressions, functions)
 bool parser::parseSelectList(const std::vector<Token>& tokens, astNode* parentNode) {
+    clauseTimer timer(ParseClause::SELECT_LIST);
+    
     do {
-        astNode* columnNode = new astNode("COLUMN_EXPR", "");
+        astNode* columnNode = makeNode("COLUMN_EXPR", "");
         parentNode->addChild(columnNode);
         
         if (!parseSelectExpression(tokens, columnNode)) {
-            std::cout << "Error: Failed to parse SELECT expression" << std::endl;
+            TRACE_ERROR("Error: Failed to parse SELECT expression");
             return false;
         }
         
@@ -130,8 +189,8 @@ bool parser::parseSelectList(const std::vector<Token>& tokens, astNode* parentNo
                 itr += 1;
                 if (itr.getVal() < tokens.size() && 
                     tokens[itr.getVal()].type == TokenType::IDENTIFIER) {
-                    std::cout << "Column alias: " << tokens[itr.getVal()].value << std::endl;
-                    columnNode->addChild(new astNode("ALIAS", tokens[itr.getVal()].value));
+                    TRACE_DEBUG("Column alias: " << tokens[itr.getVal()].value);
+                    columnNode->addChild(makeNode("ALIAS", tokens[itr.getVal()].value));
                     itr += 1;
                 }
             } else if (nextToken.type == TokenType::IDENTIFIER && 
@@ -140,8 +199,8 @@ bool parser::parseSelectList(const std::vector<Token>& tokens, astNode* parentNo
                         tokens[itr.getVal() + 1].value == "," || 
                         tokens[itr.getVal() + 1].value == "FROM")) {
                 // Direct alias without AS
-                std::cout << "Column alias (no AS): " << nextToken.value << std::endl;
-                columnNode->addChild(new astNode("ALIAS", nextToken.value));
+                TRACE_DEBUG("Column alias (no AS): " << nextToken.value);
+                columnNode->addChild(makeNode("ALIAS", nextToken.value));
                 itr += 1;
             }
         }
@@ -169,8 +228,8 @@ bool parser::parseSelectExpression(const std::vector<Token>& tokens, astNode* pa
     
     // Handle wildcard (*)
     if (currentToken.type == TokenType::OPERATOR && currentToken.value == "*") {
-        std::cout << "Wildcard (*) found" << std::endl;
-        parentNode->addChild(new astNode("WILDCARD", "*"));
+        TRACE_DEBUG("Wildcard (*) found");
+        parentNode->addChild(makeNode("WILDCARD", "*"));
         itr += 1;
         return true;
     }
@@ -185,15 +244,15 @@ bool parser::parseSelectExpression(const std::vector<Token>& tokens, astNode* pa
     
     // Handle table.column or simple column
     if (isTableColumn(tokens, itr.getVal())) {
-        std::cout << "Table.column: " << tokens[itr.getVal()].value << "." << tokens[itr.getVal() + 2].value << std::endl;
-        parentNode->addChild(new astNode("COLUMN", tokens[itr.getVal()].value + "." + tokens[itr.getVal() + 2].value));
+        TRACE_DEBUG("Table.column: " << tokens[itr.getVal()].value << "." << tokens[itr.getVal() + 2].value);
+        parentNode->addChild(makeQualifiedNode("COLUMN", tokens[itr.getVal()].value, tokens[itr.getVal() + 2].value));
         itr += 3;
         return true;
     }
     
     // Handle simple column or expression
     if (!parseValue(tokens, parentNode)) {
-        std::cout << "Error: Expected column name or expression" << std::endl;
+        PARSE_ERROR(ParseError::EXPECTED_IDENTIFIER, "Expected column name or expression");
         return false;
     }
     
@@ -203,9 +262,9 @@ bool parser::parseSelectExpression(const std::vector<Token>& tokens, astNode* pa
 // Parse aggregate functions
 bool parser::parseAggregateFunction(const std::vector<Token>& tokens, astNode* parentNode) {
     const Token& functionToken = tokens[itr.getVal()];
-    std::cout << "Aggregate function: " << functionToken.value << std::endl;
+    TRACE_DEBUG("Aggregate function: " << functionToken.value);
     
-    astNode* functionNode = new astNode("FUNCTION", functionToken.value);
+    astNode* functionNode = makeNode("FUNCTION", functionToken.value);
     parentNode->addChild(functionNode);
     itr += 1;
     
@@ -213,26 +272,26 @@ bool parser::parseAggregateFunction(const std::vector<Token>& tokens, astNode* p
     if (itr.getVal() >= tokens.size() || 
         tokens[itr.getVal()].type != TokenType::PUNCTUATION || 
         tokens[itr.getVal()].value != "(") {
-        std::cout << "Error: Expected '(' after function name" << std::endl;
+        PARSE_ERROR(ParseError::EXPECTED_PUNCTUATION, "Expected '(' after function name");
         return false;
     }
     itr += 1;
     
     // Parse function arguments
-    astNode* argsNode = new astNode("ARGS", "");
+    astNode* argsNode = makeNode("ARGS", "");
     functionNode->addChild(argsNode);
     
     // Handle special case: COUNT(*)
     if (itr.getVal() < tokens.size() && 
         tokens[itr.getVal()].type == TokenType::OPERATOR && 
         tokens[itr.getVal()].value == "*") {
-        std::cout << "Function argument: *" << std::endl;
-        argsNode->addChild(new astNode("WILDCARD", "*"));
+        TRACE_DEBUG("Function argument: *");
+        argsNode->addChild(makeNode("WILDCARD", "*"));
         itr += 1;
     } else {
         // Parse column or expression
         if (!parseValue(tokens, argsNode)) {
-            std::cout << "Error: Expected function argument" << std::endl;
+            PARSE_ERROR(ParseError::EXPECTED_VALUE, "Expected function argument");
             return false;
         }
     }
@@ -241,7 +300,7 @@ bool parser::parseAggregateFunction(const std::vector<Token>& tokens, astNode* p
     if (itr.getVal() >= tokens.size() || 
         tokens[itr.getVal()].type != TokenType::PUNCTUATION || 
         tokens[itr.getVal()].value != ")") {
-        std::cout << "Error: Expected ')' after function arguments" << std::endl;
+        PARSE_ERROR(ParseError::EXPECTED_PUNCTUATION, "Expected ')' after function arguments");
         return false;
     }
     itr += 1;
@@ -251,6 +310,8 @@ bool parser::parseAggregateFunction(const std::vector<Token>& tokens, astNode* p
 
 // Parse FROM clause with JOIN support
 bool parser::parseFromClause(const std::vector<Token>& tokens, astNode* parentNode) {
+    clauseTimer timer(ParseClause::FROM);
+    
     // Parse first table
     if (!parseTableReference(tokens, parentNode)) {
         return false;
@@ -279,14 +340,14 @@ bool parser::parseFromClause(const std::vector<Token>& tokens, astNode* parentNo
 bool parser::parseTableReference(const std::vector<Token>& tokens, astNode* parentNode) {
     if (itr.getVal() >= tokens.size() || 
         tokens[itr.getVal()].type != TokenType::IDENTIFIER) {
-        std::cout << "Error: Expected table name" << std::endl;
+        PARSE_ERROR(ParseError::EXPECTED_IDENTIFIER, "Expected table name");
         return false;
     }
     
     const Token& tableToken = tokens[itr.getVal()];
-    std::cout << "Table: " << tableToken.value << std::endl;
+    TRACE_DEBUG("Table: " << tableToken.value);
     
-    astNode* tableNode = new astNode("TABLE", tableToken.value);
+    astNode* tableNode = makeNode("TABLE", tableToken.value);
     parentNode->addChild(tableNode);
     itr += 1;
     
@@ -300,10 +361,14 @@ bool parser::parseTableReference(const std::vector<Token>& tokens, astNode* pare
            tokens[itr.getVal() + 1].value == "INNER" || 
            tokens[itr.getVal() + 1].value == "LEFT" || 
            tokens[itr.getVal() + 1].value == "RIGHT" || 
+           tokens[itr.getVal() + 1].value == "FULL" || 
+           tokens[itr.getVal() + 1].value == "ON" || 
            tokens[itr.getVal() + 1].value == "GROUP" || 
-           tokens[itr.getVal() + 1].value == "ORDER")))) {
-        std::cout << "Table alias: " << tokens[itr.getVal()].value << std::endl;
-        tableNode->addChild(new astNode("ALIAS", tokens[itr.getVal()].value));
+           tokens[itr.getVal() + 1].value == "HAVING" || 
+           tokens[itr.getVal() + 1].value == "ORDER" || 
+           tokens[itr.getVal() + 1].value == "LIMIT")))) {
+        TRACE_DEBUG("Table alias: " << tokens[itr.getVal()].value);
+        tableNode->addChild(makeNode("ALIAS", tokens[itr.getVal()].value));
         itr += 1;
     }
     
@@ -312,7 +377,9 @@ bool parser::parseTableReference(const std::vector<Token>& tokens, astNode* pare
 
 // Parse JOIN clause
 bool parser::parseJoinClause(const std::vector<Token>& tokens, astNode* parentNode) {
-    astNode* joinNode = new astNode("JOIN", "");
+    clauseTimer timer(ParseClause::JOIN);
+    
+    astNode* joinNode = makeNode("JOIN", "");
     parentNode->addChild(joinNode);
     
     std::string joinType = "";
@@ -334,7 +401,7 @@ bool parser::parseJoinClause(const std::vector<Token>& tokens, astNode* parentNo
         if (itr.getVal() >= tokens.size() || 
             tokens[itr.getVal()].type != TokenType::KEYWORD || 
             tokens[itr.getVal()].value != "JOIN") {
-            std::cout << "Error: Expected JOIN after " << joinType << std::endl;
+            PARSE_ERROR(ParseError::EXPECTED_KEYWORD, "Expected JOIN after " << joinType);
             return false;
         }
         joinType += " JOIN";
@@ -342,8 +409,8 @@ bool parser::parseJoinClause(const std::vector<Token>& tokens, astNode* parentNo
         joinType = "INNER JOIN";
     }
     
-    std::cout << "JOIN type: " << joinType << std::endl;
-    joinNode->addChild(new astNode("JOIN_TYPE", joinType));
+    TRACE_DEBUG("JOIN type: " << joinType);
+    joinNode->addChild(makeNode("JOIN_TYPE", joinType));
     itr += 1; // Skip JOIN keyword
     
     // Parse joined table
@@ -355,12 +422,12 @@ bool parser::parseJoinClause(const std::vector<Token>& tokens, astNode* parentNo
     if (itr.getVal() >= tokens.size() || 
         tokens[itr.getVal()].type != TokenType::KEYWORD || 
         tokens[itr.getVal()].value != "ON") {
-        std::cout << "Error: Expected ON after JOIN table" << std::endl;
+        PARSE_ERROR(ParseError::EXPECTED_KEYWORD, "Expected ON after JOIN table");
         return false;
     }
     
-    std::cout << "Parsing JOIN ON condition..." << std::endl;
-    astNode* onNode = new astNode("ON", "");
+    TRACE_DEBUG("Parsing JOIN ON condition...");
+    astNode* onNode = makeNode("ON", "");
     joinNode->addChild(onNode);
     itr += 1;
     
@@ -369,24 +436,25 @@ bool parser::parseJoinClause(const std::vector<Token>& tokens, astNode* parentNo
 
 // Parse GROUP BY clause
 bool parser::parseGroupBy(const std::vector<Token>& tokens, astNode* parentNode) {
-    std::cout << "Parsing GROUP BY clause..." << std::endl;
+    clauseTimer timer(ParseClause::GROUP_BY);
+    TRACE_DEBUG("Parsing GROUP BY clause...");
     
     // Expect GROUP BY
     if (itr.getVal() + 1 >= tokens.size() || 
         tokens[itr.getVal()].value != "GROUP" || 
         tokens[itr.getVal() + 1].value != "BY") {
-        std::cout << "Error: Expected GROUP BY" << std::endl;
+        PARSE_ERROR(ParseError::EXPECTED_KEYWORD, "Expected GROUP BY");
         return false;
     }
     
-    astNode* groupByNode = new astNode("GROUP_BY", "");
+    astNode* groupByNode = makeNode("GROUP_BY", "");
     parentNode->addChild(groupByNode);
     itr += 2; // Skip GROUP BY
     
     // Parse column list
     do {
         if (!parseValue(tokens, groupByNode)) {
-            std::cout << "Error: Expected column in GROUP BY" << std::endl;
+            PARSE_ERROR(ParseError::EXPECTED_IDENTIFIER, "Expected column in GROUP BY");
             return false;
         }
         
@@ -404,9 +472,10 @@ bool parser::parseGroupBy(const std::vector<Token>& tokens, astNode* parentNode)
 
 // Parse HAVING clause
 bool parser::parseHaving(const std::vector<Token>& tokens, astNode* parentNode) {
-    std::cout << "Parsing HAVING clause..." << std::endl;
+    clauseTimer timer(ParseClause::HAVING);
+    TRACE_DEBUG("Parsing HAVING clause...");
     
-    astNode* havingNode = new astNode("HAVING", "");
+    astNode* havingNode = makeNode("HAVING", "");
     parentNode->addChild(havingNode);
     itr += 1; // Skip HAVING
     
@@ -415,27 +484,28 @@ bool parser::parseHaving(const std::vector<Token>& tokens, astNode* parentNode)
 
 // Parse ORDER BY clause
 bool parser::parseOrderBy(const std::vector<Token>& tokens, astNode* parentNode) {
-    std::cout << "Parsing ORDER BY clause..." << std::endl;
+    clauseTimer timer(ParseClause::ORDER_BY);
+    TRACE_DEBUG("Parsing ORDER BY clause...");
     
     // Expect ORDER BY
     if (itr.getVal() + 1 >= tokens.size() || 
         tokens[itr.getVal()].value != "ORDER" || 
         tokens[itr.getVal() + 1].value != "BY") {
-        std::cout << "Error: Expected ORDER BY" << std::endl;
+        PARSE_ERROR(ParseError::EXPECTED_KEYWORD, "Expected ORDER BY");
         return false;
     }
     
-    astNode* orderByNode = new astNode("ORDER_BY", "");
+    astNode* orderByNode = makeNode("ORDER_BY", "");
     parentNode->addChild(orderByNode);
     itr += 2; // Skip ORDER BY
     
     // Parse order expressions
     do {
-        astNode* orderExprNode = new astNode("ORDER_EXPR", "");
+        astNode* orderExprNode = makeNode("ORDER_EXPR", "");
         orderByNode->addChild(orderExprNode);
         
         if (!parseValue(tokens, orderExprNode)) {
-            std::cout << "Error: Expected column in ORDER BY" << std::endl;
+            PARSE_ERROR(ParseError::EXPECTED_IDENTIFIER, "Expected column in ORDER BY");
             return false;
         }
         
@@ -443,8 +513,8 @@ bool parser::parseOrderBy(const std::vector<Token>& tokens, astNode* parentNode)
         if (itr.getVal() < tokens.size() && 
             tokens[itr.getVal()].type == TokenType::IDENTIFIER &&
             (tokens[itr.getVal()].value == "ASC" || tokens[itr.getVal()].value == "DESC")) {
-            std::cout << "Order direction: " << tokens[itr.getVal()].value << std::endl;
-            orderExprNode->addChild(new astNode("DIRECTION", tokens[itr.getVal()].value));
+            TRACE_DEBUG("Order direction: " << tokens[itr.getVal()].value);
+            orderExprNode->addChild(makeNode("DIRECTION", tokens[itr.getVal()].value));
             itr += 1;
         }
         
@@ -462,38 +532,419 @@ bool parser::parseOrderBy(const std::vector<Token>& tokens, astNode* parentNode)
 
 // Parse LIMIT clause
 bool parser::parseLimit(const std::vector<Token>& tokens, astNode* parentNode) {
-    std::cout << "Parsing LIMIT clause..." << std::endl;
+    clauseTimer timer(ParseClause::LIMIT);
+    TRACE_DEBUG("Parsing LIMIT clause...");
     
-    astNode* limitNode = new astNode("LIMIT", "");
+    astNode* limitNode = makeNode("LIMIT", "");
     parentNode->addChild(limitNode);
     itr += 1; // Skip LIMIT
     
+    // A bound limit (LIMIT ? / LIMIT $n) is filled in at execute time
+    if (itr.getVal() < tokens.size() && tokens[itr.getVal()].type == TokenType::PARAMETER) {
+        return parseParameter(tokens, limitNode);
+    }
+    
     if (itr.getVal() >= tokens.size() || 
         tokens[itr.getVal()].type != TokenType::NUMBER) {
-        std::cout << "Error: Expected number after LIMIT" << std::endl;
+        PARSE_ERROR(ParseError::EXPECTED_VALUE, "Expected number after LIMIT");
         return false;
     }
     
-    std::cout << "Limit value: " << tokens[itr.getVal()].value << std::endl;
-    limitNode->addChild(new astNode("VALUE", tokens[itr.getVal()].value));
+    TRACE_DEBUG("Limit value: " << tokens[itr.getVal()].value);
+    limitNode->addChild(makeNode("VALUE", tokens[itr.getVal()].value));
     itr += 1;
     
     return true;
 }
 
 // ---------------- INSERT ----------------
-bool parser::parseInsert(const std::vector<Token>& tokens, astNode* parentNode) {}
+// INSERT INTO table [(column, ...)] VALUES (value, ...) [, (value, ...)]...
+// as INSERT over TABLE, an optional COLUMNS list and VALUES holding one ROW
+// per parenthesized list
+bool parser::parseInsert(const std::vector<Token>& tokens, astNode* parentNode) {
+    TRACE_INFO("Parsing INSERT statement...");
+    itr += 1; // Skip INSERT
+
+    if (itr.getVal() + 1 >= tokens.size() || !isToken(tokens[itr.getVal()], TokenType::KEYWORD, "INTO") ||
+        tokens[itr.getVal() + 1].type != TokenType::IDENTIFIER) {
+        PARSE_ERROR(ParseError::EXPECTED_IDENTIFIER, "Expected INTO table name");
+        return false;
+    }
+    astNode* insertNode = makeNode("INSERT", "");
+    parentNode->addChild(insertNode);
+    insertNode->addChild(makeNode("TABLE", tokens[itr.getVal() + 1].value));
+    itr += 2;
+
+    if (itr.getVal() < tokens.size() && isToken(tokens[itr.getVal()], TokenType::PUNCTUATION, "(")) {
+        astNode* columnsNode = makeNode("COLUMNS", "");
+        insertNode->addChild(columnsNode);
+        itr += 1;
+        do {
+            if (itr.getVal() >= tokens.size() || tokens[itr.getVal()].type != TokenType::IDENTIFIER) {
+                PARSE_ERROR(ParseError::EXPECTED_IDENTIFIER, "Expected column name in INSERT column list");
+                return false;
+            }
+            columnsNode->addChild(makeNode("COLUMN", tokens[itr.getVal()].value));
+            itr += 1;
+            if (itr.getVal() < tokens.size() && isToken(tokens[itr.getVal()], TokenType::PUNCTUATION, ",")) {
+                itr += 1;
+            } else {
+                break;
+            }
+        } while (true);
+        if (itr.getVal() >= tokens.size() || !isToken(tokens[itr.getVal()], TokenType::PUNCTUATION, ")")) {
+            PARSE_ERROR(ParseError::EXPECTED_PUNCTUATION, "Expected ')' after INSERT column list");
+            return false;
+        }
+        itr += 1;
+    }
+
+    if (itr.getVal() >= tokens.size() || !isToken(tokens[itr.getVal()], TokenType::KEYWORD, "VALUES")) {
+        PARSE_ERROR(ParseError::EXPECTED_KEYWORD, "Expected VALUES");
+        return false;
+    }
+    itr += 1;
+    astNode* valuesNode = makeNode("VALUES", "");
+    insertNode->addChild(valuesNode);
+    do {
+        if (itr.getVal() >= tokens.size() || !isToken(tokens[itr.getVal()], TokenType::PUNCTUATION, "(")) {
+            PARSE_ERROR(ParseError::EXPECTED_PUNCTUATION, "Expected '(' before a row of values");
+            return false;
+        }
+        itr += 1;
+        astNode* rowNode = makeNode("ROW", "");
+        valuesNode->addChild(rowNode);
+        do {
+            if (!parseValue(tokens, rowNode)) return false;
+            if (itr.getVal() < tokens.size() && isToken(tokens[itr.getVal()], TokenType::PUNCTUATION, ",")) {
+                itr += 1;
+            } else {
+                break;
+            }
+        } while (true);
+        if (itr.getVal() >= tokens.size() || !isToken(tokens[itr.getVal()], TokenType::PUNCTUATION, ")")) {
+            PARSE_ERROR(ParseError::EXPECTED_PUNCTUATION, "Expected ')' after a row of values");
+            return false;
+        }
+        itr += 1;
+        if (itr.getVal() < tokens.size() && isToken(tokens[itr.getVal()], TokenType::PUNCTUATION, ",")) {
+            itr += 1;
+        } else {
+            break;
+        }
+    } while (true);
+
+    return finishStatement(tokens, "INSERT");
+}
 
 // ---------------- UPDATE ----------------
-bool parser::parseUpdate(const std::vector<Token>& tokens, astNode* parentNode) {}
+// UPDATE table SET column = value [, column = value]... [WHERE condition] as
+// UPDATE over TABLE, SET holding one ASSIGNMENT (valued with the column) per
+// pair, and an optional WHERE
+bool parser::parseUpdate(const std::vector<Token>& tokens, astNode* parentNode) {
+    TRACE_INFO("Parsing UPDATE statement...");
+    itr += 1; // Skip UPDATE
+
+    if (itr.getVal() + 1 >= tokens.size() || tokens[itr.getVal()].type != TokenType::IDENTIFIER ||
+        !isToken(tokens[itr.getVal() + 1], TokenType::KEYWORD, "SET")) {
+        PARSE_ERROR(ParseError::EXPECTED_IDENTIFIER, "Expected table name and SET");
+        return false;
+    }
+    astNode* updateNode = makeNode("UPDATE", "");
+    parentNode->addChild(updateNode);
+    updateNode->addChild(makeNode("TABLE", tokens[itr.getVal()].value));
+    itr += 2;
+
+    astNode* setNode = makeNode("SET", "");
+    updateNode->addChild(setNode);
+    do {
+        if (itr.getVal() + 1 >= tokens.size() || tokens[itr.getVal()].type != TokenType::IDENTIFIER ||
+            !isToken(tokens[itr.getVal() + 1], TokenType::OPERATOR, "=")) {
+            PARSE_ERROR(ParseError::EXPECTED_IDENTIFIER, "Expected column = value in SET");
+            return false;
+        }
+        astNode* assignmentNode = makeNode("ASSIGNMENT", tokens[itr.getVal()].value);
+        setNode->addChild(assignmentNode);
+        itr += 2;
+        if (!parseValue(tokens, assignmentNode)) return false;
+        if (itr.getVal() < tokens.size() && isToken(tokens[itr.getVal()], TokenType::PUNCTUATION, ",")) {
+            itr += 1;
+        } else {
+            break;
+        }
+    } while (true);
+
+    if (!parseOptionalWhere(tokens, updateNode)) return false;
+    return finishStatement(tokens, "UPDATE");
+}
 
 // ---------------- DELETE ----------------
-bool parser::parseDelete(const std::vector<Token>& tokens, astNode* parentNode) {}
+// DELETE FROM table [WHERE condition] as DELETE over TABLE and an optional WHERE
+bool parser::parseDelete(const std::vector<Token>& tokens, astNode* parentNode) {
+    TRACE_INFO("Parsing DELETE statement...");
+    itr += 1; // Skip DELETE
+
+    if (itr.getVal() + 1 >= tokens.size() || !isToken(tokens[itr.getVal()], TokenType::KEYWORD, "FROM") ||
+        tokens[itr.getVal() + 1].type != TokenType::IDENTIFIER) {
+        PARSE_ERROR(ParseError::EXPECTED_IDENTIFIER, "Expected FROM table name");
+        return false;
+    }
+    astNode* deleteNode = makeNode("DELETE", "");
+    parentNode->addChild(deleteNode);
+    deleteNode->addChild(makeNode("TABLE", tokens[itr.getVal() + 1].value));
+    itr += 2;
+
+    if (!parseOptionalWhere(tokens, deleteNode)) return false;
+    return finishStatement(tokens, "DELETE");
+}
+
+bool parser::parseOptionalWhere(const std::vector<Token>& tokens, astNode* parentNode) {
+    if (itr.getVal() >= tokens.size() || !isToken(tokens[itr.getVal()], TokenType::KEYWORD, "WHERE")) return true;
+    clauseTimer timer(ParseClause::WHERE);
+    astNode* whereNode = makeNode("WHERE", "");
+    parentNode->addChild(whereNode);
+    itr += 1;
+    return parseCondition(tokens, whereNode);
+}
+
+// An optional ';' and nothing after it
+bool parser::finishStatement(const std::vector<Token>& tokens, [[maybe_unused]] const char* statement) {
+    if (itr.getVal() < tokens.size() && isToken(tokens[itr.getVal()], TokenType::PUNCTUATION, ";")) {
+        itr += 1;
+    }
+    if (itr.getVal() < tokens.size()) {
+        PARSE_ERROR(ParseError::UNEXPECTED_TOKEN, "Unexpected '" << tokens[itr.getVal()].value << "' after " << statement);
+        return false;
+    }
+    return true;
+}
+
+// ---------------- CREATE ----------------
+static bool equalsIgnoreCase(const std::string& text, const char* word) {
+    size_t i = 0;
+    for (; i < text.size() && word[i]; i++) {
+        if (std::toupper(static_cast<unsigned char>(text[i])) != word[i]) return false;
+    }
+    return i == text.size() && !word[i];
+}
+
+bool parser::parseCreate(const std::vector<Token>& tokens, astNode* parentNode) {
+    TRACE_INFO("Parsing CREATE statement...");
+    itr += 1; // Skip CREATE
+
+    if (itr.getVal() < tokens.size() && tokens[itr.getVal()].type == TokenType::IDENTIFIER &&
+        equalsIgnoreCase(tokens[itr.getVal()].value, "INDEX")) {
+        return parseCreateIndex(tokens, parentNode);
+    }
+    if (itr.getVal() >= tokens.size() || !isToken(tokens[itr.getVal()], TokenType::KEYWORD, "TABLE")) {
+        PARSE_ERROR(ParseError::UNSUPPORTED_STATEMENT, "Only CREATE TABLE and CREATE INDEX are supported");
+        return false;
+    }
+    itr += 1;
+
+    if (itr.getVal() >= tokens.size() || tokens[itr.getVal()].type != TokenType::IDENTIFIER) {
+        PARSE_ERROR(ParseError::EXPECTED_IDENTIFIER, "Expected table name");
+        return false;
+    }
+    astNode* createNode = makeNode("CREATE_TABLE", tokens[itr.getVal()].value);
+    parentNode->addChild(createNode);
+    itr += 1;
+
+    if (itr.getVal() >= tokens.size() || !isToken(tokens[itr.getVal()], TokenType::PUNCTUATION, "(")) {
+        PARSE_ERROR(ParseError::EXPECTED_PUNCTUATION, "Expected '(' after table name");
+        return false;
+    }
+    itr += 1;
+
+    // Column definitions and table constraints
+    do {
+        if (itr.getVal() >= tokens.size()) {
+            PARSE_ERROR(ParseError::EXPECTED_IDENTIFIER, "Expected column definition");
+            return false;
+        }
+        const Token& currentToken = tokens[itr.getVal()];
+        bool ok;
+        if (currentToken.type == TokenType::CONSTRAINT) {
+            ok = parseTableConstraint(tokens, createNode);
+        } else {
+            ok = parseColumnDefinition(tokens, createNode);
+        }
+        if (!ok) return false;
+
+        if (itr.getVal() < tokens.size() && isToken(tokens[itr.getVal()], TokenType::PUNCTUATION, ",")) {
+            itr += 1;
+        } else {
+            break;
+        }
+    } while (true);
+
+    if (itr.getVal() >= tokens.size() || !isToken(tokens[itr.getVal()], TokenType::PUNCTUATION, ")")) {
+        PARSE_ERROR(ParseError::EXPECTED_PUNCTUATION, "Expected ')' after column definitions");
+        return false;
+    }
+    itr += 1;
+
+    // Table options: WITH (STORAGE = ROW | PAX)
+    if (itr.getVal() < tokens.size() && tokens[itr.getVal()].type == TokenType::IDENTIFIER &&
+        equalsIgnoreCase(tokens[itr.getVal()].value, "WITH")) {
+        itr += 1;
+        if (itr.getVal() + 4 >= tokens.size() ||
+            !isToken(tokens[itr.getVal()], TokenType::PUNCTUATION, "(") ||
+            tokens[itr.getVal() + 1].type != TokenType::IDENTIFIER ||
+            !equalsIgnoreCase(tokens[itr.getVal() + 1].value, "STORAGE") ||
+            !isToken(tokens[itr.getVal() + 2], TokenType::OPERATOR, "=") ||
+            tokens[itr.getVal() + 3].type != TokenType::IDENTIFIER ||
+            !isToken(tokens[itr.getVal() + 4], TokenType::PUNCTUATION, ")")) {
+            PARSE_ERROR(ParseError::UNEXPECTED_TOKEN, "Expected WITH (STORAGE = ROW | PAX)");
+            return false;
+        }
+        const std::string& format = tokens[itr.getVal() + 3].value;
+        if (!equalsIgnoreCase(format, "ROW") && !equalsIgnoreCase(format, "PAX")) {
+            PARSE_ERROR(ParseError::UNEXPECTED_TOKEN, "Unknown storage format '" << format << "'");
+            return false;
+        }
+        TRACE_DEBUG("Storage: " << format);
+        createNode->addChild(makeNode("STORAGE", equalsIgnoreCase(format, "PAX") ? "PAX" : "ROW"));
+        itr += 5;
+    }
+
+    return finishStatement(tokens, "CREATE TABLE");
+}
+
+// CREATE INDEX name ON table (column) USING HASH, as a CREATE_INDEX node
+// valued with the index name over TABLE, COLUMN and USING children
+bool parser::parseCreateIndex(const std::vector<Token>& tokens, astNode* parentNode) {
+    itr += 1; // Skip INDEX
+    size_t at = itr.getVal();
+    if (at + 5 >= tokens.size() ||
+        tokens[at].type != TokenType::IDENTIFIER ||
+        !isToken(tokens[at + 1], TokenType::KEYWORD, "ON") ||
+        tokens[at + 2].type != TokenType::IDENTIFIER ||
+        !isToken(tokens[at + 3], TokenType::PUNCTUATION, "(") ||
+        tokens[at + 4].type != TokenType::IDENTIFIER ||
+        !isToken(tokens[at + 5], TokenType::PUNCTUATION, ")")) {
+        PARSE_ERROR(ParseError::EXPECTED_IDENTIFIER, "Expected CREATE INDEX name ON table(column)");
+        return false;
+    }
+    astNode* indexNode = makeNode("CREATE_INDEX", tokens[at].value);
+    parentNode->addChild(indexNode);
+    indexNode->addChild(makeNode("TABLE", tokens[at + 2].value));
+    indexNode->addChild(makeNode("COLUMN", tokens[at + 4].value));
+    itr += 6;
+
+    if (itr.getVal() + 1 >= tokens.size() ||
+        tokens[itr.getVal()].type != TokenType::IDENTIFIER || !equalsIgnoreCase(tokens[itr.getVal()].value, "USING") ||
+        tokens[itr.getVal() + 1].type != TokenType::IDENTIFIER || !equalsIgnoreCase(tokens[itr.getVal() + 1].value, "HASH")) {
+        PARSE_ERROR(ParseError::UNEXPECTED_TOKEN, "Expected USING HASH after the indexed column");
+        return false;
+    }
+    indexNode->addChild(makeNode("USING", "HASH"));
+    itr += 2;
+
+    return finishStatement(tokens, "CREATE INDEX");
+}
+
+// name DATATYPE [(length)] [PRIMARY KEY | UNIQUE | NOT NULL | REFERENCES table(column)]...
+bool parser::parseColumnDefinition(const std::vector<Token>& tokens, astNode* parentNode) {
+    if (tokens[itr.getVal()].type != TokenType::IDENTIFIER) {
+        PARSE_ERROR(ParseError::EXPECTED_IDENTIFIER, "Expected column name");
+        return false;
+    }
+    astNode* columnNode = makeNode("COLUMN_DEF", tokens[itr.getVal()].value);
+    parentNode->addChild(columnNode);
+    itr += 1;
+
+    if (itr.getVal() >= tokens.size() || tokens[itr.getVal()].type != TokenType::DATATYPE) {
+        PARSE_ERROR(ParseError::EXPECTED_KEYWORD, "Expected datatype for column '" << columnNode->value << "'");
+        return false;
+    }
+    std::string datatype = tokens[itr.getVal()].value;
+    std::transform(datatype.begin(), datatype.end(), datatype.begin(), ::toupper);
+    itr += 1;
+
+    // Declared size, kept in the type text as Column::datatype expects it
+    if (itr.getVal() < tokens.size() && isToken(tokens[itr.getVal()], TokenType::PUNCTUATION, "(")) {
+        if (itr.getVal() + 2 >= tokens.size() ||
+            tokens[itr.getVal() + 1].type != TokenType::NUMBER ||
+            !isToken(tokens[itr.getVal() + 2], TokenType::PUNCTUATION, ")")) {
+            PARSE_ERROR(ParseError::EXPECTED_VALUE, "Expected (length) after " << datatype);
+            return false;
+        }
+        datatype += "(" + tokens[itr.getVal() + 1].value + ")";
+        itr += 3;
+    }
+    TRACE_DEBUG("Column: " << columnNode->value << " " << datatype);
+    columnNode->addChild(makeNode("DATATYPE", datatype));
+
+    while (itr.getVal() < tokens.size()) {
+        const Token& currentToken = tokens[itr.getVal()];
+        if (currentToken.type == TokenType::CONSTRAINT) {
+            if (currentToken.value != "PRIMARY KEY" && currentToken.value != "UNIQUE" && currentToken.value != "NOT NULL") {
+                PARSE_ERROR(ParseError::UNSUPPORTED_STATEMENT, currentToken.value << " is not supported on a column");
+                return false;
+            }
+            columnNode->addChild(makeNode("CONSTRAINT", currentToken.value));
+            itr += 1;
+        } else if (isToken(currentToken, TokenType::KEYWORD, "REFERENCES")) {
+            if (!parseReferences(tokens, columnNode)) return false;
+        } else {
+            break;
+        }
+    }
+    return true;
+}
+
+// PRIMARY KEY (column) | UNIQUE (column) | FOREIGN KEY (column) REFERENCES table(column)
+bool parser::parseTableConstraint(const std::vector<Token>& tokens, astNode* parentNode) {
+    const std::string& kind = tokens[itr.getVal()].value;
+    if (kind != "PRIMARY KEY" && kind != "UNIQUE" && kind != "FOREIGN KEY") {
+        PARSE_ERROR(ParseError::UNSUPPORTED_STATEMENT, kind << " is not supported on a table");
+        return false;
+    }
+    itr += 1;
+
+    if (itr.getVal() + 2 >= tokens.size() ||
+        !isToken(tokens[itr.getVal()], TokenType::PUNCTUATION, "(") ||
+        tokens[itr.getVal() + 1].type != TokenType::IDENTIFIER ||
+        !isToken(tokens[itr.getVal() + 2], TokenType::PUNCTUATION, ")")) {
+        PARSE_ERROR(ParseError::EXPECTED_IDENTIFIER, "Expected (column) after " << kind);
+        return false;
+    }
+    astNode* constraintNode = makeNode(kind == "FOREIGN KEY" ? "FOREIGN_KEY" : "TABLE_CONSTRAINT", tokens[itr.getVal() + 1].value);
+    parentNode->addChild(constraintNode);
+    itr += 3;
+
+    if (kind != "FOREIGN KEY") {
+        constraintNode->addChild(makeNode("CONSTRAINT", kind));
+        return true;
+    }
+    if (itr.getVal() >= tokens.size() || !isToken(tokens[itr.getVal()], TokenType::KEYWORD, "REFERENCES")) {
+        PARSE_ERROR(ParseError::EXPECTED_KEYWORD, "Expected REFERENCES after FOREIGN KEY");
+        return false;
+    }
+    return parseReferences(tokens, constraintNode);
+}
+
+// REFERENCES table(column), as a REFERENCES node valued "table.column"
+bool parser::parseReferences(const std::vector<Token>& tokens, astNode* parentNode) {
+    itr += 1; // Skip REFERENCES
+    if (itr.getVal() + 3 >= tokens.size() ||
+        tokens[itr.getVal()].type != TokenType::IDENTIFIER ||
+        !isToken(tokens[itr.getVal() + 1], TokenType::PUNCTUATION, "(") ||
+        tokens[itr.getVal() + 2].type != TokenType::IDENTIFIER ||
+        !isToken(tokens[itr.getVal() + 3], TokenType::PUNCTUATION, ")")) {
+        PARSE_ERROR(ParseError::EXPECTED_IDENTIFIER, "Expected table(column) after REFERENCES");
+        return false;
+    }
+    parentNode->addChild(makeQualifiedNode("REFERENCES", tokens[itr.getVal()].value, tokens[itr.getVal() + 2].value));
+    itr += 4;
+    return true;
+}
 
 // ---------------- Condition Parsing ----------------
 bool parser::parseCondition(const std::vector<Token>& tokens, astNode* parentNode) {
-    std::cout << "Parsing condition..." << std::endl;
-    astNode* conditionNode = new astNode("CONDITION", "");
+    TRACE_DEBUG("Parsing condition...");
+    astNode* conditionNode = makeNode("CONDITION", "");
     parentNode->addChild(conditionNode);
     
     return parseLogicalExpression(tokens, conditionNode);
@@ -510,8 +961,8 @@ bool parser::parseLogicalExpression(const std::vector<Token>& tokens, astNode* p
         
         if (currentToken.type == TokenType::KEYWORD && 
             (currentToken.value == "OR" || currentToken.value == "||")) {
-            std::cout << "Logical OR operator found" << std::endl;
-            astNode* orNode = new astNode("LOGICAL_OP", "OR");
+            TRACE_DEBUG("Logical OR operator found");
+            astNode* orNode = makeNode("LOGICAL_OP", "OR");
             parentNode->addChild(orNode);
             itr += 1;
             
@@ -537,8 +988,8 @@ bool parser::parseLogicalTerm(const std::vector<Token>& tokens, astNode* parentN
         
         if (currentToken.type == TokenType::KEYWORD && 
             (currentToken.value == "AND" || currentToken.value == "&&")) {
-            std::cout << "Logical AND operator found" << std::endl;
-            astNode* andNode = new astNode("LOGICAL_OP", "AND");
+            TRACE_DEBUG("Logical AND operator found");
+            astNode* andNode = makeNode("LOGICAL_OP", "AND");
             parentNode->addChild(andNode);
             itr += 1;
             
@@ -563,8 +1014,8 @@ bool parser::parseLogicalFactor(const std::vector<Token>& tokens, astNode* paren
     
     // Handle NOT operator
     if (currentToken.type == TokenType::KEYWORD && currentToken.value == "NOT") {
-        std::cout << "NOT operator found" << std::endl;
-        astNode* notNode = new astNode("LOGICAL_OP", "NOT");
+        TRACE_DEBUG("NOT operator found");
+        astNode* notNode = makeNode("LOGICAL_OP", "NOT");
         parentNode->addChild(notNode);
         itr += 1;
         
@@ -573,10 +1024,10 @@ bool parser::parseLogicalFactor(const std::vector<Token>& tokens, astNode* paren
     
     // Handle parentheses
     if (currentToken.type == TokenType::PUNCTUATION && currentToken.value == "(") {
-        std::cout << "Opening parenthesis found in condition" << std::endl;
+        TRACE_DEBUG("Opening parenthesis found in condition");
         itr += 1;
         
-        astNode* groupNode = new astNode("GROUP", "");
+        astNode* groupNode = makeNode("GROUP", "");
         parentNode->addChild(groupNode);
         
         if (!parseLogicalExpression(tokens, groupNode)) {
@@ -586,11 +1037,11 @@ bool parser::parseLogicalFactor(const std::vector<Token>& tokens, astNode* paren
         if (itr.getVal() >= tokens.size() || 
             tokens[itr.getVal()].type != TokenType::PUNCTUATION || 
             tokens[itr.getVal()].value != ")") {
-            std::cout << "Error: Expected closing parenthesis" << std::endl;
+            PARSE_ERROR(ParseError::EXPECTED_PUNCTUATION, "Expected closing parenthesis");
             return false;
         }
         
-        std::cout << "Closing parenthesis found" << std::endl;
+        TRACE_DEBUG("Closing parenthesis found");
         itr += 1;
         return true;
     }
@@ -601,12 +1052,12 @@ bool parser::parseLogicalFactor(const std::vector<Token>& tokens, astNode* paren
 
 // Parse comparison expressions (=, <, >, <=, >=, <>, !=, LIKE, IN, BETWEEN, IS, EXISTS)
 bool parser::parseComparisonExpression(const std::vector<Token>& tokens, astNode* parentNode) {
-    astNode* comparisonNode = new astNode("COMPARISON", "");
+    astNode* comparisonNode = makeNode("COMPARISON", "");
     parentNode->addChild(comparisonNode);
     
     // Parse left operand
     if (!parseValue(tokens, comparisonNode)) {
-        std::cout << "Error: Expected value or column in comparison" << std::endl;
+        PARSE_ERROR(ParseError::EXPECTED_VALUE, "Expected value or column in comparison");
         return false;
     }
     
@@ -639,15 +1090,15 @@ bool parser::parseComparisonExpression(const std::vector<Token>& tokens, astNode
 // Parse simple comparison operators (=, <, >, <=, >=, <>, !=)
 bool parser::parseSimpleComparison(const std::vector<Token>& tokens, astNode* parentNode) {
     const Token& operatorToken = tokens[itr.getVal()];
-    std::cout << "Comparison operator: " << operatorToken.value << std::endl;
+    TRACE_DEBUG("Comparison operator: " << operatorToken.value);
     
-    astNode* operatorNode = new astNode("OPERATOR", operatorToken.value);
+    astNode* operatorNode = makeNode("OPERATOR", operatorToken.value);
     parentNode->addChild(operatorNode);
     itr += 1;
     
     // Parse right operand
     if (!parseValue(tokens, parentNode)) {
-        std::cout << "Error: Expected value after comparison operator" << std::endl;
+        PARSE_ERROR(ParseError::EXPECTED_VALUE, "Expected value after comparison operator");
         return false;
     }
     
@@ -656,13 +1107,13 @@ bool parser::parseSimpleComparison(const std::vector<Token>& tokens, astNode* pa
 
 // Parse LIKE expression
 bool parser::parseLikeExpression(const std::vector<Token>& tokens, astNode* parentNode) {
-    std::cout << "LIKE operator found" << std::endl;
-    astNode* likeNode = new astNode("LIKE", "");
+    TRACE_DEBUG("LIKE operator found");
+    astNode* likeNode = makeNode("LIKE", "");
     parentNode->addChild(likeNode);
     itr += 1;
     
     if (!parseValue(tokens, likeNode)) {
-        std::cout << "Error: Expected pattern after LIKE" << std::endl;
+        PARSE_ERROR(ParseError::EXPECTED_VALUE, "Expected pattern after LIKE");
         return false;
     }
     
@@ -671,13 +1122,13 @@ bool parser::parseLikeExpression(const std::vector<Token>& tokens, astNode* pare
 
 // Parse IN expression
 bool parser::parseInExpression(const std::vector<Token>& tokens, astNode* parentNode) {
-    std::cout << "IN operator found" << std::endl;
-    astNode* inNode = new astNode("IN", "");
+    TRACE_DEBUG("IN operator found");
+    astNode* inNode = makeNode("IN", "");
     parentNode->addChild(inNode);
     itr += 1;
     
     if (itr.getVal() >= tokens.size()) {
-        std::cout << "Error: Expected value list or subquery after IN" << std::endl;
+        PARSE_ERROR(ParseError::EXPECTED_VALUE, "Expected value list or subquery after IN");
         return false;
     }
     
@@ -690,17 +1141,17 @@ bool parser::parseInExpression(const std::vector<Token>& tokens, astNode* parent
         if (itr.getVal() < tokens.size() && 
             tokens[itr.getVal()].type == TokenType::KEYWORD && 
             tokens[itr.getVal()].value == "SELECT") {
-            std::cout << "Subquery in IN clause detected" << std::endl;
+            TRACE_DEBUG("Subquery in IN clause detected");
             return handleSubquery(tokens, inNode);
         } else {
             // Parse value list
-            std::cout << "Value list in IN clause" << std::endl;
-            astNode* valueListNode = new astNode("VALUE_LIST", "");
+            TRACE_DEBUG("Value list in IN clause");
+            astNode* valueListNode = makeNode("VALUE_LIST", "");
             inNode->addChild(valueListNode);
             
             do {
                 if (!parseValue(tokens, valueListNode)) {
-                    std::cout << "Error: Expected value in IN list" << std::endl;
+                    PARSE_ERROR(ParseError::EXPECTED_VALUE, "Expected value in IN list");
                     return false;
                 }
                 
@@ -716,7 +1167,7 @@ bool parser::parseInExpression(const std::vector<Token>& tokens, astNode* parent
             if (itr.getVal() >= tokens.size() || 
                 tokens[itr.getVal()].type != TokenType::PUNCTUATION || 
                 tokens[itr.getVal()].value != ")") {
-                std::cout << "Error: Expected closing parenthesis in IN clause" << std::endl;
+                PARSE_ERROR(ParseError::EXPECTED_PUNCTUATION, "Expected closing parenthesis in IN clause");
                 return false;
             }
             itr += 1;
@@ -728,14 +1179,14 @@ bool parser::parseInExpression(const std::vector<Token>& tokens, astNode* parent
 
 // Parse BETWEEN expression
 bool parser::parseBetweenExpression(const std::vector<Token>& tokens, astNode* parentNode) {
-    std::cout << "BETWEEN operator found" << std::endl;
-    astNode* betweenNode = new astNode("BETWEEN", "");
+    TRACE_DEBUG("BETWEEN operator found");
+    astNode* betweenNode = makeNode("BETWEEN", "");
     parentNode->addChild(betweenNode);
     itr += 1;
     
     // Parse first value
     if (!parseValue(tokens, betweenNode)) {
-        std::cout << "Error: Expected first value after BETWEEN" << std::endl;
+        PARSE_ERROR(ParseError::EXPECTED_VALUE, "Expected first value after BETWEEN");
         return false;
     }
     
@@ -743,14 +1194,14 @@ bool parser::parseBetweenExpression(const std::vector<Token>& tokens, astNode* p
     if (itr.getVal() >= tokens.size() || 
         tokens[itr.getVal()].type != TokenType::KEYWORD || 
         tokens[itr.getVal()].value != "AND") {
-        std::cout << "Error: Expected AND after first value in BETWEEN" << std::endl;
+        PARSE_ERROR(ParseError::EXPECTED_KEYWORD, "Expected AND after first value in BETWEEN");
         return false;
     }
     itr += 1;
     
     // Parse second value
     if (!parseValue(tokens, betweenNode)) {
-        std::cout << "Error: Expected second value after AND in BETWEEN" << std::endl;
+        PARSE_ERROR(ParseError::EXPECTED_VALUE, "Expected second value after AND in BETWEEN");
         return false;
     }
     
@@ -759,13 +1210,13 @@ bool parser::parseBetweenExpression(const std::vector<Token>& tokens, astNode* p
 
 // Parse IS expression (IS NULL, IS NOT NULL)
 bool parser::parseIsExpression(const std::vector<Token>& tokens, astNode* parentNode) {
-    std::cout << "IS operator found" << std::endl;
-    astNode* isNode = new astNode("IS", "");
+    TRACE_DEBUG("IS operator found");
+    astNode* isNode = makeNode("IS", "");
     parentNode->addChild(isNode);
     itr += 1;
     
     if (itr.getVal() >= tokens.size()) {
-        std::cout << "Error: Expected value after IS" << std::endl;
+        PARSE_ERROR(ParseError::EXPECTED_VALUE, "Expected value after IS");
         return false;
     }
     
@@ -773,18 +1224,18 @@ bool parser::parseIsExpression(const std::vector<Token>& tokens, astNode* parent
     
     // Handle IS NOT
     if (nextToken.type == TokenType::KEYWORD && nextToken.value == "NOT") {
-        std::cout << "IS NOT found" << std::endl;
-        astNode* notNode = new astNode("NOT", "");
+        TRACE_DEBUG("IS NOT found");
+        astNode* notNode = makeNode("NOT", "");
         isNode->addChild(notNode);
         itr += 1;
         
         if (!parseValue(tokens, notNode)) {
-            std::cout << "Error: Expected value after IS NOT" << std::endl;
+            PARSE_ERROR(ParseError::EXPECTED_VALUE, "Expected value after IS NOT");
             return false;
         }
     } else {
         if (!parseValue(tokens, isNode)) {
-            std::cout << "Error: Expected value after IS" << std::endl;
+            PARSE_ERROR(ParseError::EXPECTED_VALUE, "Expected value after IS");
             return false;
         }
     }
@@ -794,15 +1245,15 @@ bool parser::parseIsExpression(const std::vector<Token>& tokens, astNode* parent
 
 // Parse EXISTS expression
 bool parser::parseExistsExpression(const std::vector<Token>& tokens, astNode* parentNode) {
-    std::cout << "EXISTS operator found" << std::endl;
-    astNode* existsNode = new astNode("EXISTS", "");
+    TRACE_DEBUG("EXISTS operator found");
+    astNode* existsNode = makeNode("EXISTS", "");
     parentNode->addChild(existsNode);
     itr += 1;
     
     if (itr.getVal() >= tokens.size() || 
         tokens[itr.getVal()].type != TokenType::PUNCTUATION || 
         tokens[itr.getVal()].value != "(") {
-        std::cout << "Error: Expected opening parenthesis after EXISTS" << std::endl;
+        PARSE_ERROR(ParseError::EXPECTED_PUNCTUATION, "Expected opening parenthesis after EXISTS");
         return false;
     }
     itr += 1;
@@ -811,7 +1262,7 @@ bool parser::parseExistsExpression(const std::vector<Token>& tokens, astNode* pa
     if (itr.getVal() >= tokens.size() || 
         tokens[itr.getVal()].type != TokenType::KEYWORD || 
         tokens[itr.getVal()].value != "SELECT") {
-        std::cout << "Error: Expected SELECT after EXISTS(" << std::endl;
+        PARSE_ERROR(ParseError::EXPECTED_KEYWORD, "Expected SELECT after EXISTS(");
         return false;
     }
     
@@ -828,8 +1279,8 @@ bool parser::parseValue(const std::vector<Token>& tokens, astNode* parentNode) {
     
     // Handle table.column format
     if (isTableColumn(tokens, itr.getVal())) {
-        std::cout << "Table column: " << tokens[itr.getVal()].value << "." << tokens[itr.getVal() + 2].value << std::endl;
-        astNode* columnNode = new astNode("COLUMN", tokens[itr.getVal()].value + "." + tokens[itr.getVal() + 2].value);
+        TRACE_DEBUG("Table column: " << tokens[itr.getVal()].value << "." << tokens[itr.getVal() + 2].value);
+        astNode* columnNode = makeQualifiedNode("COLUMN", tokens[itr.getVal()].value, tokens[itr.getVal() + 2].value);
         parentNode->addChild(columnNode);
         itr += 3;
         return true;
@@ -838,43 +1289,46 @@ bool parser::parseValue(const std::vector<Token>& tokens, astNode* parentNode) {
     // Handle different token types
     switch (currentToken.type) {
         case TokenType::IDENTIFIER:
-            std::cout << "Column: " << currentToken.value << std::endl;
-            parentNode->addChild(new astNode("COLUMN", currentToken.value));
+            TRACE_DEBUG("Column: " << currentToken.value);
+            parentNode->addChild(makeNode("COLUMN", currentToken.value));
             itr += 1;
             return true;
             
         case TokenType::NUMBER:
         case TokenType::DOUBLE:
-            std::cout << "Number: " << currentToken.value << std::endl;
-            parentNode->addChild(new astNode("NUMBER", currentToken.value));
+            TRACE_DEBUG("Number: " << currentToken.value);
+            parentNode->addChild(makeNode("NUMBER", currentToken.value));
             itr += 1;
             return true;
             
         case TokenType::STRING:
-            std::cout << "String: " << currentToken.value << std::endl;
-            parentNode->addChild(new astNode("STRING", currentToken.value));
+            TRACE_DEBUG("String: " << currentToken.value);
+            parentNode->addChild(makeNode("STRING", currentToken.value));
             itr += 1;
             return true;
             
         case TokenType::DATE:
-            std::cout << "Date: " << currentToken.value << std::endl;
-            parentNode->addChild(new astNode("DATE", currentToken.value));
+            TRACE_DEBUG("Date: " << currentToken.value);
+            parentNode->addChild(makeNode("DATE", currentToken.value));
             itr += 1;
             return true;
             
+        case TokenType::PARAMETER:
+            return parseParameter(tokens, parentNode);
+            
         case TokenType::KEYWORD:
             if (currentToken.value == "NULL") {
-                std::cout << "NULL value" << std::endl;
-                parentNode->addChild(new astNode("NULL", "NULL"));
+                TRACE_DEBUG("NULL value");
+                parentNode->addChild(makeNode("NULL", "NULL"));
                 itr += 1;
                 return true;
             } else if (currentToken.value == "TRUE" || currentToken.value == "FALSE") {
-                std::cout << "Boolean: " << currentToken.value << std::endl;
-                parentNode->addChild(new astNode("BOOLEAN", currentToken.value));
+                TRACE_DEBUG("Boolean: " << currentToken.value);
+                parentNode->addChild(makeNode("BOOLEAN", currentToken.value));
                 itr += 1;
                 return true;
             } else if (currentToken.value == "SELECT") {
-                std::cout << "Subquery detected" << std::endl;
+                TRACE_DEBUG("Subquery detected");
                 return handleSubquery(tokens, parentNode);
             }
             break;
@@ -886,11 +1340,11 @@ bool parser::parseValue(const std::vector<Token>& tokens, astNode* parentNode) {
                 if (itr.getVal() < tokens.size() && 
                     tokens[itr.getVal()].type == TokenType::KEYWORD && 
                     tokens[itr.getVal()].value == "SELECT") {
-                    std::cout << "Subquery in parentheses" << std::endl;
+                    TRACE_DEBUG("Subquery in parentheses");
                     return handleSubquery(tokens, parentNode);
                 } else {
                     // Parenthesized expression
-                    astNode* groupNode = new astNode("GROUP", "");
+                    astNode* groupNode = makeNode("GROUP", "");
                     parentNode->addChild(groupNode);
                     
                     if (!parseLogicalExpression(tokens, groupNode)) {
@@ -900,7 +1354,7 @@ bool parser::parseValue(const std::vector<Token>& tokens, astNode* parentNode) {
                     if (itr.getVal() >= tokens.size() || 
                         tokens[itr.getVal()].type != TokenType::PUNCTUATION || 
                         tokens[itr.getVal()].value != ")") {
-                        std::cout << "Error: Expected closing parenthesis" << std::endl;
+                        PARSE_ERROR(ParseError::EXPECTED_PUNCTUATION, "Expected closing parenthesis");
                         return false;
                     }
                     itr += 1;
@@ -913,24 +1367,70 @@ bool parser::parseValue(const std::vector<Token>& tokens, astNode* parentNode) {
             break;
     }
     
-    std::cout << "Error: Unexpected token in value: " << currentToken.value << std::endl;
+    PARSE_ERROR(ParseError::UNEXPECTED_TOKEN, "Unexpected token in value: " << currentToken.value);
     return false;
 }
 
+// Parse a bind placeholder into a PARAMETER node whose value is always "$n"
+bool parser::parseParameter(const std::vector<Token>& tokens, astNode* parentNode) {
+    const Token& currentToken = tokens[itr.getVal()];
+    size_t index = 0;
+    
+    if (currentToken.value == "?") {
+        if (numberedParameters) {
+            PARSE_ERROR(ParseError::MIXED_PARAMETERS, "Cannot mix ? and $n parameters");
+            return false;
+        }
+        positionalParameters = true;
+        index = parameterCount + 1;
+    } else {
+        if (positionalParameters) {
+            PARSE_ERROR(ParseError::MIXED_PARAMETERS, "Cannot mix ? and $n parameters");
+            return false;
+        }
+        numberedParameters = true;
+        const char* digits = currentToken.value.c_str() + 1;
+        char* end = nullptr;
+        errno = 0;
+        index = std::strtoull(digits, &end, 10);
+        if (errno != 0 || end == digits || *end != '\0' || index == 0) index = MAX_PARAMETERS + 1;
+    }
+    if (index > MAX_PARAMETERS) {
+        PARSE_ERROR(ParseError::INVALID_PARAMETER, "Parameter number must be 1 to " << MAX_PARAMETERS);
+        return false;
+    }
+    
+    parameterCount = std::max(parameterCount, index);
+    TRACE_DEBUG("Parameter: $" << index);
+    parentNode->addChild(makeNode("PARAMETER", "$" + std::to_string(index)));
+    itr += 1;
+    return true;
+}
+
 bool parser::parse(const std::vector<Token>& tokens, astNode* parentNode) {
-    std::cout << "Starting parsing process..." << std::endl;
-
-    // Define the function map
-    std::unordered_map<std::string, std::function<bool(const std::vector<Token>& tokens, astNode* parentNode)>> functionMap = {
-        {"SELECT", std::bind(&parser::parseSelect, this, std::placeholders::_1, std::placeholders::_2)},
-        {"INSERT", std::bind(&parser::parseInsert, this, std::placeholders::_1, std::placeholders::_2)},
-        {"UPDATE", std::bind(&parser::parseUpdate, this, std::placeholders::_1, std::placeholders::_2)},
-        {"DELETE", std::bind(&parser::parseDelete, this, std::placeholders::_1, std::placeholders::_2)},
-        {"CREATE", std::bind(&parser::parseCreate, this, std::placeholders::_1, std::placeholders::_2)}
+    TRACE_INFO("Starting parsing process...");
+    
+    parameterCount = 0;
+    positionalParameters = false;
+    numberedParameters = false;
+    firstError = ParseError::NONE;
+    firstErrorMessage.clear();
+    firstErrorToken = 0;
+
+    // Statement dispatch table, built once rather than per statement
+    using statementParser = bool (parser::*)(const std::vector<Token>& tokens, astNode* parentNode);
+    static const std::unordered_map<std::string, std::pair<statementParser, StatementKind>> functionMap = {
+        {"SELECT", {&parser::parseSelect, StatementKind::SELECT}},
+        {"INSERT", {&parser::parseInsert, StatementKind::INSERT}},
+        {"UPDATE", {&parser::parseUpdate, StatementKind::UPDATE}},
+        {"DELETE", {&parser::parseDelete, StatementKind::DELETE}},
+        {"CREATE", {&parser::parseCreate, StatementKind::CREATE}}
     };
 
     if (tokens.empty()) {
-        std::cout << "No tokens to parse." << std::endl;
+        PARSE_ERROR(ParseError::EMPTY_INPUT, "No tokens to parse.");
+        parserStats::countError(firstError);
+        parserStats::countStatement(StatementKind::OTHER, false);
         return false;
     }
 
@@ -938,12 +1438,19 @@ bool parser::parse(const std::vector<Token>& tokens, astNode* parentNode) {
     std::string firstTokenValueUpper = firstToken.value;
     std::transform(firstTokenValueUpper.begin(), firstTokenValueUpper.end(), firstTokenValueUpper.begin(), ::toupper);
     auto it = functionMap.find(firstTokenValueUpper);
+    
+    bool ok = false;
+    StatementKind kind = StatementKind::OTHER;
     if (it != functionMap.end()) {
-        std::cout << "Identified command: " << firstTokenValueUpper << std::endl;
-        return it->second(tokens, parentNode);
+        TRACE_INFO("Identified command: " << firstTokenValueUpper);
+        kind = it->second.second;
+        ok = (this->*(it->second.first))(tokens, parentNode);
     } else {
-        std::cout << "Error: Unrecognized command '" << firstToken.value << "'" << std::endl;
-        return false;
+        PARSE_ERROR(ParseError::UNSUPPORTED_STATEMENT, "Unrecognized command '" << firstToken.value << "'");
     }
-    std::cout << "Parsing completed." << std::endl;
-}
\ No newline at end of file
+    
+    if (!ok) parserStats::countError(firstError);
+    parserStats::countStatement(kind, ok);
+    TRACE_INFO("Parsing completed.");
+    return ok;
+}
@@ -0,0 +1,184 @@
+#include <iomanip>
+#include <mutex>
+#include <vector>
+#include "../../include/parser/parserStats.hpp"
+
+const char* statementKindToString(StatementKind kind) {
+    switch (kind) {
+        case StatementKind::SELECT: return "SELECT";
+        case StatementKind::INSERT: return "INSERT";
+        case StatementKind::UPDATE: return "UPDATE";
+        case StatementKind::DELETE: return "DELETE";
+        case StatementKind::CREATE: return "CREATE";
+        case StatementKind::OTHER:  return "OTHER";
+        default:                    return "invalid";
+    }
+}
+
+const char* parseErrorToString(ParseError error) {
+    switch (error) {
+        case ParseError::NONE:                  return "none";
+        case ParseError::EMPTY_INPUT:           return "empty_input";
+        case ParseError::UNSUPPORTED_STATEMENT: return "unsupported_statement";
+        case ParseError::EXPECTED_KEYWORD:      return "expected_keyword";
+        case ParseError::EXPECTED_IDENTIFIER:   return "expected_identifier";
+        case ParseError::EXPECTED_VALUE:        return "expected_value";
+        case ParseError::EXPECTED_PUNCTUATION:  return "expected_punctuation";
+        case ParseError::UNEXPECTED_TOKEN:      return "unexpected_token";
+        case ParseError::MIXED_PARAMETERS:      return "mixed_parameters";
+        case ParseError::INVALID_PARAMETER:     return "invalid_parameter";
+        default:                                return "invalid";
+    }
+}
+
+const char* parseClauseToString(ParseClause clause) {
+    switch (clause) {
+        case ParseClause::SELECT_LIST: return "select_list";
+        case ParseClause::FROM:        return "from";
+        case ParseClause::JOIN:        return "join";
+        case ParseClause::WHERE:       return "where";
+        case ParseClause::GROUP_BY:    return "group_by";
+        case ParseClause::HAVING:      return "having";
+        case ParseClause::ORDER_BY:    return "order_by";
+        case ParseClause::LIMIT:       return "limit";
+        case ParseClause::SUBQUERY:    return "subquery";
+        default:                       return "invalid";
+    }
+}
+
+std::atomic<bool> parserStats::timing{false};
+
+namespace {
+
+constexpr size_t STATEMENT_KINDS = static_cast<size_t>(StatementKind::COUNT);
+constexpr size_t ERROR_KINDS = static_cast<size_t>(ParseError::COUNT);
+constexpr size_t CLAUSES = static_cast<size_t>(ParseClause::COUNT);
+
+// Flat counter layout shared by thread slots and the retired totals
+constexpr size_t STATEMENTS_AT = 0;
+constexpr size_t FAILED_AT = STATEMENTS_AT + STATEMENT_KINDS;
+constexpr size_t ERRORS_AT = FAILED_AT + STATEMENT_KINDS;
+constexpr size_t CLAUSE_CALLS_AT = ERRORS_AT + ERROR_KINDS;
+constexpr size_t CLAUSE_NANOS_AT = CLAUSE_CALLS_AT + CLAUSES;
+constexpr size_t COUNTER_COUNT = CLAUSE_NANOS_AT + CLAUSES;
+
+struct threadSlot;
+
+// Live slots, plus totals folded in from threads that have exited
+struct slotRegistry {
+    std::mutex mtx;
+    std::vector<threadSlot*> slots;
+    uint64_t retired[COUNTER_COUNT] = {};
+};
+
+slotRegistry& registry() {
+    static slotRegistry* instance = new slotRegistry(); // never destroyed: threads may exit late
+    return *instance;
+}
+
+struct threadSlot {
+    std::atomic<uint64_t> values[COUNTER_COUNT];
+
+    threadSlot() {
+        for (auto& value : values) value.store(0, std::memory_order_relaxed);
+        slotRegistry& reg = registry();
+        std::lock_guard<std::mutex> lock(reg.mtx);
+        reg.slots.push_back(this);
+    }
+
+    ~threadSlot() {
+        slotRegistry& reg = registry();
+        std::lock_guard<std::mutex> lock(reg.mtx);
+        for (size_t i = 0; i < COUNTER_COUNT; i++) {
+            reg.retired[i] += values[i].load(std::memory_order_relaxed);
+        }
+        for (size_t i = 0; i < reg.slots.size(); i++) {
+            if (reg.slots[i] == this) {
+                reg.slots[i] = reg.slots.back();
+                reg.slots.pop_back();
+                break;
+            }
+        }
+    }
+
+    // Only the owning thread writes, so load + store cannot lose updates
+    void add(size_t index, uint64_t amount) {
+        values[index].store(values[index].load(std::memory_order_relaxed) + amount, std::memory_order_relaxed);
+    }
+};
+
+threadSlot& localSlot() {
+    static thread_local threadSlot slot;
+    return slot;
+}
+
+} // namespace
+
+void parserStats::countStatement(StatementKind kind, bool ok) {
+    threadSlot& slot = localSlot();
+    slot.add(STATEMENTS_AT + static_cast<size_t>(kind), 1);
+    if (!ok) slot.add(FAILED_AT + static_cast<size_t>(kind), 1);
+}
+
+void parserStats::countError(ParseError error) {
+    localSlot().add(ERRORS_AT + static_cast<size_t>(error), 1);
+}
+
+void parserStats::addClauseTime(ParseClause clause, uint64_t nanos) {
+    threadSlot& slot = localSlot();
+    slot.add(CLAUSE_CALLS_AT + static_cast<size_t>(clause), 1);
+    slot.add(CLAUSE_NANOS_AT + static_cast<size_t>(clause), nanos);
+}
+
+parserCounters parserStats::snapshot() {
+    uint64_t totals[COUNTER_COUNT];
+    slotRegistry& reg = registry();
+    {
+        std::lock_guard<std::mutex> lock(reg.mtx);
+        for (size_t i = 0; i < COUNTER_COUNT; i++) totals[i] = reg.retired[i];
+        for (const threadSlot* slot : reg.slots) {
+            for (size_t i = 0; i < COUNTER_COUNT; i++) {
+                totals[i] += slot->values[i].load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+    parserCounters counters;
+    for (size_t i = 0; i < STATEMENT_KINDS; i++) {
+        counters.statements[i] = totals[STATEMENTS_AT + i];
+        counters.failedStatements[i] = totals[FAILED_AT + i];
+    }
+    for (size_t i = 0; i < ERROR_KINDS; i++) counters.errors[i] = totals[ERRORS_AT + i];
+    for (size_t i = 0; i < CLAUSES; i++) {
+        counters.clauseCalls[i] = totals[CLAUSE_CALLS_AT + i];
+        counters.clauseNanos[i] = totals[CLAUSE_NANOS_AT + i];
+    }
+    return counters;
+}
+
+void parserStats::dump(std::ostream& out) {
+    parserCounters counters = snapshot();
+
+    out << "Statements parsed (failed):" << std::endl;
+    for (size_t i = 0; i < STATEMENT_KINDS; i++) {
+        if (counters.statements[i] == 0) continue;
+        out << "  " << std::left << std::setw(22) << statementKindToString(static_cast<StatementKind>(i))
+            << std::right << std::setw(10) << counters.statements[i]
+            << " (" << counters.failedStatements[i] << ")" << std::endl;
+    }
+
+    out << "Parse errors:" << std::endl;
+    for (size_t i = 1; i < ERROR_KINDS; i++) {
+        if (counters.errors[i] == 0) continue;
+        out << "  " << std::left << std::setw(22) << parseErrorToString(static_cast<ParseError>(i))
+            << std::right << std::setw(10) << counters.errors[i] << std::endl;
+    }
+
+    out << "Clause time (calls, total ns):" << std::endl;
+    for (size_t i = 0; i < CLAUSES; i++) {
+        if (counters.clauseCalls[i] == 0) continue;
+        out << "  " << std::left << std::setw(22) << parseClauseToString(static_cast<ParseClause>(i))
+            << std::right << std::setw(10) << counters.clauseCalls[i]
+            << std::setw(16) << counters.clauseNanos[i] << std::endl;
+    }
+}
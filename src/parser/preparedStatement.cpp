@@ -0,0 +1,81 @@
+#include <iostream>
+#include "../../include/parser/preparedStatement.hpp"
+#include "../../include/common/trace.hpp"
+
+preparedStatement::preparedStatement(std::string sqlText, compactAst parsedTree, size_t parameterCount)
+    : text(std::move(sqlText)), ast(std::move(parsedTree)), parameters(parameterCount) {
+    for (uint32_t i = 0; i < ast.nodes.size(); i++) {
+        if (ast.nodes[i].kind == NodeKind::PARAMETER) placeholders.push_back(i);
+    }
+}
+
+preparedStatementCache::preparedStatementCache(size_t capacity)
+    : maxEntries(capacity ? capacity : 1) {
+    index.reserve(maxEntries);
+}
+
+// Lex and parse once into the session arena, keep only the compact tree
+std::shared_ptr<const preparedStatement> preparedStatementCache::parseStatement(std::string_view sql) {
+    std::vector<Token> tokens = lex.tokenize(sql);
+
+    pars.nodeArena = &parseArena;
+    pars.itr = Iterator();
+    astNode* root = astNode::create("ROOT", "ROOT", &parseArena);
+    bool ok = pars.parse(tokens, root);
+
+    std::shared_ptr<const preparedStatement> statement;
+    if (ok) {
+        statement = std::make_shared<const preparedStatement>(std::string(sql), compactAst::fromTree(root), pars.parameterCount);
+    } else {
+        std::cerr << "Error: " << pars.error() << " (token " << pars.firstErrorToken << ")." << std::endl;
+    }
+    parseArena.reset();
+    return statement;
+}
+
+std::shared_ptr<const preparedStatement> preparedStatementCache::prepare(std::string_view sql) {
+    auto it = index.find(sql);
+    if (it != index.end()) {
+        hitCount++;
+        entries.splice(entries.begin(), entries, it->second);
+        return *it->second;
+    }
+
+    missCount++;
+    std::shared_ptr<const preparedStatement> statement = parseStatement(sql);
+    if (!statement) return nullptr;
+
+    if (entries.size() >= maxEntries) {
+        index.erase(entries.back()->sql());
+        entries.pop_back();
+        evictionCount++;
+    }
+
+    entries.push_front(statement);
+    index.emplace(statement->sql(), entries.begin());
+    return statement;
+}
+
+bool preparedStatementCache::execute(const std::shared_ptr<const preparedStatement>& statement,
+                                     std::vector<Value> values, boundStatement& bound) {
+    if (!statement) return false;
+    if (values.size() != statement->parameterCount()) {
+        TRACE_ERROR("Error: Statement expects " << statement->parameterCount()
+                    << " parameters, got " << values.size());
+        return false;
+    }
+
+    bound.statement = statement;
+    bound.parameters = std::move(values);
+    bound.text = Value::internStrings(bound.parameters);
+    return true;
+}
+
+bool preparedStatementCache::execute(std::string_view sql, std::vector<Value> values, boundStatement& bound) {
+    return execute(prepare(sql), std::move(values), bound);
+}
+
+void preparedStatementCache::clear() {
+    index.clear();
+    entries.clear();
+}
@@ -0,0 +1,259 @@
+#include <cstdint>
+#include <cstring>
+#include "../../include/parser/simdScan.hpp"
+
+#if defined(__x86_64__) || defined(__i386__) || defined(_M_X64)
+#define MINISQL_SCAN_X86 1
+#include <immintrin.h>
+#endif
+
+// Token boundary bytes, grouped into contiguous ranges so the vector code can
+// test them with a handful of compares:
+//   0x09-0x0D  \t \n \v \f \r
+//   0x20-0x21  space !
+//   0x26-0x2F  & ' ( ) * + , - . /
+//   0x3B-0x3E  ; < = >
+//   0x7C       |
+constexpr bool isBoundaryByte(unsigned char c) {
+    return (c >= 0x09 && c <= 0x0D) || c == 0x20 || c == 0x21 ||
+           (c >= 0x26 && c <= 0x2F) || (c >= 0x3B && c <= 0x3E) || c == 0x7C;
+}
+
+struct BoundaryTable {
+    bool bytes[256] = {};
+    constexpr BoundaryTable() {
+        for (int c = 0; c < 256; c++) bytes[c] = isBoundaryByte(static_cast<unsigned char>(c));
+    }
+};
+
+constexpr BoundaryTable boundary_table;
+
+// ---------------- Scalar ----------------
+static size_t scalarTokenBoundary(const char* data, size_t len) {
+    for (size_t i = 0; i < len; i++) {
+        if (boundary_table.bytes[static_cast<unsigned char>(data[i])]) return i;
+    }
+    return len;
+}
+
+static size_t scalarQuote(const char* data, size_t len) {
+    const void* hit = std::memchr(data, '\'', len);
+    return hit ? static_cast<const char*>(hit) - data : len;
+}
+
+static size_t scalarQuoteOrSemicolon(const char* data, size_t len) {
+    for (size_t i = 0; i < len; i++) {
+        if (data[i] == '\'' || data[i] == ';') return i;
+    }
+    return len;
+}
+
+static NewlineInfo scalarNewlines(const char* data, size_t len) {
+    NewlineInfo info;
+    for (size_t i = 0; i < len; i++) {
+        if (data[i] == '\n') {
+            info.count++;
+            info.lastOffset = i;
+        }
+    }
+    return info;
+}
+
+#ifdef MINISQL_SCAN_X86
+
+// ---------------- SSE2 ----------------
+// Unsigned lo <= x <= hi using a biased signed compare
+static inline __m128i sse2InRange(__m128i x, unsigned char lo, unsigned char hi) {
+    __m128i shifted = _mm_add_epi8(x, _mm_set1_epi8(static_cast<char>(0x80 - lo)));
+    return _mm_cmplt_epi8(shifted, _mm_set1_epi8(static_cast<char>(0x80 + (hi - lo) + 1)));
+}
+
+static inline unsigned sse2BoundaryMask(__m128i x) {
+    __m128i m = sse2InRange(x, 0x09, 0x0D);
+    m = _mm_or_si128(m, sse2InRange(x, 0x20, 0x21));
+    m = _mm_or_si128(m, sse2InRange(x, 0x26, 0x2F));
+    m = _mm_or_si128(m, sse2InRange(x, 0x3B, 0x3E));
+    m = _mm_or_si128(m, _mm_cmpeq_epi8(x, _mm_set1_epi8(0x7C)));
+    return static_cast<unsigned>(_mm_movemask_epi8(m));
+}
+
+static size_t sse2TokenBoundary(const char* data, size_t len) {
+    size_t i = 0;
+    for (; i + 16 <= len; i += 16) {
+        unsigned mask = sse2BoundaryMask(_mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i)));
+        if (mask) return i + __builtin_ctz(mask);
+    }
+    return i + scalarTokenBoundary(data + i, len - i);
+}
+
+static size_t sse2Quote(const char* data, size_t len) {
+    const __m128i quote = _mm_set1_epi8('\'');
+    size_t i = 0;
+    for (; i + 16 <= len; i += 16) {
+        __m128i x = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i));
+        unsigned mask = static_cast<unsigned>(_mm_movemask_epi8(_mm_cmpeq_epi8(x, quote)));
+        if (mask) return i + __builtin_ctz(mask);
+    }
+    return i + scalarQuote(data + i, len - i);
+}
+
+static size_t sse2QuoteOrSemicolon(const char* data, size_t len) {
+    const __m128i quote = _mm_set1_epi8('\'');
+    const __m128i semicolon = _mm_set1_epi8(';');
+    size_t i = 0;
+    for (; i + 16 <= len; i += 16) {
+        __m128i x = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i));
+        __m128i m = _mm_or_si128(_mm_cmpeq_epi8(x, quote), _mm_cmpeq_epi8(x, semicolon));
+        unsigned mask = static_cast<unsigned>(_mm_movemask_epi8(m));
+        if (mask) return i + __builtin_ctz(mask);
+    }
+    return i + scalarQuoteOrSemicolon(data + i, len - i);
+}
+
+static NewlineInfo sse2Newlines(const char* data, size_t len) {
+    const __m128i newline = _mm_set1_epi8('\n');
+    NewlineInfo info;
+    size_t i = 0;
+    for (; i + 16 <= len; i += 16) {
+        __m128i x = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i));
+        unsigned mask = static_cast<unsigned>(_mm_movemask_epi8(_mm_cmpeq_epi8(x, newline)));
+        if (mask) {
+            info.count += __builtin_popcount(mask);
+            info.lastOffset = i + 31 - __builtin_clz(mask);
+        }
+    }
+    NewlineInfo tail = scalarNewlines(data + i, len - i);
+    if (tail.count) {
+        info.count += tail.count;
+        info.lastOffset = i + tail.lastOffset;
+    }
+    return info;
+}
+
+// ---------------- AVX2 ----------------
+__attribute__((target("avx2")))
+static inline __m256i avx2InRange(__m256i x, unsigned char lo, unsigned char hi) {
+    __m256i shifted = _mm256_add_epi8(x, _mm256_set1_epi8(static_cast<char>(0x80 - lo)));
+    return _mm256_cmpgt_epi8(_mm256_set1_epi8(static_cast<char>(0x80 + (hi - lo) + 1)), shifted);
+}
+
+__attribute__((target("avx2")))
+static size_t avx2TokenBoundary(const char* data, size_t len) {
+    size_t i = 0;
+    for (; i + 32 <= len; i += 32) {
+        __m256i x = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + i));
+        __m256i m = avx2InRange(x, 0x09, 0x0D);
+        m = _mm256_or_si256(m, avx2InRange(x, 0x20, 0x21));
+        m = _mm256_or_si256(m, avx2InRange(x, 0x26, 0x2F));
+        m = _mm256_or_si256(m, avx2InRange(x, 0x3B, 0x3E));
+        m = _mm256_or_si256(m, _mm256_cmpeq_epi8(x, _mm256_set1_epi8(0x7C)));
+        unsigned mask = static_cast<unsigned>(_mm256_movemask_epi8(m));
+        if (mask) return i + __builtin_ctz(mask);
+    }
+    return i + sse2TokenBoundary(data + i, len - i);
+}
+
+__attribute__((target("avx2")))
+static size_t avx2Quote(const char* data, size_t len) {
+    const __m256i quote = _mm256_set1_epi8('\'');
+    size_t i = 0;
+    for (; i + 32 <= len; i += 32) {
+        __m256i x = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + i));
+        unsigned mask = static_cast<unsigned>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(x, quote)));
+        if (mask) return i + __builtin_ctz(mask);
+    }
+    return i + sse2Quote(data + i, len - i);
+}
+
+__attribute__((target("avx2")))
+static size_t avx2QuoteOrSemicolon(const char* data, size_t len) {
+    const __m256i quote = _mm256_set1_epi8('\'');
+    const __m256i semicolon = _mm256_set1_epi8(';');
+    size_t i = 0;
+    for (; i + 32 <= len; i += 32) {
+        __m256i x = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + i));
+        __m256i m = _mm256_or_si256(_mm256_cmpeq_epi8(x, quote), _mm256_cmpeq_epi8(x, semicolon));
+        unsigned mask = static_cast<unsigned>(_mm256_movemask_epi8(m));
+        if (mask) return i + __builtin_ctz(mask);
+    }
+    return i + sse2QuoteOrSemicolon(data + i, len - i);
+}
+
+__attribute__((target("avx2")))
+static NewlineInfo avx2Newlines(const char* data, size_t len) {
+    const __m256i newline = _mm256_set1_epi8('\n');
+    NewlineInfo info;
+    size_t i = 0;
+    for (; i + 32 <= len; i += 32) {
+        __m256i x = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + i));
+        unsigned mask = static_cast<unsigned>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(x, newline)));
+        if (mask) {
+            info.count += __builtin_popcount(mask);
+            info.lastOffset = i + 31 - __builtin_clz(mask);
+        }
+    }
+    NewlineInfo tail = sse2Newlines(data + i, len - i);
+    if (tail.count) {
+        info.count += tail.count;
+        info.lastOffset = i + tail.lastOffset;
+    }
+    return info;
+}
+
+#endif // MINISQL_SCAN_X86
+
+// ---------------- Dispatch ----------------
+struct ScanDispatch {
+    ScanLevel level;
+    size_t (*tokenBoundary)(const char*, size_t);
+    size_t (*quote)(const char*, size_t);
+    size_t (*quoteOrSemicolon)(const char*, size_t);
+    NewlineInfo (*newlines)(const char*, size_t);
+};
+
+static ScanDispatch dispatchFor(ScanLevel level) {
+#ifdef MINISQL_SCAN_X86
+    if (level == ScanLevel::AVX2 && __builtin_cpu_supports("avx2")) {
+        return {ScanLevel::AVX2, avx2TokenBoundary, avx2Quote, avx2QuoteOrSemicolon, avx2Newlines};
+    }
+    if (level != ScanLevel::SCALAR) {
+        return {ScanLevel::SSE2, sse2TokenBoundary, sse2Quote, sse2QuoteOrSemicolon, sse2Newlines};
+    }
+#endif
+    return {ScanLevel::SCALAR, scalarTokenBoundary, scalarQuote, scalarQuoteOrSemicolon, scalarNewlines};
+}
+
+static ScanDispatch active_scan = dispatchFor(ScanLevel::AVX2);
+
+size_t scanTokenBoundary(const char* data, size_t len) {
+    return active_scan.tokenBoundary(data, len);
+}
+
+size_t scanQuote(const char* data, size_t len) {
+    return active_scan.quote(data, len);
+}
+
+size_t scanQuoteOrSemicolon(const char* data, size_t len) {
+    return active_scan.quoteOrSemicolon(data, len);
+}
+
+NewlineInfo scanNewlines(const char* data, size_t len) {
+    return active_scan.newlines(data, len);
+}
+
+ScanLevel activeScanLevel() {
+    return active_scan.level;
+}
+
+void forceScanLevel(ScanLevel level) {
+    active_scan = dispatchFor(level);
+}
+
+const char* scanLevelName(ScanLevel level) {
+    switch (level) {
+        case ScanLevel::AVX2:   return "avx2";
+        case ScanLevel::SSE2:   return "sse2";
+        case ScanLevel::SCALAR: return "scalar";
+        default:                return "invalid";
+    }
+}
@@ -0,0 +1,200 @@
+#include <algorithm>
+#include <cctype>
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include "../../include/parser/streamLexer.hpp"
+#include "../../include/parser/simdScan.hpp"
+
+// ---------------- statementSplitter ----------------
+size_t statementSplitter::findEnd(const char* data, size_t len) {
+    size_t i = 0;
+    while (i < len) {
+        if (insideLiteral) {
+            size_t quote = scanQuote(data + i, len - i);
+            if (quote == len - i) return npos;
+            insideLiteral = false;
+            i += quote + 1;
+            continue;
+        }
+
+        size_t hit = scanQuoteOrSemicolon(data + i, len - i);
+        if (hit == len - i) return npos;
+        i += hit;
+        if (data[i] == ';') return i + 1;
+        insideLiteral = true;
+        i++;
+    }
+    return npos;
+}
+
+// ---------------- fileSource ----------------
+fileSource::fileSource(int descriptor) : fd(descriptor), ownsFd(false) {}
+
+fileSource::fileSource(const std::string& path) : fd(::open(path.c_str(), O_RDONLY)), ownsFd(true) {
+#ifdef POSIX_FADV_SEQUENTIAL
+    if (fd >= 0) posix_fadvise(fd, 0, 0, POSIX_FADV_SEQUENTIAL);
+#endif
+}
+
+fileSource::~fileSource() {
+    if (ownsFd && fd >= 0) ::close(fd);
+}
+
+size_t fileSource::read(char* buffer, size_t capacity) {
+    if (fd < 0) return 0;
+    while (true) {
+        ssize_t n = ::read(fd, buffer, capacity);
+        if (n >= 0) return static_cast<size_t>(n);
+        if (errno != EINTR) return 0;
+    }
+}
+
+// ---------------- mappedFile ----------------
+mappedFile::mappedFile(const std::string& path) {
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) return;
+
+    struct stat st;
+    if (fstat(fd, &st) == 0) {
+        length = static_cast<size_t>(st.st_size);
+        if (length == 0) {
+            opened = true;
+        } else {
+            void* addr = mmap(nullptr, length, PROT_READ, MAP_PRIVATE, fd, 0);
+            if (addr != MAP_FAILED) {
+                base = static_cast<char*>(addr);
+                opened = true;
+                madvise(base, length, MADV_SEQUENTIAL);
+            }
+        }
+    }
+    ::close(fd);
+}
+
+mappedFile::~mappedFile() {
+    if (base) munmap(base, length);
+}
+
+void mappedFile::release(size_t offset) {
+    static const size_t pageSize = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+    const size_t releaseBatch = 4 << 20; // avoid a syscall per statement
+
+    size_t alignedEnd = std::min(offset, length) / pageSize * pageSize;
+    if (!base || alignedEnd < releasedUpTo + releaseBatch) return;
+    madvise(base + releasedUpTo, alignedEnd - releasedUpTo, MADV_DONTNEED);
+    releasedUpTo = alignedEnd;
+}
+
+// ---------------- streamLexer ----------------
+streamLexer::streamLexer(sqlSource& src, size_t chunkSize) : source(&src) {
+    buffer.resize(std::max<size_t>(chunkSize, 4096));
+    window = buffer.data();
+    peakBuffer = buffer.size();
+}
+
+streamLexer::streamLexer(mappedFile& file) : mapping(&file) {
+    window = file.data();
+    dataEnd = file.size();
+    endOfInput = true;
+}
+
+// Move the partial statement to the front and read more input behind it,
+// growing the buffer only when a single statement exceeds it
+bool streamLexer::refill() {
+    if (endOfInput) return false;
+
+    if (dataBegin > 0) {
+        std::memmove(buffer.data(), buffer.data() + dataBegin, dataEnd - dataBegin);
+        dataEnd -= dataBegin;
+        scanPos -= dataBegin;
+        dataBegin = 0;
+    }
+    if (dataEnd == buffer.size()) {
+        buffer.resize(buffer.size() * 2);
+        peakBuffer = std::max(peakBuffer, buffer.size());
+    }
+    window = buffer.data();
+
+    size_t n = source->read(buffer.data() + dataEnd, buffer.size() - dataEnd);
+    if (n == 0) {
+        endOfInput = true;
+        return false;
+    }
+    dataEnd += n;
+    return true;
+}
+
+void streamLexer::advancePosition(std::string_view statement) {
+    NewlineInfo newlines = scanNewlines(statement.data(), statement.size());
+    if (newlines.count != 0) {
+        lineBase += newlines.count;
+        columnBase = statement.size() - newlines.lastOffset;
+    } else {
+        columnBase += statement.size();
+    }
+    streamOffset += statement.size();
+}
+
+bool streamLexer::nextStatement(std::string_view& statement) {
+    while (true) {
+        size_t end = splitter.findEnd(window + scanPos, dataEnd - scanPos);
+        size_t stop;
+        if (end != statementSplitter::npos) {
+            stop = scanPos + end;
+        } else {
+            scanPos = dataEnd;
+            if (refill()) continue;
+            if (dataBegin == dataEnd) return false;
+            stop = dataEnd;
+        }
+
+        std::string_view text(window + dataBegin, stop - dataBegin);
+        dataBegin = scanPos = stop;
+
+        bool blank = std::all_of(text.begin(), text.end(), [](char c) { return std::isspace(static_cast<unsigned char>(c)); });
+        if (blank) {
+            advancePosition(text);
+            continue;
+        }
+
+        statement = text;
+        statementOffset = streamOffset;
+        statementLine = lineBase;
+        statementColumn = columnBase;
+        advancePosition(text);
+        statementCount++;
+        return true;
+    }
+}
+
+bool streamLexer::nextStatementTokens(std::vector<TokenView>& tokens) {
+    std::string_view statement;
+    if (!nextStatement(statement)) return false;
+
+    // The previous statement's bytes are no longer referenced by the caller
+    if (mapping) mapping->release(statementOffset);
+
+    tokens = lex.tokenizeView(statement);
+    for (auto& token : tokens) {
+        if (token.line == 1) token.column += statementColumn - 1;
+        token.line += statementLine - 1;
+        token.position += statementOffset;
+    }
+    return true;
+}
+
+bool streamLexer::nextToken(TokenView& token) {
+    while (pendingIndex >= pending.size()) {
+        pendingIndex = 0;
+        if (!nextStatementTokens(pending)) {
+            pending.clear();
+            return false;
+        }
+    }
+    token = std::move(pending[pendingIndex++]);
+    return true;
+}
@@ -0,0 +1,210 @@
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+#include <mutex>
+#include "../../include/parser/templateCache.hpp"
+#include "../../include/parser/lexer.hpp"
+#include "../../include/parser/parser.hpp"
+#include "../../include/common/arena.hpp"
+
+static uint64_t fingerprintHash(std::string_view text) {
+    uint64_t hash = 1469598103934665603ull;
+    for (char c : text) {
+        hash ^= static_cast<unsigned char>(c);
+        hash *= 1099511628211ull;
+    }
+    return hash;
+}
+
+bool normalizeTokens(const std::vector<Token>& tokens, normalizedStatement& out) {
+    out.text.clear();
+    out.literals.clear();
+
+    for (const Token& token : tokens) {
+        if (token.type == TokenType::PARAMETER || token.type == TokenType::ERROR) return false;
+
+        if (!out.text.empty()) out.text += ' ';
+        if (token.isLiteral()) {
+            out.literals.push_back(token.literalValue());
+            out.text += '$';
+            out.text += std::to_string(out.literals.size());
+        } else {
+            out.text += token.value;
+        }
+    }
+
+    out.fingerprint = fingerprintHash(out.text);
+    return true;
+}
+
+// Parser state is per statement, so every thread keeps its own
+static thread_local lexer thread_lexer;
+static thread_local parser thread_parser;
+static thread_local arena thread_arena;
+
+templateCache::templateCache(size_t capacity, const DatabaseSchema* schema)
+    : maxEntries(capacity ? capacity : 1), schema(schema) {}
+
+std::shared_ptr<const preparedStatement> templateCache::parseTokens(const std::vector<Token>& tokens, std::string text,
+                                                                    std::vector<parameterRule>* rules, bool& unbound) {
+    thread_parser.nodeArena = &thread_arena;
+    thread_parser.itr = Iterator();
+    astNode* root = astNode::create("ROOT", "ROOT", &thread_arena);
+    bool ok = thread_parser.parse(tokens, root);
+    if (!ok && !rules) {
+        std::cerr << "Error: " << thread_parser.error() << " (token " << thread_parser.firstErrorToken << ")." << std::endl;
+    }
+    unbound = false;
+    if (ok && schema) {
+        binder resolver(*schema);
+        unbound = !resolver.bind(root);
+        if (unbound && !rules) std::cerr << "Error: " << resolver.error() << std::endl;
+        if (!unbound && rules) *rules = resolver.parameterRules();
+        ok = !unbound;
+    }
+
+    std::shared_ptr<const preparedStatement> statement;
+    if (ok) {
+        statement = std::make_shared<const preparedStatement>(std::move(text), compactAst::fromTree(root), thread_parser.parameterCount);
+    }
+    thread_arena.reset();
+    return statement;
+}
+
+std::shared_ptr<templateCache::entry> templateCache::find(const normalizedStatement& normalized) {
+    shard& s = shardFor(normalized.fingerprint);
+    std::shared_lock<std::shared_mutex> lock(s.mtx);
+    auto it = s.entries.find(normalized.fingerprint);
+    // Compare the text too, so a hash collision is a miss rather than a wrong plan
+    if (it == s.entries.end() || it->second->text != normalized.text) return nullptr;
+    return it->second;
+}
+
+std::shared_ptr<const preparedStatement> templateCache::parseDirect(const std::vector<Token>& tokens) {
+    bool unbound;
+    return parseTokens(tokens, std::string(), nullptr, unbound);
+}
+
+static bool rulesHold(const std::vector<parameterRule>& rules, const std::vector<Value>& literals) {
+    return std::all_of(rules.begin(), rules.end(),
+                       [&literals](const parameterRule& rule) { return binder::satisfied(rule, literals); });
+}
+
+bool templateCache::execute(std::string_view sql, boundStatement& bound) {
+    return execute(thread_lexer.tokenize(sql), bound);
+}
+
+bool templateCache::execute(const std::vector<Token>& tokens, boundStatement& bound) {
+    auto start = std::chrono::steady_clock::now();
+    auto elapsedNanos = [&start]() {
+        return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now() - start).count());
+    };
+
+    static thread_local normalizedStatement normalized;
+    if (!normalizeTokens(tokens, normalized)) {
+        bypassCount.fetch_add(1, std::memory_order_relaxed);
+        bound.statement = parseDirect(tokens);
+        bound.parameters.clear();
+        bound.text.reset();
+        return bound.statement != nullptr;
+    }
+
+    if (std::shared_ptr<entry> cached = find(normalized)) {
+        hitCount.fetch_add(1, std::memory_order_relaxed);
+        if (cached->statement && rulesHold(cached->rules, normalized.literals)) {
+            bound.statement = cached->statement;
+            bound.parameters = normalized.literals;
+            bound.text = Value::internStrings(bound.parameters);
+        } else {
+            bypassCount.fetch_add(1, std::memory_order_relaxed);
+            bound.statement = parseDirect(tokens);
+            bound.parameters.clear();
+            bound.text.reset();
+        }
+        cached->hits.fetch_add(1, std::memory_order_relaxed);
+        cached->executions.fetch_add(1, std::memory_order_relaxed);
+        cached->totalNanos.fetch_add(elapsedNanos(), std::memory_order_relaxed);
+        return bound.statement != nullptr;
+    }
+
+    missCount.fetch_add(1, std::memory_order_relaxed);
+
+    // Parse the template: the same tokens with every literal turned into its slot
+    std::vector<Token> templateTokens;
+    templateTokens.reserve(tokens.size());
+    size_t slot = 0;
+    for (const Token& token : tokens) {
+        if (token.isLiteral()) {
+            templateTokens.emplace_back(TokenType::PARAMETER, "$" + std::to_string(++slot), token.original,
+                                        token.position, token.line, token.column);
+        } else {
+            templateTokens.push_back(token);
+        }
+    }
+
+    std::vector<parameterRule> rules;
+    bool unbound;
+    std::shared_ptr<const preparedStatement> statement = parseTokens(templateTokens, normalized.text, &rules, unbound);
+
+    // A slot the grammar does not accept (or drops) means the shape only
+    // parses with its literals; remember that, and handle it directly
+    if (statement && statement->parameterCount() != normalized.literals.size()) statement = nullptr;
+
+    if (statement && rulesHold(rules, normalized.literals)) {
+        bound.statement = statement;
+        bound.parameters = normalized.literals;
+        bound.text = Value::internStrings(bound.parameters);
+    } else {
+        bypassCount.fetch_add(1, std::memory_order_relaxed);
+        bound.statement = parseDirect(tokens);
+        bound.parameters.clear();
+        bound.text.reset();
+    }
+
+    if (!unbound && entryCount.load(std::memory_order_relaxed) < maxEntries) {
+        auto created = std::make_shared<entry>();
+        created->text = normalized.text;
+        created->statement = statement;
+        created->rules = std::move(rules);
+        created->executions.store(1, std::memory_order_relaxed);
+        created->totalNanos.store(elapsedNanos(), std::memory_order_relaxed);
+
+        shard& s = shardFor(normalized.fingerprint);
+        std::unique_lock<std::shared_mutex> lock(s.mtx);
+        // Another thread may have inserted the same shape meanwhile; keep theirs
+        if (s.entries.emplace(normalized.fingerprint, std::move(created)).second) {
+            entryCount.fetch_add(1, std::memory_order_relaxed);
+        }
+    }
+    return bound.statement != nullptr;
+}
+
+std::vector<templateStats> templateCache::stats() const {
+    std::vector<templateStats> result;
+    for (const shard& s : shards) {
+        std::shared_lock<std::shared_mutex> lock(s.mtx);
+        for (const auto& [fingerprint, cached] : s.entries) {
+            result.push_back({fingerprint, cached->text,
+                              cached->executions.load(std::memory_order_relaxed),
+                              cached->hits.load(std::memory_order_relaxed),
+                              cached->totalNanos.load(std::memory_order_relaxed)});
+        }
+    }
+    std::sort(result.begin(), result.end(), [](const templateStats& a, const templateStats& b) {
+        return a.executions > b.executions;
+    });
+    return result;
+}
+
+void templateCache::clear() {
+    for (shard& s : shards) {
+        std::unique_lock<std::shared_mutex> lock(s.mtx);
+        entryCount.fetch_sub(s.entries.size(), std::memory_order_relaxed);
+        s.entries.clear();
+    }
+}
+
+size_t templateCache::size() const {
+    return entryCount.load(std::memory_order_relaxed);
+}
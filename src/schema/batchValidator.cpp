@@ -0,0 +1,112 @@
+#include <algorithm>
+#include <cmath>
+#include "../../include/schema/batchValidator.hpp"
+
+static size_t wordsFor(size_t rows) {
+    return (rows + 63) / 64;
+}
+
+void batchErrors::reset(size_t rowCount) {
+    rows = rowCount;
+    for (std::vector<uint64_t>* bitmap : {&notNull, &type, &range, &unique}) {
+        bitmap->assign(wordsFor(rowCount), 0);
+    }
+}
+
+bool batchErrors::failed(size_t row) const {
+    uint64_t bit = uint64_t(1) << (row % 64);
+    size_t word = row / 64;
+    return ((notNull[word] | type[word] | range[word] | unique[word]) & bit) != 0;
+}
+
+size_t batchErrors::failedCount() const {
+    size_t failures = 0;
+    for (size_t word = 0; word < notNull.size(); word++) {
+        failures += static_cast<size_t>(__builtin_popcountll(notNull[word] | type[word] | range[word] | unique[word]));
+    }
+    return failures;
+}
+
+namespace {
+
+// Build one bitmap word per 64 rows from a per-row predicate. The inner loop
+// has no branches, so the compiler can unroll and vectorize it.
+template <typename Predicate>
+void fillBitmap(const Value* values, size_t count, std::vector<uint64_t>& bitmap, Predicate fails) {
+    for (size_t base = 0; base < count; base += 64) {
+        size_t end = std::min<size_t>(64, count - base);
+        uint64_t word = 0;
+        for (size_t i = 0; i < end; i++) {
+            word |= static_cast<uint64_t>(fails(values[base + i])) << i;
+        }
+        bitmap[base / 64] = word;
+    }
+}
+
+// Mark every row whose key already appeared earlier in the batch. Open
+// addressing over row numbers: one allocation for the whole batch.
+void markDuplicates(const Value* values, size_t count, std::vector<uint64_t>& bitmap) {
+    size_t capacity = 16;
+    while (capacity < count * 2) capacity *= 2;
+    const size_t mask = capacity - 1;
+    constexpr uint32_t EMPTY = UINT32_MAX;
+    std::vector<uint32_t> slots(capacity, EMPTY);
+
+    for (size_t row = 0; row < count; row++) {
+        const Value& key = values[row];
+        if (key.isNull()) continue; // NULLs never collide under UNIQUE
+
+        for (size_t slot = key.hash() & mask;; slot = (slot + 1) & mask) {
+            if (slots[slot] == EMPTY) {
+                slots[slot] = static_cast<uint32_t>(row);
+                break;
+            }
+            if (values[slots[slot]] == key) {
+                bitmap[row / 64] |= uint64_t(1) << (row % 64);
+                break;
+            }
+        }
+    }
+}
+
+} // namespace
+
+bool validateColumnBatch(const Column& column, const Value* values, size_t count,
+                         batchErrors& errors, const keyLookup* existing) {
+    errors.reset(count);
+
+    if (column.isNotNull || column.isPrimaryKey) {
+        fillBitmap(values, count, errors.notNull, [](const Value& value) { return value.isNull(); });
+    }
+
+    // An INT fits a DOUBLE column; NULL is the NOT NULL pass's business
+    const ValueType expected = columnValueType(column.type);
+    const bool widenInt = expected == ValueType::DOUBLE;
+    fillBitmap(values, count, errors.type, [expected, widenInt](const Value& value) {
+        ValueType actual = value.type();
+        return actual != ValueType::NULL_VALUE && actual != expected && !(widenInt && actual == ValueType::INT);
+    });
+
+    const bool limited = (column.type == ColumnType::CHAR || column.type == ColumnType::VARCHAR) && column.length > 0;
+    if (limited) {
+        const size_t limit = column.length;
+        fillBitmap(values, count, errors.range, [limit](const Value& value) {
+            return value.type() == ValueType::STRING && value.asString().size() > limit;
+        });
+    } else if (column.type == ColumnType::DOUBLE) {
+        fillBitmap(values, count, errors.range, [](const Value& value) {
+            return value.type() == ValueType::DOUBLE && !std::isfinite(value.asDouble());
+        });
+    }
+
+    if (column.isUnique || column.isPrimaryKey) {
+        markDuplicates(values, count, errors.unique);
+        if (existing) {
+            std::vector<uint64_t> found(errors.unique.size(), 0);
+            existing->probe(values, count, found.data());
+            for (size_t word = 0; word < found.size(); word++) errors.unique[word] |= found[word];
+        }
+    }
+
+    return errors.ok();
+}
@@ -0,0 +1,254 @@
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <iostream>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include "../../include/schema/catalogFile.hpp"
+
+static size_t alignUp(size_t value) {
+    return (value + 7) & ~static_cast<size_t>(7);
+}
+
+catalogFile::catalogFile(const std::string& path) {
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) return;
+
+    struct stat st;
+    if (fstat(fd, &st) == 0 && static_cast<size_t>(st.st_size) >= sizeof(catalogHeader)) {
+        length = static_cast<size_t>(st.st_size);
+        void* addr = mmap(nullptr, length, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (addr != MAP_FAILED) base = static_cast<char*>(addr);
+    }
+    ::close(fd);
+    if (!base) return;
+
+    const catalogHeader* candidate = reinterpret_cast<const catalogHeader*>(base);
+    if (std::memcmp(candidate->magic, MAGIC, sizeof(MAGIC)) != 0) {
+        std::cerr << "Error: '" << path << "' is not a catalog file." << std::endl;
+        return;
+    }
+    if (candidate->version != VERSION) {
+        std::cerr << "Error: Catalog '" << path << "' has version " << candidate->version
+                  << ", expected " << VERSION << "." << std::endl;
+        return;
+    }
+
+    // Every section must lie inside the file; records are trusted after this
+    auto fits = [this](uint64_t offset, uint64_t bytes) {
+        return offset <= length && bytes <= length - offset;
+    };
+    if (!fits(candidate->tablesOffset, uint64_t(candidate->tableCount) * sizeof(catalogTableRecord)) ||
+        !fits(candidate->columnsOffset, uint64_t(candidate->columnCount) * sizeof(catalogColumnRecord)) ||
+        !fits(candidate->foreignKeysOffset, uint64_t(candidate->foreignKeyCount) * sizeof(catalogForeignKeyRecord)) ||
+        !fits(candidate->indexesOffset, uint64_t(candidate->indexCount) * sizeof(catalogIndexRecord)) ||
+        !fits(candidate->stringsOffset, candidate->stringsSize)) {
+        std::cerr << "Error: Catalog '" << path << "' is truncated." << std::endl;
+        return;
+    }
+
+    // An index method this build does not know is corruption, not a default
+    const catalogIndexRecord* indexRecords = reinterpret_cast<const catalogIndexRecord*>(base + candidate->indexesOffset);
+    for (uint32_t i = 0; i < candidate->indexCount; i++) {
+        if (indexRecords[i].method > static_cast<uint32_t>(IndexMethod::HASH)) {
+            std::cerr << "Error: Catalog '" << path << "' has an index with unknown method "
+                      << indexRecords[i].method << "." << std::endl;
+            return;
+        }
+    }
+
+    header = candidate;
+    tables = reinterpret_cast<const catalogTableRecord*>(base + header->tablesOffset);
+    columns = reinterpret_cast<const catalogColumnRecord*>(base + header->columnsOffset);
+    foreignKeys = reinterpret_cast<const catalogForeignKeyRecord*>(base + header->foreignKeysOffset);
+    indexes = reinterpret_cast<const catalogIndexRecord*>(base + header->indexesOffset);
+    strings = base + header->stringsOffset;
+}
+
+catalogFile::~catalogFile() {
+    if (base) munmap(base, length);
+}
+
+std::string_view catalogFile::text(catalogString str) const {
+    if (uint64_t(str.offset) + str.length > header->stringsSize) return {};
+    return std::string_view(strings + str.offset, str.length);
+}
+
+std::string_view catalogFile::tableName(size_t table) const {
+    return text(tables[table].name);
+}
+
+long catalogFile::findTable(std::string_view name) const {
+    size_t lo = 0;
+    size_t hi = tableCount();
+    while (lo < hi) {
+        size_t mid = lo + (hi - lo) / 2;
+        int cmp = tableName(mid).compare(name);
+        if (cmp == 0) return static_cast<long>(mid);
+        if (cmp < 0) {
+            lo = mid + 1;
+        } else {
+            hi = mid;
+        }
+    }
+    return -1;
+}
+
+Table catalogFile::loadTable(size_t table) const {
+    const catalogTableRecord& record = tables[table];
+    Table result;
+    result.name = std::string(text(record.name));
+    result.storage = record.storage == static_cast<uint32_t>(TableStorage::PAX) ? TableStorage::PAX : TableStorage::ROW;
+
+    uint32_t columnEnd = std::min(record.firstColumn + record.columnCount, header->columnCount);
+    result.columns.reserve(record.columnCount);
+    result.columnIndex.reserve(record.columnCount);
+    for (uint32_t i = record.firstColumn; i < columnEnd; i++) {
+        const catalogColumnRecord& col = columns[i];
+        Column column;
+        column.name = std::string(text(col.name));
+        column.datatype = std::string(text(col.datatype));
+        column.isPrimaryKey = col.flags & COLUMN_PRIMARY_KEY;
+        column.isUnique = col.flags & COLUMN_UNIQUE;
+        column.isNotNull = col.flags & COLUMN_NOT_NULL;
+        result.addColumn(std::move(column));
+    }
+
+    uint32_t foreignKeyEnd = std::min(record.firstForeignKey + record.foreignKeyCount, header->foreignKeyCount);
+    for (uint32_t i = record.firstForeignKey; i < foreignKeyEnd; i++) {
+        result.foreignKeys.emplace(std::string(text(foreignKeys[i].column)), std::string(text(foreignKeys[i].reference)));
+    }
+    return result;
+}
+
+IndexDefinition catalogFile::loadIndex(size_t index) const {
+    const catalogIndexRecord& record = indexes[index];
+    IndexDefinition result;
+    result.name = std::string(text(record.name));
+    result.table = std::string(text(record.table));
+    result.column = std::string(text(record.column));
+    result.method = static_cast<IndexMethod>(record.method); // checked when the file was opened
+    return result;
+}
+
+// Write all of data, retrying on short writes
+static bool writeAll(int fd, const char* data, size_t size) {
+    while (size > 0) {
+        ssize_t written = ::write(fd, data, size);
+        if (written < 0) return false;
+        data += written;
+        size -= static_cast<size_t>(written);
+    }
+    return true;
+}
+
+bool catalogFile::write(const std::string& path, const std::vector<const Table*>& tableList,
+                        const std::vector<IndexDefinition>& indexList, uint64_t generation) {
+    std::vector<const Table*> sorted(tableList);
+    std::sort(sorted.begin(), sorted.end(), [](const Table* a, const Table* b) { return a->name < b->name; });
+
+    std::vector<catalogTableRecord> tableRecords;
+    std::vector<catalogColumnRecord> columnRecords;
+    std::vector<catalogForeignKeyRecord> foreignKeyRecords;
+    std::string pool;
+    tableRecords.reserve(sorted.size());
+
+    auto addString = [&pool](const std::string& str) {
+        catalogString ref{static_cast<uint32_t>(pool.size()), static_cast<uint32_t>(str.size())};
+        pool += str;
+        return ref;
+    };
+
+    // Table names go first in the pool, so a lookup's binary search only
+    // touches the record array and this one dense run of names
+    std::vector<catalogString> names;
+    names.reserve(sorted.size());
+    for (const Table* table : sorted) names.push_back(addString(table->name));
+
+    for (const Table* table : sorted) {
+        catalogTableRecord record{};
+        record.name = names[tableRecords.size()];
+        record.firstColumn = static_cast<uint32_t>(columnRecords.size());
+        record.columnCount = static_cast<uint32_t>(table->columns.size());
+        record.firstForeignKey = static_cast<uint32_t>(foreignKeyRecords.size());
+        record.foreignKeyCount = static_cast<uint32_t>(table->foreignKeys.size());
+        record.storage = static_cast<uint32_t>(table->storage);
+
+        for (const Column& column : table->columns) {
+            catalogColumnRecord col{};
+            col.name = addString(column.name);
+            col.datatype = addString(column.datatype);
+            col.flags = (column.isPrimaryKey ? COLUMN_PRIMARY_KEY : 0u) |
+                        (column.isUnique ? COLUMN_UNIQUE : 0u) |
+                        (column.isNotNull ? COLUMN_NOT_NULL : 0u);
+            columnRecords.push_back(col);
+        }
+        for (const auto& [columnName, reference] : table->foreignKeys) {
+            foreignKeyRecords.push_back({addString(columnName), addString(reference)});
+        }
+        tableRecords.push_back(record);
+    }
+
+    std::vector<catalogIndexRecord> indexRecords;
+    indexRecords.reserve(indexList.size());
+    for (const IndexDefinition& index : indexList) {
+        catalogIndexRecord record{};
+        record.name = addString(index.name);
+        record.table = addString(index.table);
+        record.column = addString(index.column);
+        record.method = static_cast<uint32_t>(index.method);
+        indexRecords.push_back(record);
+    }
+
+    catalogHeader header{};
+    std::memcpy(header.magic, MAGIC, sizeof(MAGIC));
+    header.version = VERSION;
+    header.tableCount = static_cast<uint32_t>(tableRecords.size());
+    header.columnCount = static_cast<uint32_t>(columnRecords.size());
+    header.foreignKeyCount = static_cast<uint32_t>(foreignKeyRecords.size());
+    header.indexCount = static_cast<uint32_t>(indexRecords.size());
+    header.generation = generation;
+    header.tablesOffset = alignUp(sizeof(catalogHeader));
+    header.columnsOffset = alignUp(header.tablesOffset + tableRecords.size() * sizeof(catalogTableRecord));
+    header.foreignKeysOffset = alignUp(header.columnsOffset + columnRecords.size() * sizeof(catalogColumnRecord));
+    header.indexesOffset = alignUp(header.foreignKeysOffset + foreignKeyRecords.size() * sizeof(catalogForeignKeyRecord));
+    header.stringsOffset = alignUp(header.indexesOffset + indexRecords.size() * sizeof(catalogIndexRecord));
+    header.stringsSize = pool.size();
+
+    std::string image(header.stringsOffset + pool.size(), '\0');
+    std::memcpy(&image[0], &header, sizeof(header));
+    auto copySection = [&image](uint64_t offset, const void* data, size_t bytes) {
+        if (bytes != 0) std::memcpy(&image[offset], data, bytes);
+    };
+    copySection(header.tablesOffset, tableRecords.data(), tableRecords.size() * sizeof(catalogTableRecord));
+    copySection(header.columnsOffset, columnRecords.data(), columnRecords.size() * sizeof(catalogColumnRecord));
+    copySection(header.foreignKeysOffset, foreignKeyRecords.data(), foreignKeyRecords.size() * sizeof(catalogForeignKeyRecord));
+    copySection(header.indexesOffset, indexRecords.data(), indexRecords.size() * sizeof(catalogIndexRecord));
+    copySection(header.stringsOffset, pool.data(), pool.size());
+
+    std::string tempPath = path + ".tmp";
+    int fd = ::open(tempPath.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if (fd < 0) {
+        std::cerr << "Error: Cannot create '" << tempPath << "'." << std::endl;
+        return false;
+    }
+    bool ok = writeAll(fd, image.data(), image.size()) && fsync(fd) == 0;
+    ::close(fd);
+    if (!ok || std::rename(tempPath.c_str(), path.c_str()) != 0) {
+        std::cerr << "Error: Cannot write catalog '" << path << "'." << std::endl;
+        ::unlink(tempPath.c_str());
+        return false;
+    }
+
+    // Make the rename itself durable
+    size_t slash = path.rfind('/');
+    std::string directory = slash == std::string::npos ? "." : (slash == 0 ? "/" : path.substr(0, slash));
+    int dirFd = ::open(directory.c_str(), O_RDONLY | O_DIRECTORY);
+    if (dirFd >= 0) {
+        fsync(dirFd);
+        ::close(dirFd);
+    }
+    return true;
+}
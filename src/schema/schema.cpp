@@ -1,81 +1,468 @@
 #include "../../include/schema/schema.hpp"
+#include "../../include/schema/catalogFile.hpp"
+#include "../../include/schema/batchValidator.hpp"
+#include "../../include/common/epoch.hpp"
 #include <iostream>
+#include <memory>
 #include <algorithm>
+#include <cctype>
+#include <cmath>
+#include <vector>
+#include <unistd.h>
+
+ColumnType columnTypeFromString(std::string_view datatype, uint32_t& length) {
+    length = 0;
+    size_t paren = datatype.find('(');
+    std::string base;
+    for (char c : datatype.substr(0, paren)) {
+        if (!std::isspace(static_cast<unsigned char>(c))) base += static_cast<char>(std::toupper(static_cast<unsigned char>(c)));
+    }
+    if (paren != std::string_view::npos) {
+        for (size_t i = paren + 1; i < datatype.size() && std::isdigit(static_cast<unsigned char>(datatype[i])); i++) {
+            length = length * 10 + static_cast<uint32_t>(datatype[i] - '0');
+        }
+    }
+
+    if (base == "INT" || base == "NUMBER") return ColumnType::INT;
+    if (base == "DOUBLE" || base == "FLOAT") return ColumnType::DOUBLE;
+    if (base == "BOOLEAN") return ColumnType::BOOLEAN;
+    if (base == "DATE") return ColumnType::DATE;
+    if (base == "CHAR") {
+        if (length == 0) length = 1;
+        return ColumnType::CHAR;
+    }
+    if (base == "VARCHAR" || base == "STRING") return ColumnType::VARCHAR;
+    if (base == "TEXT") return ColumnType::TEXT;
+    return ColumnType::UNKNOWN;
+}
+
+const char* columnTypeToString(ColumnType type) {
+    switch (type) {
+        case ColumnType::INT:     return "INT";
+        case ColumnType::DOUBLE:  return "DOUBLE";
+        case ColumnType::BOOLEAN: return "BOOLEAN";
+        case ColumnType::DATE:    return "DATE";
+        case ColumnType::CHAR:    return "CHAR";
+        case ColumnType::VARCHAR: return "VARCHAR";
+        case ColumnType::TEXT:    return "TEXT";
+        default:                  return "UNKNOWN";
+    }
+}
+
+uint32_t columnTypeWidth(ColumnType type, uint32_t length) {
+    switch (type) {
+        case ColumnType::INT:     return 8;
+        case ColumnType::DOUBLE:  return 8;
+        case ColumnType::BOOLEAN: return 1;
+        case ColumnType::DATE:    return 4;
+        case ColumnType::CHAR:    return length;
+        case ColumnType::VARCHAR: return 8;
+        case ColumnType::TEXT:    return 8;
+        default:                  return 8;
+    }
+}
+
+const char* tableStorageToString(TableStorage storage) {
+    return storage == TableStorage::PAX ? "PAX" : "ROW";
+}
+
+const char* indexMethodToString(IndexMethod method) {
+    return method == IndexMethod::HASH ? "HASH" : "UNKNOWN";
+}
+
+ValueType columnValueType(ColumnType type) {
+    switch (type) {
+        case ColumnType::INT:     return ValueType::INT;
+        case ColumnType::DOUBLE:  return ValueType::DOUBLE;
+        case ColumnType::BOOLEAN: return ValueType::BOOLEAN;
+        case ColumnType::DATE:    return ValueType::DATE;
+        case ColumnType::CHAR:
+        case ColumnType::VARCHAR:
+        case ColumnType::TEXT:    return ValueType::STRING;
+        default:                  return ValueType::NULL_VALUE;
+    }
+}
+
+// Natural alignment of a slot: CHAR data is bytes, everything else its own width
+static uint32_t slotAlignment(const Column& column) {
+    return column.type == ColumnType::CHAR ? 1 : column.width;
+}
+
+bool Table::addColumn(Column column) {
+    if (columnIndex.count(column.name)) return false;
+
+    column.ordinal = static_cast<uint32_t>(columns.size());
+    column.nullBit = column.ordinal;
+    column.type = columnTypeFromString(column.datatype, column.length);
+    column.width = columnTypeWidth(column.type, column.length);
+
+    columnIndex.emplace(column.name, column.ordinal);
+    columns.push_back(std::move(column));
+    computeLayout();
+    return true;
+}
+
+const Column* Table::findColumn(const std::string& columnName) const {
+    auto it = columnIndex.find(columnName);
+    return it == columnIndex.end() ? nullptr : &columns[it->second];
+}
+
+void Table::computeLayout() {
+    nullBitmapBytes = static_cast<uint32_t>((columns.size() + 7) / 8);
+
+    // Widest alignment first, so slots pack without padding after the bitmap
+    std::vector<uint32_t> order(columns.size());
+    for (uint32_t i = 0; i < order.size(); i++) order[i] = i;
+    std::stable_sort(order.begin(), order.end(), [this](uint32_t a, uint32_t b) {
+        return slotAlignment(columns[a]) > slotAlignment(columns[b]);
+    });
+
+    uint32_t offset = nullBitmapBytes;
+    for (uint32_t ordinal : order) {
+        Column& column = columns[ordinal];
+        uint32_t align = slotAlignment(column);
+        offset = (offset + align - 1) / align * align;
+        column.offset = offset;
+        offset += column.width;
+    }
+    fixedRowSize = (offset + 7) / 8 * 8;
+}
+
+// A mapped catalog plus the tables materialized from it so far. Shared by
+// every snapshot over the same file, so a table loaded through one snapshot
+// stays alive in its successors. Each slot is filled once, by compare-and-swap.
+struct catalogTables {
+    std::shared_ptr<const catalogFile> file;
+    std::unique_ptr<std::atomic<std::shared_ptr<const Table>*>[]> loaded;
+
+    explicit catalogTables(std::shared_ptr<const catalogFile> mapped)
+        : file(std::move(mapped)), loaded(new std::atomic<std::shared_ptr<const Table>*>[file->tableCount()]) {
+        for (size_t i = 0; i < file->tableCount(); i++) loaded[i].store(nullptr, std::memory_order_relaxed);
+    }
+
+    ~catalogTables() {
+        for (size_t i = 0; i < file->tableCount(); i++) delete loaded[i].load(std::memory_order_relaxed);
+    }
+
+    // Table at index, built on first use; racing readers agree on one copy
+    const std::shared_ptr<const Table>& materialize(size_t index) const {
+        std::shared_ptr<const Table>* table = loaded[index].load(std::memory_order_acquire);
+        if (table) return *table;
+
+        auto* fresh = new std::shared_ptr<const Table>(std::make_shared<const Table>(file->loadTable(index)));
+        if (loaded[index].compare_exchange_strong(table, fresh, std::memory_order_acq_rel, std::memory_order_acquire)) {
+            return *fresh;
+        }
+        delete fresh;
+        return *table;
+    }
+};
+
+// One immutable version of the schema
+struct schemaSnapshot {
+    uint64_t version = 0;
+    std::unordered_map<std::string, std::shared_ptr<const Table>> tables; // added in memory
+    std::shared_ptr<const catalogTables> catalog;
+    size_t tableCount = 0;
+    std::vector<IndexDefinition> indexes; // every index, in memory and in the catalog
+
+    const Table* find(const std::string& tableName) const {
+        auto it = tables.find(tableName);
+        if (it != tables.end()) return it->second.get();
+        if (!catalog) return nullptr;
+
+        long index = catalog->file->findTable(tableName);
+        if (index < 0) return nullptr;
+        return catalog->materialize(static_cast<size_t>(index)).get();
+    }
+
+    bool contains(const std::string& tableName) const {
+        return tables.count(tableName) || (catalog && catalog->file->findTable(tableName) >= 0);
+    }
+
+    // Every table, catalog ones materialized, so a snapshot over another
+    // catalog keeps the exact Table objects readers may already hold
+    std::unordered_map<std::string, std::shared_ptr<const Table>> allTables() const {
+        std::unordered_map<std::string, std::shared_ptr<const Table>> all(tables);
+        size_t count = catalog ? catalog->file->tableCount() : 0;
+        for (size_t i = 0; i < count; i++) {
+            const std::shared_ptr<const Table>& table = catalog->materialize(i);
+            all.emplace(table->name, table);
+        }
+        return all;
+    }
+};
+
+DatabaseSchema::DatabaseSchema() : current(new schemaSnapshot()) {}
+
+DatabaseSchema::~DatabaseSchema() {
+    // No reader can be inside a schema that is being destroyed
+    delete current.load(std::memory_order_acquire);
+    epochReclaimer::reclaim();
+}
+
+// Callers hold writerMutex
+void DatabaseSchema::publish(schemaSnapshot* next) {
+    const schemaSnapshot* previous = current.exchange(next, std::memory_order_seq_cst);
+    epochReclaimer::retire([previous] { delete previous; });
+}
+
+uint64_t DatabaseSchema::version() const {
+    epochGuard guard;
+    return current.load(std::memory_order_seq_cst)->version;
+}
+
+// Snapshot holding tables and indexes over a newly mapped catalog (file may
+// be null). Tables the catalog also holds move into its slots rather than
+// being reloaded, so pointers readers already hold stay valid.
+static schemaSnapshot* snapshotOver(const schemaSnapshot& previous,
+                                    std::unordered_map<std::string, std::shared_ptr<const Table>> tables,
+                                    std::vector<IndexDefinition> indexes,
+                                    std::shared_ptr<const catalogFile> file) {
+    auto* next = new schemaSnapshot();
+    next->version = previous.version + 1;
+    next->indexes = std::move(indexes);
+
+    std::shared_ptr<catalogTables> mapped;
+    if (file) mapped = std::make_shared<catalogTables>(std::move(file));
+    for (auto& [name, table] : tables) {
+        long index = mapped ? mapped->file->findTable(name) : -1;
+        if (index >= 0) {
+            mapped->loaded[index].store(new std::shared_ptr<const Table>(std::move(table)), std::memory_order_relaxed);
+        } else {
+            next->tables.emplace(name, std::move(table));
+        }
+    }
+    next->catalog = std::move(mapped);
+    next->tableCount = next->tables.size() + (next->catalog ? next->catalog->file->tableCount() : 0);
+    return next;
+}
+
+bool DatabaseSchema::openCatalog(const std::string& path) {
+    auto file = std::make_shared<catalogFile>(path);
+    if (!file->isOpen()) {
+        // A missing file is an empty catalog; anything else is an error
+        if (::access(path.c_str(), F_OK) == 0) return false;
+        file.reset();
+    }
+
+    std::lock_guard<std::mutex> lock(writerMutex);
+    const schemaSnapshot* previous = current.load(std::memory_order_relaxed);
+
+    // The catalog's indexes, then any defined in memory under another name
+    std::vector<IndexDefinition> indexes;
+    for (size_t i = 0; file && i < file->indexCount(); i++) indexes.push_back(file->loadIndex(i));
+    for (const IndexDefinition& index : previous->indexes) {
+        bool known = std::any_of(indexes.begin(), indexes.end(), [&index](const IndexDefinition& other) { return other.name == index.name; });
+        if (!known) indexes.push_back(index);
+    }
+    publish(snapshotOver(*previous, previous->allTables(), std::move(indexes), std::move(file)));
+    catalogPath = path;
+    return true;
+}
+
+bool DatabaseSchema::saveCatalog() {
+    std::lock_guard<std::mutex> lock(writerMutex);
+    return saveCatalogLocked(*current.load(std::memory_order_relaxed));
+}
+
+bool DatabaseSchema::saveCatalogLocked(const schemaSnapshot& contents) {
+    if (catalogPath.empty()) {
+        std::cerr << "Error: No catalog file attached." << std::endl;
+        return false;
+    }
+
+    // Every catalog table has to be written again, so materialize them all
+    auto all = contents.allTables();
+
+    std::vector<const Table*> list;
+    list.reserve(all.size());
+    for (const auto& [name, table] : all) list.push_back(table.get());
+
+    uint64_t generation = contents.catalog ? contents.catalog->file->generation() + 1 : 1;
+    if (!catalogFile::write(catalogPath, list, contents.indexes, generation)) return false;
+
+    // The old mapping stays valid until its snapshot is reclaimed: rename never touches its inode
+    auto file = std::make_shared<catalogFile>(catalogPath);
+    if (!file->isOpen()) return false;
+
+    schemaSnapshot* next = snapshotOver(contents, std::move(all), contents.indexes, std::move(file));
+    next->version = current.load(std::memory_order_relaxed)->version + 1;
+    publish(next);
+    return true;
+}
+
+size_t DatabaseSchema::tableCount() const {
+    epochGuard guard;
+    return current.load(std::memory_order_seq_cst)->tableCount;
+}
 
 // Add a table to the schema
-void DatabaseSchema::addTable(const Table& table) {
-    if (tables.find(table.name) != tables.end()) {
+bool DatabaseSchema::addTable(const Table& table) {
+    std::lock_guard<std::mutex> lock(writerMutex);
+    const schemaSnapshot* previous = current.load(std::memory_order_relaxed);
+    if (previous->contains(table.name)) {
         std::cerr << "Error: Table '" << table.name << "' already exists." << std::endl;
-        return;
+        return false;
+    }
+
+    // Copy-on-write: the map is copied, the tables and catalog are shared
+    std::unique_ptr<schemaSnapshot> next(new schemaSnapshot());
+    next->version = previous->version + 1;
+    next->tables = previous->tables;
+    next->tables.emplace(table.name, std::make_shared<const Table>(table));
+    next->catalog = previous->catalog;
+    next->tableCount = previous->tableCount + 1;
+    next->indexes = previous->indexes;
+
+    // With a catalog attached, the table is published only once it is written
+    if (!catalogPath.empty()) return saveCatalogLocked(*next);
+    publish(next.release());
+    return true;
+}
+
+bool DatabaseSchema::addIndex(const IndexDefinition& index) {
+    std::lock_guard<std::mutex> lock(writerMutex);
+    const schemaSnapshot* previous = current.load(std::memory_order_relaxed);
+    for (const IndexDefinition& other : previous->indexes) {
+        if (other.name == index.name) {
+            std::cerr << "Error: Index '" << index.name << "' already exists." << std::endl;
+            return false;
+        }
+    }
+    const Table* table = previous->find(index.table);
+    if (!table) {
+        std::cerr << "Error: Table '" << index.table << "' does not exist." << std::endl;
+        return false;
     }
-    tables[table.name] = table;
-    std::cout << "Table '" << table.name << "' added to the schema." << std::endl;
+    if (!table->findColumn(index.column)) {
+        std::cerr << "Error: Column '" << index.column << "' does not exist in table '" << index.table << "'." << std::endl;
+        return false;
+    }
+
+    std::unique_ptr<schemaSnapshot> next(new schemaSnapshot());
+    next->version = previous->version + 1;
+    next->tables = previous->tables;
+    next->catalog = previous->catalog;
+    next->tableCount = previous->tableCount;
+    next->indexes = previous->indexes;
+    next->indexes.push_back(index);
+
+    if (!catalogPath.empty()) return saveCatalogLocked(*next);
+    publish(next.release());
+    return true;
+}
+
+std::vector<IndexDefinition> DatabaseSchema::getIndexes(const std::string& tableName) const {
+    epochGuard guard;
+    std::vector<IndexDefinition> result;
+    for (const IndexDefinition& index : current.load(std::memory_order_seq_cst)->indexes) {
+        if (index.table == tableName) result.push_back(index);
+    }
+    return result;
 }
 
 // Check if a table exists
 bool DatabaseSchema::tableExists(const std::string& tableName) const {
-    return tables.find(tableName) != tables.end();
+    epochGuard guard;
+    return current.load(std::memory_order_seq_cst)->contains(tableName);
 }
 
 // Get table metadata
 const Table* DatabaseSchema::getTable(const std::string& tableName) const {
-    auto it = tables.find(tableName);
-    if (it != tables.end()) {
-        return &it->second;
-    }
-    return nullptr;
+    epochGuard guard;
+    return current.load(std::memory_order_seq_cst)->find(tableName);
 }
 
 // Validate a column's constraints
-bool DatabaseSchema::validateColumnConstraints(const std::string& tableName, const std::string& columnName, const std::string& value) const {
+bool DatabaseSchema::validateColumnConstraints(const std::string& tableName, const std::string& columnName, const std::string& value,
+                                               const keyLookup* existing) const {
+    const Table* table = getTable(tableName);
+    const Column* column = table ? table->findColumn(columnName) : nullptr;
+    if (!column) return validateColumnConstraints(tableName, columnName, Value::null());
+
+    // Parse once into the column's type; an empty string stands for NULL
+    Value typed;
+    if (!value.empty() && !Value::parse(value, columnValueType(column->type), typed)) {
+        std::cerr << "Error: Invalid value '" << value << "' for column '" << columnName << "' of type " << column->datatype << "." << std::endl;
+        return false;
+    }
+    return validateColumnConstraints(tableName, columnName, typed, existing);
+}
+
+bool DatabaseSchema::validateColumnConstraints(const std::string& tableName, const std::string& columnName, const Value& value,
+                                               const keyLookup* existing) const {
     const Table* table = getTable(tableName);
     if (!table) {
         std::cerr << "Error: Table '" << tableName << "' does not exist." << std::endl;
         return false;
     }
 
-    auto colIt = table->columns.find(columnName);
-    if (colIt == table->columns.end()) {
+    const Column* columnInfo = table->findColumn(columnName);
+    if (!columnInfo) {
         std::cerr << "Error: Column '" << columnName << "' does not exist in table '" << tableName << "'." << std::endl;
         return false;
     }
 
-    const Column& column = colIt->second;
+    const Column& column = *columnInfo;
 
     // Check NOT NULL constraint
-    if (column.isNotNull && value.empty()) {
+    if (column.isNotNull && value.isNull()) {
         std::cerr << "Error: Column '" << columnName << "' cannot be NULL." << std::endl;
         return false;
     }
 
-    // Check UNIQUE constraint (this would require additional logic to check existing data)
-    if (column.isUnique) {
-        std::cerr << "Error: UNIQUE constraint validation not implemented yet." << std::endl;
+    // Check datatype: an INT fits a DOUBLE column, everything else must match;
+    // a DOUBLE must be finite, as validateColumnBatch requires
+    ValueType expected = columnValueType(column.type);
+    bool fits = value.isNull() || value.type() == expected ||
+                (expected == ValueType::DOUBLE && value.type() == ValueType::INT);
+    if (fits && value.type() == ValueType::DOUBLE) {
+        fits = std::isfinite(value.asDouble());
+    } else if (fits && value.type() == ValueType::STRING && column.type == ColumnType::CHAR) {
+        fits = value.asString().size() <= column.length;
+    } else if (fits && value.type() == ValueType::STRING && column.type == ColumnType::VARCHAR && column.length > 0) {
+        fits = value.asString().size() <= column.length;
     }
-
-    // Check datatype (basic validation)
-    if (column.datatype == "INT" && !std::all_of(value.begin(), value.end(), ::isdigit)) {
-        std::cerr << "Error: Invalid value '" << value << "' for column '" << columnName << "' of type INT." << std::endl;
+    if (!fits) {
+        std::cerr << "Error: Invalid value " << value << " for column '" << columnName << "' of type " << column.datatype << "." << std::endl;
         return false;
     }
 
+    // Check UNIQUE constraint against the stored keys
+    if ((column.isUnique || column.isPrimaryKey) && existing && !value.isNull()) {
+        uint64_t found = 0;
+        existing->probe(&value, 1, &found);
+        if (found) {
+            std::cerr << "Error: Duplicate value " << value << " for UNIQUE column '" << columnName << "'." << std::endl;
+            return false;
+        }
+    }
 
     return true;
 }
 
 // Print the schema (for debugging)
 void DatabaseSchema::printSchema() const {
-    for (const auto& [tableName, table] : tables) {
-        std::cout << "Table: " << tableName << std::endl;
-        for (const auto& [columnName, column] : table.columns) {
-            std::cout << "  Column: " << columnName
+    epochGuard guard;
+    const schemaSnapshot* snapshot = current.load(std::memory_order_seq_cst);
+    auto all = snapshot->allTables();
+
+    for (const auto& [tableName, table] : all) {
+        std::cout << "Table: " << tableName << " (Storage: " << tableStorageToString(table->storage) << ")" << std::endl;
+        for (const Column& column : table->columns) {
+            std::cout << "  Column: " << column.name
                       << " (Type: " << column.datatype
                       << ", PrimaryKey: " << column.isPrimaryKey
                       << ", Unique: " << column.isUnique
                       << ", NotNull: " << column.isNotNull << ")" << std::endl;
         }
-        for (const auto& [colName, ref] : table.foreignKeys) {
+        for (const auto& [colName, ref] : table->foreignKeys) {
             std::cout << "  ForeignKey: " << colName << " -> " << ref << std::endl;
         }
+        for (const IndexDefinition& index : snapshot->indexes) {
+            if (index.table != tableName) continue;
+            std::cout << "  Index: " << index.name << " (" << index.column << ") USING " << indexMethodToString(index.method) << std::endl;
+        }
     }
-}
\ No newline at end of file
+}
@@ -0,0 +1,691 @@
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <iostream>
+#include <thread>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include "../../include/storage/bTreeIndex.hpp"
+#include "../../include/storage/pageIo.hpp"
+
+namespace {
+
+constexpr char INDEX_MAGIC[8] = {'M', 'S', 'Q', 'L', 'B', 'T', 'R', '\0'};
+
+struct indexHeader {
+    char magic[8];
+    uint32_t root;
+    uint32_t pageCount;
+    uint32_t keyWidth;
+    uint8_t columnType;
+    uint8_t clean;        // 0 while changes may be missing from the file
+    uint16_t reserved;
+    uint64_t keyCount;
+};
+
+struct nodeHeader {
+    uint8_t leaf;
+    uint8_t reserved;
+    uint16_t count;
+    uint32_t link;        // leaf: right sibling (0 = none); inner: leftmost child
+    uint64_t reserved2;
+};
+
+// Version latch: bit 1 set while a writer holds the node, and every unlock
+// moves the version on, so a reader that saw the same unlocked version
+// before and after reading a node read a consistent node
+constexpr uint64_t LOCKED = 2;
+
+bool readLock(const std::atomic<uint64_t>& latch, uint64_t& version) {
+    version = latch.load(std::memory_order_acquire);
+    return (version & LOCKED) == 0;
+}
+
+bool validate(const std::atomic<uint64_t>& latch, uint64_t version) {
+    std::atomic_thread_fence(std::memory_order_acquire);
+    return latch.load(std::memory_order_relaxed) == version;
+}
+
+bool upgrade(std::atomic<uint64_t>& latch, uint64_t version) {
+    return latch.compare_exchange_strong(version, version + LOCKED, std::memory_order_acquire);
+}
+
+void unlock(std::atomic<uint64_t>& latch) {
+    latch.fetch_add(LOCKED, std::memory_order_release);
+}
+
+void backoff(unsigned attempt) {
+    if (attempt > 8) std::this_thread::yield();
+}
+
+nodeHeader headerOf(const char* node) {
+    nodeHeader header;
+    std::memcpy(&header, node, sizeof(header));
+    return header;
+}
+
+void setHeader(char* node, const nodeHeader& header) {
+    std::memcpy(node, &header, sizeof(header));
+}
+
+void storeBigEndian(uint64_t value, char* out, size_t bytes) {
+    for (size_t i = 0; i < bytes; i++) out[i] = static_cast<char>(value >> (8 * (bytes - 1 - i)));
+}
+
+uint64_t packRid(recordId rid) {
+    return (uint64_t(rid.page) << 16) | rid.slot;
+}
+
+recordId unpackRid(uint64_t value) {
+    return {static_cast<uint32_t>(value >> 16), static_cast<uint16_t>(value & 0xFFFF)};
+}
+
+// Entries of a node; counts read without a lock are clamped so a torn read
+// stays inside the page until validation rejects it
+struct nodeView {
+    char* node;
+    uint32_t keyWidth;
+    uint32_t entryBytes;
+    uint32_t count;
+
+    nodeView(const char* data, uint32_t keyWidth, uint32_t entryBytes, uint32_t capacity)
+        : node(const_cast<char*>(data)), keyWidth(keyWidth), entryBytes(entryBytes),
+          count(std::min<uint32_t>(headerOf(data).count, capacity)) {}
+
+    char* key(uint32_t i) const { return node + sizeof(nodeHeader) + static_cast<size_t>(i) * entryBytes; }
+
+    uint64_t value(uint32_t i) const {
+        uint64_t v;
+        std::memcpy(&v, key(i) + keyWidth, sizeof(v));
+        return v;
+    }
+
+    void set(uint32_t i, const char* k, uint64_t v) const {
+        std::memcpy(key(i), k, keyWidth);
+        std::memcpy(key(i) + keyWidth, &v, sizeof(v));
+    }
+
+    // First entry whose key is >= k (or > k when after)
+    uint32_t search(const char* k, bool after) const {
+        uint32_t lo = 0;
+        uint32_t hi = count;
+        while (lo < hi) {
+            uint32_t mid = lo + (hi - lo) / 2;
+            int cmp = std::memcmp(key(mid), k, keyWidth);
+            if (cmp < 0 || (after && cmp == 0)) lo = mid + 1; else hi = mid;
+        }
+        return lo;
+    }
+
+    // Inner node: the child whose keys include k; nullptr = leftmost
+    uint32_t child(const char* k) const {
+        uint32_t i = k ? search(k, true) : 0;
+        return i == 0 ? headerOf(node).link : static_cast<uint32_t>(value(i - 1));
+    }
+};
+
+} // namespace
+
+bool bTreeIndex::supports(const Column& column) {
+    switch (column.type) {
+        case ColumnType::INT:
+        case ColumnType::DOUBLE:
+        case ColumnType::BOOLEAN:
+        case ColumnType::DATE:
+            return true;
+        case ColumnType::CHAR:
+        case ColumnType::VARCHAR:
+            return column.length > 0 && column.length <= MAX_KEY;
+        default:
+            return false;
+    }
+}
+
+bTreeIndex::bTreeIndex(const std::string& path, const Column& column, bufferPool& pool)
+    : path(path), column(column), pool(pool),
+      latches(new std::atomic<std::atomic<uint64_t>*>[LATCH_CHUNKS]()) {
+    if (!supports(column)) {
+        std::cerr << "Error: Column '" << column.name << "' of type " << column.datatype << " cannot be indexed." << std::endl;
+        return;
+    }
+    keyWidth = column.type == ColumnType::CHAR || column.type == ColumnType::VARCHAR ? column.length : column.width;
+    entryBytes = keyWidth + sizeof(uint64_t);
+    capacity = static_cast<uint32_t>((PAGE_SIZE - sizeof(nodeHeader)) / entryBytes);
+
+    fd = ::open(path.c_str(), O_RDWR | O_CREAT, 0644);
+    if (fd < 0) {
+        std::cerr << "Error: Cannot open index file '" << path << "'." << std::endl;
+        return;
+    }
+
+    struct stat st;
+    bool ok = fstat(fd, &st) == 0;
+    uint32_t pageCount = 0;
+    if (ok && st.st_size == 0) {
+        // Header page and an empty root leaf
+        created = true;
+        std::unique_ptr<char[]> node(new char[PAGE_SIZE]());
+        setHeader(node.get(), nodeHeader{1, 0, 0, 0, 0});
+        root = 1;
+        pageCount = 2;
+        ok = pwriteAll(fd, node.get(), PAGE_SIZE, PAGE_SIZE);
+        pages = pageCount;
+        ok = ok && writeHeader(true) && fsync(fd) == 0;
+    } else if (ok) {
+        indexHeader header;
+        ok = preadAll(fd, reinterpret_cast<char*>(&header), sizeof(header), 0) &&
+             std::memcmp(header.magic, INDEX_MAGIC, sizeof(INDEX_MAGIC)) == 0 &&
+             header.keyWidth == keyWidth && header.columnType == static_cast<uint8_t>(column.type);
+        unclean = ok && !header.clean;
+        ok = ok && header.clean && header.root > 0 && header.root < header.pageCount &&
+             static_cast<uint64_t>(st.st_size) >= static_cast<uint64_t>(header.pageCount) * PAGE_SIZE;
+        if (ok) {
+            root = header.root;
+            pageCount = header.pageCount;
+            keyCount = header.keyCount;
+        }
+    }
+    if (ok && pageCount > LATCH_CHUNK * LATCH_CHUNKS) ok = false;
+    if (!ok) {
+        // An unclean file is expected after a crash; the owner rebuilds it
+        if (!unclean) std::cerr << "Error: Index file '" << path << "' is damaged or belongs to another column." << std::endl;
+        ::close(fd);
+        fd = -1;
+        return;
+    }
+
+    for (uint32_t chunk = 0; chunk * LATCH_CHUNK < pageCount; chunk++) {
+        latches[chunk].store(new std::atomic<uint64_t>[LATCH_CHUNK](), std::memory_order_relaxed);
+    }
+    pages = pageCount;
+}
+
+bTreeIndex::~bTreeIndex() {
+    if (fd >= 0) {
+        flush();
+        pool.drop(this);
+        ::close(fd);
+    }
+    for (uint32_t chunk = 0; chunk < LATCH_CHUNKS; chunk++) delete[] latches[chunk].load(std::memory_order_relaxed);
+}
+
+bool bTreeIndex::readPage(uint32_t page, char* data) const {
+    return preadAll(fd, data, PAGE_SIZE, static_cast<off_t>(page) * PAGE_SIZE);
+}
+
+bool bTreeIndex::writePage(uint32_t page, const char* data) const {
+    return pwriteAll(fd, data, PAGE_SIZE, static_cast<off_t>(page) * PAGE_SIZE);
+}
+
+bool bTreeIndex::writeHeader(bool clean) const {
+    std::unique_ptr<char[]> page(new char[PAGE_SIZE]());
+    indexHeader header{};
+    std::memcpy(header.magic, INDEX_MAGIC, sizeof(INDEX_MAGIC));
+    header.root = root.load(std::memory_order_acquire);
+    header.pageCount = pages.load(std::memory_order_acquire);
+    header.keyWidth = keyWidth;
+    header.columnType = static_cast<uint8_t>(column.type);
+    header.clean = clean;
+    header.keyCount = keyCount.load(std::memory_order_relaxed);
+    std::memcpy(page.get(), &header, sizeof(header));
+    return pwriteAll(fd, page.get(), PAGE_SIZE, 0);
+}
+
+bool bTreeIndex::markChanged() {
+    // Before the first change reaches the file, say the file may be stale;
+    // opening it then fails until the next flush
+    if (changed.load(std::memory_order_acquire)) return true;
+    std::lock_guard<std::mutex> lock(allocateMutex);
+    if (changed.load(std::memory_order_relaxed)) return true;
+    if (!writeHeader(false) || fsync(fd) != 0) {
+        std::cerr << "Error: Cannot write index file '" << path << "'." << std::endl;
+        return false;
+    }
+    changed.store(true, std::memory_order_release);
+    return true;
+}
+
+bool bTreeIndex::flush() {
+    if (fd < 0) return false;
+    if (!changed.load(std::memory_order_acquire)) return true;
+    if (!pool.flush(this) || fsync(fd) != 0 || !writeHeader(true) || fsync(fd) != 0) {
+        std::cerr << "Error: Cannot sync index file '" << path << "'." << std::endl;
+        return false;
+    }
+    changed.store(false, std::memory_order_release);
+    return true;
+}
+
+std::atomic<uint64_t>* bTreeIndex::latch(uint32_t page) const {
+    // A page number read from a node being changed may be garbage
+    if (page == 0 || page >= pages.load(std::memory_order_acquire)) return nullptr;
+    return &latches[page / LATCH_CHUNK].load(std::memory_order_acquire)[page % LATCH_CHUNK];
+}
+
+bool bTreeIndex::allocate(pageHandle& handle) {
+    std::lock_guard<std::mutex> lock(allocateMutex);
+    uint32_t page = pages.load(std::memory_order_relaxed);
+    if (page >= LATCH_CHUNK * LATCH_CHUNKS) {
+        std::cerr << "Error: Index file '" << path << "' is full." << std::endl;
+        return false;
+    }
+    if (page % LATCH_CHUNK == 0 && !latches[page / LATCH_CHUNK].load(std::memory_order_relaxed)) {
+        latches[page / LATCH_CHUNK].store(new std::atomic<uint64_t>[LATCH_CHUNK](), std::memory_order_release);
+    }
+    handle = pool.create(this, page);
+    if (!handle) return false;
+    pages.store(page + 1, std::memory_order_release);
+    return true;
+}
+
+bool bTreeIndex::encodeKey(const Value& key, char* out) const {
+    switch (column.type) {
+        case ColumnType::INT:
+            if (key.type() != ValueType::INT) return false;
+            storeBigEndian(static_cast<uint64_t>(key.asInt()) ^ (uint64_t(1) << 63), out, 8);
+            return true;
+        case ColumnType::DOUBLE: {
+            if (!key.isNumeric()) return false;
+            double v = key.asDouble();
+            if (std::isnan(v)) return false;
+            if (v == 0) v = 0; // -0.0 and 0.0 are one key
+            uint64_t bits;
+            std::memcpy(&bits, &v, sizeof(bits));
+            bits = (bits >> 63) ? ~bits : bits | (uint64_t(1) << 63);
+            storeBigEndian(bits, out, 8);
+            return true;
+        }
+        case ColumnType::BOOLEAN:
+            if (key.type() != ValueType::BOOLEAN) return false;
+            out[0] = key.asBool() ? 1 : 0;
+            return true;
+        case ColumnType::DATE:
+            if (key.type() != ValueType::DATE) return false;
+            storeBigEndian(static_cast<uint32_t>(key.asDate()) ^ (uint32_t(1) << 31), out, 4);
+            return true;
+        case ColumnType::CHAR:
+        case ColumnType::VARCHAR: {
+            if (key.type() != ValueType::STRING || key.asString().size() > keyWidth) return false;
+            std::string_view text = key.asString();
+            std::memcpy(out, text.data(), text.size());
+            std::memset(out + text.size(), 0, keyWidth - text.size());
+            return true;
+        }
+        default:
+            return false;
+    }
+}
+
+int bTreeIndex::findLeaf(const char* key, pageHandle& leaf, uint64_t& version) const {
+    uint32_t page = root.load(std::memory_order_acquire);
+    std::atomic<uint64_t>* nodeLatch = latch(page);
+    if (!nodeLatch || !readLock(*nodeLatch, version) || page != root.load(std::memory_order_acquire)) return 0;
+    pageHandle node = pool.pin(this, page);
+    if (!node) return -1;
+
+    while (!headerOf(node.data()).leaf) {
+        uint32_t child = nodeView(node.data(), keyWidth, entryBytes, capacity).child(key);
+        if (!validate(*nodeLatch, version)) return 0;
+        std::atomic<uint64_t>* childLatch = latch(child);
+        uint64_t childVersion;
+        if (!childLatch || !readLock(*childLatch, childVersion) || !validate(*nodeLatch, version)) return 0;
+        node = pool.pin(this, child);
+        if (!node) return -1;
+        nodeLatch = childLatch;
+        version = childVersion;
+    }
+    leaf = std::move(node);
+    return 1;
+}
+
+bool bTreeIndex::lookup(const Value& key, recordId& rid) const {
+    char encoded[MAX_KEY];
+    if (fd < 0 || key.isNull() || !encodeKey(key, encoded)) return false;
+
+    for (unsigned attempt = 0;; attempt++) {
+        pageHandle leaf;
+        uint64_t version;
+        int result = findLeaf(encoded, leaf, version);
+        if (result < 0) return false;
+        if (result == 0) {
+            backoff(attempt);
+            continue;
+        }
+        nodeView view(leaf.data(), keyWidth, entryBytes, capacity);
+        uint32_t i = view.search(encoded, false);
+        bool found = i < view.count && std::memcmp(view.key(i), encoded, keyWidth) == 0;
+        uint64_t value = found ? view.value(i) : 0;
+        if (!validate(*latch(leaf.page()), version)) {
+            backoff(attempt);
+            continue;
+        }
+        if (found) rid = unpackRid(value);
+        return found;
+    }
+}
+
+void bTreeIndex::probe(const Value* keys, size_t count, uint64_t* found) const {
+    recordId rid;
+    for (size_t i = 0; i < count; i++) {
+        if (lookup(keys[i], rid)) found[i / 64] |= uint64_t(1) << (i % 64);
+    }
+}
+
+void bTreeIndex::splitNode(char* node, char* right, uint32_t rightPage, char* separator) {
+    nodeHeader header = headerOf(node);
+    nodeView left(node, keyWidth, entryBytes, capacity);
+    uint32_t half = left.count / 2;
+    nodeHeader rightHeader{header.leaf, 0, 0, 0, 0};
+
+    std::memcpy(separator, left.key(half), keyWidth);
+    uint32_t first = half;
+    if (header.leaf) {
+        rightHeader.link = header.link;
+        header.link = rightPage;
+    } else {
+        // The middle key moves up; its child becomes the right node's leftmost
+        rightHeader.link = static_cast<uint32_t>(left.value(half));
+        first = half + 1;
+    }
+    rightHeader.count = static_cast<uint16_t>(left.count - first);
+    std::memcpy(right + sizeof(nodeHeader), left.key(first), static_cast<size_t>(rightHeader.count) * entryBytes);
+    header.count = static_cast<uint16_t>(half);
+    setHeader(node, header);
+    setHeader(right, rightHeader);
+}
+
+void bTreeIndex::insertIntoInner(char* node, const char* key, uint32_t child) const {
+    nodeView view(node, keyWidth, entryBytes, capacity);
+    uint32_t i = view.search(key, true);
+    std::memmove(view.key(i + 1), view.key(i), static_cast<size_t>(view.count - i) * entryBytes);
+    view.set(i, key, child);
+    nodeHeader header = headerOf(node);
+    header.count++;
+    setHeader(node, header);
+}
+
+// 1: done, 0: restart, -1: error
+int bTreeIndex::insertOnce(const char* key, recordId rid, indexStatus& status) {
+    uint32_t page = root.load(std::memory_order_acquire);
+    std::atomic<uint64_t>* nodeLatch = latch(page);
+    uint64_t version;
+    if (!nodeLatch || !readLock(*nodeLatch, version) || page != root.load(std::memory_order_acquire)) return 0;
+    pageHandle node = pool.pin(this, page);
+    if (!node) return -1;
+
+    pageHandle parent;
+    std::atomic<uint64_t>* parentLatch = nullptr;
+    uint64_t parentVersion = 0;
+
+    for (;;) {
+        nodeHeader header = headerOf(node.data());
+        if (header.count >= capacity) {
+            // Split a full node now, while its parent is known to have room,
+            // then start over
+            if (parentLatch && !upgrade(*parentLatch, parentVersion)) return 0;
+            if (!upgrade(*nodeLatch, version)) {
+                if (parentLatch) unlock(*parentLatch);
+                return 0;
+            }
+            int result = 1;
+            pageHandle right;
+            pageHandle newRoot;
+            if (!parentLatch && node.page() != root.load(std::memory_order_acquire)) {
+                result = 0;
+            } else if (!allocate(right) || (!parentLatch && !allocate(newRoot))) {
+                result = -1;
+            } else {
+                char separator[MAX_KEY];
+                splitNode(node.data(), right.data(), right.page(), separator);
+                node.markDirty();
+                if (parentLatch) {
+                    insertIntoInner(parent.data(), separator, right.page());
+                    parent.markDirty();
+                } else {
+                    setHeader(newRoot.data(), nodeHeader{0, 0, 1, node.page(), 0});
+                    nodeView(newRoot.data(), keyWidth, entryBytes, capacity).set(0, separator, right.page());
+                    root.store(newRoot.page(), std::memory_order_release);
+                }
+            }
+            unlock(*nodeLatch);
+            if (parentLatch) unlock(*parentLatch);
+            return result < 0 ? -1 : 0;
+        }
+        if (header.leaf) break;
+
+        uint32_t child = nodeView(node.data(), keyWidth, entryBytes, capacity).child(key);
+        if (!validate(*nodeLatch, version)) return 0;
+        std::atomic<uint64_t>* childLatch = latch(child);
+        uint64_t childVersion;
+        if (!childLatch || !readLock(*childLatch, childVersion) || !validate(*nodeLatch, version)) return 0;
+        pageHandle next = pool.pin(this, child);
+        if (!next) return -1;
+        parent = std::move(node);
+        parentLatch = nodeLatch;
+        parentVersion = version;
+        node = std::move(next);
+        nodeLatch = childLatch;
+        version = childVersion;
+    }
+
+    // A leaf with room
+    if (!upgrade(*nodeLatch, version)) return 0;
+    if (parentLatch && !validate(*parentLatch, parentVersion)) {
+        unlock(*nodeLatch);
+        return 0;
+    }
+    nodeView view(node.data(), keyWidth, entryBytes, capacity);
+    uint32_t i = view.search(key, false);
+    if (i < view.count && std::memcmp(view.key(i), key, keyWidth) == 0) {
+        status = indexStatus::DUPLICATE;
+    } else {
+        std::memmove(view.key(i + 1), view.key(i), static_cast<size_t>(view.count - i) * entryBytes);
+        view.set(i, key, packRid(rid));
+        nodeHeader header = headerOf(node.data());
+        header.count++;
+        setHeader(node.data(), header);
+        node.markDirty();
+        keyCount.fetch_add(1, std::memory_order_relaxed);
+        status = indexStatus::OK;
+    }
+    unlock(*nodeLatch);
+    return 1;
+}
+
+indexStatus bTreeIndex::insert(const Value& key, recordId rid) {
+    if (fd < 0) return indexStatus::ERROR;
+    if (key.isNull()) return indexStatus::OK;
+    char encoded[MAX_KEY];
+    if (!encodeKey(key, encoded)) {
+        std::cerr << "Error: Value " << key << " cannot be a key of column '" << column.name << "'." << std::endl;
+        return indexStatus::ERROR;
+    }
+    if (!markChanged()) return indexStatus::ERROR;
+
+    indexStatus status = indexStatus::ERROR;
+    for (unsigned attempt = 0;; attempt++) {
+        int result = insertOnce(encoded, rid, status);
+        if (result > 0) return status;
+        if (result < 0) {
+            std::cerr << "Error: Cannot update index file '" << path << "'." << std::endl;
+            return indexStatus::ERROR;
+        }
+        backoff(attempt);
+    }
+}
+
+int bTreeIndex::eraseOnce(const char* key, bool& erased) {
+    pageHandle leaf;
+    uint64_t version;
+    int result = findLeaf(key, leaf, version);
+    if (result <= 0) return result;
+    std::atomic<uint64_t>* leafLatch = latch(leaf.page());
+    if (!upgrade(*leafLatch, version)) return 0;
+
+    nodeView view(leaf.data(), keyWidth, entryBytes, capacity);
+    uint32_t i = view.search(key, false);
+    erased = i < view.count && std::memcmp(view.key(i), key, keyWidth) == 0;
+    if (erased) {
+        std::memmove(view.key(i), view.key(i + 1), static_cast<size_t>(view.count - i - 1) * entryBytes);
+        nodeHeader header = headerOf(leaf.data());
+        header.count--;
+        setHeader(leaf.data(), header);
+        leaf.markDirty();
+        keyCount.fetch_sub(1, std::memory_order_relaxed);
+    }
+    unlock(*leafLatch);
+    return 1;
+}
+
+bool bTreeIndex::erase(const Value& key) {
+    char encoded[MAX_KEY];
+    if (fd < 0 || key.isNull() || !encodeKey(key, encoded) || !markChanged()) return false;
+
+    bool erased = false;
+    for (unsigned attempt = 0;; attempt++) {
+        int result = eraseOnce(encoded, erased);
+        if (result > 0) return erased;
+        if (result < 0) return false;
+        backoff(attempt);
+    }
+}
+
+uint32_t bTreeIndex::height() const {
+    if (fd < 0) return 0;
+    uint32_t levels = 1;
+    pageHandle node = pool.pin(this, root.load(std::memory_order_acquire));
+    while (node && !headerOf(node.data()).leaf) {
+        node = pool.pin(this, headerOf(node.data()).link);
+        levels++;
+    }
+    return levels;
+}
+
+bool bTreeIndex::boundKey(const Value& bound, bool isLow, bool& inclusive, std::string& out) const {
+    out.assign(keyWidth, '\0');
+    Value key = bound;
+    if (column.type == ColumnType::INT && bound.type() == ValueType::DOUBLE) {
+        // Round inwards: x >= 2.5 is x >= 3, x <= 2.5 is x <= 2
+        double v = bound.asDouble();
+        if (std::isnan(v)) return false;
+        double rounded = isLow ? std::ceil(v) : std::floor(v);
+        if (rounded != v) inclusive = true;
+        if (rounded >= 9223372036854775808.0) {
+            if (isLow) return false;
+            key = Value::integer(INT64_MAX); // past every key
+            inclusive = true;
+        } else if (rounded < -9223372036854775808.0) {
+            if (!isLow) return false;
+            key = Value::integer(INT64_MIN);
+            inclusive = true;
+        } else {
+            key = Value::integer(static_cast<int64_t>(rounded));
+        }
+    } else if ((column.type == ColumnType::CHAR || column.type == ColumnType::VARCHAR) &&
+               bound.type() == ValueType::STRING && bound.asString().size() > keyWidth) {
+        // Every key is at most keyWidth bytes: above the prefix means above the bound
+        key = Value::string(bound.asString().substr(0, keyWidth));
+        inclusive = !isLow;
+    }
+    if (!encodeKey(key, &out[0])) {
+        std::cerr << "Error: Value " << bound << " cannot be compared with column '" << column.name << "'." << std::endl;
+        return false;
+    }
+    return true;
+}
+
+bTreeScan::bTreeScan(const bTreeIndex& index, const Value& low, bool lowInclusive, const Value& high, bool highInclusive)
+    : index(index), lowInclusive(lowInclusive), highInclusive(highInclusive) {
+    hasLow = !low.isNull();
+    hasHigh = !high.isNull();
+    if (!index.isOpen() ||
+        (hasLow && !index.boundKey(low, true, this->lowInclusive, this->low)) ||
+        (hasHigh && !index.boundKey(high, false, this->highInclusive, this->high))) {
+        empty = true;
+    }
+}
+
+bool bTreeScan::fill() {
+    rids.clear();
+    position = 0;
+    const uint32_t keyWidth = index.keyWidth;
+
+    while (!done && rids.empty()) {
+        for (unsigned attempt = 0;; attempt++) {
+            rids.clear();
+            pageHandle leaf;
+            uint64_t version;
+            if (!started) {
+                int result = index.findLeaf(hasLow ? low.data() : nullptr, leaf, version);
+                if (result < 0) {
+                    done = true;
+                    return false;
+                }
+                if (result == 0) {
+                    backoff(attempt);
+                    continue;
+                }
+            } else {
+                std::atomic<uint64_t>* leafLatch = index.latch(nextLeaf);
+                if (!leafLatch) {
+                    done = true;
+                    return false;
+                }
+                if (!readLock(*leafLatch, version)) {
+                    backoff(attempt);
+                    continue;
+                }
+                leaf = index.pool.pin(&index, nextLeaf);
+                if (!leaf) {
+                    done = true;
+                    return false;
+                }
+            }
+
+            // Copy the leaf's rows in range, then check nothing moved meanwhile
+            nodeView view(leaf.data(), keyWidth, index.entryBytes, index.capacity);
+            bool pastHigh = false;
+            uint32_t i = 0;
+            if (hasLast) {
+                i = view.search(last.data(), true);
+            } else if (hasLow) {
+                i = view.search(low.data(), !lowInclusive);
+            }
+            uint32_t end = i;
+            for (; end < view.count; end++) {
+                if (hasHigh) {
+                    int cmp = std::memcmp(view.key(end), high.data(), keyWidth);
+                    if (cmp > 0 || (cmp == 0 && !highInclusive)) {
+                        pastHigh = true;
+                        break;
+                    }
+                }
+                rids.push_back(unpackRid(view.value(end)));
+            }
+            std::string lastKey = end > i ? std::string(view.key(end - 1), keyWidth) : std::string();
+            uint32_t link = headerOf(leaf.data()).link;
+            if (!validate(*index.latch(leaf.page()), version)) {
+                backoff(attempt);
+                continue;
+            }
+
+            started = true;
+            if (!lastKey.empty()) {
+                last = std::move(lastKey);
+                hasLast = true;
+            }
+            nextLeaf = link;
+            done = pastHigh || link == 0;
+            break;
+        }
+    }
+    return !rids.empty();
+}
+
+bool bTreeScan::next(recordId& rid) {
+    if (empty) return false;
+    if (position == rids.size() && !fill()) return false;
+    rid = rids[position++];
+    return true;
+}
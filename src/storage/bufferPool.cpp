@@ -0,0 +1,313 @@
+#include <algorithm>
+#include <cstring>
+#include <iostream>
+#include "../../include/storage/bufferPool.hpp"
+
+struct bufferPool::shard {
+    enum queueKind : uint8_t { FREE, FIFO, MAIN };
+
+    struct frameInfo {
+        pageKey key{nullptr, 0};
+        uint32_t pins = 0;
+        bool dirty = false;
+        queueKind queue = FREE;
+        std::list<uint32_t>::iterator position;
+    };
+
+    std::mutex latch;
+    char* data = nullptr;                   // frames.size() pages
+    std::vector<frameInfo> frames;
+    std::unordered_map<pageKey, uint32_t, pageKeyHash> table;
+    std::list<uint32_t> fifo;               // front: newest
+    std::list<uint32_t> lru;                // front: most recently used
+    std::list<pageKey> ghosts;              // keys recently evicted from fifo, front: newest
+    std::unordered_map<pageKey, std::list<pageKey>::iterator, pageKeyHash> ghostIndex;
+    std::vector<uint32_t> freeFrames;
+    size_t fifoTarget = 1;
+    size_t ghostLimit = 1;
+    bufferPoolStats counters;
+
+    char* frameData(uint32_t frame) { return data + static_cast<size_t>(frame) * PAGE_SIZE; }
+
+    void enqueue(uint32_t frame, queueKind queue) {
+        std::list<uint32_t>& list = queue == FIFO ? fifo : lru;
+        list.push_front(frame);
+        frames[frame].queue = queue;
+        frames[frame].position = list.begin();
+    }
+
+    void dequeue(uint32_t frame) {
+        frameInfo& info = frames[frame];
+        if (info.queue == FIFO) fifo.erase(info.position);
+        if (info.queue == MAIN) lru.erase(info.position);
+        info.queue = FREE;
+    }
+
+    void remember(const pageKey& key) {
+        ghosts.push_front(key);
+        ghostIndex[key] = ghosts.begin();
+        if (ghosts.size() > ghostLimit) {
+            ghostIndex.erase(ghosts.back());
+            ghosts.pop_back();
+        }
+    }
+
+    bool forget(const pageKey& key) {
+        auto it = ghostIndex.find(key);
+        if (it == ghostIndex.end()) return false;
+        ghosts.erase(it->second);
+        ghostIndex.erase(it);
+        return true;
+    }
+
+    // Oldest unpinned frame of list, or -1
+    long oldestUnpinned(const std::list<uint32_t>& list) const {
+        for (auto it = list.rbegin(); it != list.rend(); ++it) {
+            if (frames[*it].pins == 0) return *it;
+        }
+        return -1;
+    }
+
+    bool writeBack(uint32_t frame) {
+        frameInfo& info = frames[frame];
+        if (!info.dirty) return true;
+        if (!info.key.file->writePage(info.key.page, frameData(frame))) {
+            std::cerr << "Error: Cannot write back page " << info.key.page << "." << std::endl;
+            return false;
+        }
+        info.dirty = false;
+        counters.writeBacks++;
+        return true;
+    }
+
+    // A frame to load into: a free one, else an evicted one; -1 if all are pinned
+    long claimFrame() {
+        if (!freeFrames.empty()) {
+            uint32_t frame = freeFrames.back();
+            freeFrames.pop_back();
+            return frame;
+        }
+
+        // Drain the FIFO while it is over target, otherwise the LRU
+        bool fromFifo = fifo.size() > fifoTarget || lru.empty();
+        long victim = oldestUnpinned(fromFifo ? fifo : lru);
+        if (victim < 0) victim = oldestUnpinned(fromFifo ? lru : fifo);
+        if (victim < 0) return -1;
+
+        uint32_t frame = static_cast<uint32_t>(victim);
+        if (!writeBack(frame)) return -1;
+        frameInfo& info = frames[frame];
+        if (info.queue == FIFO) remember(info.key);
+        dequeue(frame);
+        table.erase(info.key);
+        counters.evictions++;
+        return frame;
+    }
+
+    void release(uint32_t frame) {
+        dequeue(frame);
+        table.erase(frames[frame].key);
+        frames[frame] = frameInfo();
+        freeFrames.push_back(frame);
+    }
+};
+
+pageHandle& pageHandle::operator=(pageHandle&& other) noexcept {
+    if (this != &other) {
+        release();
+        pool = other.pool;
+        frameData = other.frameData;
+        shard = other.shard;
+        frame = other.frame;
+        pageNo = other.pageNo;
+        dirty = other.dirty;
+        other.pool = nullptr;
+        other.frameData = nullptr;
+    }
+    return *this;
+}
+
+void pageHandle::release() {
+    if (!pool) return;
+    pool->unpin(shard, frame, dirty);
+    pool = nullptr;
+    frameData = nullptr;
+    dirty = false;
+}
+
+bufferPool::bufferPool(size_t frameCount, evictionPolicy policy, size_t shardCount) : policy(policy) {
+    frameCount = std::max<size_t>(frameCount, 1);
+    shardCount = std::min(std::max<size_t>(shardCount, 1), frameCount);
+    memory.reset(new char[frameCount * PAGE_SIZE]);
+
+    size_t next = 0;
+    for (size_t s = 0; s < shardCount; s++) {
+        size_t frames = frameCount / shardCount + (s < frameCount % shardCount ? 1 : 0);
+        auto part = std::make_unique<shard>();
+        part->data = memory.get() + next * PAGE_SIZE;
+        part->frames.resize(frames);
+        part->table.reserve(frames);
+        part->freeFrames.reserve(frames);
+        for (size_t f = frames; f-- > 0;) part->freeFrames.push_back(static_cast<uint32_t>(f));
+        part->fifoTarget = std::max<size_t>(frames / 4, 1);
+        part->ghostLimit = std::max<size_t>(frames / 2, 1);
+        shards.push_back(std::move(part));
+        next += frames;
+    }
+}
+
+bufferPool::~bufferPool() = default;
+
+size_t bufferPool::frameCount() const {
+    size_t total = 0;
+    for (const auto& part : shards) total += part->frames.size();
+    return total;
+}
+
+pageHandle bufferPool::pin(const pagedFile* file, uint32_t page) {
+    return fetch(file, page, true);
+}
+
+pageHandle bufferPool::create(const pagedFile* file, uint32_t page) {
+    return fetch(file, page, false);
+}
+
+pageHandle bufferPool::fetch(const pagedFile* file, uint32_t page, bool read) {
+    pageKey key{file, page};
+    uint32_t shardIndex = static_cast<uint32_t>(pageKeyHash()(key) % shards.size());
+    shard& part = *shards[shardIndex];
+    std::lock_guard<std::mutex> lock(part.latch);
+
+    pageHandle handle;
+    handle.pool = this;
+    handle.shard = shardIndex;
+    handle.pageNo = page;
+
+    auto it = part.table.find(key);
+    if (it != part.table.end()) {
+        uint32_t frame = it->second;
+        shard::frameInfo& info = part.frames[frame];
+        if (info.queue == shard::FIFO) {
+            part.dequeue(frame); // touched again: part of the working set
+            part.enqueue(frame, shard::MAIN);
+        } else if (info.position != part.lru.begin()) {
+            part.lru.splice(part.lru.begin(), part.lru, info.position);
+        }
+        info.pins++;
+        if (read) part.counters.hits++;
+        handle.frame = frame;
+        handle.frameData = part.frameData(frame);
+        return handle;
+    }
+
+    if (read) part.counters.misses++;
+    long claimed = part.claimFrame();
+    if (claimed < 0) {
+        std::cerr << "Error: Every buffer frame is pinned." << std::endl;
+        handle.pool = nullptr;
+        return handle;
+    }
+    uint32_t frame = static_cast<uint32_t>(claimed);
+    char* data = part.frameData(frame);
+    if (read) {
+        if (!file->readPage(page, data)) {
+            part.frames[frame] = shard::frameInfo();
+            part.freeFrames.push_back(frame);
+            std::cerr << "Error: Cannot read page " << page << "." << std::endl;
+            handle.pool = nullptr;
+            return handle;
+        }
+    } else {
+        std::memset(data, 0, PAGE_SIZE);
+    }
+
+    shard::frameInfo& info = part.frames[frame];
+    info.key = key;
+    info.pins = 1;
+    info.dirty = !read;
+    part.table.emplace(key, frame);
+    bool seenBefore = part.forget(key);
+    part.enqueue(frame, policy == evictionPolicy::LRU || seenBefore ? shard::MAIN : shard::FIFO);
+
+    handle.frame = frame;
+    handle.frameData = data;
+    return handle;
+}
+
+void bufferPool::unpin(uint32_t shardIndex, uint32_t frame, bool dirty) {
+    shard& part = *shards[shardIndex];
+    std::lock_guard<std::mutex> lock(part.latch);
+    shard::frameInfo& info = part.frames[frame];
+    info.pins--;
+    info.dirty |= dirty;
+}
+
+bool bufferPool::flush(const pagedFile* file) {
+    bool ok = true;
+    for (auto& part : shards) {
+        std::lock_guard<std::mutex> lock(part->latch);
+        for (uint32_t frame = 0; frame < part->frames.size(); frame++) {
+            if (part->frames[frame].key.file == file) ok &= part->writeBack(frame);
+        }
+    }
+    return ok;
+}
+
+bool bufferPool::flushPage(const pagedFile* file, uint32_t page) {
+    pageKey key{file, page};
+    shard& part = *shards[pageKeyHash()(key) % shards.size()];
+    std::lock_guard<std::mutex> lock(part.latch);
+    auto it = part.table.find(key);
+    if (it == part.table.end() || part.frames[it->second].pins != 0) return true;
+    return part.writeBack(it->second);
+}
+
+bool bufferPool::drop(const pagedFile* file) {
+    bool ok = true;
+    for (auto& part : shards) {
+        std::lock_guard<std::mutex> lock(part->latch);
+        for (uint32_t frame = 0; frame < part->frames.size(); frame++) {
+            shard::frameInfo& info = part->frames[frame];
+            if (info.key.file != file || info.queue == shard::FREE) continue;
+            if (info.pins != 0) {
+                std::cerr << "Error: Dropping a file with page " << info.key.page << " still pinned." << std::endl;
+                ok = false;
+                continue;
+            }
+            if (!part->writeBack(frame)) {
+                ok = false;
+                continue;
+            }
+            part->release(frame);
+        }
+        // The file's address may be reused by another file
+        for (auto it = part->ghosts.begin(); it != part->ghosts.end();) {
+            if (it->file == file) {
+                part->ghostIndex.erase(*it);
+                it = part->ghosts.erase(it);
+            } else {
+                ++it;
+            }
+        }
+    }
+    return ok;
+}
+
+bufferPoolStats bufferPool::stats() const {
+    bufferPoolStats total;
+    for (const auto& part : shards) {
+        std::lock_guard<std::mutex> lock(part->latch);
+        total.hits += part->counters.hits;
+        total.misses += part->counters.misses;
+        total.evictions += part->counters.evictions;
+        total.writeBacks += part->counters.writeBacks;
+    }
+    return total;
+}
+
+void bufferPool::resetStats() {
+    for (auto& part : shards) {
+        std::lock_guard<std::mutex> lock(part->latch);
+        part->counters = bufferPoolStats();
+    }
+}
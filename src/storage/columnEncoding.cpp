@@ -0,0 +1,226 @@
+#include <algorithm>
+#include <cstring>
+#include <unordered_map>
+#include <vector>
+#include "../../include/storage/columnEncoding.hpp"
+
+namespace {
+
+bool isVariable(ColumnType type) {
+    return type == ColumnType::VARCHAR || type == ColumnType::TEXT;
+}
+
+bool isNull(const chunkValues& values, uint32_t row) {
+    return (values.nulls[row / 64] >> (row % 64)) & 1;
+}
+
+void align(std::string& out) {
+    out.resize((out.size() + 7) / 8 * 8, '\0');
+}
+
+size_t alignUp(size_t bytes) {
+    return (bytes + 7) / 8 * 8;
+}
+
+template <typename T>
+void put(std::string& out, T value) {
+    out.append(reinterpret_cast<const char*>(&value), sizeof(value));
+}
+
+int64_t integerAt(const chunkValues& values, uint32_t row) {
+    if (values.column->type == ColumnType::DATE) {
+        int32_t v;
+        std::memcpy(&v, values.fixed + static_cast<size_t>(row) * 4, sizeof(v));
+        return v;
+    }
+    int64_t v;
+    std::memcpy(&v, values.fixed + static_cast<size_t>(row) * 8, sizeof(v));
+    return v;
+}
+
+size_t plainSize(const chunkValues& values) {
+    if (isVariable(values.column->type)) return (values.rows + 1) * sizeof(uint32_t) + values.offsets[values.rows];
+    return static_cast<size_t>(values.rows) * values.column->width;
+}
+
+void writePlain(const chunkValues& values, std::string& out) {
+    if (isVariable(values.column->type)) {
+        out.append(reinterpret_cast<const char*>(values.offsets), (values.rows + 1) * sizeof(uint32_t));
+        out.append(values.text, values.offsets[values.rows]);
+    } else {
+        out.append(values.fixed, static_cast<size_t>(values.rows) * values.column->width);
+    }
+}
+
+} // namespace
+
+const char* chunkEncodingToString(chunkEncoding encoding) {
+    switch (encoding) {
+        case chunkEncoding::PLAIN:              return "PLAIN";
+        case chunkEncoding::DICTIONARY:         return "DICTIONARY";
+        case chunkEncoding::RUN_LENGTH:         return "RUN_LENGTH";
+        case chunkEncoding::FRAME_OF_REFERENCE: return "FRAME_OF_REFERENCE";
+        default:                                return "UNKNOWN";
+    }
+}
+
+uint32_t bitWidth(uint64_t maxValue) {
+    return maxValue == 0 ? 0 : 64 - static_cast<uint32_t>(__builtin_clzll(maxValue));
+}
+
+void packBits(const uint64_t* values, size_t count, uint32_t width, uint64_t* out) {
+    std::memset(out, 0, packedWords(count, width) * sizeof(uint64_t));
+    if (width == 0) return;
+    for (size_t i = 0; i < count; i++) {
+        size_t bit = i * width;
+        size_t word = bit / 64;
+        uint32_t shift = static_cast<uint32_t>(bit % 64);
+        out[word] |= values[i] << shift;
+        if (shift + width > 64) out[word + 1] |= values[i] >> (64 - shift);
+    }
+}
+
+std::string_view chunkValues::string(uint32_t row) const {
+    if (isVariable(column->type)) return std::string_view(text + offsets[row], offsets[row + 1] - offsets[row]);
+    const char* slot = fixed + static_cast<size_t>(row) * column->width;
+    size_t length = column->length;
+    while (length > 0 && slot[length - 1] == '\0') length--;
+    return std::string_view(slot, length);
+}
+
+chunkEncoding encodeChunk(const chunkValues& values, bool compress, std::string& out, uint8_t& width) {
+    width = 0;
+    ColumnType type = values.column->type;
+    size_t best = plainSize(values);
+    chunkEncoding choice = chunkEncoding::PLAIN;
+    if (!compress || values.rows == 0) {
+        writePlain(values, out);
+        return choice;
+    }
+
+    bool strings = type == ColumnType::CHAR || isVariable(type);
+    bool integers = type == ColumnType::INT || type == ColumnType::DATE;
+
+    // Dictionary: sorted distinct strings, so codes keep the values' order
+    std::vector<std::string_view> dictionary;
+    if (strings) {
+        std::unordered_map<std::string_view, uint32_t> distinct;
+        size_t dictionaryBytes = 0;
+        for (uint32_t row = 0; row < values.rows; row++) {
+            if (isNull(values, row)) continue;
+            std::string_view text = values.string(row);
+            if (distinct.emplace(text, 0).second) {
+                dictionary.push_back(text);
+                dictionaryBytes += text.size();
+            }
+        }
+        uint32_t codeWidth = bitWidth(dictionary.empty() ? 0 : dictionary.size() - 1);
+        size_t size = 8 + alignUp((dictionary.size() + 1) * sizeof(uint32_t)) + alignUp(dictionaryBytes) +
+                      packedWords(values.rows, codeWidth) * sizeof(uint64_t);
+        if (!dictionary.empty() && size < best) { // all NULL: nothing to code
+            best = size;
+            choice = chunkEncoding::DICTIONARY;
+            width = static_cast<uint8_t>(codeWidth);
+        }
+    }
+
+    // Runs of equal fixed-width values
+    size_t runs = 0;
+    if (!isVariable(type)) {
+        uint32_t valueWidth = values.column->width;
+        runs = 1;
+        for (uint32_t row = 1; row < values.rows; row++) {
+            runs += std::memcmp(values.fixed + static_cast<size_t>(row) * valueWidth,
+                                values.fixed + static_cast<size_t>(row - 1) * valueWidth, valueWidth) != 0;
+        }
+        size_t size = 8 + alignUp(runs * sizeof(uint32_t)) + alignUp(runs * valueWidth);
+        if (size < best) {
+            best = size;
+            choice = chunkEncoding::RUN_LENGTH;
+            width = 0;
+        }
+    }
+
+    // Frame of reference: differences from the minimum, bit packed
+    int64_t base = 0;
+    if (integers) {
+        bool any = false;
+        int64_t high = 0;
+        for (uint32_t row = 0; row < values.rows; row++) {
+            if (isNull(values, row)) continue;
+            int64_t v = integerAt(values, row);
+            if (!any || v < base) base = v;
+            if (!any || v > high) high = v;
+            any = true;
+        }
+        uint32_t differenceWidth = bitWidth(static_cast<uint64_t>(high) - static_cast<uint64_t>(base));
+        size_t size = 8 + packedWords(values.rows, differenceWidth) * sizeof(uint64_t);
+        if (size < best) {
+            best = size;
+            choice = chunkEncoding::FRAME_OF_REFERENCE;
+            width = static_cast<uint8_t>(differenceWidth);
+        }
+    }
+
+    switch (choice) {
+        case chunkEncoding::DICTIONARY: {
+            std::sort(dictionary.begin(), dictionary.end());
+            std::unordered_map<std::string_view, uint32_t> codes;
+            codes.reserve(dictionary.size());
+            put<uint32_t>(out, static_cast<uint32_t>(dictionary.size()));
+            put<uint32_t>(out, 0);
+            uint32_t offset = 0;
+            for (uint32_t i = 0; i < dictionary.size(); i++) {
+                codes.emplace(dictionary[i], i);
+                put<uint32_t>(out, offset);
+                offset += static_cast<uint32_t>(dictionary[i].size());
+            }
+            put<uint32_t>(out, offset);
+            align(out);
+            for (std::string_view text : dictionary) out.append(text);
+            align(out);
+
+            std::vector<uint64_t> rowCodes(values.rows, 0);
+            for (uint32_t row = 0; row < values.rows; row++) {
+                if (!isNull(values, row)) rowCodes[row] = codes[values.string(row)];
+            }
+            std::vector<uint64_t> packed(packedWords(values.rows, width));
+            packBits(rowCodes.data(), values.rows, width, packed.data());
+            out.append(reinterpret_cast<const char*>(packed.data()), packed.size() * sizeof(uint64_t));
+            break;
+        }
+        case chunkEncoding::RUN_LENGTH: {
+            uint32_t valueWidth = values.column->width;
+            put<uint32_t>(out, static_cast<uint32_t>(runs));
+            put<uint32_t>(out, 0);
+            std::string runValues;
+            for (uint32_t row = 1; row <= values.rows; row++) {
+                if (row == values.rows ||
+                    std::memcmp(values.fixed + static_cast<size_t>(row) * valueWidth,
+                                values.fixed + static_cast<size_t>(row - 1) * valueWidth, valueWidth) != 0) {
+                    put<uint32_t>(out, row); // end of the run
+                    runValues.append(values.fixed + static_cast<size_t>(row - 1) * valueWidth, valueWidth);
+                }
+            }
+            align(out);
+            out += runValues;
+            align(out);
+            break;
+        }
+        case chunkEncoding::FRAME_OF_REFERENCE: {
+            put<int64_t>(out, base);
+            std::vector<uint64_t> differences(values.rows, 0);
+            for (uint32_t row = 0; row < values.rows; row++) {
+                if (!isNull(values, row)) differences[row] = static_cast<uint64_t>(integerAt(values, row)) - static_cast<uint64_t>(base);
+            }
+            std::vector<uint64_t> packed(packedWords(values.rows, width));
+            packBits(differences.data(), values.rows, width, packed.data());
+            out.append(reinterpret_cast<const char*>(packed.data()), packed.size() * sizeof(uint64_t));
+            break;
+        }
+        default:
+            writePlain(values, out);
+            break;
+    }
+    return choice;
+}
@@ -0,0 +1,167 @@
+#include <algorithm>
+#include "../../include/storage/hashIndex.hpp"
+
+hashIndex::hashIndex(const Column& column) : column(column) {
+    segments.emplace_back(new bucket[SEGMENT_BUCKETS]);
+    buckets = INITIAL_BUCKETS;
+    roundSize = INITIAL_BUCKETS;
+}
+
+hashIndex::~hashIndex() {
+    for (size_t i = 0; i < buckets; i++) {
+        bucket* chain = at(i).overflow;
+        while (chain) {
+            bucket* following = chain->overflow;
+            delete chain;
+            chain = following;
+        }
+    }
+}
+
+hashIndex::bucket& hashIndex::at(size_t index) const {
+    return segments[index / SEGMENT_BUCKETS][index % SEGMENT_BUCKETS];
+}
+
+// Buckets before the split pointer were already split this round, so they
+// are addressed with one more bit
+size_t hashIndex::address(uint64_t hash) const {
+    size_t index = hash & (roundSize - 1);
+    if (index < next) index = hash & (roundSize * 2 - 1);
+    return index;
+}
+
+// Add item to the chain's last bucket, opening an overflow bucket when full.
+// Every overflow bucket holds at least one entry.
+void hashIndex::append(bucket& head, const entry& item) {
+    bucket* tail = &head;
+    while (tail->overflow) tail = tail->overflow;
+    if (tail->count == BUCKET_ENTRIES) {
+        tail->overflow = new bucket();
+        tail = tail->overflow;
+    }
+    tail->entries[tail->count++] = item;
+}
+
+void hashIndex::release(Value& key) {
+    if (key.type() == ValueType::STRING && key.asString().size() > Value::INLINE_CAPACITY) {
+        strings.deallocate(const_cast<char*>(key.asString().data()), key.asString().size(), 1);
+    }
+}
+
+void hashIndex::insert(const Value& key, recordId rid) {
+    if (key.isNull()) return;
+    entry item{key.hash(), key.type() == ValueType::STRING ? Value::string(key.asString(), &strings) : key, rid};
+    append(at(address(item.hash)), item);
+    entryCount++;
+    if (entryCount > MAX_LOAD * BUCKET_ENTRIES * buckets) split();
+}
+
+// Divide the bucket under the split pointer between itself and a new last
+// bucket, by the next bit of each entry's hash
+void hashIndex::split() {
+    size_t from = next;
+    size_t to = roundSize + next;
+    if (to / SEGMENT_BUCKETS == segments.size()) segments.emplace_back(new bucket[SEGMENT_BUCKETS]);
+
+    bucket& head = at(from);
+    moving.clear();
+    moving.insert(moving.end(), head.entries, head.entries + head.count);
+    bucket* chain = head.overflow;
+    while (chain) {
+        moving.insert(moving.end(), chain->entries, chain->entries + chain->count);
+        bucket* following = chain->overflow;
+        delete chain;
+        chain = following;
+    }
+    head.count = 0;
+    head.overflow = nullptr;
+
+    buckets++;
+    if (++next == roundSize) {
+        roundSize *= 2;
+        next = 0;
+    }
+    for (const entry& item : moving) append(at(address(item.hash)), item);
+}
+
+bool hashIndex::erase(const Value& key, recordId rid) {
+    if (key.isNull()) return false;
+    uint64_t hash = key.hash();
+    bucket& head = at(address(hash));
+    for (bucket* node = &head; node; node = node->overflow) {
+        for (uint32_t i = 0; i < node->count; i++) {
+            entry& item = node->entries[i];
+            if (item.hash != hash || item.rid != rid || Value::compare(item.key, key) != 0) continue;
+            release(item.key);
+
+            // Fill the hole with the chain's last entry, and drop the last
+            // overflow bucket once it is empty
+            bucket* before = nullptr;
+            bucket* tail = &head;
+            while (tail->overflow) {
+                before = tail;
+                tail = tail->overflow;
+            }
+            item = tail->entries[--tail->count];
+            if (tail->count == 0 && before) {
+                before->overflow = nullptr;
+                delete tail;
+            }
+            entryCount--;
+            return true;
+        }
+    }
+    return false;
+}
+
+size_t hashIndex::find(const Value& key, std::vector<recordId>& rids) const {
+    if (key.isNull()) return 0;
+    uint64_t hash = key.hash();
+    size_t found = 0;
+    for (const bucket* node = &at(address(hash)); node; node = node->overflow) {
+        for (uint32_t i = 0; i < node->count; i++) {
+            const entry& item = node->entries[i];
+            if (item.hash == hash && Value::compare(item.key, key) == 0) {
+                rids.push_back(item.rid);
+                found++;
+            }
+        }
+    }
+    return found;
+}
+
+bool hashIndex::contains(const Value& key) const {
+    if (key.isNull()) return false;
+    uint64_t hash = key.hash();
+    return contains(at(address(hash)), key, hash);
+}
+
+bool hashIndex::contains(const bucket& head, const Value& key, uint64_t hash) const {
+    for (const bucket* node = &head; node; node = node->overflow) {
+        for (uint32_t i = 0; i < node->count; i++) {
+            const entry& item = node->entries[i];
+            if (item.hash == hash && Value::compare(item.key, key) == 0) return true;
+        }
+    }
+    return false;
+}
+
+// Keys are hashed a group at a time and their buckets prefetched, so the
+// cache misses of a group overlap instead of following one another
+void hashIndex::probe(const Value* keys, size_t count, uint64_t* found) const {
+    constexpr size_t GROUP = 16;
+    uint64_t hashes[GROUP];
+    const bucket* heads[GROUP];
+    for (size_t first = 0; first < count; first += GROUP) {
+        size_t group = std::min(GROUP, count - first);
+        for (size_t i = 0; i < group; i++) {
+            hashes[i] = keys[first + i].hash();
+            heads[i] = &at(address(hashes[i]));
+            __builtin_prefetch(heads[i]);
+        }
+        for (size_t i = 0; i < group; i++) {
+            const Value& key = keys[first + i];
+            if (!key.isNull() && contains(*heads[i], key, hashes[i])) found[(first + i) / 64] |= uint64_t(1) << ((first + i) % 64);
+        }
+    }
+}
@@ -0,0 +1,743 @@
+#include <algorithm>
+#include <cstring>
+#include <iostream>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include "../../include/storage/heapFile.hpp"
+#include "../../include/storage/pageIo.hpp"
+
+namespace {
+
+constexpr char FSM_MAGIC[8] = {'M', 'S', 'Q', 'L', 'F', 'S', 'M', '\0'};
+
+struct fsmHeader {
+    char magic[8];
+    uint32_t pageCount;
+    uint32_t reserved;
+};
+
+// Page version latch, as in bTreeIndex: bit 1 set while the page changes,
+// and every unlock moves the version on
+constexpr uint64_t LOCKED = 2;
+
+// Holds a page latch for a scope. Only one thread modifies the file, so the
+// latch is never taken twice at once.
+class latchGuard {
+public:
+    explicit latchGuard(std::atomic<uint64_t>& latch) : latch(latch) {
+        latch.fetch_add(LOCKED, std::memory_order_acquire);
+    }
+    ~latchGuard() { latch.fetch_add(LOCKED, std::memory_order_release); }
+
+    latchGuard(const latchGuard&) = delete;
+    latchGuard& operator=(const latchGuard&) = delete;
+
+private:
+    std::atomic<uint64_t>& latch;
+};
+
+uint64_t packRecord(recordId rid) {
+    return (static_cast<uint64_t>(rid.page) << 16) | rid.slot;
+}
+
+} // namespace
+
+heapFile::heapFile(const std::string& path, const Table& table, bufferPool& pool)
+    : path(path), rowCodec(table), pool(pool), pageLatches(new std::atomic<uint64_t>[PAGE_LATCHES]()) {
+    fd = ::open(path.c_str(), O_RDWR | O_CREAT, 0644);
+    if (fd < 0) {
+        std::cerr << "Error: Cannot open heap file '" << path << "'." << std::endl;
+        return;
+    }
+
+    struct stat st;
+    if (fstat(fd, &st) != 0 || st.st_size % PAGE_SIZE != 0) {
+        std::cerr << "Error: Heap file '" << path << "' is not a whole number of pages." << std::endl;
+        ::close(fd);
+        fd = -1;
+        return;
+    }
+    pages = static_cast<uint32_t>(st.st_size / PAGE_SIZE);
+
+    if (!loadFreeSpaceMap() && !rebuildFreeSpaceMap()) {
+        std::cerr << "Error: Cannot read heap file '" << path << "'." << std::endl;
+        ::close(fd);
+        fd = -1;
+        return;
+    }
+    if (!openIndexes()) {
+        ::close(fd);
+        fd = -1;
+    }
+}
+
+heapFile::~heapFile() {
+    if (fd < 0) return;
+    flush();
+    insertPage.release();
+    pool.drop(this);
+    ::close(fd);
+}
+
+bool heapFile::openIndexes() {
+    const Table& table = rowCodec.schema();
+    for (const Column& column : table.columns) {
+        if (!column.isPrimaryKey && !column.isUnique) continue;
+        if (!bTreeIndex::supports(column)) {
+            std::cerr << "Warning: UNIQUE is not enforced on column '" << column.name << "' of type " << column.datatype << "." << std::endl;
+            continue;
+        }
+        std::string indexPath = path + "." + column.name + ".idx";
+        auto index = std::make_unique<bTreeIndex>(indexPath, column, pool);
+        // After a crash the rows may still hold half-made changes, so keys
+        // seen twice now are not reported; recovery rebuilds the index again
+        bool crashed = index->wasUnclean();
+        if (!index->isOpen()) {
+            ::unlink(indexPath.c_str());
+            index = std::make_unique<bTreeIndex>(indexPath, column, pool);
+            if (!index->isOpen()) return false;
+        }
+        if (index->isNew() && pages > 0) {
+            heapScan scan(*this);
+            recordId rid;
+            const char* tuple;
+            uint16_t length;
+            while (scan.next(rid, tuple, length)) {
+                Value key = rowCodec.decode(tuple, column.ordinal);
+                if (index->insert(key, rid) == indexStatus::DUPLICATE && !crashed) {
+                    std::cerr << "Error: Duplicate value " << key << " in UNIQUE column '" << column.name << "'." << std::endl;
+                }
+            }
+            if (!index->flush()) return false;
+        }
+        indexes.push_back(std::move(index));
+    }
+    return true;
+}
+
+const bTreeIndex* heapFile::index(uint32_t ordinal) const {
+    for (const auto& index : indexes) {
+        if (index->keyColumn().ordinal == ordinal) return index.get();
+    }
+    return nullptr;
+}
+
+bool heapFile::addIndex(const IndexDefinition& definition) {
+    const Column* column = rowCodec.schema().findColumn(definition.column);
+    if (!column) {
+        std::cerr << "Error: Column '" << definition.column << "' does not exist in table '" << rowCodec.schema().name << "'." << std::endl;
+        return false;
+    }
+    if (hashIndexOn(column->ordinal)) {
+        std::cerr << "Error: Column '" << definition.column << "' already has a hash index." << std::endl;
+        return false;
+    }
+
+    auto index = std::make_unique<hashIndex>(*column);
+    heapScan scan(*this);
+    recordId rid;
+    const char* tuple;
+    uint16_t length;
+    while (scan.next(rid, tuple, length)) index->insert(rowCodec.decode(tuple, column->ordinal), rid);
+    hashIndexes.push_back(std::move(index));
+    return true;
+}
+
+const hashIndex* heapFile::hashIndexOn(uint32_t ordinal) const {
+    for (const auto& index : hashIndexes) {
+        if (index->keyColumn().ordinal == ordinal) return index.get();
+    }
+    return nullptr;
+}
+
+const keyLookup* heapFile::keys(uint32_t ordinal) const {
+    if (const hashIndex* hashed = hashIndexOn(ordinal)) return hashed;
+    return index(ordinal);
+}
+
+bool heapFile::lookup(uint32_t ordinal, const Value& key, std::vector<recordId>& rids) const {
+    if (const hashIndex* hashed = hashIndexOn(ordinal)) {
+        hashed->find(key, rids);
+        return true;
+    }
+    if (const bTreeIndex* tree = index(ordinal)) {
+        recordId rid;
+        if (tree->lookup(key, rid)) rids.push_back(rid);
+        return true;
+    }
+    return false;
+}
+
+bool heapFile::addReference(const std::string& columnName, const heapFile& parent) {
+    const Table& table = rowCodec.schema();
+    auto foreignKey = table.foreignKeys.find(columnName);
+    const Table& parentTable = parent.rowCodec.schema();
+    std::string target = foreignKey == table.foreignKeys.end() ? "" : foreignKey->second;
+    size_t dot = target.find('.');
+    if (dot == std::string::npos || target.compare(0, dot, parentTable.name) != 0) {
+        std::cerr << "Error: Column '" << columnName << "' has no foreign key to table '" << parentTable.name << "'." << std::endl;
+        return false;
+    }
+
+    const Column* parentColumn = parentTable.findColumn(target.substr(dot + 1));
+    const keyLookup* parentKeys = parentColumn ? parent.keys(parentColumn->ordinal) : nullptr;
+    if (!parentKeys) {
+        std::cerr << "Error: No index on '" << target << "' to check foreign key '" << columnName
+                  << "'; add one with CREATE INDEX ... USING HASH." << std::endl;
+        return false;
+    }
+    references.push_back({table.findColumn(columnName)->ordinal, parentKeys, target});
+    return true;
+}
+
+bool heapFile::checkReferences(const char* tuple) const {
+    for (const reference& ref : references) {
+        Value key = rowCodec.decode(tuple, ref.ordinal);
+        if (key.isNull()) continue;
+        uint64_t found = 0;
+        ref.keys->probe(&key, 1, &found);
+        if (!found) {
+            std::cerr << "Error: Value " << key << " for column '" << rowCodec.schema().columns[ref.ordinal].name
+                      << "' has no match in '" << ref.target << "'." << std::endl;
+            return false;
+        }
+    }
+    return true;
+}
+
+bool heapFile::indexTuple(const char* tuple, recordId rid) {
+    for (size_t i = 0; i < indexes.size(); i++) {
+        const Column& column = indexes[i]->keyColumn();
+        Value key = rowCodec.decode(tuple, column.ordinal);
+        indexStatus status = indexes[i]->insert(key, rid);
+        if (status == indexStatus::OK) continue;
+        if (status == indexStatus::DUPLICATE) {
+            std::cerr << "Error: Duplicate value " << key << " for UNIQUE column '" << column.name << "'." << std::endl;
+        }
+        unindexTuple(tuple, i);
+        return false;
+    }
+    for (const auto& index : hashIndexes) index->insert(rowCodec.decode(tuple, index->keyColumn().ordinal), rid);
+    return true;
+}
+
+void heapFile::unindexTuple(const char* tuple, size_t indexCount) {
+    for (size_t i = 0; i < indexCount; i++) {
+        indexes[i]->erase(rowCodec.decode(tuple, indexes[i]->keyColumn().ordinal));
+    }
+}
+
+void heapFile::unindexAll(const char* tuple, recordId rid) {
+    unindexTuple(tuple, indexes.size());
+    for (const auto& index : hashIndexes) index->erase(rowCodec.decode(tuple, index->keyColumn().ordinal), rid);
+}
+
+// Whether every unique key that changes from before to after is still free
+bool heapFile::keysAvailable(const char* before, const char* after) const {
+    for (const auto& index : indexes) {
+        const Column& column = index->keyColumn();
+        Value key = rowCodec.decode(after, column.ordinal);
+        if (key == rowCodec.decode(before, column.ordinal)) continue;
+        recordId other;
+        if (index->lookup(key, other)) {
+            std::cerr << "Error: Duplicate value " << key << " for UNIQUE column '" << column.name << "'." << std::endl;
+            return false;
+        }
+    }
+    return true;
+}
+
+void heapFile::rekey(const char* before, const char* after, recordId rid) {
+    for (const auto& index : indexes) {
+        uint32_t ordinal = index->keyColumn().ordinal;
+        Value oldKey = rowCodec.decode(before, ordinal);
+        Value newKey = rowCodec.decode(after, ordinal);
+        if (oldKey == newKey) continue;
+        index->erase(oldKey);
+        index->insert(newKey, rid);
+    }
+    for (const auto& index : hashIndexes) {
+        uint32_t ordinal = index->keyColumn().ordinal;
+        Value oldKey = rowCodec.decode(before, ordinal);
+        Value newKey = rowCodec.decode(after, ordinal);
+        if (oldKey == newKey) continue;
+        index->erase(oldKey, rid);
+        index->insert(newKey, rid);
+    }
+}
+
+void heapFile::setLog(writeAheadLog* log, uint32_t fileId) {
+    this->log = log;
+    logFileId = fileId;
+}
+
+bool heapFile::beginRead(uint32_t page, uint64_t& version) const {
+    version = latchFor(page).load(std::memory_order_acquire);
+    return (version & LOCKED) == 0;
+}
+
+bool heapFile::endRead(uint32_t page, uint64_t version) const {
+    std::atomic_thread_fence(std::memory_order_acquire);
+    return latchFor(page).load(std::memory_order_relaxed) == version;
+}
+
+void heapFile::noteDirty(uint32_t page, uint64_t lsn) const {
+    std::lock_guard<std::mutex> lock(dirtyMutex);
+    changedPages.emplace(page, lsn);
+}
+
+void heapFile::dirtyPages(std::vector<std::pair<uint32_t, uint64_t>>& pages) const {
+    std::lock_guard<std::mutex> lock(dirtyMutex);
+    pages.insert(pages.end(), changedPages.begin(), changedPages.end());
+}
+
+// Log a change to the page in view, which must stay pinned until its page
+// LSN is set. The page enters the dirty page table before the record is
+// appended, so a checkpoint sees one or the other.
+bool heapFile::logChange(walTransaction* txn, logType type, recordId rid, std::string_view before,
+                         std::string_view after, slottedPage& view) {
+    if (!log || !txn) return true;
+    noteDirty(rid.page, log->endLsn());
+    uint64_t lsn = log->append(*txn, type, logFileId, rid, before, after);
+    if (lsn == 0) {
+        std::cerr << "Error: Cannot log change to '" << path << "'." << std::endl;
+        return false;
+    }
+    view.setPageLsn(lsn);
+    return true;
+}
+
+bool heapFile::readPage(uint32_t page, char* data) const {
+    return preadAll(fd, data, PAGE_SIZE, static_cast<off_t>(page) * PAGE_SIZE);
+}
+
+bool heapFile::writePage(uint32_t page, const char* data) const {
+    // Write-ahead rule: the page's latest change must be in the log first
+    uint64_t lsn = slottedPage(const_cast<char*>(data)).pageLsn();
+    if (log && lsn != 0 && !log->flushTo(lsn + 1)) return false;
+    if (!pwriteAll(fd, data, PAGE_SIZE, static_cast<off_t>(page) * PAGE_SIZE)) return false;
+    // Nobody changes a page while the pool writes it, so it is clean now
+    std::lock_guard<std::mutex> lock(dirtyMutex);
+    changedPages.erase(page);
+    return true;
+}
+
+bool heapFile::pinForInsert(uint32_t page) {
+    if (insertPage && insertPage.page() == page) return true;
+    insertPage.release();
+
+    if (page == pages) {
+        insertPage = pool.create(this, page); // append
+        if (!insertPage) return false;
+        slottedPage(insertPage.data()).init(page);
+        pages++;
+        freeSpace.push_back(0);
+        if (blockMax.size() * FSM_BLOCK < pages) blockMax.push_back(0);
+        return true;
+    }
+    insertPage = pool.pin(this, page);
+    return static_cast<bool>(insertPage);
+}
+
+// Free the page's tombstones whose transactions have ended
+void heapFile::purgeTombstones(uint32_t page, slottedPage& view) {
+    for (uint16_t slot = 0; slot < view.slotCount(); slot++) {
+        if (!view.isTombstone(slot)) continue;
+        auto it = tombstones.find(packRecord({page, slot}));
+        if (it != tombstones.end()) {
+            if (log && log->isActive(it->second)) continue;
+            tombstones.erase(it);
+        }
+        view.purge(slot);
+    }
+}
+
+void heapFile::setFree(uint32_t page, size_t freeBytes) {
+    uint8_t category = static_cast<uint8_t>(std::min<size_t>(freeBytes / FSM_GRANULE, 255));
+    freeSpace[page] = category;
+    uint8_t& bound = blockMax[page / FSM_BLOCK];
+    bound = std::max(bound, category);
+}
+
+long heapFile::findPage(size_t needed) {
+    size_t want = (needed + FSM_GRANULE - 1) / FSM_GRANULE;
+    if (want > 255) return -1;
+
+    // The page being filled usually has room; avoid the map entirely then
+    if (insertPage && freeSpace[insertPage.page()] >= want) return insertPage.page();
+
+    for (size_t block = 0; block < blockMax.size(); block++) {
+        if (blockMax[block] < want) continue;
+        size_t first = block * FSM_BLOCK;
+        size_t last = std::min<size_t>(first + FSM_BLOCK, pages);
+        uint8_t actual = 0;
+        for (size_t page = first; page < last; page++) {
+            if (freeSpace[page] >= want) return static_cast<long>(page);
+            actual = std::max(actual, freeSpace[page]);
+        }
+        blockMax[block] = actual; // the bound was stale; tighten it
+    }
+    return -1;
+}
+
+// Encode row into encodeBuffer; its length, or 0 if it does not match the table
+size_t heapFile::encodeRow(const Value* row) {
+    size_t length = rowCodec.size(row);
+    if (length != 0) {
+        encodeBuffer.resize(length);
+        if (!rowCodec.encode(row, &encodeBuffer[0])) length = 0;
+    }
+    if (length == 0) std::cerr << "Error: Row does not match table '" << rowCodec.schema().name << "'." << std::endl;
+    return length;
+}
+
+bool heapFile::insert(const Value* row, recordId& rid, walTransaction* txn) {
+    size_t length = encodeRow(row);
+    return length != 0 && insertTuple(encodeBuffer.data(), length, rid, txn);
+}
+
+bool heapFile::insertTuple(const char* tuple, size_t length, recordId& rid, walTransaction* txn) {
+    if (fd < 0) return false;
+    if (length == 0 || length > slottedPage::MAX_TUPLE) {
+        std::cerr << "Error: A " << length << "-byte row does not fit in a page." << std::endl;
+        return false;
+    }
+    if (!checkReferences(tuple)) return false;
+
+    // The map is a lower bound on the page's free space, so this normally
+    // succeeds first time; a stale entry (from an old .fsm) is corrected by
+    // setFree and the search repeated
+    for (;;) {
+        long found = findPage(length);
+        uint32_t page = found < 0 ? pages.load() : static_cast<uint32_t>(found);
+        if (!pinForInsert(page)) return false;
+
+        latchGuard latch(latchFor(page));
+        slottedPage view(insertPage.data());
+        purgeTombstones(page, view);
+        int slot = view.insert(tuple, length);
+        setFree(page, view.freeSpace());
+        if (slot >= 0) {
+            insertPage.markDirty();
+            rid = {page, static_cast<uint16_t>(slot)};
+            if (!indexTuple(tuple, rid)) {
+                view.erase(static_cast<uint16_t>(slot));
+                setFree(page, view.freeSpace());
+                return false;
+            }
+            if (!logChange(txn, logType::INSERT, rid, {}, std::string_view(tuple, length), view)) {
+                unindexAll(tuple, rid);
+                view.erase(static_cast<uint16_t>(slot));
+                setFree(page, view.freeSpace());
+                return false;
+            }
+            if (history) history->changed(rid, {}, std::string_view(tuple, length), view.pageLsn());
+            return true;
+        }
+        if (found < 0) return false; // a fresh page always has room
+    }
+}
+
+bool heapFile::get(recordId rid, std::string& tuple) {
+    if (fd < 0 || rid.page >= pages) return false;
+    pageHandle handle = pool.pin(this, rid.page);
+    if (!handle) return false;
+    uint16_t length;
+    const char* data = slottedPage(handle.data()).get(rid.slot, length);
+    if (!data) return false;
+    tuple.assign(data, length);
+    return true;
+}
+
+bool heapFile::update(recordId& rid, const Value* row, walTransaction* txn) {
+    size_t length = encodeRow(row);
+    return length != 0 && updateTuple(rid, encodeBuffer.data(), length, txn);
+}
+
+bool heapFile::updateTuple(recordId& rid, const char* tuple, size_t length, walTransaction* txn) {
+    if (fd < 0 || rid.page >= pages) return false;
+    if (length == 0 || length > slottedPage::MAX_TUPLE) {
+        std::cerr << "Error: A " << length << "-byte row does not fit in a page." << std::endl;
+        return false;
+    }
+    if (!checkReferences(tuple)) return false;
+
+    pageHandle handle = pool.pin(this, rid.page);
+    if (!handle) return false;
+    slottedPage view(handle.data());
+    uint16_t oldLength;
+    const char* current = view.get(rid.slot, oldLength);
+    if (!current) return false;
+    std::string before(current, oldLength);
+    if (!keysAvailable(before.data(), tuple)) return false;
+
+    bool inPlace;
+    {
+        latchGuard latch(latchFor(rid.page));
+        inPlace = view.update(rid.slot, tuple, length);
+        if (inPlace) {
+            if (!logChange(txn, logType::UPDATE, rid, before, std::string_view(tuple, length), view)) {
+                view.update(rid.slot, before.data(), before.size());
+                return false;
+            }
+            if (history) history->changed(rid, before, std::string_view(tuple, length), view.pageLsn());
+        }
+    }
+    if (!inPlace) {
+        // No room on the page: move the row. The keys were checked, so the
+        // insert only fails on I/O errors; put the old row back then
+        handle.release();
+        recordId moved;
+        if (!erase(rid, txn)) return false;
+        if (!insertTuple(tuple, length, moved, txn)) {
+            if (insertTuple(before.data(), before.size(), moved, txn)) rid = moved;
+            return false;
+        }
+        rid = moved;
+        return true;
+    }
+
+    rekey(before.data(), tuple, rid);
+    handle.markDirty();
+    setFree(rid.page, view.freeSpace());
+    return true;
+}
+
+bool heapFile::erase(recordId rid, walTransaction* txn) {
+    if (fd < 0 || rid.page >= pages) return false;
+    pageHandle handle = pool.pin(this, rid.page);
+    if (!handle) return false;
+    slottedPage view(handle.data());
+    uint16_t length;
+    const char* tuple = view.get(rid.slot, length);
+    if (!tuple) return false;
+    latchGuard latch(latchFor(rid.page));
+    if (!logChange(txn, logType::DELETE, rid, std::string_view(tuple, length), {}, view)) return false;
+    if (history) history->changed(rid, std::string_view(tuple, length), {}, view.pageLsn());
+    unindexAll(tuple, rid);
+    if (log && txn) {
+        // Keep the slot and bytes until txn ends, in case it is undone
+        view.markDeleted(rid.slot);
+        tombstones[packRecord(rid)] = *txn;
+        setFree(rid.page, view.reclaimableSpace());
+    } else {
+        view.erase(rid.slot);
+        setFree(rid.page, view.freeSpace());
+    }
+    handle.markDirty();
+    return true;
+}
+
+bool heapFile::flush() {
+    if (fd < 0) return false;
+    insertPage.release(); // its frame is only marked dirty on release
+    if (!pool.flush(this)) return false;
+    if (fsync(fd) != 0) {
+        std::cerr << "Error: Cannot sync heap file '" << path << "'." << std::endl;
+        return false;
+    }
+    for (const auto& index : indexes) {
+        if (!index->flush()) return false;
+    }
+    return saveFreeSpaceMap();
+}
+
+bool heapFile::redo(const logRecordHeader* record, bool& applied) {
+    applied = false;
+    if (fd < 0 || record->page >= pages) {
+        std::cerr << "Error: Log record at LSN " << record->lsn << " is past the end of '" << path << "'." << std::endl;
+        return false;
+    }
+    pageHandle handle = pool.pin(this, record->page);
+    if (!handle) return false;
+    slottedPage view(handle.data());
+    if (view.pageLsn() >= record->lsn) return true;
+    if (view.isBlank()) view.init(record->page);
+    // Tombstones are purged without a log record, so the change may have
+    // used their space; undo comes after redo and needs no reservation
+    for (uint16_t slot = 0; slot < view.slotCount(); slot++) {
+        if (view.isTombstone(slot)) view.purge(slot);
+    }
+
+    std::string_view after = logAfter(record);
+    switch (static_cast<logType>(record->type)) {
+        case logType::INSERT: applied = view.insertAt(record->slot, after.data(), after.size()); break;
+        case logType::DELETE: applied = view.erase(record->slot); break;
+        case logType::UPDATE: applied = view.update(record->slot, after.data(), after.size()); break;
+        default: break;
+    }
+    if (!applied) {
+        std::cerr << "Error: Cannot redo " << logTypeToString(static_cast<logType>(record->type)) << " at LSN "
+                  << record->lsn << " on page " << record->page << " of '" << path << "'." << std::endl;
+        return false;
+    }
+    noteDirty(record->page, record->lsn);
+    view.setPageLsn(record->lsn);
+    handle.markDirty();
+    return true;
+}
+
+bool heapFile::undo(const logRecordHeader* record, walTransaction& txn) {
+    return undo(static_cast<logType>(record->type), {record->page, record->slot}, logBefore(record), logAfter(record),
+                record->lsn, record->prevLsn, txn);
+}
+
+bool heapFile::undo(logType type, recordId rid, std::string_view before, std::string_view after, uint64_t lsn,
+                    uint64_t prevLsn, walTransaction& txn) {
+    if (fd < 0 || !log || rid.page >= pages) return false;
+    pageHandle handle = pool.pin(this, rid.page);
+    if (!handle) return false;
+    slottedPage view(handle.data());
+
+    // Each compensation record is the inverse change, so redo can repeat it
+    latchGuard latch(latchFor(rid.page));
+    noteDirty(rid.page, log->endLsn());
+    uint64_t clr = 0;
+    bool applied = false;
+    switch (type) {
+        case logType::INSERT:
+            clr = log->compensate(txn, logType::DELETE, logFileId, rid, after, {}, prevLsn);
+            if (clr != 0) {
+                unindexAll(after.data(), rid);
+                applied = view.erase(rid.slot);
+            }
+            break;
+        case logType::DELETE:
+            clr = log->compensate(txn, logType::INSERT, logFileId, rid, {}, before, prevLsn);
+            applied = clr != 0 && view.insertAt(rid.slot, before.data(), before.size());
+            if (applied) {
+                tombstones.erase(packRecord(rid));
+                indexTuple(before.data(), rid);
+            }
+            break;
+        case logType::UPDATE:
+            clr = log->compensate(txn, logType::UPDATE, logFileId, rid, after, before, prevLsn);
+            applied = clr != 0 && view.update(rid.slot, before.data(), before.size());
+            if (applied) rekey(after.data(), before.data(), rid);
+            break;
+        default:
+            break;
+    }
+    if (!applied) {
+        std::cerr << "Error: Cannot undo " << logTypeToString(type) << " at LSN " << lsn << " on page " << rid.page
+                  << " of '" << path << "'." << std::endl;
+        return false;
+    }
+    if (history) history->changed(rid, after, before, clr); // the inverse change
+    view.setPageLsn(clr);
+    handle.markDirty();
+    setFree(rid.page, view.freeSpace());
+    return true;
+}
+
+bool heapFile::extendTo(uint32_t count) {
+    if (fd < 0) return false;
+    if (count <= pages) return true;
+    if (ftruncate(fd, static_cast<off_t>(count) * PAGE_SIZE) != 0) {
+        std::cerr << "Error: Cannot extend heap file '" << path << "'." << std::endl;
+        return false;
+    }
+    pages = count;
+    freeSpace.resize(pages, 0);
+    blockMax.resize((pages + FSM_BLOCK - 1) / FSM_BLOCK, 0);
+    return true;
+}
+
+bool heapFile::rebuildIndexes() {
+    if (fd < 0) return false;
+    insertPage.release();
+    if (!pool.flush(this) || !rebuildFreeSpaceMap()) return false;
+
+    for (auto& index : indexes) {
+        std::string indexPath = path + "." + index->keyColumn().name + ".idx";
+        index.reset();
+        ::unlink(indexPath.c_str());
+    }
+    indexes.clear();
+    if (!openIndexes()) return false;
+
+    for (auto& index : hashIndexes) {
+        const Column& column = index->keyColumn();
+        index = std::make_unique<hashIndex>(column);
+        heapScan scan(*this);
+        recordId rid;
+        const char* tuple;
+        uint16_t length;
+        while (scan.next(rid, tuple, length)) index->insert(rowCodec.decode(tuple, column.ordinal), rid);
+    }
+    return true;
+}
+
+bool heapFile::loadFreeSpaceMap() {
+    int mapFd = ::open((path + ".fsm").c_str(), O_RDONLY);
+    if (mapFd < 0) return false;
+
+    fsmHeader header;
+    bool ok = preadAll(mapFd, reinterpret_cast<char*>(&header), sizeof(header), 0) &&
+              std::memcmp(header.magic, FSM_MAGIC, sizeof(FSM_MAGIC)) == 0 &&
+              header.pageCount == pages;
+    if (ok) {
+        freeSpace.resize(pages);
+        ok = pages == 0 || preadAll(mapFd, reinterpret_cast<char*>(freeSpace.data()), pages, sizeof(header));
+    }
+    ::close(mapFd);
+    if (!ok) return false;
+
+    blockMax.assign((pages + FSM_BLOCK - 1) / FSM_BLOCK, 0);
+    for (uint32_t page = 0; page < pages; page++) {
+        blockMax[page / FSM_BLOCK] = std::max(blockMax[page / FSM_BLOCK], freeSpace[page]);
+    }
+    return true;
+}
+
+bool heapFile::rebuildFreeSpaceMap() {
+    freeSpace.assign(pages, 0);
+    blockMax.assign((pages + FSM_BLOCK - 1) / FSM_BLOCK, 0);
+    // Straight from the file: the pool should not fill up with every page
+    std::unique_ptr<char[]> data(new char[PAGE_SIZE]);
+    for (uint32_t page = 0; page < pages; page++) {
+        if (!readPage(page, data.get())) return false;
+        setFree(page, slottedPage(data.get()).reclaimableSpace());
+    }
+    return true;
+}
+
+bool heapFile::saveFreeSpaceMap() const {
+    // Only a hint: a stale or torn map is detected or corrected on use, so no fsync
+    int mapFd = ::open((path + ".fsm").c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if (mapFd < 0) {
+        std::cerr << "Error: Cannot write free-space map for '" << path << "'." << std::endl;
+        return false;
+    }
+    fsmHeader header{};
+    std::memcpy(header.magic, FSM_MAGIC, sizeof(FSM_MAGIC));
+    header.pageCount = pages;
+    bool ok = pwriteAll(mapFd, reinterpret_cast<const char*>(&header), sizeof(header), 0) &&
+              pwriteAll(mapFd, reinterpret_cast<const char*>(freeSpace.data()), freeSpace.size(), sizeof(header));
+    ::close(mapFd);
+    return ok;
+}
+
+heapScan::heapScan(const heapFile& file) : file(file) {}
+
+bool heapScan::next(recordId& rid, const char*& tuple, uint16_t& length) {
+    for (;;) {
+        if (current) {
+            slottedPage view(current.data());
+            while (slot < view.slotCount()) {
+                uint16_t index = slot++;
+                if (const char* data = view.get(index, length)) {
+                    rid = {current.page(), index};
+                    tuple = data;
+                    return true;
+                }
+            }
+        }
+        current.release();
+        if (page >= file.pageCount()) return false;
+        current = file.buffers().pin(&file, page++);
+        slot = 0;
+        if (!current) return false;
+    }
+}
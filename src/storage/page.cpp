@@ -0,0 +1,171 @@
+#include <algorithm>
+#include <cstring>
+#include <vector>
+#include "../../include/storage/page.hpp"
+
+void slottedPage::init(uint32_t pageId) {
+    std::memset(data, 0, PAGE_SIZE);
+    pageHeader* h = header();
+    h->pageId = pageId;
+    h->freeStart = sizeof(pageHeader);
+    h->freeEnd = PAGE_SIZE;
+}
+
+size_t slottedPage::freeSpace() const {
+    const pageHeader* h = header();
+    size_t free = static_cast<size_t>(h->freeEnd - h->freeStart) + h->fragmented;
+    return free > sizeof(pageSlot) ? free - sizeof(pageSlot) : 0;
+}
+
+size_t slottedPage::reclaimableSpace() const {
+    size_t tombstones = 0;
+    for (uint16_t i = 0; i < header()->slotCount; i++) {
+        if (slots()[i].length & TOMBSTONE) tombstones += slots()[i].length & ~TOMBSTONE;
+    }
+    return freeSpace() + tombstones;
+}
+
+int slottedPage::insert(const char* tuple, size_t length) {
+    if (length == 0 || length > MAX_TUPLE) return -1;
+    pageHeader* h = header();
+
+    // Reuse a free slot before growing the slot array
+    uint16_t slot = h->slotCount;
+    for (uint16_t i = 0; i < h->slotCount; i++) {
+        if (slots()[i].length == 0) {
+            slot = i;
+            break;
+        }
+    }
+    size_t slotBytes = slot == h->slotCount ? sizeof(pageSlot) : 0;
+
+    if (static_cast<size_t>(h->freeEnd - h->freeStart) < length + slotBytes) {
+        if (static_cast<size_t>(h->freeEnd - h->freeStart) + h->fragmented < length + slotBytes) return -1;
+        compact();
+    }
+
+    h->freeEnd = static_cast<uint16_t>(h->freeEnd - length);
+    std::memcpy(data + h->freeEnd, tuple, length);
+    if (slot == h->slotCount) {
+        h->slotCount++;
+        h->freeStart = static_cast<uint16_t>(h->freeStart + sizeof(pageSlot));
+    }
+    slots()[slot] = {h->freeEnd, static_cast<uint16_t>(length)};
+    return slot;
+}
+
+bool slottedPage::insertAt(uint16_t slot, const char* tuple, size_t length) {
+    if (length == 0 || length > MAX_TUPLE) return false;
+    pageHeader* h = header();
+    if (isTombstone(slot)) purge(slot);
+    if (slot < h->slotCount && slots()[slot].length != 0) return false;
+    size_t slotBytes = slot < h->slotCount ? 0 : (slot + 1 - h->slotCount) * sizeof(pageSlot);
+
+    if (static_cast<size_t>(h->freeEnd - h->freeStart) < length + slotBytes) {
+        if (static_cast<size_t>(h->freeEnd - h->freeStart) + h->fragmented < length + slotBytes) return false;
+        compact();
+    }
+
+    h->freeEnd = static_cast<uint16_t>(h->freeEnd - length);
+    std::memcpy(data + h->freeEnd, tuple, length);
+    while (h->slotCount <= slot) {
+        slots()[h->slotCount++] = {0, 0};
+        h->freeStart = static_cast<uint16_t>(h->freeStart + sizeof(pageSlot));
+    }
+    slots()[slot] = {h->freeEnd, static_cast<uint16_t>(length)};
+    return true;
+}
+
+const char* slottedPage::get(uint16_t slot, uint16_t& length) const {
+    if (slot >= header()->slotCount || slots()[slot].length == 0 || (slots()[slot].length & TOMBSTONE)) return nullptr;
+    length = slots()[slot].length;
+    return data + slots()[slot].offset;
+}
+
+bool slottedPage::erase(uint16_t slot) {
+    pageHeader* h = header();
+    if (slot >= h->slotCount || slots()[slot].length == 0 || (slots()[slot].length & TOMBSTONE)) return false;
+
+    pageSlot& entry = slots()[slot];
+    if (entry.offset == h->freeEnd) {
+        h->freeEnd = static_cast<uint16_t>(h->freeEnd + entry.length); // lowest tuple: give it straight back
+    } else {
+        h->fragmented = static_cast<uint16_t>(h->fragmented + entry.length);
+    }
+    entry = {0, 0};
+
+    // Trailing free slots can go too
+    while (h->slotCount > 0 && slots()[h->slotCount - 1].length == 0) {
+        h->slotCount--;
+        h->freeStart = static_cast<uint16_t>(h->freeStart - sizeof(pageSlot));
+    }
+    return true;
+}
+
+bool slottedPage::markDeleted(uint16_t slot) {
+    uint16_t length;
+    if (!get(slot, length)) return false;
+    slots()[slot].length = static_cast<uint16_t>(length | TOMBSTONE);
+    return true;
+}
+
+bool slottedPage::isTombstone(uint16_t slot) const {
+    return slot < header()->slotCount && (slots()[slot].length & TOMBSTONE);
+}
+
+bool slottedPage::purge(uint16_t slot) {
+    if (!isTombstone(slot)) return false;
+    slots()[slot].length = static_cast<uint16_t>(slots()[slot].length & ~TOMBSTONE);
+    return erase(slot);
+}
+
+bool slottedPage::update(uint16_t slot, const char* tuple, size_t length) {
+    pageHeader* h = header();
+    if (length == 0 || slot >= h->slotCount || slots()[slot].length == 0 || (slots()[slot].length & TOMBSTONE)) return false;
+
+    pageSlot& entry = slots()[slot];
+    if (length <= entry.length) {
+        std::memcpy(data + entry.offset, tuple, length);
+        h->fragmented = static_cast<uint16_t>(h->fragmented + entry.length - length);
+        entry.length = static_cast<uint16_t>(length);
+        return true;
+    }
+    if (static_cast<size_t>(h->freeEnd - h->freeStart) + h->fragmented + entry.length < length) return false;
+
+    // Give the old bytes up, then place the tuple as a fresh one
+    if (entry.offset == h->freeEnd) {
+        h->freeEnd = static_cast<uint16_t>(h->freeEnd + entry.length);
+    } else {
+        h->fragmented = static_cast<uint16_t>(h->fragmented + entry.length);
+    }
+    entry = {0, 0};
+    if (static_cast<size_t>(h->freeEnd - h->freeStart) < length) compact();
+    h->freeEnd = static_cast<uint16_t>(h->freeEnd - length);
+    std::memcpy(data + h->freeEnd, tuple, length);
+    slots()[slot] = {h->freeEnd, static_cast<uint16_t>(length)};
+    return true;
+}
+
+void slottedPage::compact() {
+    pageHeader* h = header();
+    if (h->fragmented == 0) return;
+
+    // Slide live tuples and tombstones to the end of the page, highest offset first
+    std::vector<uint16_t> order;
+    order.reserve(h->slotCount);
+    for (uint16_t i = 0; i < h->slotCount; i++) {
+        if (slots()[i].length != 0) order.push_back(i);
+    }
+    std::sort(order.begin(), order.end(), [this](uint16_t a, uint16_t b) { return slots()[a].offset > slots()[b].offset; });
+
+    uint16_t end = PAGE_SIZE;
+    for (uint16_t slot : order) {
+        pageSlot& entry = slots()[slot];
+        uint16_t bytes = entry.length & ~TOMBSTONE;
+        end = static_cast<uint16_t>(end - bytes);
+        std::memmove(data + end, data + entry.offset, bytes);
+        entry.offset = end;
+    }
+    h->freeEnd = end;
+    h->fragmented = 0;
+}
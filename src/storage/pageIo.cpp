@@ -0,0 +1,24 @@
+#include <unistd.h>
+#include "../../include/storage/pageIo.hpp"
+
+bool preadAll(int fd, char* data, size_t size, off_t offset) {
+    while (size > 0) {
+        ssize_t got = ::pread(fd, data, size, offset);
+        if (got <= 0) return false;
+        data += got;
+        size -= static_cast<size_t>(got);
+        offset += got;
+    }
+    return true;
+}
+
+bool pwriteAll(int fd, const char* data, size_t size, off_t offset) {
+    while (size > 0) {
+        ssize_t written = ::pwrite(fd, data, size, offset);
+        if (written < 0) return false;
+        data += written;
+        size -= static_cast<size_t>(written);
+        offset += written;
+    }
+    return true;
+}
@@ -0,0 +1,757 @@
+#include <algorithm>
+#include <cstddef>
+#include <cstring>
+#include <iostream>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include "../../include/storage/paxFile.hpp"
+#include "../../include/storage/pageIo.hpp"
+
+namespace {
+
+constexpr char BLOCK_MAGIC[8] = {'M', 'S', 'Q', 'L', 'P', 'A', 'X', '\0'};
+constexpr size_t BOUND_BYTES = 16; // string bounds keep this long a prefix
+
+struct paxBlockHeader {
+    char magic[8];
+    uint32_t rowCount;
+    uint32_t pageCount;
+    uint32_t columnCount;
+    uint32_t reserved;
+};
+
+struct paxChunkHeader {
+    uint32_t firstPage;
+    uint32_t pageCount;
+    uint32_t bytes;
+    uint32_t nullCount;
+    uint8_t boundType;      // ValueType of min/max, NULL_VALUE when there are none
+    uint8_t maxTruncated;
+    uint8_t encoding;       // chunkEncoding
+    uint8_t width;          // bit width of packed values
+    uint32_t minLength;     // STRING bounds: prefix length
+    uint32_t maxLength;
+    uint32_t reserved2;
+    char min[BOUND_BYTES];  // numbers in their native width, strings as a prefix
+    char max[BOUND_BYTES];
+};
+
+static_assert(sizeof(paxChunkHeader) == 64, "chunk headers are packed four to a cache line pair");
+
+size_t nullBytes(uint32_t rows) {
+    return (rows + 63) / 64 * sizeof(uint64_t);
+}
+
+bool isVariable(ColumnType type) {
+    return type == ColumnType::VARCHAR || type == ColumnType::TEXT;
+}
+
+void storeBound(const Value& value, char* out, uint32_t& length) {
+    switch (value.type()) {
+        case ValueType::INT: {
+            int64_t v = value.asInt();
+            std::memcpy(out, &v, sizeof(v));
+            break;
+        }
+        case ValueType::DOUBLE: {
+            double v = value.asDouble();
+            std::memcpy(out, &v, sizeof(v));
+            break;
+        }
+        case ValueType::DATE: {
+            int32_t v = value.asDate();
+            std::memcpy(out, &v, sizeof(v));
+            break;
+        }
+        case ValueType::BOOLEAN:
+            *out = value.asBool() ? 1 : 0;
+            break;
+        case ValueType::STRING: {
+            std::string_view text = value.asString();
+            length = static_cast<uint32_t>(std::min(text.size(), BOUND_BYTES));
+            std::memcpy(out, text.data(), length);
+            break;
+        }
+        default:
+            break;
+    }
+}
+
+// A bound as stored; strings view in
+Value loadBound(ValueType type, const char* in, uint32_t length) {
+    switch (type) {
+        case ValueType::INT: {
+            int64_t v;
+            std::memcpy(&v, in, sizeof(v));
+            return Value::integer(v);
+        }
+        case ValueType::DOUBLE: {
+            double v;
+            std::memcpy(&v, in, sizeof(v));
+            return Value::real(v);
+        }
+        case ValueType::DATE: {
+            int32_t v;
+            std::memcpy(&v, in, sizeof(v));
+            return Value::date(v);
+        }
+        case ValueType::BOOLEAN:
+            return Value::boolean(*in != 0);
+        case ValueType::STRING:
+            return Value::string(std::string_view(in, std::min<size_t>(length, BOUND_BYTES)));
+        default:
+            return Value::null();
+    }
+}
+
+} // namespace
+
+const size_t paxFile::MAX_COLUMNS = (PAGE_SIZE - sizeof(paxBlockHeader)) / sizeof(paxChunkHeader);
+
+// The rows of one column not yet written, in chunk layout
+struct paxFile::columnBuilder {
+    std::vector<uint64_t> nulls;
+    std::vector<char> values;       // fixed-width values
+    std::vector<uint32_t> offsets;  // VARCHAR/TEXT: start of each row's text
+    std::string text;
+    uint32_t nullCount = 0;
+    Value min;                      // non-string bounds
+    Value max;
+    std::string minText;            // string bounds
+    std::string maxText;
+    bool hasBounds = false;
+
+    void reset() {
+        nulls.clear();
+        values.clear();
+        offsets.clear();
+        text.clear();
+        nullCount = 0;
+        hasBounds = false;
+    }
+};
+
+paxFile::paxFile(const std::string& path, const Table& table, bufferPool& pool)
+    : path(path), table(table), pool(pool), builders(table.columns.size()) {
+    if (table.columns.size() > MAX_COLUMNS) {
+        std::cerr << "Error: PAX tables hold at most " << MAX_COLUMNS << " columns." << std::endl;
+        return;
+    }
+    fd = ::open(path.c_str(), O_RDWR | O_CREAT, 0644);
+    if (fd < 0) {
+        std::cerr << "Error: Cannot open PAX file '" << path << "'." << std::endl;
+        return;
+    }
+    if (!loadBlocks()) {
+        ::close(fd);
+        fd = -1;
+    }
+}
+
+paxFile::~paxFile() {
+    if (fd < 0) return;
+    flush();
+    pool.drop(this);
+    ::close(fd);
+}
+
+bool paxFile::readPage(uint32_t page, char* data) const {
+    return preadAll(fd, data, PAGE_SIZE, static_cast<off_t>(page) * PAGE_SIZE);
+}
+
+bool paxFile::writePage(uint32_t page, const char* data) const {
+    return pwriteAll(fd, data, PAGE_SIZE, static_cast<off_t>(page) * PAGE_SIZE);
+}
+
+// Directory entry for the block whose header page is data
+static bool parseBlock(const char* data, uint32_t firstPage, size_t columns, paxBlock& block) {
+    paxBlockHeader header;
+    std::memcpy(&header, data, sizeof(header));
+    if (std::memcmp(header.magic, BLOCK_MAGIC, sizeof(BLOCK_MAGIC)) != 0 || header.columnCount != columns) return false;
+
+    block.firstPage = firstPage;
+    block.pageCount = header.pageCount;
+    block.rowCount = header.rowCount;
+    block.chunks.resize(columns);
+    block.stats.resize(columns);
+
+    std::vector<Value> bounds(columns * 2);
+    for (size_t i = 0; i < columns; i++) {
+        const char* entry = data + sizeof(paxBlockHeader) + i * sizeof(paxChunkHeader);
+        paxChunkHeader chunk;
+        std::memcpy(&chunk, entry, sizeof(chunk));
+        block.chunks[i] = {chunk.firstPage, chunk.pageCount, chunk.bytes, static_cast<chunkEncoding>(chunk.encoding), chunk.width};
+        block.stats[i].nullCount = chunk.nullCount;
+        block.stats[i].maxTruncated = chunk.maxTruncated != 0;
+        ValueType type = static_cast<ValueType>(chunk.boundType);
+        bounds[i * 2] = loadBound(type, entry + offsetof(paxChunkHeader, min), chunk.minLength);
+        bounds[i * 2 + 1] = loadBound(type, entry + offsetof(paxChunkHeader, max), chunk.maxLength);
+    }
+    // The header page is not kept, so string bounds get their own copy
+    block.boundText = Value::internStrings(bounds);
+    for (size_t i = 0; i < columns; i++) {
+        block.stats[i].min = bounds[i * 2];
+        block.stats[i].max = bounds[i * 2 + 1];
+    }
+    return true;
+}
+
+bool paxFile::loadBlocks() {
+    struct stat st;
+    if (fstat(fd, &st) != 0) return false;
+    uint32_t filePages = static_cast<uint32_t>(st.st_size / PAGE_SIZE);
+
+    std::unique_ptr<char[]> data(new char[PAGE_SIZE]);
+    while (pages < filePages) {
+        paxBlock block;
+        if (!readPage(pages, data.get()) || !parseBlock(data.get(), pages, table.columns.size(), block)) {
+            std::cerr << "Error: Page " << pages << " of '" << path << "' is not a block of table '" << table.name << "'." << std::endl;
+            return false;
+        }
+        if (block.pageCount == 0 || pages + block.pageCount > filePages) {
+            // A block cut short by a crash: it was never flushed, drop it
+            std::cerr << "Warning: Ignoring an incomplete block at the end of '" << path << "'." << std::endl;
+            break;
+        }
+        pages += block.pageCount;
+        storedRows += block.rowCount;
+        blocks.push_back(std::move(block));
+    }
+    return true;
+}
+
+bool paxFile::append(const Value* row) {
+    if (fd < 0) return false;
+    size_t variable = 0;
+    for (const Column& column : table.columns) {
+        if (!tupleCodec::fits(column, row[column.ordinal], variable)) {
+            std::cerr << "Error: Value " << row[column.ordinal] << " does not fit column '" << column.name << "'." << std::endl;
+            return false;
+        }
+    }
+
+    uint32_t index = pendingRows;
+    for (const Column& column : table.columns) {
+        columnBuilder& builder = builders[column.ordinal];
+        const Value& value = row[column.ordinal];
+        if (index % 64 == 0) builder.nulls.push_back(0);
+
+        if (isVariable(column.type)) {
+            builder.offsets.push_back(static_cast<uint32_t>(builder.text.size()));
+        } else {
+            builder.values.resize(builder.values.size() + column.width);
+        }
+        if (value.isNull()) {
+            builder.nulls.back() |= uint64_t(1) << (index % 64);
+            builder.nullCount++;
+            continue;
+        }
+
+        char* slot = isVariable(column.type) ? nullptr : builder.values.data() + builder.values.size() - column.width;
+        Value stored = value;
+        switch (column.type) {
+            case ColumnType::INT: {
+                int64_t v = value.asInt();
+                std::memcpy(slot, &v, sizeof(v));
+                break;
+            }
+            case ColumnType::DOUBLE: {
+                double v = value.asDouble();
+                std::memcpy(slot, &v, sizeof(v));
+                stored = Value::real(v);
+                break;
+            }
+            case ColumnType::BOOLEAN:
+                *slot = value.asBool() ? 1 : 0;
+                break;
+            case ColumnType::DATE: {
+                int32_t v = value.asDate();
+                std::memcpy(slot, &v, sizeof(v));
+                break;
+            }
+            case ColumnType::CHAR: {
+                std::string_view text = value.asString();
+                std::memcpy(slot, text.data(), text.size());
+                break;
+            }
+            default:
+                builder.text.append(value.asString());
+                pendingBytes += value.asString().size();
+                break;
+        }
+
+        if (stored.type() == ValueType::STRING) {
+            std::string_view text = stored.asString();
+            if (!builder.hasBounds || text < builder.minText) builder.minText.assign(text);
+            if (!builder.hasBounds || text > builder.maxText) builder.maxText.assign(text);
+        } else {
+            if (!builder.hasBounds || stored < builder.min) builder.min = stored;
+            if (!builder.hasBounds || builder.max < stored) builder.max = stored;
+        }
+        builder.hasBounds = true;
+    }
+    pendingRows++;
+    pendingBytes += table.fixedRowSize;
+
+    if (pendingRows == BLOCK_ROWS || pendingBytes >= BLOCK_BYTES) return writeBlock();
+    return true;
+}
+
+bool paxFile::writeBlock() {
+    uint32_t rows = pendingRows;
+    if (rows == 0) return true;
+    size_t columns = table.columns.size();
+
+    // Encode every chunk, then place them
+    std::vector<paxChunkHeader> chunks(columns);
+    std::vector<std::string> bodies(columns);
+    uint32_t blockPages = 1;
+    for (const Column& column : table.columns) {
+        columnBuilder& builder = builders[column.ordinal];
+        if (isVariable(column.type)) builder.offsets.push_back(static_cast<uint32_t>(builder.text.size()));
+        chunkValues values{&column, rows, builder.nulls.data(), builder.values.data(), builder.offsets.data(), builder.text.data()};
+
+        paxChunkHeader& chunk = chunks[column.ordinal];
+        std::memset(&chunk, 0, sizeof(chunk));
+        chunk.encoding = static_cast<uint8_t>(encodeChunk(values, compress, bodies[column.ordinal], chunk.width));
+        size_t bytes = nullBytes(rows) + bodies[column.ordinal].size();
+        chunk.firstPage = blockPages;
+        chunk.pageCount = static_cast<uint32_t>((bytes + PAGE_SIZE - 1) / PAGE_SIZE);
+        chunk.bytes = static_cast<uint32_t>(bytes);
+        chunk.nullCount = builder.nullCount;
+        blockPages += chunk.pageCount;
+
+        if (builder.hasBounds) {
+            if (columnValueType(column.type) == ValueType::STRING) {
+                chunk.boundType = static_cast<uint8_t>(ValueType::STRING);
+                storeBound(Value::string(builder.minText), chunk.min, chunk.minLength);
+                storeBound(Value::string(builder.maxText), chunk.max, chunk.maxLength);
+                chunk.maxTruncated = builder.maxText.size() > BOUND_BYTES;
+            } else {
+                chunk.boundType = static_cast<uint8_t>(builder.min.type());
+                storeBound(builder.min, chunk.min, chunk.minLength);
+                storeBound(builder.max, chunk.max, chunk.maxLength);
+            }
+        } else {
+            chunk.boundType = static_cast<uint8_t>(ValueType::NULL_VALUE);
+        }
+    }
+
+    // The block image, written straight to the file: it is new, so the
+    // pool holds none of its pages
+    std::unique_ptr<char[]> image(new char[static_cast<size_t>(blockPages) * PAGE_SIZE]());
+    paxBlockHeader header{};
+    std::memcpy(header.magic, BLOCK_MAGIC, sizeof(BLOCK_MAGIC));
+    header.rowCount = rows;
+    header.pageCount = blockPages;
+    header.columnCount = static_cast<uint32_t>(columns);
+    std::memcpy(image.get(), &header, sizeof(header));
+    std::memcpy(image.get() + sizeof(header), chunks.data(), columns * sizeof(paxChunkHeader));
+
+    for (const Column& column : table.columns) {
+        const columnBuilder& builder = builders[column.ordinal];
+        char* out = image.get() + static_cast<size_t>(chunks[column.ordinal].firstPage) * PAGE_SIZE;
+        std::memcpy(out, builder.nulls.data(), builder.nulls.size() * sizeof(uint64_t));
+        const std::string& body = bodies[column.ordinal];
+        std::memcpy(out + nullBytes(rows), body.data(), body.size());
+    }
+
+    if (!pwriteAll(fd, image.get(), static_cast<size_t>(blockPages) * PAGE_SIZE, static_cast<off_t>(pages) * PAGE_SIZE)) {
+        std::cerr << "Error: Cannot write a block to '" << path << "'." << std::endl;
+        return false;
+    }
+
+    paxBlock block;
+    parseBlock(image.get(), pages, columns, block);
+    blocks.push_back(std::move(block));
+    pages += blockPages;
+    storedRows += rows;
+    pendingRows = 0;
+    pendingBytes = 0;
+    for (columnBuilder& builder : builders) builder.reset();
+    return true;
+}
+
+bool paxFile::flush() {
+    if (fd < 0) return false;
+    if (!writeBlock()) return false;
+    if (fsync(fd) != 0) {
+        std::cerr << "Error: Cannot sync PAX file '" << path << "'." << std::endl;
+        return false;
+    }
+    return true;
+}
+
+bool paxFile::mayContain(size_t blockIndex, uint32_t ordinal, const Value& low, const Value& high) const {
+    const paxColumnStats& stats = blocks[blockIndex].stats[ordinal];
+    if (stats.min.isNull()) return false; // only NULLs
+
+    if (!high.isNull() && Value::compare(stats.min, high) > 0) return false;
+    if (!low.isNull()) {
+        if (stats.maxTruncated && low.type() == ValueType::STRING) {
+            // The largest value starts with max and may continue past it
+            std::string_view prefix = low.asString().substr(0, stats.max.asString().size());
+            if (prefix > stats.max.asString()) return false;
+        } else if (Value::compare(stats.max, low) < 0) {
+            return false;
+        }
+    }
+    return true;
+}
+
+void paxColumnView::attach(const Column* columnInfo, uint32_t rowCount, const paxChunk& chunk, const char* data) {
+    column = columnInfo;
+    rows = rowCount;
+    encoding = chunk.encoding;
+    width = chunk.width;
+    nulls = reinterpret_cast<const uint64_t*>(data);
+    isDecoded = false;
+    lastRun = 0;
+
+    // Body layouts as encodeChunk writes them
+    const char* body = data + nullBytes(rows);
+    switch (encoding) {
+        case chunkEncoding::DICTIONARY: {
+            std::memcpy(&dictionarySize, body, sizeof(uint32_t));
+            dictionaryOffsets = reinterpret_cast<const uint32_t*>(body + 8);
+            dictionaryText = body + 8 + (dictionarySize + 1 + 1) / 2 * 8;
+            packed = reinterpret_cast<const uint64_t*>(dictionaryText + (dictionaryOffsets[dictionarySize] + 7) / 8 * 8);
+            break;
+        }
+        case chunkEncoding::RUN_LENGTH:
+            std::memcpy(&runCount, body, sizeof(uint32_t));
+            runEnds = reinterpret_cast<const uint32_t*>(body + 8);
+            runValues = body + 8 + (runCount + 1) / 2 * 8;
+            break;
+        case chunkEncoding::FRAME_OF_REFERENCE:
+            std::memcpy(&base, body, sizeof(base));
+            packed = reinterpret_cast<const uint64_t*>(body + 8);
+            break;
+        default:
+            values = body;
+            text = isVariable(column->type) ? body + (rows + 1) * sizeof(uint32_t) : nullptr;
+            break;
+    }
+}
+
+Value paxColumnView::fixedValue(const char* slot) const {
+    switch (column->type) {
+        case ColumnType::INT: {
+            int64_t v;
+            std::memcpy(&v, slot, sizeof(v));
+            return Value::integer(v);
+        }
+        case ColumnType::DOUBLE: {
+            double v;
+            std::memcpy(&v, slot, sizeof(v));
+            return Value::real(v);
+        }
+        case ColumnType::BOOLEAN:
+            return Value::boolean(*slot != 0);
+        case ColumnType::DATE: {
+            int32_t v;
+            std::memcpy(&v, slot, sizeof(v));
+            return Value::date(v);
+        }
+        case ColumnType::CHAR: {
+            size_t length = column->length;
+            while (length > 0 && slot[length - 1] == '\0') length--;
+            return Value::string(std::string_view(slot, length));
+        }
+        default:
+            return Value::null();
+    }
+}
+
+uint32_t paxColumnView::runOf(uint32_t row) const {
+    // Scans read rows in order, so the last run usually still holds
+    uint32_t start = lastRun == 0 ? 0 : runEnds[lastRun - 1];
+    if (row >= start && row < runEnds[lastRun]) return lastRun;
+    lastRun = static_cast<uint32_t>(std::upper_bound(runEnds, runEnds + runCount, row) - runEnds);
+    return lastRun;
+}
+
+Value paxColumnView::get(uint32_t row) const {
+    if (isNull(row)) return Value::null();
+    switch (encoding) {
+        case chunkEncoding::DICTIONARY: {
+            uint64_t code = unpackBits(packed, row, width);
+            return Value::string(std::string_view(dictionaryText + dictionaryOffsets[code],
+                                                  dictionaryOffsets[code + 1] - dictionaryOffsets[code]));
+        }
+        case chunkEncoding::RUN_LENGTH:
+            return fixedValue(runValues + static_cast<size_t>(runOf(row)) * column->width);
+        case chunkEncoding::FRAME_OF_REFERENCE: {
+            int64_t v = static_cast<int64_t>(static_cast<uint64_t>(base) + unpackBits(packed, row, width));
+            return column->type == ColumnType::DATE ? Value::date(static_cast<int32_t>(v)) : Value::integer(v);
+        }
+        default:
+            break;
+    }
+    if (isVariable(column->type)) {
+        const uint32_t* offsets = reinterpret_cast<const uint32_t*>(values);
+        return Value::string(std::string_view(text + offsets[row], offsets[row + 1] - offsets[row]));
+    }
+    return fixedValue(values + static_cast<size_t>(row) * column->width);
+}
+
+const char* paxColumnView::plainValues() const {
+    if (encoding == chunkEncoding::PLAIN) return values;
+    if (isDecoded) return decoded.data();
+    if (isVariable(column->type)) return nullptr;
+
+    size_t valueWidth = column->width;
+    decoded.assign(static_cast<size_t>(rows) * valueWidth, '\0');
+    char* out = decoded.data();
+    switch (encoding) {
+        case chunkEncoding::DICTIONARY:
+            for (uint32_t row = 0; row < rows; row++) {
+                if (isNull(row)) continue;
+                uint64_t code = unpackBits(packed, row, width);
+                std::memcpy(out + row * valueWidth, dictionaryText + dictionaryOffsets[code],
+                            dictionaryOffsets[code + 1] - dictionaryOffsets[code]);
+            }
+            break;
+        case chunkEncoding::RUN_LENGTH: {
+            uint32_t row = 0;
+            for (uint32_t run = 0; run < runCount; run++) {
+                for (; row < runEnds[run]; row++) std::memcpy(out + row * valueWidth, runValues + run * valueWidth, valueWidth);
+            }
+            break;
+        }
+        case chunkEncoding::FRAME_OF_REFERENCE:
+            for (uint32_t row = 0; row < rows; row++) {
+                int64_t v = static_cast<int64_t>(static_cast<uint64_t>(base) + unpackBits(packed, row, width));
+                if (column->type == ColumnType::DATE) {
+                    int32_t day = static_cast<int32_t>(v);
+                    std::memcpy(out + row * valueWidth, &day, sizeof(day));
+                } else {
+                    std::memcpy(out + row * valueWidth, &v, sizeof(v));
+                }
+            }
+            break;
+        default:
+            break;
+    }
+    isDecoded = true;
+    return out;
+}
+
+namespace {
+
+bool holds(compareOp op, int cmp) {
+    switch (op) {
+        case compareOp::EQ: return cmp == 0;
+        case compareOp::NE: return cmp != 0;
+        case compareOp::LT: return cmp < 0;
+        case compareOp::LE: return cmp <= 0;
+        case compareOp::GT: return cmp > 0;
+        default:            return cmp >= 0;
+    }
+}
+
+void setRange(uint64_t* bits, uint32_t from, uint32_t to) {
+    for (uint32_t row = from; row < to; row++) bits[row / 64] |= uint64_t(1) << (row % 64);
+}
+
+// matches[i] = bit i set when test(i), 64 rows per word
+template <typename Test>
+void fillMatches(uint32_t rows, uint64_t* matches, Test test) {
+    for (uint32_t word = 0; word * 64 < rows; word++) {
+        uint32_t first = word * 64;
+        uint32_t last = std::min<uint32_t>(first + 64, rows);
+        uint64_t bits = 0;
+        for (uint32_t row = first; row < last; row++) bits |= uint64_t(test(row)) << (row - first);
+        matches[word] = bits;
+    }
+}
+
+} // namespace
+
+void paxColumnView::selectRows(compareOp op, const Value& constant, uint64_t* matches) const {
+    // Plain values of the constant's own type
+    if (encoding == chunkEncoding::PLAIN) {
+        if (column->type == ColumnType::INT && constant.type() == ValueType::INT) {
+            const int64_t* v = data<int64_t>();
+            int64_t c = constant.asInt();
+            fillMatches(rows, matches, [&](uint32_t r) { return holds(op, (v[r] > c) - (v[r] < c)); });
+            return;
+        }
+        if (column->type == ColumnType::DOUBLE && constant.isNumeric()) {
+            const double* v = data<double>();
+            double c = constant.asDouble();
+            fillMatches(rows, matches, [&](uint32_t r) { return holds(op, (v[r] > c) - (v[r] < c)); });
+            return;
+        }
+        if (column->type == ColumnType::DATE && constant.type() == ValueType::DATE) {
+            const int32_t* v = data<int32_t>();
+            int32_t c = constant.asDate();
+            fillMatches(rows, matches, [&](uint32_t r) { return holds(op, (v[r] > c) - (v[r] < c)); });
+            return;
+        }
+    }
+
+    // Dictionary: the constant becomes a range of codes
+    if (encoding == chunkEncoding::DICTIONARY && constant.type() == ValueType::STRING) {
+        std::string_view c = constant.asString();
+        auto entry = [this](uint32_t code) {
+            return std::string_view(dictionaryText + dictionaryOffsets[code], dictionaryOffsets[code + 1] - dictionaryOffsets[code]);
+        };
+        uint32_t lo = 0;
+        uint32_t hi = dictionarySize;
+        while (lo < hi) {
+            uint32_t mid = lo + (hi - lo) / 2;
+            if (entry(mid) < c) lo = mid + 1; else hi = mid;
+        }
+        uint32_t found = lo < dictionarySize && entry(lo) == c ? 1 : 0;
+        uint64_t from = 0;
+        uint64_t to = dictionarySize;
+        switch (op) {
+            case compareOp::EQ:
+            case compareOp::NE: from = lo; to = lo + found; break;
+            case compareOp::LT: to = lo; break;
+            case compareOp::LE: to = lo + found; break;
+            case compareOp::GT: from = lo + found; break;
+            default:            from = lo; break;
+        }
+        bool negate = op == compareOp::NE;
+        fillMatches(rows, matches, [&](uint32_t r) {
+            uint64_t code = unpackBits(packed, r, width);
+            return (code >= from && code < to) != negate;
+        });
+        return;
+    }
+
+    // Frame of reference: compare the packed differences with constant - base
+    if (encoding == chunkEncoding::FRAME_OF_REFERENCE &&
+        ((column->type == ColumnType::INT && constant.type() == ValueType::INT) ||
+         (column->type == ColumnType::DATE && constant.type() == ValueType::DATE))) {
+        __int128 k = static_cast<__int128>(constant.type() == ValueType::DATE ? constant.asDate() : constant.asInt()) - base;
+        __int128 largest = width == 64 ? static_cast<__int128>(UINT64_MAX) : (static_cast<__int128>(1) << width) - 1;
+        if (k < 0 || k > largest) {
+            // Every difference lies on one side of the constant
+            bool all = holds(op, k < 0 ? 1 : -1);
+            fillMatches(rows, matches, [all](uint32_t) { return all; });
+            return;
+        }
+        uint64_t target = static_cast<uint64_t>(k);
+        fillMatches(rows, matches, [&](uint32_t r) {
+            uint64_t d = unpackBits(packed, r, width);
+            return holds(op, (d > target) - (d < target));
+        });
+        return;
+    }
+
+    // Runs: one comparison per run
+    if (encoding == chunkEncoding::RUN_LENGTH) {
+        std::fill(matches, matches + (rows + 63) / 64, 0);
+        uint32_t start = 0;
+        for (uint32_t run = 0; run < runCount; run++) {
+            if (holds(op, Value::compare(fixedValue(runValues + static_cast<size_t>(run) * column->width), constant))) {
+                setRange(matches, start, runEnds[run]);
+            }
+            start = runEnds[run];
+        }
+        return;
+    }
+
+    fillMatches(rows, matches, [&](uint32_t r) { return holds(op, Value::compare(get(r), constant)); });
+}
+
+void paxColumnView::select(compareOp op, const Value& constant, uint64_t* matches) const {
+    size_t words = (rows + 63) / 64;
+    if (constant.isNull()) {
+        std::fill(matches, matches + words, 0); // a comparison with NULL is never true
+        return;
+    }
+    selectRows(op, constant, matches);
+    for (size_t w = 0; w < words; w++) matches[w] &= ~nulls[w];
+}
+
+void paxColumnView::selectIn(const std::vector<Value>& list, uint64_t* matches) const {
+    size_t words = (rows + 63) / 64;
+    if (encoding == chunkEncoding::DICTIONARY && dictionarySize == 0) {
+        std::fill(matches, matches + words, 0); // every row is NULL; older files may hold such chunks
+    } else if (encoding == chunkEncoding::DICTIONARY) {
+        // Mark the codes of the listed strings, then test each row's code once
+        std::vector<char> wanted(dictionarySize, 0);
+        for (const Value& item : list) {
+            if (item.type() != ValueType::STRING) continue;
+            std::string_view c = item.asString();
+            uint32_t lo = 0;
+            uint32_t hi = dictionarySize;
+            while (lo < hi) {
+                uint32_t mid = lo + (hi - lo) / 2;
+                std::string_view entry(dictionaryText + dictionaryOffsets[mid], dictionaryOffsets[mid + 1] - dictionaryOffsets[mid]);
+                if (entry < c) lo = mid + 1; else hi = mid;
+            }
+            if (lo < dictionarySize &&
+                std::string_view(dictionaryText + dictionaryOffsets[lo], dictionaryOffsets[lo + 1] - dictionaryOffsets[lo]) == c) {
+                wanted[lo] = 1;
+            }
+        }
+        fillMatches(rows, matches, [&](uint32_t r) { return wanted[unpackBits(packed, r, width)] != 0; });
+    } else {
+        std::fill(matches, matches + words, 0);
+        std::vector<uint64_t> one(words);
+        for (const Value& item : list) {
+            if (item.isNull()) continue;
+            selectRows(compareOp::EQ, item, one.data());
+            for (size_t w = 0; w < words; w++) matches[w] |= one[w];
+        }
+    }
+    for (size_t w = 0; w < words; w++) matches[w] &= ~nulls[w];
+}
+
+paxScan::paxScan(const paxFile& file, std::vector<uint32_t> ordinals)
+    : file(file), ordinals(std::move(ordinals)), buffers(this->ordinals.size()),
+      capacities(this->ordinals.size(), 0), views(this->ordinals.size()) {
+    for (size_t i = 0; i < this->ordinals.size(); i++) views[i].column = &file.schema().columns[this->ordinals[i]];
+}
+
+void paxScan::addRange(uint32_t ordinal, Value low, Value high) {
+    ranges.push_back({ordinal, low, high});
+}
+
+bool paxScan::next() {
+    current = nullptr;
+    while (nextBlock < file.blockCount()) {
+        size_t index = nextBlock++;
+        bool admitted = true;
+        for (const range& r : ranges) admitted = admitted && file.mayContain(index, r.ordinal, r.low, r.high);
+        if (!admitted) {
+            skipped++;
+            continue;
+        }
+        current = &file.block(index);
+        for (size_t i = 0; i < ordinals.size(); i++) {
+            if (!loadChunk(i)) {
+                current = nullptr;
+                return false;
+            }
+        }
+        return true;
+    }
+    return false;
+}
+
+bool paxScan::loadChunk(size_t i) {
+    const paxChunk& chunk = current->chunks[ordinals[i]];
+    size_t bytes = static_cast<size_t>(chunk.pageCount) * PAGE_SIZE;
+    if (capacities[i] < bytes) {
+        buffers[i].reset(new char[bytes]);
+        capacities[i] = bytes;
+    }
+
+    // Chunk pages are contiguous in the file but not in the pool
+    char* out = buffers[i].get();
+    for (uint32_t page = 0; page < chunk.pageCount; page++) {
+        pageHandle handle = file.buffers().pin(&file, current->firstPage + chunk.firstPage + page);
+        if (!handle) return false;
+        std::memcpy(out + static_cast<size_t>(page) * PAGE_SIZE, handle.data(), PAGE_SIZE);
+    }
+
+    views[i].attach(&file.schema().columns[ordinals[i]], current->rowCount, chunk, out);
+    return true;
+}
@@ -0,0 +1,331 @@
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <iostream>
+#include <queue>
+#include <tuple>
+#include <unordered_map>
+#include "../../include/storage/recoveryManager.hpp"
+
+namespace {
+
+// A CHECKPOINT record's data: counts, then that many transactions and
+// dirty pages
+struct checkpointCounts {
+    uint32_t transactions;
+    uint32_t pages;
+};
+
+struct checkpointTransaction {
+    uint64_t id;
+    uint64_t lastLsn;
+};
+
+struct checkpointPage {
+    uint32_t fileId;
+    uint32_t page;
+    uint64_t recLsn;
+};
+
+constexpr size_t PART_ENTRIES = (UINT16_MAX - sizeof(checkpointCounts)) / sizeof(checkpointPage);
+
+static_assert(sizeof(checkpointTransaction) == sizeof(checkpointPage), "entries share the part size limit");
+
+bool isChange(const logRecordHeader* record) {
+    logType type = static_cast<logType>(record->type);
+    return type == logType::INSERT || type == logType::DELETE || type == logType::UPDATE;
+}
+
+bool isEnd(const logRecordHeader* record) {
+    logType type = static_cast<logType>(record->type);
+    return type == logType::COMMIT || type == logType::ABORT;
+}
+
+uint64_t pageOf(const logRecordHeader* record) {
+    return (static_cast<uint64_t>(record->fileId) << 32) | record->page;
+}
+
+double secondsSince(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+} // namespace
+
+recoveryManager::recoveryManager(writeAheadLog& log, bufferPool& pool) : log(log), pool(pool) {}
+
+recoveryManager::~recoveryManager() {
+    stopCheckpoints();
+}
+
+bool recoveryManager::attach(uint32_t fileId, heapFile& file) {
+    if (!files.emplace(fileId, &file).second) {
+        std::cerr << "Error: File id " << fileId << " is already attached to the log." << std::endl;
+        return false;
+    }
+    file.setLog(&log, fileId);
+    return true;
+}
+
+heapFile* recoveryManager::fileFor(const logRecordHeader* record) const {
+    auto it = files.find(record->fileId);
+    if (it != files.end()) return it->second;
+    std::cerr << "Error: Log record at LSN " << record->lsn << " is for file " << record->fileId
+              << ", which is not attached." << std::endl;
+    return nullptr;
+}
+
+bool recoveryManager::checkpoint() {
+    std::lock_guard<std::mutex> lock(checkpointMutex);
+    // Every transaction with a record before begin has an id below firstTxn
+    uint64_t begin = log.endLsn();
+    uint64_t firstTxn = log.nextTransaction();
+    if (!log.flushTo(begin)) return false;
+
+    std::vector<walTransaction> transactions = log.activeTransactions();
+    std::vector<checkpointPage> pages;
+    std::vector<std::pair<uint32_t, uint64_t>> dirty;
+    for (const auto& [fileId, file] : files) {
+        dirty.clear();
+        file->dirtyPages(dirty);
+        for (const auto& [page, recLsn] : dirty) pages.push_back({fileId, page, recLsn});
+    }
+
+    // As many parts as the tables need, each within one record's image
+    size_t t = 0;
+    size_t p = 0;
+    uint64_t part = 0;
+    std::string data;
+    do {
+        checkpointCounts counts{};
+        counts.transactions = static_cast<uint32_t>(std::min(transactions.size() - t, PART_ENTRIES));
+        counts.pages = static_cast<uint32_t>(std::min(pages.size() - p, PART_ENTRIES - counts.transactions));
+        data.assign(reinterpret_cast<const char*>(&counts), sizeof(counts));
+        for (uint32_t i = 0; i < counts.transactions; i++, t++) {
+            checkpointTransaction entry{transactions[t].id, transactions[t].lastLsn};
+            data.append(reinterpret_cast<const char*>(&entry), sizeof(entry));
+        }
+        data.append(reinterpret_cast<const char*>(pages.data() + p), counts.pages * sizeof(checkpointPage));
+        p += counts.pages;
+        part = log.appendCheckpoint(begin, firstTxn, part, data);
+        if (part == 0) return false;
+    } while (t < transactions.size() || p < pages.size());
+
+    return log.flushTo(part + 1) && log.setCheckpoint(part);
+}
+
+bool recoveryManager::recover(size_t redoThreads, recoveryStats* stats) {
+    recoveryStats local;
+    recoveryStats& result = stats ? *stats : local;
+    result = recoveryStats();
+    walReader reader(log.filePath());
+    if (!reader.isOpen()) return true; // nothing logged yet
+
+    // Analysis: the checkpoint's tables, then everything logged after it began
+    auto started = std::chrono::steady_clock::now();
+    std::map<uint64_t, uint64_t> transactions;            // id -> last LSN
+    std::unordered_map<uint64_t, uint64_t> dirty;         // file and page -> recLsn
+    uint64_t start = writeAheadLog::FIRST_LSN;
+    for (uint64_t lsn = log.checkpointLsn(); lsn != 0;) {
+        const logRecordHeader* part = reader.at(lsn);
+        if (!part || part->type != static_cast<uint8_t>(logType::CHECKPOINT) || part->afterLength < sizeof(checkpointCounts)) {
+            std::cerr << "Error: No checkpoint at LSN " << lsn << " of the log." << std::endl;
+            return false;
+        }
+        std::string_view data = logAfter(part);
+        checkpointCounts counts;
+        std::memcpy(&counts, data.data(), sizeof(counts));
+        const char* entry = data.data() + sizeof(counts);
+        for (uint32_t i = 0; i < counts.transactions; i++, entry += sizeof(checkpointTransaction)) {
+            checkpointTransaction txn;
+            std::memcpy(&txn, entry, sizeof(txn));
+            transactions[txn.id] = txn.lastLsn;
+        }
+        for (uint32_t i = 0; i < counts.pages; i++, entry += sizeof(checkpointPage)) {
+            checkpointPage page;
+            std::memcpy(&page, entry, sizeof(page));
+            dirty.emplace((static_cast<uint64_t>(page.fileId) << 32) | page.page, page.recLsn);
+        }
+        start = part->undoNextLsn;
+        lsn = part->prevLsn;
+    }
+    // A transaction may have ended just before the checkpoint began
+    for (auto it = transactions.begin(); it != transactions.end();) {
+        const logRecordHeader* last = reader.at(it->second);
+        if (!last) {
+            std::cerr << "Error: Transaction " << it->first << " has no record at LSN " << it->second << "." << std::endl;
+            return false;
+        }
+        it = isEnd(last) ? transactions.erase(it) : std::next(it);
+    }
+
+    const logRecordHeader* record;
+    std::string_view before;
+    std::string_view after;
+    reader.seek(start);
+    while (reader.next(record, before, after)) {
+        if (record->type == static_cast<uint8_t>(logType::CHECKPOINT)) continue;
+        if (isEnd(record)) {
+            transactions.erase(record->txn);
+            continue;
+        }
+        transactions[record->txn] = record->lsn;
+        if (isChange(record)) dirty.emplace(pageOf(record), record->lsn);
+    }
+    uint64_t end = reader.position();
+    result.analyzedBytes = end - start;
+    result.analysisSeconds = secondsSince(started);
+
+    // Redo: from the oldest change a page may lack, split by page
+    started = std::chrono::steady_clock::now();
+    if (redoThreads == 0) redoThreads = std::max(1u, std::thread::hardware_concurrency());
+    uint64_t redoStart = end;
+    for (const auto& entry : dirty) redoStart = std::min(redoStart, entry.second);
+    std::vector<std::vector<const logRecordHeader*>> partitions(redoThreads);
+    std::map<heapFile*, uint32_t> pagesNeeded;
+    reader.seek(redoStart);
+    while (reader.position() < end && reader.next(record, before, after)) {
+        if (!isChange(record)) continue;
+        auto entry = dirty.find(pageOf(record));
+        if (entry == dirty.end() || record->lsn < entry->second) continue; // written since
+        heapFile* file = fileFor(record);
+        if (!file) return false;
+        uint32_t& needed = pagesNeeded[file];
+        needed = std::max(needed, record->page + 1);
+        uint64_t hash = pageOf(record) * 0x9E3779B97F4A7C15ull;
+        partitions[(hash >> 32) % redoThreads].push_back(record);
+    }
+    for (const auto& [file, needed] : pagesNeeded) {
+        if (!file->extendTo(needed)) return false;
+    }
+
+    std::atomic<bool> failed{false};
+    std::atomic<uint64_t> redone{0};
+    std::vector<std::atomic<bool>> changed(files.size());
+    std::map<heapFile*, size_t> fileIndex;
+    for (const auto& [fileId, file] : files) fileIndex.emplace(file, fileIndex.size());
+    auto replay = [&](const std::vector<const logRecordHeader*>& partition) {
+        for (const logRecordHeader* change : partition) {
+            heapFile* file = files.at(change->fileId);
+            bool applied = false;
+            if (!file->redo(change, applied)) {
+                failed = true;
+                return;
+            }
+            if (applied) {
+                redone.fetch_add(1, std::memory_order_relaxed);
+                changed[fileIndex.at(file)].store(true, std::memory_order_relaxed);
+            }
+        }
+    };
+    std::vector<std::thread> workers;
+    for (size_t i = 1; i < redoThreads; i++) workers.emplace_back(replay, std::cref(partitions[i]));
+    replay(partitions[0]);
+    for (auto& worker : workers) worker.join();
+    if (failed) return false;
+    result.redoBytes = end - redoStart;
+    result.redone = redone;
+    // Indexes are not logged, so rebuild those of every file redo changed
+    for (const auto& [file, index] : fileIndex) {
+        if (changed[index] && !file->rebuildIndexes()) return false;
+    }
+    result.redoSeconds = secondsSince(started);
+
+    // Undo: roll back every transaction that never ended
+    started = std::chrono::steady_clock::now();
+    std::vector<walTransaction> losers;
+    for (const auto& [id, lastLsn] : transactions) losers.push_back(log.resume(id, lastLsn));
+    result.losers = losers.size();
+    if (!undoFrom(reader, losers, result)) return false;
+    result.undoSeconds = secondsSince(started);
+
+    if (!log.flushTo(log.endLsn())) return false;
+    for (const auto& [fileId, file] : files) {
+        if (!file->flush()) return false;
+    }
+    return checkpoint();
+}
+
+// Undo transactions' changes newest first, each down to its first record
+bool recoveryManager::undoFrom(walReader& reader, std::vector<walTransaction>& transactions, recoveryStats& stats) {
+    std::priority_queue<std::pair<uint64_t, size_t>> pending;
+    for (size_t i = 0; i < transactions.size(); i++) {
+        if (transactions[i].lastLsn != 0) {
+            pending.emplace(transactions[i].lastLsn, i);
+        } else if (!log.abort(transactions[i])) {
+            return false;
+        }
+    }
+    while (!pending.empty()) {
+        auto [lsn, i] = pending.top();
+        pending.pop();
+        const logRecordHeader* record = reader.at(lsn);
+        if (!record) {
+            std::cerr << "Error: Transaction " << transactions[i].id << " has no record at LSN " << lsn << "." << std::endl;
+            return false;
+        }
+
+        uint64_t next = record->prevLsn;
+        if (record->flags & LOG_COMPENSATION) {
+            next = record->undoNextLsn; // already undone up to there
+        } else if (isChange(record)) {
+            heapFile* file = fileFor(record);
+            if (!file || !file->undo(record, transactions[i])) return false;
+            stats.undone++;
+        }
+        if (next != 0) {
+            pending.emplace(next, i);
+        } else if (!log.abort(transactions[i])) {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool recoveryManager::rollback(walTransaction& txn) {
+    if (txn.lastLsn == 0) return log.abort(txn);
+    // The records are read back from the file
+    if (!log.flushTo(txn.lastLsn + 1)) return false;
+    walReader reader(log.filePath());
+    std::vector<walTransaction> transactions{txn};
+    recoveryStats stats;
+    bool ok = undoFrom(reader, transactions, stats);
+    txn = transactions[0];
+    return ok;
+}
+
+void recoveryManager::writeOldestPages(size_t count) {
+    std::vector<std::tuple<uint64_t, heapFile*, uint32_t>> oldest;
+    std::vector<std::pair<uint32_t, uint64_t>> dirty;
+    for (const auto& [fileId, file] : files) {
+        dirty.clear();
+        file->dirtyPages(dirty);
+        for (const auto& [page, recLsn] : dirty) oldest.emplace_back(recLsn, file, page);
+    }
+    count = std::min(count, oldest.size());
+    std::partial_sort(oldest.begin(), oldest.begin() + count, oldest.end());
+    for (size_t i = 0; i < count; i++) pool.flushPage(std::get<1>(oldest[i]), std::get<2>(oldest[i]));
+}
+
+void recoveryManager::startCheckpoints(std::chrono::milliseconds interval, size_t pagesPerRound) {
+    stopCheckpoints();
+    stopping = false;
+    background = std::thread([this, interval, pagesPerRound] {
+        std::unique_lock<std::mutex> lock(backgroundMutex);
+        while (!backgroundWake.wait_for(lock, interval, [this] { return stopping; })) {
+            lock.unlock();
+            writeOldestPages(pagesPerRound);
+            checkpoint();
+            lock.lock();
+        }
+    });
+}
+
+void recoveryManager::stopCheckpoints() {
+    if (!background.joinable()) return;
+    {
+        std::lock_guard<std::mutex> lock(backgroundMutex);
+        stopping = true;
+    }
+    backgroundWake.notify_one();
+    background.join();
+}
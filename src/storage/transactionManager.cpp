@@ -0,0 +1,640 @@
+#include <algorithm>
+#include <cstring>
+#include <iostream>
+#include "../../include/common/epoch.hpp"
+#include "../../include/storage/transactionManager.hpp"
+
+namespace {
+
+constexpr uint64_t UNCOMMITTED = UINT64_MAX;   // stamp while a commit is being applied
+
+uint64_t pack(recordId rid) {
+    return (static_cast<uint64_t>(rid.page) << 16) | rid.slot;
+}
+
+bool isProvisional(recordId rid) {
+    return rid.page >= versionedTable::PENDING_PAGE;
+}
+
+recordId provisionalId(size_t write) {
+    return {versionedTable::PENDING_PAGE + static_cast<uint32_t>(write >> 16), static_cast<uint16_t>(write & 0xFFFF)};
+}
+
+size_t provisionalIndex(recordId rid) {
+    return (static_cast<size_t>(rid.page - versionedTable::PENDING_PAGE) << 16) | rid.slot;
+}
+
+} // namespace
+
+// ---- mvccTransaction ----
+
+mvccTransaction::~mvccTransaction() {
+    if (active) manager->abort(*this);
+}
+
+mvccTransaction& mvccTransaction::operator=(mvccTransaction&& other) noexcept {
+    if (this == &other) return *this;
+    if (active) manager->abort(*this);
+    manager = other.manager;
+    id = other.id;
+    start = other.start;
+    active = other.active;
+    conflicted = other.conflicted;
+    writes = std::move(other.writes);
+    written = std::move(other.written);
+    other.active = false;
+    other.writes.clear();
+    other.written.clear();
+    return *this;
+}
+
+// ---- versionedTable ----
+
+versionedTable::versionedTable(transactionManager& manager, heapFile& file)
+    : manager(manager), heap(file), stripes(new chainStripe[CHAIN_STRIPES]) {
+    heap.setHistory(this);
+}
+
+versionedTable::~versionedTable() {
+    heap.setHistory(nullptr);
+    for (size_t i = 0; i < CHAIN_STRIPES; i++) {
+        for (auto& [page, chains] : stripes[i].pages) {
+            for (const slotChain& chain : chains) {
+                for (rowVersion* version = chain.newest; version;) {
+                    rowVersion* older = version->older.load(std::memory_order_relaxed);
+                    delete version;
+                    version = older;
+                }
+            }
+        }
+    }
+}
+
+// Called by the heap, under the page latch, for every change a commit
+// applies or rolls back
+void versionedTable::changed(recordId rid, std::string_view before, std::string_view after, uint64_t lsn) {
+    std::vector<transactionManager::appliedChange>* applied = manager.applying;
+    if (!applied) return; // not from a commit (recovery, say): no snapshot can be older
+
+    lastChange.store(UNCOMMITTED, std::memory_order_release);
+    rowVersion* version = new rowVersion();
+    version->timestamp.store(UNCOMMITTED, std::memory_order_relaxed);
+    version->image.assign(before.data(), before.size());
+    {
+        chainStripe& stripe = stripeFor(rid.page);
+        std::lock_guard<std::mutex> lock(stripe.mtx);
+        std::vector<slotChain>& chains = stripe.pages[rid.page];
+        auto it = std::find_if(chains.begin(), chains.end(), [&](const slotChain& c) { return c.slot == rid.slot; });
+        if (it == chains.end()) {
+            chains.push_back({rid.slot, version});
+        } else {
+            version->older.store(it->newest, std::memory_order_relaxed);
+            it->newest = version;
+        }
+    }
+    logType type = before.empty() ? logType::INSERT : after.empty() ? logType::DELETE : logType::UPDATE;
+    applied->push_back({this, rid, version, type, std::string(after), lsn});
+    manager.versions.fetch_add(1, std::memory_order_relaxed);
+    manager.versionBytes.fetch_add(sizeof(rowVersion) + version->image.size(), std::memory_order_relaxed);
+}
+
+// Copy a page and its chains under the page latch, then work out which
+// rows the snapshot at sees (only onlySlot's, unless it is negative)
+bool versionedTable::readPage(uint32_t page, uint64_t at, int onlySlot, pageRows& out) const {
+    out.rows.clear();
+    out.data.clear();
+    if (page >= heap.pageCount()) return true;
+    pageHandle handle = heap.buffers().pin(&heap, page);
+    if (!handle) return false;
+    if (!out.copy) out.copy.reset(new char[PAGE_SIZE]);
+
+    epochGuard guard; // the chain entries stay alive until we are done
+    chainStripe& stripe = stripeFor(page);
+    for (unsigned attempt = 0;; attempt++) {
+        uint64_t version;
+        if (heap.beginRead(page, version)) {
+            std::memcpy(out.copy.get(), handle.data(), PAGE_SIZE);
+            {
+                std::lock_guard<std::mutex> lock(stripe.mtx);
+                auto it = stripe.pages.find(page);
+                if (it == stripe.pages.end()) {
+                    out.chains.clear();
+                } else {
+                    out.chains = it->second;
+                }
+            }
+            if (heap.endRead(page, version)) break;
+        }
+        if (attempt > 8) std::this_thread::yield();
+    }
+    handle.release();
+
+    slottedPage view(out.copy.get());
+    uint32_t slots = view.slotCount();
+    for (const slotChain& chain : out.chains) slots = std::max<uint32_t>(slots, chain.slot + 1u);
+    std::sort(out.chains.begin(), out.chains.end(), [](const slotChain& a, const slotChain& b) { return a.slot < b.slot; });
+    auto chain = out.chains.begin();
+    uint32_t first = onlySlot < 0 ? 0 : static_cast<uint32_t>(onlySlot);
+    uint32_t last = onlySlot < 0 ? slots : std::min<uint32_t>(slots, first + 1);
+    for (uint32_t slot = first; slot < last; slot++) {
+        while (chain != out.chains.end() && chain->slot < slot) ++chain;
+        uint16_t length = 0;
+        const char* tuple = view.get(static_cast<uint16_t>(slot), length);
+        if (chain != out.chains.end() && chain->slot == slot) {
+            // Undo the changes committed after the snapshot, newest first
+            for (rowVersion* version = chain->newest; version && version->timestamp.load(std::memory_order_acquire) > at;
+                 version = version->older.load(std::memory_order_acquire)) {
+                tuple = version->image.empty() ? nullptr : version->image.data();
+                length = static_cast<uint16_t>(version->image.size());
+            }
+        }
+        if (!tuple) continue;
+        out.rows.push_back({static_cast<uint16_t>(slot), static_cast<uint32_t>(out.data.size()), length});
+        out.data.append(tuple, length);
+    }
+    return true;
+}
+
+// The committed row at rid in txn's snapshot
+bool versionedTable::readVisible(const mvccTransaction& txn, recordId rid, std::string& tuple) const {
+    pageRows rows;
+    if (!readPage(rid.page, txn.start, rid.slot, rows) || rows.rows.empty()) return false;
+    tuple.assign(rows.data, rows.rows[0].offset, rows.rows[0].length);
+    return true;
+}
+
+bool versionedTable::encode(const Value* row, std::string& tuple) const {
+    size_t length = heap.codec().size(row);
+    if (length != 0) {
+        tuple.resize(length);
+        if (!heap.codec().encode(row, &tuple[0])) length = 0;
+    }
+    if (length == 0) std::cerr << "Error: Row does not match table '" << heap.codec().schema().name << "'." << std::endl;
+    return length != 0;
+}
+
+const mvccTransaction::pendingWrite* versionedTable::ownWrite(const mvccTransaction& txn, recordId rid) const {
+    if (isProvisional(rid)) {
+        size_t index = provisionalIndex(rid);
+        if (index >= txn.writes.size() || txn.writes[index].table != this || !isProvisional(txn.writes[index].rid)) {
+            return nullptr;
+        }
+        return &txn.writes[index];
+    }
+    if (txn.written.empty()) return nullptr;
+    auto it = txn.written.find({this, pack(rid)});
+    return it == txn.written.end() ? nullptr : &txn.writes[it->second];
+}
+
+mvccTransaction::pendingWrite* versionedTable::ownWrite(mvccTransaction& txn, recordId rid) const {
+    return const_cast<mvccTransaction::pendingWrite*>(ownWrite(static_cast<const mvccTransaction&>(txn), rid));
+}
+
+bool versionedTable::get(const mvccTransaction& txn, recordId rid, std::string& tuple) const {
+    if (!txn.active) return false;
+    if (const mvccTransaction::pendingWrite* write = ownWrite(txn, rid)) {
+        if (write->type == logType::DELETE) return false;
+        tuple = write->tuple;
+        return true;
+    }
+    return !isProvisional(rid) && readVisible(txn, rid, tuple);
+}
+
+bool versionedTable::lookup(const mvccTransaction& txn, uint32_t ordinal, const Value& key, std::vector<recordId>& rids) const {
+    const bTreeIndex* index = heap.index(ordinal);
+    if (!index || !txn.active) return false;
+    size_t first = rids.size();
+    std::vector<recordId> candidates;
+    recordId rid;
+    if (index->lookup(key, rid)) candidates.push_back(rid);
+    // A change reports its old image before it touches the index, so a
+    // key the probe missed because of it is in a chain by now
+    if (lastChange.load(std::memory_order_acquire) > txn.start) changedSince(txn.start, candidates);
+    std::string tuple;
+    for (recordId candidate : candidates) {
+        if (std::find(rids.begin() + static_cast<long>(first), rids.end(), candidate) != rids.end()) continue;
+        if (get(txn, candidate, tuple) && heap.codec().decode(tuple.data(), ordinal) == key) rids.push_back(candidate);
+    }
+    // Rows it inserted, or gave this key, are not in the index yet
+    for (size_t i = 0; i < txn.writes.size(); i++) {
+        const mvccTransaction::pendingWrite& write = txn.writes[i];
+        if (write.table != this || write.type == logType::DELETE) continue;
+        if (heap.codec().decode(write.tuple.data(), ordinal) != key) continue;
+        recordId own = isProvisional(write.rid) ? provisionalId(i) : write.rid;
+        if (std::find(rids.begin() + static_cast<long>(first), rids.end(), own) == rids.end()) rids.push_back(own);
+    }
+    return true;
+}
+
+bool versionedTable::insert(mvccTransaction& txn, const Value* row, recordId& rid) {
+    if (!txn.active) return false;
+    std::string tuple;
+    if (!encode(row, tuple)) return false;
+    if (tuple.size() > slottedPage::MAX_TUPLE) {
+        std::cerr << "Error: A " << tuple.size() << "-byte row does not fit in a page." << std::endl;
+        return false;
+    }
+    rid = provisionalId(txn.writes.size());
+    txn.writes.push_back({this, rid, logType::INSERT, std::move(tuple)});
+    return true;
+}
+
+writeStatus versionedTable::update(mvccTransaction& txn, recordId rid, const Value* row) {
+    if (!txn.active) return writeStatus::ERROR;
+    if (txn.conflicted) return writeStatus::CONFLICT;
+    std::string tuple;
+    if (!encode(row, tuple)) return writeStatus::ERROR;
+    if (mvccTransaction::pendingWrite* write = ownWrite(txn, rid)) {
+        if (write->type == logType::DELETE) return writeStatus::MISSING;
+        write->tuple = std::move(tuple);
+        return writeStatus::OK;
+    }
+    if (isProvisional(rid)) return writeStatus::MISSING;
+    writeStatus status = claim(txn, rid);
+    if (status != writeStatus::OK) return status;
+    txn.written.emplace(std::make_pair(this, pack(rid)), txn.writes.size());
+    txn.writes.push_back({this, rid, logType::UPDATE, std::move(tuple)});
+    return writeStatus::OK;
+}
+
+writeStatus versionedTable::erase(mvccTransaction& txn, recordId rid) {
+    if (!txn.active) return writeStatus::ERROR;
+    if (txn.conflicted) return writeStatus::CONFLICT;
+    if (mvccTransaction::pendingWrite* write = ownWrite(txn, rid)) {
+        if (write->type == logType::DELETE) return writeStatus::MISSING;
+        write->type = logType::DELETE;
+        write->tuple.clear();
+        return writeStatus::OK;
+    }
+    if (isProvisional(rid)) return writeStatus::MISSING;
+    writeStatus status = claim(txn, rid);
+    if (status != writeStatus::OK) return status;
+    txn.written.emplace(std::make_pair(this, pack(rid)), txn.writes.size());
+    txn.writes.push_back({this, rid, logType::DELETE, {}});
+    return writeStatus::OK;
+}
+
+// Commit time of the newest change to the slot still in its chain, 0 if it
+// has none; UNCOMMITTED while a commit is applying one
+uint64_t versionedTable::newestChange(recordId rid) const {
+    chainStripe& stripe = stripeFor(rid.page);
+    std::lock_guard<std::mutex> lock(stripe.mtx);
+    auto it = stripe.pages.find(rid.page);
+    if (it == stripe.pages.end()) return 0;
+    for (const slotChain& chain : it->second) {
+        if (chain.slot == rid.slot) return chain.newest->timestamp.load(std::memory_order_acquire);
+    }
+    return 0;
+}
+
+// Append the slots changed after at, committed or being applied
+void versionedTable::changedSince(uint64_t at, std::vector<recordId>& rids) const {
+    for (size_t i = 0; i < CHAIN_STRIPES; i++) {
+        std::lock_guard<std::mutex> lock(stripes[i].mtx);
+        for (const auto& [page, chains] : stripes[i].pages) {
+            for (const slotChain& chain : chains) {
+                if (chain.newest->timestamp.load(std::memory_order_acquire) > at) rids.push_back({page, chain.slot});
+            }
+        }
+    }
+}
+
+// Claim the right to write an existing row. A committer holds its rows'
+// claims until their images are stamped, so a change committed after the
+// snapshot either still has its claim or shows in the chain.
+writeStatus versionedTable::claim(mvccTransaction& txn, recordId rid) {
+    std::lock_guard<std::mutex> lock(claimMutex);
+    auto it = claims.find(pack(rid));
+    if ((it != claims.end() && it->second != txn.id) || newestChange(rid) > txn.start) {
+        txn.conflicted = true;
+        manager.conflicts.fetch_add(1, std::memory_order_relaxed);
+        return writeStatus::CONFLICT;
+    }
+    std::string tuple;
+    if (!readVisible(txn, rid, tuple)) return writeStatus::MISSING;
+    claims.emplace(pack(rid), txn.id);
+    return writeStatus::OK;
+}
+
+void versionedTable::unclaim(recordId rid) {
+    std::lock_guard<std::mutex> lock(claimMutex);
+    claims.erase(pack(rid));
+}
+
+bool versionedTable::apply(mvccTransaction::pendingWrite& write, walTransaction& wal) {
+    recordId rid = write.rid;
+    switch (write.type) {
+        case logType::INSERT:
+            return heap.insertTuple(write.tuple.data(), write.tuple.size(), rid, &wal);
+        case logType::UPDATE:
+            return heap.updateTuple(rid, write.tuple.data(), write.tuple.size(), &wal);
+        case logType::DELETE:
+            return isProvisional(rid) || heap.erase(rid, &wal); // a row it inserted and deleted again never existed
+        default:
+            return false;
+    }
+}
+
+// Take back the newest image of a slot, pushed by a commit that failed
+void versionedTable::unlinkNewest(recordId rid, rowVersion* version, std::vector<rowVersion*>& garbage) {
+    chainStripe& stripe = stripeFor(rid.page);
+    std::lock_guard<std::mutex> lock(stripe.mtx);
+    auto page = stripe.pages.find(rid.page);
+    if (page == stripe.pages.end()) return;
+    std::vector<slotChain>& chains = page->second;
+    for (size_t i = 0; i < chains.size(); i++) {
+        if (chains[i].slot != rid.slot || chains[i].newest != version) continue;
+        chains[i].newest = version->older.load(std::memory_order_relaxed);
+        if (!chains[i].newest) {
+            chains[i] = chains.back();
+            chains.pop_back();
+            if (chains.empty()) stripe.pages.erase(page);
+        }
+        garbage.push_back(version);
+        return;
+    }
+}
+
+// Cut every chain changed up to oldest back to the images some snapshot
+// newer than oldest still needs. An image replaced at or before oldest is
+// never read: each snapshot stops walking at that change.
+size_t versionedTable::prune(uint64_t oldest, size_t budget, std::vector<rowVersion*>& garbage) {
+    size_t freed = 0;
+    while (freed < budget) {
+        recordId rid;
+        {
+            std::lock_guard<std::mutex> lock(collectMutex);
+            if (changes.empty() || changes.front().first > oldest) break;
+            rid = changes.front().second;
+            changes.pop_front();
+        }
+        chainStripe& stripe = stripeFor(rid.page);
+        std::lock_guard<std::mutex> lock(stripe.mtx);
+        auto page = stripe.pages.find(rid.page);
+        if (page == stripe.pages.end()) continue;
+        std::vector<slotChain>& chains = page->second;
+        auto chain = std::find_if(chains.begin(), chains.end(), [&](const slotChain& c) { return c.slot == rid.slot; });
+        if (chain == chains.end()) continue;
+
+        rowVersion* newer = nullptr;
+        rowVersion* version = chain->newest;
+        while (version && version->timestamp.load(std::memory_order_relaxed) > oldest) {
+            newer = version;
+            version = version->older.load(std::memory_order_relaxed);
+        }
+        if (!version) continue;
+        if (newer) {
+            newer->older.store(nullptr, std::memory_order_release);
+        } else {
+            *chain = chains.back();
+            chains.pop_back();
+            if (chains.empty()) stripe.pages.erase(page);
+        }
+        for (; version; version = version->older.load(std::memory_order_relaxed)) {
+            garbage.push_back(version);
+            freed++;
+        }
+    }
+    return freed;
+}
+
+// ---- snapshotScan ----
+
+snapshotScan::snapshotScan(const versionedTable& table, const mvccTransaction& txn)
+    : table(table), txn(txn), pages(table.file().pageCount()) {}
+
+bool snapshotScan::next(recordId& rid, const char*& tuple, uint16_t& length) {
+    if (!txn.active) return false;
+    for (;;) {
+        while (row < current.rows.size()) {
+            const versionedTable::visibleRow& visible = current.rows[row++];
+            rid = {page - 1, visible.slot};
+            if (const mvccTransaction::pendingWrite* write = table.ownWrite(txn, rid)) {
+                if (write->type == logType::DELETE) continue;
+                tuple = write->tuple.data();
+                length = static_cast<uint16_t>(write->tuple.size());
+                return true;
+            }
+            tuple = current.data.data() + visible.offset;
+            length = visible.length;
+            return true;
+        }
+        if (page >= pages) break;
+        row = 0;
+        if (!table.readPage(page++, txn.start, -1, current)) return false;
+    }
+
+    // Then the rows it inserted
+    while (pending < txn.writes.size()) {
+        size_t index = pending++;
+        const mvccTransaction::pendingWrite& write = txn.writes[index];
+        if (write.table != &table || write.type == logType::DELETE || !isProvisional(write.rid)) continue;
+        rid = provisionalId(index);
+        tuple = write.tuple.data();
+        length = static_cast<uint16_t>(write.tuple.size());
+        return true;
+    }
+    return false;
+}
+
+// ---- transactionManager ----
+
+transactionManager::transactionManager(writeAheadLog& log) : log(log) {}
+
+transactionManager::~transactionManager() {
+    stopCollector();
+    tables.clear();
+    epochReclaimer::reclaim();
+}
+
+versionedTable& transactionManager::manage(heapFile& file) {
+    tables.push_back(std::make_unique<versionedTable>(*this, file));
+    return *tables.back();
+}
+
+mvccTransaction transactionManager::begin() {
+    mvccTransaction txn;
+    txn.manager = this;
+    txn.id = nextId.fetch_add(1, std::memory_order_relaxed);
+    {
+        std::lock_guard<std::mutex> lock(activeMutex);
+        txn.start = published.load(std::memory_order_acquire);
+        snapshots.insert(txn.start);
+    }
+    txn.active = true;
+    return txn;
+}
+
+uint64_t transactionManager::oldestSnapshot() const {
+    std::lock_guard<std::mutex> lock(activeMutex);
+    return snapshots.empty() ? published.load(std::memory_order_acquire) : *snapshots.begin();
+}
+
+// Give up txn's claims
+void transactionManager::release(mvccTransaction& txn) {
+    for (const auto& [key, index] : txn.written) {
+        const mvccTransaction::pendingWrite& write = txn.writes[index];
+        write.table->unclaim(write.rid);
+    }
+}
+
+void transactionManager::finish(mvccTransaction& txn) {
+    {
+        std::lock_guard<std::mutex> lock(activeMutex);
+        snapshots.erase(snapshots.find(txn.start));
+    }
+    txn.active = false;
+    txn.writes.clear();
+    txn.written.clear();
+}
+
+void transactionManager::abort(mvccTransaction& txn) {
+    if (!txn.active) return;
+    release(txn);
+    finish(txn);
+}
+
+// Commits become visible in commit time order
+void transactionManager::publish(uint64_t timestamp) {
+    std::unique_lock<std::mutex> lock(publishMutex);
+    publishTurn.wait(lock, [&] { return published.load(std::memory_order_relaxed) == timestamp - 1; });
+    published.store(timestamp, std::memory_order_release);
+    lock.unlock();
+    publishTurn.notify_all();
+}
+
+void transactionManager::discard(std::vector<versionedTable::rowVersion*>& garbage) {
+    if (garbage.empty()) return;
+    epochReclaimer::retire([garbage = std::move(garbage)] {
+        for (versionedTable::rowVersion* version : garbage) delete version;
+    });
+    garbage.clear();
+}
+
+bool transactionManager::commit(mvccTransaction& txn) {
+    if (!txn.active) return false;
+    if (txn.conflicted) {
+        abort(txn);
+        return false;
+    }
+    bool changes = std::any_of(txn.writes.begin(), txn.writes.end(), [](const mvccTransaction::pendingWrite& write) {
+        return !(write.type == logType::DELETE && isProvisional(write.rid));
+    });
+    if (!changes) {
+        abort(txn); // read-only: nothing to make durable
+        return true;
+    }
+
+    std::unique_lock<std::mutex> lock(commitMutex);
+    walTransaction wal = log.begin();
+    std::vector<appliedChange> applied;
+    applying = &applied;
+    bool ok = true;
+    for (mvccTransaction::pendingWrite& write : txn.writes) {
+        if (!write.table->apply(write, wal)) {
+            ok = false;
+            break;
+        }
+    }
+    if (!ok) {
+        // Undo newest first from the images in memory rather than reading
+        // the log back under the lock. Every change the commit logged is in
+        // applied, in order, so each one's predecessor is the one before it.
+        // The undo's own changes go on the chains too, so snapshots see the
+        // old rows throughout; then the whole attempt comes off again. If an
+        // undo fails the transaction stays open in the log for recovery
+        bool undone = true;
+        for (size_t i = applied.size(); undone && i-- > 0;) {
+            appliedChange change = applied[i]; // a copy: undo appends to applied
+            uint64_t prevLsn = i > 0 ? applied[i - 1].lsn : 0;
+            undone = change.table->heap.undo(change.type, change.rid, change.version->image, change.after, change.lsn,
+                                             prevLsn, wal);
+        }
+        if (undone) log.abort(wal);
+        applying = nullptr;
+        std::vector<versionedTable::rowVersion*> garbage;
+        for (auto it = applied.rbegin(); it != applied.rend(); ++it) it->table->unlinkNewest(it->rid, it->version, garbage);
+        for (versionedTable::rowVersion* version : garbage) {
+            versions.fetch_sub(1, std::memory_order_relaxed);
+            versionBytes.fetch_sub(sizeof(versionedTable::rowVersion) + version->image.size(), std::memory_order_relaxed);
+        }
+        discard(garbage);
+        release(txn);
+        lock.unlock();
+        failedCommits.fetch_add(1, std::memory_order_relaxed);
+        finish(txn);
+        return false;
+    }
+    applying = nullptr;
+
+    uint64_t timestamp = ++lastCommit;
+    for (const appliedChange& change : applied) {
+        change.version->timestamp.store(timestamp, std::memory_order_release);
+        change.table->lastChange.store(timestamp, std::memory_order_release);
+        std::lock_guard<std::mutex> queue(change.table->collectMutex);
+        change.table->changes.emplace_back(timestamp, change.rid);
+    }
+    release(txn);
+    uint64_t lsn = log.appendCommit(wal);
+    lock.unlock();
+
+    bool durable = lsn != 0 && log.flushTo(lsn + 1);
+    publish(timestamp);
+    if (durable) commits.fetch_add(1, std::memory_order_relaxed);
+    finish(txn);
+    return durable;
+}
+
+size_t transactionManager::collect(size_t budget) {
+    std::lock_guard<std::mutex> lock(collectMutex);
+    uint64_t oldest = oldestSnapshot();
+    std::vector<versionedTable::rowVersion*> garbage;
+    size_t freed = 0;
+    // Start where the last round stopped, so every table gets its turn
+    for (size_t i = 0; i < tables.size() && freed < budget; i++) {
+        freed += tables[(nextTable + i) % tables.size()]->prune(oldest, budget - freed, garbage);
+    }
+    if (!tables.empty()) nextTable = (nextTable + 1) % tables.size();
+    for (versionedTable::rowVersion* version : garbage) {
+        versionBytes.fetch_sub(sizeof(versionedTable::rowVersion) + version->image.size(), std::memory_order_relaxed);
+    }
+    versions.fetch_sub(freed, std::memory_order_relaxed);
+    collected.fetch_add(freed, std::memory_order_relaxed);
+    discard(garbage);
+    epochReclaimer::reclaim();
+    return freed;
+}
+
+void transactionManager::startCollector(std::chrono::milliseconds interval, size_t budget) {
+    stopCollector();
+    stopping = false;
+    background = std::thread([this, interval, budget] {
+        std::unique_lock<std::mutex> lock(backgroundMutex);
+        while (!backgroundWake.wait_for(lock, interval, [this] { return stopping; })) {
+            lock.unlock();
+            collect(budget);
+            lock.lock();
+        }
+    });
+}
+
+void transactionManager::stopCollector() {
+    if (!background.joinable()) return;
+    {
+        std::lock_guard<std::mutex> lock(backgroundMutex);
+        stopping = true;
+    }
+    backgroundWake.notify_one();
+    background.join();
+}
+
+mvccStats transactionManager::stats() const {
+    mvccStats result;
+    result.commits = commits.load(std::memory_order_relaxed);
+    result.failedCommits = failedCommits.load(std::memory_order_relaxed);
+    result.conflicts = conflicts.load(std::memory_order_relaxed);
+    result.versions = versions.load(std::memory_order_relaxed);
+    result.versionBytes = versionBytes.load(std::memory_order_relaxed);
+    result.collected = collected.load(std::memory_order_relaxed);
+    return result;
+}
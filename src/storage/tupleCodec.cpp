@@ -0,0 +1,127 @@
+#include <cstring>
+#include "../../include/storage/tupleCodec.hpp"
+
+bool tupleCodec::fits(const Column& column, const Value& value, size_t& variable) {
+    variable = 0;
+    if (value.isNull()) return true;
+    switch (column.type) {
+        case ColumnType::INT:     return value.type() == ValueType::INT;
+        case ColumnType::DOUBLE:  return value.isNumeric();
+        case ColumnType::BOOLEAN: return value.type() == ValueType::BOOLEAN;
+        case ColumnType::DATE:    return value.type() == ValueType::DATE;
+        case ColumnType::CHAR:
+            return value.type() == ValueType::STRING && value.asString().size() <= column.length;
+        case ColumnType::VARCHAR:
+        case ColumnType::TEXT:
+            if (value.type() != ValueType::STRING) return false;
+            if (column.length != 0 && value.asString().size() > column.length) return false;
+            variable = value.asString().size();
+            return true;
+        default:
+            return false;
+    }
+}
+
+size_t tupleCodec::size(const Value* row) const {
+    size_t total = table.fixedRowSize;
+    for (const Column& column : table.columns) {
+        size_t variable;
+        if (!fits(column, row[column.ordinal], variable)) return 0;
+        total += variable;
+    }
+    return total;
+}
+
+bool tupleCodec::encode(const Value* row, char* out) const {
+    std::memset(out, 0, table.fixedRowSize);
+    uint32_t variableOffset = table.fixedRowSize;
+
+    for (const Column& column : table.columns) {
+        const Value& value = row[column.ordinal];
+        size_t variable;
+        if (!fits(column, value, variable)) return false;
+
+        char* slot = out + column.offset;
+        if (value.isNull()) {
+            out[column.nullBit / 8] |= static_cast<char>(1u << (column.nullBit % 8));
+            continue;
+        }
+        switch (column.type) {
+            case ColumnType::INT: {
+                int64_t v = value.asInt();
+                std::memcpy(slot, &v, sizeof(v));
+                break;
+            }
+            case ColumnType::DOUBLE: {
+                double v = value.asDouble();
+                std::memcpy(slot, &v, sizeof(v));
+                break;
+            }
+            case ColumnType::BOOLEAN:
+                *slot = value.asBool() ? 1 : 0;
+                break;
+            case ColumnType::DATE: {
+                int32_t v = value.asDate();
+                std::memcpy(slot, &v, sizeof(v));
+                break;
+            }
+            case ColumnType::CHAR: {
+                std::string_view text = value.asString();
+                std::memcpy(slot, text.data(), text.size());
+                break;
+            }
+            default: {
+                std::string_view text = value.asString();
+                uint32_t ref[2] = {variableOffset, static_cast<uint32_t>(text.size())};
+                std::memcpy(slot, ref, sizeof(ref));
+                std::memcpy(out + variableOffset, text.data(), text.size());
+                variableOffset += static_cast<uint32_t>(text.size());
+                break;
+            }
+        }
+    }
+    return true;
+}
+
+Value tupleCodec::decode(const char* tuple, uint32_t ordinal) const {
+    const Column& column = table.columns[ordinal];
+    if (tuple[column.nullBit / 8] & (1u << (column.nullBit % 8))) return Value::null();
+
+    const char* slot = tuple + column.offset;
+    switch (column.type) {
+        case ColumnType::INT: {
+            int64_t v;
+            std::memcpy(&v, slot, sizeof(v));
+            return Value::integer(v);
+        }
+        case ColumnType::DOUBLE: {
+            double v;
+            std::memcpy(&v, slot, sizeof(v));
+            return Value::real(v);
+        }
+        case ColumnType::BOOLEAN:
+            return Value::boolean(*slot != 0);
+        case ColumnType::DATE: {
+            int32_t v;
+            std::memcpy(&v, slot, sizeof(v));
+            return Value::date(v);
+        }
+        case ColumnType::CHAR: {
+            size_t length = column.length;
+            while (length > 0 && slot[length - 1] == '\0') length--;
+            return Value::string(std::string_view(slot, length));
+        }
+        case ColumnType::VARCHAR:
+        case ColumnType::TEXT: {
+            uint32_t ref[2];
+            std::memcpy(ref, slot, sizeof(ref));
+            return Value::string(std::string_view(tuple + ref[0], ref[1]));
+        }
+        default:
+            return Value::null();
+    }
+}
+
+void tupleCodec::decodeAll(const char* tuple, Value* row) const {
+    for (uint32_t i = 0; i < table.columns.size(); i++) row[i] = decode(tuple, i);
+}
@@ -0,0 +1,484 @@
+#include <algorithm>
+#include <array>
+#include <cstdio>
+#include <cstring>
+#include <iostream>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include "../../include/storage/writeAheadLog.hpp"
+#include "../../include/storage/pageIo.hpp"
+
+namespace {
+
+constexpr char LOG_MAGIC[8] = {'M', 'S', 'Q', 'L', 'W', 'A', 'L', '\0'};
+constexpr char MASTER_MAGIC[8] = {'M', 'S', 'Q', 'L', 'C', 'K', 'P', '\0'};
+constexpr uint32_t LOG_VERSION = 2;
+constexpr size_t MIN_BUFFER = 1u << 20;
+
+struct logFileHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t reserved;
+};
+
+static_assert(sizeof(logFileHeader) == writeAheadLog::FIRST_LSN, "records start right after the file header");
+
+struct masterRecord {
+    char magic[8];
+    uint64_t lsn;
+    uint32_t checksum;     // of lsn
+    uint32_t reserved;
+};
+
+// CRC-32C (Castagnoli), one table lookup per byte
+uint32_t crc32c(uint32_t crc, const void* data, size_t size) {
+    static const std::array<uint32_t, 256> table = [] {
+        std::array<uint32_t, 256> t{};
+        for (uint32_t i = 0; i < 256; i++) {
+            uint32_t c = i;
+            for (int bit = 0; bit < 8; bit++) c = (c >> 1) ^ (0x82F63B78u & (0u - (c & 1)));
+            t[i] = c;
+        }
+        return t;
+    }();
+    const unsigned char* bytes = static_cast<const unsigned char*>(data);
+    crc = ~crc;
+    for (size_t i = 0; i < size; i++) crc = table[(crc ^ bytes[i]) & 0xFF] ^ (crc >> 8);
+    return ~crc;
+}
+
+// Checksum of a record: its length word, then everything from lsn on
+uint32_t recordChecksum(const logRecordHeader& header, std::string_view before, std::string_view after) {
+    uint32_t crc = crc32c(0, &header.length, sizeof(header.length));
+    crc = crc32c(crc, &header.lsn, sizeof(header) - offsetof(logRecordHeader, lsn));
+    crc = crc32c(crc, before.data(), before.size());
+    return crc32c(crc, after.data(), after.size());
+}
+
+size_t recordLength(size_t beforeLength, size_t afterLength) {
+    return (sizeof(logRecordHeader) + beforeLength + afterLength + 7) & ~static_cast<size_t>(7);
+}
+
+} // namespace
+
+const char* logTypeToString(logType type) {
+    switch (type) {
+        case logType::INSERT: return "INSERT";
+        case logType::DELETE: return "DELETE";
+        case logType::UPDATE: return "UPDATE";
+        case logType::COMMIT: return "COMMIT";
+        case logType::ABORT:  return "ABORT";
+        case logType::CHECKPOINT: return "CHECKPOINT";
+        default:              return "UNKNOWN";
+    }
+}
+
+std::string_view logBefore(const logRecordHeader* header) {
+    return std::string_view(reinterpret_cast<const char*>(header + 1), header->beforeLength);
+}
+
+std::string_view logAfter(const logRecordHeader* header) {
+    return std::string_view(reinterpret_cast<const char*>(header + 1) + header->beforeLength, header->afterLength);
+}
+
+writeAheadLog::writeAheadLog(const std::string& path, size_t bufferBytes, std::chrono::microseconds commitDelay)
+    : path(path), commitDelayMicros(commitDelay.count()) {
+    // Find the end of the intact log and the highest transaction id in it,
+    // scanning from where the latest checkpoint began
+    uint64_t end = FIRST_LSN;
+    uint64_t lastTxn = 0;
+    {
+        walReader reader(path);
+        uint64_t master = 0;
+        if (readMaster(master)) {
+            const logRecordHeader* part = reader.at(master);
+            if (part && part->type == static_cast<uint8_t>(logType::CHECKPOINT)) {
+                masterLsn.store(master);
+                lastTxn = part->txn - 1;
+                reader.seek(part->undoNextLsn);
+            } else {
+                std::cerr << "Warning: Checkpoint in '" << path << ".master' is not in the log; reading all of it." << std::endl;
+            }
+        }
+        const logRecordHeader* header;
+        std::string_view before;
+        std::string_view after;
+        while (reader.next(header, before, after)) {
+            if (header->type != static_cast<uint8_t>(logType::CHECKPOINT)) lastTxn = std::max(lastTxn, header->txn);
+        }
+        end = reader.position();
+    }
+
+    fd = ::open(path.c_str(), O_RDWR | O_CREAT, 0644);
+    if (fd < 0) {
+        std::cerr << "Error: Cannot open log '" << path << "'." << std::endl;
+        return;
+    }
+    struct stat st;
+    if (fstat(fd, &st) != 0) {
+        ::close(fd);
+        fd = -1;
+        return;
+    }
+    uint64_t size = static_cast<uint64_t>(st.st_size);
+    if (size == 0) {
+        logFileHeader header{};
+        std::memcpy(header.magic, LOG_MAGIC, sizeof(LOG_MAGIC));
+        header.version = LOG_VERSION;
+        if (!pwriteAll(fd, reinterpret_cast<const char*>(&header), sizeof(header), 0) || fsync(fd) != 0) {
+            std::cerr << "Error: Cannot write log '" << path << "'." << std::endl;
+            ::close(fd);
+            fd = -1;
+            return;
+        }
+    } else {
+        logFileHeader header{};
+        if (size < sizeof(header) || !preadAll(fd, reinterpret_cast<char*>(&header), sizeof(header), 0) ||
+            std::memcmp(header.magic, LOG_MAGIC, sizeof(LOG_MAGIC)) != 0 || header.version != LOG_VERSION) {
+            std::cerr << "Error: '" << path << "' is not a log file." << std::endl;
+            ::close(fd);
+            fd = -1;
+            return;
+        }
+        if (size > end) {
+            std::cerr << "Warning: Cutting " << size - end << " bytes of torn log records from '" << path << "'." << std::endl;
+            if (ftruncate(fd, static_cast<off_t>(end)) != 0 || fsync(fd) != 0) {
+                ::close(fd);
+                fd = -1;
+                return;
+            }
+        }
+    }
+
+    capacity = MIN_BUFFER;
+    while (capacity < bufferBytes) capacity *= 2;
+    ring.reset(new char[capacity]());
+    active.reset(new activeEntry[MAX_ACTIVE]);
+    for (uint32_t slot = MAX_ACTIVE; slot > 0; slot--) freeSlots.push_back(slot - 1);
+    reserved.store(end);
+    recycled.store(end);
+    durable.store(end);
+    requested = end;
+    nextTxn.store(lastTxn + 1);
+    flusher = std::thread(&writeAheadLog::flusherLoop, this);
+}
+
+writeAheadLog::~writeAheadLog() {
+    if (fd < 0) return;
+    {
+        std::lock_guard<std::mutex> lock(flushMutex);
+        stopping = true;
+    }
+    flushWanted.notify_one();
+    flusher.join();
+    ::close(fd);
+}
+
+bool writeAheadLog::readMaster(uint64_t& lsn) const {
+    int masterFd = ::open((path + ".master").c_str(), O_RDONLY);
+    if (masterFd < 0) return false;
+    masterRecord master;
+    bool ok = preadAll(masterFd, reinterpret_cast<char*>(&master), sizeof(master), 0) &&
+              std::memcmp(master.magic, MASTER_MAGIC, sizeof(MASTER_MAGIC)) == 0 &&
+              master.checksum == crc32c(0, &master.lsn, sizeof(master.lsn));
+    ::close(masterFd);
+    if (ok) lsn = master.lsn;
+    return ok;
+}
+
+bool writeAheadLog::setCheckpoint(uint64_t lsn) {
+    // Written beside the old one and renamed over it, so a crash leaves one
+    // of the two
+    std::string masterPath = path + ".master";
+    std::string temporary = masterPath + ".tmp";
+    masterRecord master{};
+    std::memcpy(master.magic, MASTER_MAGIC, sizeof(MASTER_MAGIC));
+    master.lsn = lsn;
+    master.checksum = crc32c(0, &master.lsn, sizeof(master.lsn));
+    int masterFd = ::open(temporary.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    bool ok = masterFd >= 0 && pwriteAll(masterFd, reinterpret_cast<const char*>(&master), sizeof(master), 0) &&
+              fsync(masterFd) == 0;
+    if (masterFd >= 0) ::close(masterFd);
+    if (!ok || std::rename(temporary.c_str(), masterPath.c_str()) != 0) {
+        std::cerr << "Error: Cannot write '" << masterPath << "'." << std::endl;
+        return false;
+    }
+    masterLsn.store(lsn, std::memory_order_release);
+    return true;
+}
+
+walTransaction writeAheadLog::begin() {
+    return resume(nextTxn.fetch_add(1), 0);
+}
+
+walTransaction writeAheadLog::resume(uint64_t id, uint64_t lastLsn) {
+    std::unique_lock<std::mutex> lock(activeMutex);
+    slotFreed.wait(lock, [this] { return !freeSlots.empty(); });
+    walTransaction txn;
+    txn.id = id;
+    txn.lastLsn = lastLsn;
+    txn.slot = freeSlots.back();
+    freeSlots.pop_back();
+    active[txn.slot].id = id;
+    active[txn.slot].lastLsn.store(lastLsn, std::memory_order_relaxed);
+    return txn;
+}
+
+void writeAheadLog::end(walTransaction& txn) {
+    {
+        std::lock_guard<std::mutex> lock(activeMutex);
+        active[txn.slot].id = 0;
+        freeSlots.push_back(txn.slot);
+    }
+    slotFreed.notify_one();
+}
+
+bool writeAheadLog::isActive(const walTransaction& txn) const {
+    std::lock_guard<std::mutex> lock(activeMutex);
+    return txn.slot < MAX_ACTIVE && active[txn.slot].id == txn.id;
+}
+
+std::vector<walTransaction> writeAheadLog::activeTransactions() const {
+    std::vector<walTransaction> transactions;
+    std::lock_guard<std::mutex> lock(activeMutex);
+    for (uint32_t slot = 0; slot < MAX_ACTIVE; slot++) {
+        if (active[slot].id == 0) continue;
+        walTransaction txn;
+        txn.id = active[slot].id;
+        txn.lastLsn = active[slot].lastLsn.load(std::memory_order_acquire);
+        txn.slot = slot;
+        if (txn.lastLsn != 0) transactions.push_back(txn);
+    }
+    return transactions;
+}
+
+// Claim length bytes of log, waiting while the ring has no room for them
+uint64_t writeAheadLog::reserve(size_t length) {
+    uint64_t lsn = reserved.fetch_add(length, std::memory_order_acq_rel);
+    uint64_t end = lsn + length;
+    if (end > recycled.load(std::memory_order_acquire) + capacity) {
+        std::unique_lock<std::mutex> lock(flushMutex);
+        while (end > recycled.load(std::memory_order_acquire) + capacity && !failed) {
+            requested = std::max(requested, end - capacity);
+            flushWanted.notify_one();
+            flushDone.wait(lock);
+        }
+        if (failed) return 0;
+    }
+    return lsn;
+}
+
+void writeAheadLog::copyIn(uint64_t lsn, const char* data, size_t length) {
+    if (length == 0) return;
+    size_t position = lsn & (capacity - 1);
+    size_t first = std::min(length, capacity - position);
+    std::memcpy(ring.get() + position, data, first);
+    if (first < length) std::memcpy(ring.get(), data + first, length - first);
+}
+
+uint64_t writeAheadLog::append(walTransaction& txn, logType type, uint32_t fileId, recordId rid,
+                               std::string_view before, std::string_view after) {
+    logRecordHeader header{};
+    header.fileId = fileId;
+    header.page = rid.page;
+    header.slot = rid.slot;
+    header.type = static_cast<uint8_t>(type);
+    return write(header, &txn, before, after);
+}
+
+uint64_t writeAheadLog::compensate(walTransaction& txn, logType type, uint32_t fileId, recordId rid,
+                                   std::string_view before, std::string_view after, uint64_t undoNext) {
+    logRecordHeader header{};
+    header.undoNextLsn = undoNext;
+    header.fileId = fileId;
+    header.page = rid.page;
+    header.slot = rid.slot;
+    header.type = static_cast<uint8_t>(type);
+    header.flags = LOG_COMPENSATION;
+    return write(header, &txn, before, after);
+}
+
+uint64_t writeAheadLog::appendCheckpoint(uint64_t beginLsn, uint64_t firstTxn, uint64_t prevPart, std::string_view data) {
+    logRecordHeader header{};
+    header.txn = firstTxn;
+    header.prevLsn = prevPart;
+    header.undoNextLsn = beginLsn;
+    header.type = static_cast<uint8_t>(logType::CHECKPOINT);
+    return write(header, nullptr, {}, data);
+}
+
+// Reserve, fill and publish a record; header holds every field but the
+// position, length and checksum, and the transaction's if txn is given
+uint64_t writeAheadLog::write(logRecordHeader& header, walTransaction* txn, std::string_view before, std::string_view after) {
+    if (fd < 0 || before.size() > UINT16_MAX || after.size() > UINT16_MAX) return 0;
+    header.length = static_cast<uint32_t>(recordLength(before.size(), after.size()));
+    header.lsn = reserve(header.length);
+    if (header.lsn == 0) return 0;
+    if (txn) {
+        header.txn = txn->id;
+        header.prevLsn = txn->lastLsn;
+    }
+    header.beforeLength = static_cast<uint16_t>(before.size());
+    header.afterLength = static_cast<uint16_t>(after.size());
+    header.checksum = recordChecksum(header, before, after);
+
+    // Everything but the length word, which publishes the record to the
+    // flusher; the padding is still zero from the last recycling
+    copyIn(header.lsn + sizeof(header.length), reinterpret_cast<const char*>(&header) + sizeof(header.length),
+           sizeof(header) - sizeof(header.length));
+    copyIn(header.lsn + sizeof(header), before.data(), before.size());
+    copyIn(header.lsn + sizeof(header) + before.size(), after.data(), after.size());
+    // A checkpoint that waits for this record also sees the table entry
+    if (txn) {
+        txn->lastLsn = header.lsn;
+        active[txn->slot].lastLsn.store(header.lsn, std::memory_order_relaxed);
+    }
+    __atomic_store_n(reinterpret_cast<uint32_t*>(ring.get() + (header.lsn & (capacity - 1))), header.length, __ATOMIC_RELEASE);
+    return header.lsn;
+}
+
+bool writeAheadLog::commit(walTransaction& txn) {
+    uint64_t lsn = appendCommit(txn);
+    bool ok = lsn != 0 && flushTo(lsn + recordLength(0, 0));
+    if (ok) commits.fetch_add(1, std::memory_order_relaxed);
+    return ok;
+}
+
+uint64_t writeAheadLog::appendCommit(walTransaction& txn) {
+    uint64_t lsn = append(txn, logType::COMMIT, 0, {}, {}, {});
+    end(txn);
+    return lsn;
+}
+
+bool writeAheadLog::abort(walTransaction& txn) {
+    bool ok = append(txn, logType::ABORT, 0, {}, {}, {}) != 0;
+    end(txn);
+    return ok;
+}
+
+bool writeAheadLog::flushTo(uint64_t lsn) {
+    if (durable.load(std::memory_order_acquire) >= lsn) return true;
+    std::unique_lock<std::mutex> lock(flushMutex);
+    if (requested < lsn) {
+        requested = lsn;
+        flushWanted.notify_one();
+    }
+    flushDone.wait(lock, [this, lsn] { return failed || durable.load(std::memory_order_relaxed) >= lsn; });
+    return durable.load(std::memory_order_relaxed) >= lsn;
+}
+
+void writeAheadLog::flusherLoop() {
+    std::unique_lock<std::mutex> lock(flushMutex);
+    for (;;) {
+        flushWanted.wait(lock, [this] { return stopping || requested > durable.load(std::memory_order_relaxed); });
+        bool last = stopping;
+        uint64_t want = last ? reserved.load(std::memory_order_acquire) : requested;
+        lock.unlock();
+
+        int64_t delay = commitDelayMicros.load(std::memory_order_relaxed);
+        if (delay > 0 && !last) std::this_thread::sleep_for(std::chrono::microseconds(delay));
+
+        // Every published record up to the first one still unpublished. Its
+        // writer may be waiting in reserve() for the space this flush frees,
+        // so only the record at durable itself is waited for: that one
+        // always fits, and is published in a moment
+        uint64_t from = durable.load(std::memory_order_relaxed);
+        uint64_t end = reserved.load(std::memory_order_acquire);
+        uint64_t to = from;
+        while (to < end) {
+            uint32_t length = __atomic_load_n(reinterpret_cast<uint32_t*>(ring.get() + (to & (capacity - 1))), __ATOMIC_ACQUIRE);
+            if (length == 0) {
+                if (to > from || to >= want) break;
+                std::this_thread::yield();
+                continue;
+            }
+            to += length;
+        }
+        bool ok = writeOut(from, to);
+
+        lock.lock();
+        if (ok) {
+            durable.store(to, std::memory_order_release);
+            recycled.store(to, std::memory_order_release);
+        } else {
+            failed = true;
+        }
+        flushDone.notify_all();
+        if (last || failed) return;
+    }
+}
+
+// Write ring bytes [from, to) to the file, sync them, then zero them so
+// the space can be reserved again
+bool writeAheadLog::writeOut(uint64_t from, uint64_t to) {
+    if (from == to) return true;
+    size_t position = from & (capacity - 1);
+    size_t length = static_cast<size_t>(to - from);
+    size_t first = std::min(length, capacity - position);
+    bool ok = pwriteAll(fd, ring.get() + position, first, static_cast<off_t>(from));
+    if (ok && first < length) ok = pwriteAll(fd, ring.get(), length - first, static_cast<off_t>(from + first));
+    if (ok) ok = fdatasync(fd) == 0;
+    if (!ok) {
+        std::cerr << "Error: Cannot write log '" << path << "'." << std::endl;
+        return false;
+    }
+    syncs.fetch_add(1, std::memory_order_relaxed);
+
+    std::memset(ring.get() + position, 0, first);
+    if (first < length) std::memset(ring.get(), 0, length - first);
+    return true;
+}
+
+walReader::walReader(const std::string& path) {
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) return;
+    struct stat st;
+    if (fstat(fd, &st) == 0 && static_cast<size_t>(st.st_size) >= sizeof(logFileHeader)) {
+        length = static_cast<size_t>(st.st_size);
+        void* addr = mmap(nullptr, length, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (addr != MAP_FAILED) base = static_cast<char*>(addr);
+    }
+    ::close(fd);
+    if (!base) return;
+
+    const logFileHeader* header = reinterpret_cast<const logFileHeader*>(base);
+    if (std::memcmp(header->magic, LOG_MAGIC, sizeof(LOG_MAGIC)) != 0 || header->version != LOG_VERSION) {
+        munmap(base, length);
+        base = nullptr;
+    }
+}
+
+walReader::~walReader() {
+    if (base) munmap(base, length);
+}
+
+const logRecordHeader* walReader::validate(uint64_t lsn) const {
+    if (!base || lsn < writeAheadLog::FIRST_LSN || lsn % 8 != 0 || lsn > length ||
+        length - lsn < sizeof(logRecordHeader)) {
+        return nullptr;
+    }
+    const logRecordHeader* candidate = reinterpret_cast<const logRecordHeader*>(base + lsn);
+    uint32_t size = candidate->length;
+    if (size < sizeof(logRecordHeader) || size % 8 != 0 || size > length - lsn || candidate->lsn != lsn ||
+        recordLength(candidate->beforeLength, candidate->afterLength) != size ||
+        recordChecksum(*candidate, logBefore(candidate), logAfter(candidate)) != candidate->checksum) {
+        return nullptr;
+    }
+    return candidate;
+}
+
+bool walReader::next(const logRecordHeader*& header, std::string_view& before, std::string_view& after) {
+    const logRecordHeader* candidate = validate(offset);
+    if (!candidate) return false;
+    header = candidate;
+    before = logBefore(candidate);
+    after = logAfter(candidate);
+    offset += candidate->length;
+    return true;
+}
+
+const logRecordHeader* walReader::at(uint64_t lsn) const {
+    return validate(lsn);
+}
@@ -0,0 +1,347 @@
+#include <iostream>
+#include <string>
+#include <vector>
+#include <map>
+#include <atomic>
+#include <thread>
+#include <random>
+#include <algorithm>
+#include <cstdlib>
+#include <unistd.h>
+#include "include/schema/schema.hpp"
+#include "include/storage/bTreeIndex.hpp"
+#include "include/storage/hashIndex.hpp"
+
+// Checks of hashIndex and bTreeIndex against a std::multimap / std::map
+// holding the same entries, through several rounds of splits, erases and
+// range scans.
+//
+// usage: test_index [directory]
+
+int failures = 0;
+
+void check(bool ok, const std::string& what) {
+    if (!ok) {
+        std::cerr << "FAIL: " << what << std::endl;
+        failures++;
+    }
+}
+
+bool ridLess(const recordId& a, const recordId& b) {
+    return a.page != b.page ? a.page < b.page : a.slot < b.slot;
+}
+
+recordId ridFor(uint64_t n) {
+    return {static_cast<uint32_t>(n >> 8), static_cast<uint16_t>(n & 0xFF)};
+}
+
+// Every key of reference finds exactly its rids, and nothing else is stored
+template <typename Key, typename MakeValue>
+bool sameEntries(const hashIndex& index, const std::multimap<Key, recordId>& reference, MakeValue makeValue) {
+    if (index.size() != reference.size()) return false;
+    for (auto it = reference.begin(); it != reference.end(); it = reference.upper_bound(it->first)) {
+        std::vector<recordId> expected;
+        for (auto range = reference.equal_range(it->first); range.first != range.second; ++range.first) {
+            expected.push_back(range.first->second);
+        }
+        std::vector<recordId> found;
+        Value key = makeValue(it->first);
+        if (index.find(key, found) != expected.size() || !index.contains(key)) return false;
+        std::sort(expected.begin(), expected.end(), ridLess);
+        std::sort(found.begin(), found.end(), ridLess);
+        if (found != expected) return false;
+    }
+    return true;
+}
+
+// Duplicate keys pile up in one chain, so their bucket overflows; erasing
+// from the middle of such a chain moves the chain's last entry into the
+// hole and frees the overflow bucket it emptied. Rounds of inserts and
+// erases carry the table through several doublings.
+void testHashIntegers() {
+    Table table;
+    table.name = "hash";
+    table.addColumn({"k", "INT"});
+    hashIndex index(table.columns[0]);
+    std::multimap<int64_t, recordId> reference;
+    auto makeValue = [](int64_t key) { return Value::integer(key); };
+    std::mt19937_64 random(42);
+    uint64_t nextRid = 0;
+
+    index.insert(Value::null(), ridFor(nextRid++));
+    check(index.size() == 0, "hash: NULL not stored");
+
+    for (int round = 0; round < 5; round++) {
+        size_t inserts = hashIndex::INITIAL_BUCKETS * hashIndex::BUCKET_ENTRIES << (round + 1);
+        for (size_t i = 0; i < inserts; i++) {
+            // A few keys with many rows each, the rest nearly unique
+            int64_t key = i % 4 == 0 ? static_cast<int64_t>(random() % 8) : static_cast<int64_t>(random() % 100000);
+            recordId rid = ridFor(nextRid++);
+            index.insert(Value::integer(key), rid);
+            reference.emplace(key, rid);
+        }
+        check(sameEntries(index, reference, makeValue), "hash: round " + std::to_string(round) + " after inserts");
+
+        // Erase a third of the entries, from anywhere in their chains
+        std::vector<std::multimap<int64_t, recordId>::iterator> erasing;
+        for (auto it = reference.begin(); it != reference.end(); ++it) {
+            if (random() % 3 == 0) erasing.push_back(it);
+        }
+        std::shuffle(erasing.begin(), erasing.end(), random);
+        for (auto it : erasing) {
+            check(index.erase(Value::integer(it->first), it->second), "hash: erase present entry");
+            check(!index.erase(Value::integer(it->first), it->second), "hash: erase twice");
+            reference.erase(it);
+        }
+        check(!index.erase(Value::integer(-1), ridFor(0)), "hash: erase missing key");
+        check(sameEntries(index, reference, makeValue), "hash: round " + std::to_string(round) + " after erases");
+    }
+    check(index.bucketCount() >= hashIndex::INITIAL_BUCKETS * 8, "hash: several split rounds");
+
+    std::vector<recordId> none;
+    check(index.find(Value::integer(-1), none) == 0 && !index.contains(Value::integer(-1)), "hash: missing key");
+    check(index.find(Value::null(), none) == 0, "hash: NULL finds nothing");
+
+    // Erase everything, then the empty table still takes inserts
+    for (auto it = reference.begin(); it != reference.end(); it = reference.erase(it)) {
+        check(index.erase(Value::integer(it->first), it->second), "hash: erase all");
+    }
+    check(index.size() == 0, "hash: empty");
+    index.insert(Value::integer(7), ridFor(1));
+    reference.emplace(7, ridFor(1));
+    check(sameEntries(index, reference, makeValue), "hash: insert after emptying");
+}
+
+// Strings too long to be inline are copied into the index, so the caller's
+// buffer may change once insert returns
+void testHashStrings() {
+    Table table;
+    table.name = "hash";
+    table.addColumn({"s", "VARCHAR(100)"});
+    hashIndex index(table.columns[0]);
+    std::multimap<std::string, recordId> reference;
+    auto keyFor = [](size_t n) { return "a string long enough not to be inline " + std::to_string(n % 500); };
+    auto makeValue = [](const std::string& key) { return Value::string(key); };
+
+    std::string buffer;
+    for (size_t n = 0; n < 3000; n++) {
+        buffer = keyFor(n);
+        index.insert(Value::string(buffer), ridFor(n));
+        reference.emplace(buffer, ridFor(n));
+        buffer.assign(buffer.size(), '#');
+    }
+    check(sameEntries(index, reference, makeValue), "hash strings: after inserts");
+    for (size_t n = 0; n < 3000; n += 2) {
+        buffer = keyFor(n);
+        check(index.erase(Value::string(buffer), ridFor(n)), "hash strings: erase");
+        auto range = reference.equal_range(buffer);
+        for (auto it = range.first; it != range.second; ++it) {
+            if (it->second == ridFor(n)) {
+                reference.erase(it);
+                break;
+            }
+        }
+    }
+    check(sameEntries(index, reference, makeValue), "hash strings: after erases");
+}
+
+// Keys of reference between the bounds, a null pointer being open
+std::vector<recordId> expectedRange(const std::map<int64_t, recordId>& reference, const int64_t* low, bool lowInclusive,
+                                    const int64_t* high, bool highInclusive) {
+    std::vector<recordId> rids;
+    auto it = !low ? reference.begin() : lowInclusive ? reference.lower_bound(*low) : reference.upper_bound(*low);
+    for (; it != reference.end(); ++it) {
+        if (high && (highInclusive ? it->first > *high : it->first >= *high)) break;
+        rids.push_back(it->second);
+    }
+    return rids;
+}
+
+std::vector<recordId> scanRange(const bTreeIndex& index, const int64_t* low, bool lowInclusive, const int64_t* high,
+                                bool highInclusive) {
+    bTreeScan scan(index, low ? Value::integer(*low) : Value::null(), lowInclusive,
+                   high ? Value::integer(*high) : Value::null(), highInclusive);
+    std::vector<recordId> rids;
+    recordId rid;
+    while (scan.next(rid)) rids.push_back(rid);
+    return rids;
+}
+
+// Every key in [-span, span] looks up as the reference says, and scans with
+// bounds on, between and beside keys, inclusive or not, open or not, match it
+void checkTree(const bTreeIndex& index, const std::map<int64_t, recordId>& reference, int64_t span,
+               std::mt19937_64& random, const std::string& what) {
+    check(index.size() == reference.size(), what + ": size");
+    bool lookups = true;
+    for (int64_t key = -span - 1; key <= span + 1; key++) {
+        recordId rid;
+        auto it = reference.find(key);
+        bool found = index.lookup(Value::integer(key), rid);
+        lookups = lookups && found == (it != reference.end()) && (!found || rid == it->second);
+    }
+    check(lookups, what + ": lookups");
+
+    for (int i = 0; i < 200; i++) {
+        int64_t low = static_cast<int64_t>(random() % (2 * span + 3)) - span - 1;
+        int64_t high = i % 10 == 0 ? low : low + static_cast<int64_t>(random() % (span / 4 + 1));
+        bool lowInclusive = random() % 2;
+        bool highInclusive = random() % 2;
+        const int64_t* lowBound = i % 7 == 1 ? nullptr : &low;
+        const int64_t* highBound = i % 7 == 2 ? nullptr : &high;
+        if (i == 3) lowBound = highBound = nullptr;
+        if (i == 4) std::swap(low, high); // empty range
+        std::string bounds = (lowBound ? (lowInclusive ? "[" : "(") + std::to_string(low) : "(NULL") + ", " +
+                             (highBound ? std::to_string(high) + (highInclusive ? "]" : ")") : "NULL)");
+        check(scanRange(index, lowBound, lowInclusive, highBound, highInclusive) ==
+                  expectedRange(reference, lowBound, lowInclusive, highBound, highInclusive),
+              what + ": scan " + bounds);
+    }
+}
+
+// Inserts in scrambled order grow the tree to three levels; rounds of
+// erases and re-inserts follow, and the file is reopened between them
+void testTree(const std::string& dir) {
+    const std::string path = dir + "/tree.idx";
+    ::unlink(path.c_str());
+    Table table;
+    table.name = "tree";
+    table.addColumn({"id", "INT", true, true, true});
+    const int64_t span = 250000;
+    std::map<int64_t, recordId> reference;
+    std::mt19937_64 random(7);
+    bufferPool pool(256);
+
+    {
+        bTreeIndex index(path, table.columns[0], pool);
+        check(index.isOpen() && index.isNew(), "tree: create");
+        if (!index.isOpen()) return;
+        check(index.insert(Value::null(), ridFor(1)) == indexStatus::OK && index.size() == 0, "tree: NULL not stored");
+        // Every other key of [-span, span], so lookups and bounds fall between keys too
+        const uint64_t count = static_cast<uint64_t>(span) + 1;
+        bool inserted = true;
+        for (uint64_t i = 0; i < count; i++) {
+            int64_t key = static_cast<int64_t>(i * 2654435761ull % count) * 2 - span;
+            recordId rid = ridFor(static_cast<uint64_t>(key + span));
+            inserted = inserted && index.insert(Value::integer(key), rid) == indexStatus::OK;
+            reference.emplace(key, rid);
+        }
+        check(inserted, "tree: inserts");
+        check(index.height() >= 3, "tree: three levels");
+        check(index.insert(Value::integer(0), ridFor(9)) == indexStatus::DUPLICATE, "tree: duplicate key");
+        checkTree(index, reference, span, random, "tree: built");
+        check(index.flush(), "tree: flush");
+    }
+
+    for (int round = 0; round < 3; round++) {
+        bTreeIndex index(path, table.columns[0], pool);
+        check(index.isOpen() && !index.isNew() && !index.wasUnclean(), "tree: reopen");
+        if (!index.isOpen()) return;
+        std::string what = "tree: round " + std::to_string(round);
+
+        bool erased = true;
+        for (auto it = reference.begin(); it != reference.end();) {
+            if (random() % 3 == 0) {
+                erased = erased && index.erase(Value::integer(it->first));
+                it = reference.erase(it);
+            } else {
+                ++it;
+            }
+        }
+        check(erased, what + ": erases");
+        check(!index.erase(Value::integer(span + 1)), what + ": erase missing key");
+        checkTree(index, reference, span, random, what + " after erases");
+
+        bool inserted = true;
+        for (int i = 0; i < 20000; i++) {
+            int64_t key = static_cast<int64_t>(random() % (2 * span + 1)) - span;
+            recordId rid = ridFor(static_cast<uint64_t>(i));
+            indexStatus status = index.insert(Value::integer(key), rid);
+            bool fresh = reference.emplace(key, rid).second;
+            inserted = inserted && status == (fresh ? indexStatus::OK : indexStatus::DUPLICATE);
+        }
+        check(inserted, what + ": inserts");
+        checkTree(index, reference, span, random, what + " after inserts");
+        check(index.flush(), what + ": flush");
+    }
+    ::unlink(path.c_str());
+}
+
+// Readers descending while a writer splits nodes restart instead of
+// missing a key: keys present before the writer started are always found,
+// and a full scan returns them all in order
+void testTreeRestarts(const std::string& dir) {
+    const std::string path = dir + "/restarts.idx";
+    ::unlink(path.c_str());
+    Table table;
+    table.name = "restarts";
+    table.addColumn({"id", "INT", true, true, true});
+    bufferPool pool(4096);
+    const int64_t stable = 20000;
+    {
+        bTreeIndex index(path, table.columns[0], pool);
+        check(index.isOpen(), "restarts: create");
+        if (!index.isOpen()) return;
+        for (int64_t key = 0; key < stable; key++) {
+            index.insert(Value::integer(key * 16), ridFor(static_cast<uint64_t>(key)));
+        }
+
+        std::atomic<bool> stop{false};
+        std::atomic<uint64_t> misses{0};
+        std::atomic<uint64_t> badScans{0};
+        std::vector<std::thread> readers;
+        for (int t = 0; t < 3; t++) {
+            readers.emplace_back([&, t] {
+                recordId rid;
+                for (uint64_t i = static_cast<uint64_t>(t); !stop.load(); i++) {
+                    int64_t key = static_cast<int64_t>(i * 7919 % stable);
+                    if (!index.lookup(Value::integer(key * 16), rid) || rid != ridFor(static_cast<uint64_t>(key))) {
+                        misses++;
+                    }
+                }
+            });
+        }
+        readers.emplace_back([&] {
+            while (!stop.load()) {
+                bTreeScan scan(index, Value::null(), true, Value::null(), true);
+                recordId rid;
+                int64_t seen = 0;
+                while (scan.next(rid)) {
+                    // The writer's rows have page >= 1 << 16; the stable ones are in order
+                    if (rid.page >= (1u << 16)) continue;
+                    if (rid != ridFor(static_cast<uint64_t>(seen))) break;
+                    seen++;
+                }
+                if (seen != stable) badScans++;
+            }
+        });
+
+        // New keys between the stable ones split leaves and inner nodes
+        bool inserted = true;
+        for (int64_t key = 0; key < stable * 15; key++) {
+            int64_t spot = key / 15 * 16 + key % 15 + 1;
+            inserted = inserted && index.insert(Value::integer(spot), {static_cast<uint32_t>(key + (1 << 16)), 0}) == indexStatus::OK;
+        }
+        stop = true;
+        for (std::thread& reader : readers) reader.join();
+        check(inserted, "restarts: writer inserts");
+        check(misses.load() == 0, "restarts: lookups missed " + std::to_string(misses.load()) + " keys");
+        check(badScans.load() == 0, "restarts: " + std::to_string(badScans.load()) + " scans lost stable keys");
+        check(index.size() == static_cast<uint64_t>(stable) * 16, "restarts: size");
+    }
+    ::unlink(path.c_str());
+}
+
+int main(int argc, char** argv) {
+    std::string dir = argc > 1 ? argv[1] : ".";
+    alarm(300);
+    testHashIntegers();
+    testHashStrings();
+    testTree(dir);
+    testTreeRestarts(dir);
+    if (failures) {
+        std::cerr << failures << " check(s) failed" << std::endl;
+        return 1;
+    }
+    std::cout << "all index checks passed" << std::endl;
+    return 0;
+}
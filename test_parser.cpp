@@ -0,0 +1,217 @@
+#include <iostream>
+#include <string>
+#include <vector>
+#include <unistd.h>
+#include "include/parser/binder.hpp"
+#include "include/parser/compactAst.hpp"
+#include "include/parser/lexer.hpp"
+#include "include/parser/parser.hpp"
+#include "include/parser/preparedStatement.hpp"
+#include "include/parser/templateCache.hpp"
+#include "include/common/arena.hpp"
+#include "include/storage/heapFile.hpp"
+
+// Checks of parser edge cases that have gone wrong before
+//
+// usage: test_parser [directory]
+
+int failures = 0;
+
+void check(bool ok, const std::string& what) {
+    if (!ok) {
+        std::cerr << "FAIL: " << what << std::endl;
+        failures++;
+    }
+}
+
+// Parse sql with every PARAMETER token's value replaced by parameter, so
+// numbers the lexer would not produce reach the parser too
+bool parseWith(const std::string& sql, const std::string& parameter, parser& pars) {
+    lexer lex;
+    std::vector<Token> tokens = lex.tokenize(sql);
+    for (Token& token : tokens) {
+        if (token.type == TokenType::PARAMETER) token.value = parameter;
+    }
+    arena nodes;
+    pars.nodeArena = &nodes;
+    pars.itr = Iterator();
+    astNode* root = astNode::create("ROOT", "ROOT", &nodes);
+    bool ok = pars.parse(tokens, root);
+    nodes.reset();
+    return ok;
+}
+
+// $n is 1-based and at most MAX_PARAMETERS; anything else is a parse
+// error rather than a placeholder no value can be bound to
+void testParameterNumbers() {
+    const std::string sql = "SELECT * FROM users WHERE id = $1;";
+    const std::string huge = "$" + std::string(30, '9');
+    const std::string tooMany = "$" + std::to_string(parser::MAX_PARAMETERS + 1);
+    for (const std::string& parameter : {std::string("$0"), std::string("$00"), huge, tooMany}) {
+        parser pars;
+        check(!parseWith(sql, parameter, pars), parameter + ": rejected");
+        check(pars.firstError == ParseError::INVALID_PARAMETER, parameter + ": invalid_parameter");
+    }
+    parser pars;
+    const std::string last = "$" + std::to_string(parser::MAX_PARAMETERS);
+    check(parseWith(sql, last, pars), last + ": accepted");
+    check(pars.parameterCount == parser::MAX_PARAMETERS, last + ": parameter count");
+
+    preparedStatementCache cache;
+    check(cache.prepare("SELECT * FROM users WHERE id = $0;") == nullptr, "prepare $0");
+    check(cache.prepare("SELECT * FROM users WHERE id = " + huge + ";") == nullptr, "prepare huge index");
+    auto statement = cache.prepare("SELECT * FROM users WHERE id = $2 AND age > $1;");
+    check(statement && statement->parameterCount() == 2, "prepare $2, $1");
+}
+
+// The first error keeps its message and token without tracing compiled in
+void testErrorReport() {
+    parser pars;
+    check(!parseWith("SELECT * users;", "$1", pars), "missing FROM: rejected");
+    check(pars.firstError == ParseError::EXPECTED_KEYWORD, "missing FROM: kind");
+    check(pars.error() == "Expected FROM keyword", "missing FROM: message");
+    check(pars.firstErrorToken == 2, "missing FROM: token");
+    check(parseWith("SELECT * FROM users;", "$1", pars), "parses after an error");
+    check(pars.error().empty() && pars.firstError == ParseError::NONE, "error cleared");
+}
+
+// Every node the parser makes has a NodeKind, so none of these statements
+// copies a type name into its compactAst
+void testNodeKinds() {
+    const std::vector<std::string> statements = {
+        "SELECT DISTINCT name AS n FROM users u JOIN orders o ON u.id = o.user_id "
+        "WHERE u.age BETWEEN 1 AND 9 AND NOT u.name LIKE 'a%' OR u.id IN (1, 2) "
+        "GROUP BY name HAVING COUNT(*) > $1 ORDER BY name DESC LIMIT 5;",
+        "INSERT INTO users (id, name) VALUES (1, 'a'), (2, NULL);",
+        "UPDATE users SET name = 'b', age = 3 WHERE id = 1;",
+        "DELETE FROM users WHERE id = 1;",
+        "CREATE TABLE orders (id INT PRIMARY KEY, user_id INT NOT NULL REFERENCES users(id), "
+        "total DOUBLE, UNIQUE (total), FOREIGN KEY (user_id) REFERENCES users(id)) WITH (STORAGE = PAX);",
+        "CREATE INDEX orders_user ON orders (user_id) USING HASH;",
+    };
+    for (const std::string& sql : statements) {
+        lexer lex;
+        std::vector<Token> tokens = lex.tokenize(sql);
+        arena nodes;
+        parser pars;
+        pars.nodeArena = &nodes;
+        astNode* root = astNode::create("ROOT", "ROOT", &nodes);
+        check(pars.parse(tokens, root), sql + ": parses");
+        compactAst tree = compactAst::fromTree(root);
+        for (const compactNode& node : tree.nodes) {
+            check(node.kind != NodeKind::UNKNOWN, sql + ": " + std::string(tree.typeName(node)) + " has a kind");
+        }
+    }
+}
+
+// With a schema, templates are bound once and a hit only checks the
+// literals against what their slots need
+void testBoundTemplates() {
+    DatabaseSchema schema;
+    Table users;
+    users.name = "users";
+    users.addColumn({"id", "INT"});
+    users.addColumn({"name", "VARCHAR(20)"});
+    check(schema.addTable(users), "add users");
+    templateCache cache(16, &schema);
+    boundStatement bound;
+
+    check(cache.execute("SELECT * FROM users WHERE id = 1;", bound), "bind id = 1");
+    check(cache.execute("SELECT * FROM users WHERE id = 2;", bound), "bind id = 2");
+    check(cache.hits() == 1 && cache.bypassed() == 0, "id = 2 is a template hit");
+    check(!cache.execute("SELECT * FROM users WHERE id = 'x';", bound), "id = 'x' does not bind");
+    check(cache.execute("SELECT * FROM users WHERE name LIKE 'a%';", bound), "bind LIKE 'a%'");
+    check(!cache.execute("SELECT * FROM users WHERE name LIKE 5;", bound), "LIKE 5 does not bind");
+    check(cache.execute("INSERT INTO users VALUES (1, 'a');", bound), "bind INSERT");
+    check(!cache.execute("INSERT INTO users VALUES ('a', 'a');", bound), "INSERT 'a' into INT does not bind");
+    check(cache.execute("SELECT SUM(id) FROM users WHERE 1 = 1;", bound), "bind 1 = 1");
+    check(!cache.execute("SELECT SUM(id) FROM users WHERE 1 = 'a';", bound), "1 = 'a' does not bind");
+
+    // A shape naming a missing table is not kept, so it binds once the table exists
+    size_t cached = cache.size();
+    check(!cache.execute("SELECT * FROM orders WHERE id = 1;", bound), "orders does not bind yet");
+    check(cache.size() == cached, "unbound shape not cached");
+    Table orders;
+    orders.name = "orders";
+    orders.addColumn({"id", "INT"});
+    check(schema.addTable(orders), "add orders");
+    check(cache.execute("SELECT * FROM orders WHERE id = 1;", bound), "orders binds once added");
+}
+
+// Bind sql against schema and answer its WHERE from the indexes of rows,
+// the file of its first table
+bool lookupWith(const std::string& sql, const DatabaseSchema& schema, const heapFile& rows,
+                std::vector<recordId>& rids) {
+    lexer lex;
+    std::vector<Token> tokens = lex.tokenize(sql);
+    arena nodes;
+    parser pars;
+    pars.nodeArena = &nodes;
+    astNode* root = astNode::create("ROOT", "ROOT", &nodes);
+    binder resolver(schema);
+    if (!pars.parse(tokens, root) || !resolver.bind(root) || root->children.empty()) {
+        check(false, sql + ": binds");
+        return false;
+    }
+    rids.clear();
+    return binder::lookupWhere(root->children[0], 0, rows, rids);
+}
+
+// An equality ANDed into a WHERE is answered by the column's index; OR,
+// NOT, unindexed columns and literals the column cannot hold need a scan
+void testIndexedWhere(const std::string& dir) {
+    const std::string path = dir + "/indexed_where.heap";
+    ::unlink(path.c_str());
+    DatabaseSchema schema;
+    Table users;
+    users.name = "users";
+    users.addColumn({"id", "INT", true, true, true});
+    users.addColumn({"city", "VARCHAR(20)"});
+    users.addColumn({"age", "INT"});
+    check(schema.addTable(users), "add users");
+    bufferPool pool(64);
+    {
+        heapFile rows(path, users, pool);
+        check(rows.isOpen(), "indexed where: open");
+        for (int64_t id = 0; id < 100; id++) {
+            std::string city = "c" + std::to_string(id % 5);
+            Value row[3] = {Value::integer(id), Value::string(city), Value::integer(id % 10)};
+            recordId rid;
+            check(rows.insert(row, rid), "indexed where: insert");
+        }
+        check(rows.addIndex({"users_city", "users", "city", IndexMethod::HASH}), "indexed where: hash index");
+
+        std::vector<recordId> rids;
+        check(lookupWith("SELECT * FROM users WHERE id = 7;", schema, rows, rids) && rids.size() == 1,
+              "id = 7 uses the primary key");
+        check(lookupWith("SELECT * FROM users WHERE age > 3 AND city = 'c2';", schema, rows, rids) && rids.size() == 20,
+              "city = 'c2' uses the hash index");
+        check(lookupWith("DELETE FROM users WHERE (age = 1 AND 7 = id);", schema, rows, rids) && rids.size() == 1,
+              "7 = id inside parentheses");
+        check(lookupWith("UPDATE users SET age = 1 WHERE city = 'c9';", schema, rows, rids) && rids.empty(),
+              "city = 'c9' matches nothing");
+        check(!lookupWith("SELECT * FROM users WHERE id = 7 OR age = 1;", schema, rows, rids), "OR scans");
+        check(!lookupWith("SELECT * FROM users WHERE NOT id = 7;", schema, rows, rids), "NOT scans");
+        check(!lookupWith("SELECT * FROM users WHERE age = 3;", schema, rows, rids), "unindexed column scans");
+        check(!lookupWith("SELECT * FROM users WHERE id = 2.5;", schema, rows, rids), "id = 2.5 scans");
+        check(!lookupWith("SELECT * FROM users WHERE id > 7;", schema, rows, rids), "id > 7 scans");
+    }
+    ::unlink(path.c_str());
+    ::unlink((path + ".fsm").c_str());
+    ::unlink((path + ".id.idx").c_str());
+}
+
+int main(int argc, char** argv) {
+    std::string dir = argc > 1 ? argv[1] : ".";
+    testParameterNumbers();
+    testErrorReport();
+    testNodeKinds();
+    testBoundTemplates();
+    testIndexedWhere(dir);
+    if (failures) {
+        std::cerr << failures << " check(s) failed" << std::endl;
+        return 1;
+    }
+    std::cout << "all parser checks passed" << std::endl;
+    return 0;
+}
@@ -0,0 +1,378 @@
+#include <iostream>
+#include <string>
+#include <vector>
+#include <map>
+#include <iomanip>
+#include <chrono>
+#include <random>
+#include <thread>
+#include <cstdlib>
+#include <cstring>
+#include <csignal>
+#include <poll.h>
+#include <sys/stat.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#include "include/storage/recoveryManager.hpp"
+
+// Crash test for the write-ahead log and recovery. Each round forks a
+// child that runs transactions from several writer threads (one heap file
+// each) with background checkpoints, and SIGKILLs it at a random moment.
+// The parent then recovers, times it, and checks every file holds exactly
+// the rows of the transactions it was told had committed, plus possibly
+// the one each writer was committing when it died.
+//
+// Transactions are generated from (writer, sequence number), so parent and
+// child agree on what each did without sending the rows over.
+//
+// usage: test_recovery [rounds] [writers] [directory]
+
+struct operation {
+    enum kind : uint8_t { INSERT, UPDATE, DELETE } type;
+    int64_t id;
+    int64_t value;
+};
+
+struct writerState {
+    uint64_t seq = 0;
+    std::map<int64_t, int64_t> rows;   // id -> value
+};
+
+// What a writer reports through the pipe
+struct message {
+    uint32_t writer;
+    uint32_t kind;                      // 0: starting seq, 1: committed, 2: rolled back
+    uint64_t seq;
+};
+
+std::string padFor(int64_t value) {
+    return std::string(static_cast<size_t>(value % 180), 'p');
+}
+
+// Transaction seq of writer: a few inserts, updates and deletes against
+// rows; one in eight is rolled back instead of committed
+std::vector<operation> plan(uint32_t writer, uint64_t seq, const std::map<int64_t, int64_t>& rows, bool& rollback) {
+    std::mt19937_64 rng(writer * 1000003ull + seq);
+    std::map<int64_t, int64_t> scratch = rows;
+    std::vector<operation> ops;
+    size_t count = 1 + rng() % 6;
+    for (size_t k = 0; k < count; k++) {
+        int64_t value = static_cast<int64_t>(rng() % 1000000);
+        unsigned choice = static_cast<unsigned>(rng() % 10);
+        if (choice < 5 || scratch.size() < 10) {
+            int64_t id = static_cast<int64_t>(writer) * 1000000000ll + static_cast<int64_t>(seq * 8 + k);
+            ops.push_back({operation::INSERT, id, value});
+            scratch[id] = value;
+            continue;
+        }
+        auto it = std::next(scratch.begin(), static_cast<long>(rng() % scratch.size()));
+        if (choice < 8) {
+            ops.push_back({operation::UPDATE, it->first, value});
+            it->second = value;
+        } else {
+            ops.push_back({operation::DELETE, it->first, 0});
+            scratch.erase(it);
+        }
+    }
+    rollback = rng() % 8 == 0;
+    return ops;
+}
+
+void applyOps(std::map<int64_t, int64_t>& rows, const std::vector<operation>& ops) {
+    for (const operation& op : ops) {
+        if (op.type == operation::DELETE) {
+            rows.erase(op.id);
+        } else {
+            rows[op.id] = op.value;
+        }
+    }
+}
+
+Table rowsTable() {
+    Table table;
+    table.name = "rows";
+    table.addColumn({"id", "INT", true, true, true});
+    table.addColumn({"value", "INT"});
+    table.addColumn({"pad", "VARCHAR(200)"});
+    return table;
+}
+
+std::string heapPath(const std::string& dir, size_t writer) {
+    return dir + "/rows_" + std::to_string(writer) + ".heap";
+}
+
+// The child: run transactions until killed
+[[noreturn]] void runWriters(const std::string& dir, std::vector<writerState> states, int pipeFd) {
+    Table table = rowsTable();
+    writeAheadLog log(dir + "/recovery.log", 4u << 20, std::chrono::microseconds(100));
+    bufferPool pool(256);
+    std::vector<std::unique_ptr<heapFile>> heaps;
+    recoveryManager manager(log, pool);
+    for (size_t w = 0; w < states.size(); w++) {
+        heaps.push_back(std::make_unique<heapFile>(heapPath(dir, w), table, pool));
+        if (!log.isOpen() || !heaps.back()->isOpen() || !manager.attach(static_cast<uint32_t>(w + 1), *heaps.back())) _exit(2);
+    }
+    manager.startCheckpoints(std::chrono::milliseconds(20), 64);
+
+    auto send = [pipeFd](uint32_t writer, uint32_t kind, uint64_t seq) {
+        message m{writer, kind, seq};
+        if (write(pipeFd, &m, sizeof(m)) != sizeof(m)) _exit(2);
+    };
+    std::vector<std::thread> threads;
+    for (size_t w = 0; w < states.size(); w++) {
+        threads.emplace_back([&, w] {
+            writerState& state = states[w];
+            heapFile& heap = *heaps[w];
+            for (;; state.seq++) {
+                bool rollback;
+                std::vector<operation> ops = plan(static_cast<uint32_t>(w), state.seq, state.rows, rollback);
+                send(static_cast<uint32_t>(w), 0, state.seq);
+                walTransaction txn = log.begin();
+                for (const operation& op : ops) {
+                    std::string pad = padFor(op.value);
+                    Value row[3] = {Value::integer(op.id), Value::integer(op.value), Value::string(pad)};
+                    std::vector<recordId> rids;
+                    bool ok;
+                    if (op.type == operation::INSERT) {
+                        recordId rid;
+                        ok = heap.insert(row, rid, &txn);
+                    } else {
+                        ok = heap.lookup(0, Value::integer(op.id), rids) && rids.size() == 1;
+                        if (ok) ok = op.type == operation::UPDATE ? heap.update(rids[0], row, &txn) : heap.erase(rids[0], &txn);
+                    }
+                    if (!ok) {
+                        std::cerr << "writer " << w << ": operation failed in transaction " << state.seq << std::endl;
+                        _exit(2);
+                    }
+                }
+                if (rollback) {
+                    if (!manager.rollback(txn)) _exit(2);
+                    send(static_cast<uint32_t>(w), 2, state.seq);
+                } else {
+                    if (!log.commit(txn)) _exit(2);
+                    applyOps(state.rows, ops);
+                    send(static_cast<uint32_t>(w), 1, state.seq);
+                }
+            }
+        });
+    }
+    for (auto& thread : threads) thread.join();
+    _exit(0);
+}
+
+// Apply a writer's reports; pending is the transaction it had started and
+// not reported on, or -1
+void readReports(const std::vector<char>& bytes, std::vector<writerState>& states, std::vector<int64_t>& pending) {
+    for (size_t offset = 0; offset + sizeof(message) <= bytes.size(); offset += sizeof(message)) {
+        message m;
+        std::memcpy(&m, bytes.data() + offset, sizeof(m));
+        writerState& state = states[m.writer];
+        if (m.kind == 0) {
+            pending[m.writer] = static_cast<int64_t>(m.seq);
+            continue;
+        }
+        if (m.kind == 1) {
+            bool rollback;
+            applyOps(state.rows, plan(m.writer, m.seq, state.rows, rollback));
+        }
+        state.seq = m.seq + 1;
+        pending[m.writer] = -1;
+    }
+}
+
+// Rows actually in a heap file; false if a row or its index entry is wrong
+bool readRows(heapFile& heap, std::map<int64_t, int64_t>& rows) {
+    heapScan scan(heap);
+    recordId rid;
+    const char* tuple;
+    uint16_t length;
+    while (scan.next(rid, tuple, length)) {
+        int64_t id = heap.codec().decode(tuple, 0).asInt();
+        int64_t value = heap.codec().decode(tuple, 1).asInt();
+        if (heap.codec().decode(tuple, 2).asString() != padFor(value) || !rows.emplace(id, value).second) return false;
+        std::vector<recordId> rids;
+        if (!heap.lookup(0, Value::integer(id), rids) || rids.size() != 1 || rids[0] != rid) return false;
+    }
+    return heap.index(0)->size() == rows.size();
+}
+
+// Two transactions on one file at once: T1 erases rows, T2 inserts into
+// the same pages and commits, then T1 is rolled back live or undone by
+// recovery after a crash. Its rows must go back to the slots they left.
+bool interleavedRollback(const std::string& dir, bool crash) {
+    std::string heapFileName = dir + "/interleaved/rows.heap";
+    std::string logName = dir + "/interleaved/recovery.log";
+    if (std::system(("rm -rf '" + dir + "/interleaved' && mkdir -p '" + dir + "/interleaved'").c_str()) != 0) return false;
+    Table table = rowsTable();
+    std::map<int64_t, int64_t> expected;
+
+    auto run = [&]() -> bool {
+        writeAheadLog log(logName);
+        bufferPool pool(64);
+        heapFile heap(heapFileName, table, pool);
+        recoveryManager manager(log, pool);
+        if (!log.isOpen() || !heap.isOpen() || !manager.attach(1, heap)) return false;
+        auto insertRow = [&](walTransaction& txn, int64_t id) {
+            std::string pad = padFor(id);
+            Value row[3] = {Value::integer(id), Value::integer(id), Value::string(pad)};
+            recordId rid;
+            return heap.insert(row, rid, &txn);
+        };
+
+        walTransaction t0 = log.begin();
+        for (int64_t id = 0; id < 200; id++) {
+            if (!insertRow(t0, id)) return false;
+        }
+        if (!log.commit(t0)) return false;
+        walTransaction t1 = log.begin();
+        for (int64_t id = 0; id < 200; id += 2) {
+            std::vector<recordId> rids;
+            if (!heap.lookup(0, Value::integer(id), rids) || rids.size() != 1 || !heap.erase(rids[0], &t1)) return false;
+        }
+        walTransaction t2 = log.begin();
+        for (int64_t id = 1000; id < 1300; id++) {
+            if (!insertRow(t2, id)) return false;
+        }
+        if (!log.commit(t2)) return false;
+        if (crash) {
+            log.flushTo(log.endLsn());
+            heap.flush();
+            _exit(0);
+        }
+        return manager.rollback(t1);
+    };
+    for (int64_t id = 0; id < 200; id++) expected[id] = id;
+    for (int64_t id = 1000; id < 1300; id++) expected[id] = id;
+
+    if (crash) {
+        pid_t child = fork();
+        if (child == 0) _exit(run() ? 0 : 2);
+        int status = 0;
+        waitpid(child, &status, 0);
+        if (!WIFEXITED(status) || WEXITSTATUS(status) != 0) return false;
+    } else if (!run()) {
+        return false;
+    }
+
+    writeAheadLog log(logName);
+    bufferPool pool(64);
+    heapFile heap(heapFileName, table, pool);
+    recoveryManager manager(log, pool);
+    if (!manager.attach(1, heap) || !manager.recover(1)) return false;
+    std::map<int64_t, int64_t> actual;
+    return readRows(heap, actual) && actual == expected;
+}
+
+int main(int argc, char** argv) {
+    int rounds = argc > 1 ? std::atoi(argv[1]) : 20;
+    size_t writers = argc > 2 ? std::strtoull(argv[2], nullptr, 10) : 4;
+    std::string dir = argc > 3 ? argv[3] : "recovery_test";
+    if (std::system(("rm -rf '" + dir + "' && mkdir -p '" + dir + "'").c_str()) != 0) return 1;
+
+    for (bool crash : {false, true}) {
+        if (!interleavedRollback(dir, crash)) {
+            std::cerr << "FAIL: interleaved rollback" << (crash ? " after a crash" : "") << std::endl;
+            return 1;
+        }
+    }
+
+    Table table = rowsTable();
+    std::vector<writerState> states(writers);
+    std::mt19937_64 rng(12345);
+    std::cout << "round |   log MB | analyzed KB | redo KB | redone | undone | losers | recovery ms |    rows" << std::endl;
+
+    for (int round = 1; round <= rounds; round++) {
+        int fds[2];
+        if (pipe(fds) != 0) return 1;
+        pid_t child = fork();
+        if (child == 0) {
+            close(fds[0]);
+            runWriters(dir, states, fds[1]);
+        }
+        close(fds[1]);
+
+        // Collect reports until the kill, then whatever is left in the pipe
+        std::vector<char> bytes;
+        char buffer[4096];
+        auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(100 + rng() % 900);
+        bool killed = false;
+        for (;;) {
+            auto now = std::chrono::steady_clock::now();
+            if (!killed && now >= deadline) {
+                kill(child, SIGKILL);
+                killed = true;
+            }
+            pollfd reader{fds[0], POLLIN, 0};
+            int wait = killed ? -1 : static_cast<int>(std::chrono::duration_cast<std::chrono::milliseconds>(deadline - now).count()) + 1;
+            if (poll(&reader, 1, wait) <= 0) continue;
+            ssize_t got = read(fds[0], buffer, sizeof(buffer));
+            if (got <= 0) break;
+            bytes.insert(bytes.end(), buffer, buffer + got);
+        }
+        close(fds[0]);
+        int status = 0;
+        waitpid(child, &status, 0);
+        if (!WIFSIGNALED(status)) {
+            std::cerr << "FAIL: the writers stopped before being killed (status " << status << ")" << std::endl;
+            return 1;
+        }
+        std::vector<int64_t> pending(writers, -1);
+        readReports(bytes, states, pending);
+
+        // Restart
+        struct stat logStat{};
+        stat((dir + "/recovery.log").c_str(), &logStat);
+        recoveryStats stats;
+        auto started = std::chrono::steady_clock::now();
+        writeAheadLog log(dir + "/recovery.log");
+        bufferPool pool(4096);
+        std::vector<std::unique_ptr<heapFile>> heaps;
+        recoveryManager manager(log, pool);
+        for (size_t w = 0; w < writers; w++) {
+            heaps.push_back(std::make_unique<heapFile>(heapPath(dir, w), table, pool));
+            if (!heaps.back()->isOpen() || !manager.attach(static_cast<uint32_t>(w + 1), *heaps.back())) return 1;
+        }
+        if (!log.isOpen() || !manager.recover(0, &stats)) {
+            std::cerr << "FAIL: recovery failed in round " << round << std::endl;
+            return 1;
+        }
+        double milliseconds = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - started).count();
+
+        // Each file must hold the committed rows, with or without the
+        // transaction that was in flight
+        size_t total = 0;
+        for (size_t w = 0; w < writers; w++) {
+            std::map<int64_t, int64_t> actual;
+            if (!readRows(*heaps[w], actual)) {
+                std::cerr << "FAIL: rows and index of writer " << w << " disagree in round " << round << std::endl;
+                return 1;
+            }
+            writerState& state = states[w];
+            bool matched = actual == state.rows;
+            if (!matched && pending[w] >= 0) {
+                bool rollback;
+                std::map<int64_t, int64_t> with = state.rows;
+                applyOps(with, plan(static_cast<uint32_t>(w), static_cast<uint64_t>(pending[w]), state.rows, rollback));
+                if (!rollback && actual == with) {
+                    state.rows = with;
+                    state.seq = static_cast<uint64_t>(pending[w]) + 1;
+                    matched = true;
+                }
+            }
+            if (!matched) {
+                std::cerr << "FAIL: writer " << w << " has " << actual.size() << " rows, expected " << state.rows.size()
+                          << " after transaction " << state.seq << " in round " << round << std::endl;
+                return 1;
+            }
+            total += actual.size();
+        }
+
+        std::cout << std::setw(5) << round << " | " << std::fixed << std::setprecision(2) << std::setw(8)
+                  << logStat.st_size / 1048576.0 << " | " << std::setprecision(1) << std::setw(11) << stats.analyzedBytes / 1024.0
+                  << " | " << std::setw(7) << stats.redoBytes / 1024.0 << " | " << std::setw(6) << stats.redone << " | "
+                  << std::setw(6) << stats.undone << " | " << std::setw(6) << stats.losers << " | " << std::setprecision(1)
+                  << std::setw(11) << milliseconds << " | " << std::setw(7) << total << std::endl;
+    }
+    std::cout << "ALL ROUNDS OK" << std::endl;
+    return 0;
+}